@@ -273,6 +273,9 @@ namespace icarus {
       crtHits.push_back(*crtHit);
     }
 
+    // Sort and group the CRT hits once for all the tracks
+    CRTHitIndex const crtHitIndex = t0Alg.MakeCRTHitIndex(crtHits, m_gate_start_timestamp, true);
+
     // Retrieve track list
     for(const auto& trackLabel : fTpcTrackModuleLabel){
 
@@ -307,6 +310,16 @@ namespace icarus {
 	auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(event);
 	art::FindManyP<recob::Hit> findManyHits(trackListHandle, event, trackLabel);
 
+	// Match all the tracks in parallel
+	std::vector<std::vector<art::Ptr<recob::Hit>>> trackHits;
+	trackHits.reserve(trackList.size());
+	for (auto const& track : trackList) {
+	  trackHits.push_back(findManyHits.at(track->ID()));
+	  // read the hit data product here rather than from the parallel tasks
+	  if (!trackHits.back().empty()) trackHits.back().front().get();
+	}
+	std::vector<matchCand> const matches = t0Alg.GetClosestCRTHits(detProp, trackList, trackHits, crtHitIndex);
+
 	// Loop over all the reconstructed tracks 
 	for(size_t track_i = 0; track_i < trackList.size(); track_i++) {
 
@@ -324,11 +337,11 @@ namespace icarus {
 	    }
 	  }
 
-	  std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(trackList[track_i]->ID());
+	  std::vector<art::Ptr<recob::Hit>> const& hits = trackHits[track_i];
 	  if (hits.size() == 0) continue;
 	  int const cryoNumber = hits[0]->WireID().Cryostat;
 	  // std::pair<double, double> matchedTime = t0Alg.T0AndDCAFromCRTHits(detProp, *trackList[track_i], crtHits, event);
-	  matchCand closest = t0Alg.GetClosestCRTHit(detProp, *trackList[track_i], hits, crtHits,  m_gate_start_timestamp, true);
+	  matchCand const& closest = matches[track_i];
 	  // std::vector <matchCand> closestvec = t0Alg.GetClosestCRTHit(detProp, *trackList[track_i], crtHits, event);
 	  // matchCand closest = closestvec.back();	  
 
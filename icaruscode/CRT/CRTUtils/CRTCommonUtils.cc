@@ -3,6 +3,7 @@
 
 #include "icaruscode/CRT/CRTUtils/CRTCommonUtils.h"
 #include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
+#include <algorithm>
 #include <fstream>
 
 using namespace icarus::crt;
@@ -12,6 +13,41 @@ CRTCommonUtils::CRTCommonUtils() {
   fGeoService  = lar::providerFrom<geo::Geometry>();
   FillFebMap();
   FillAuxDetMaps();
+  FillChannelTables();
+}
+
+//------------------------------------------------------------------------------------
+CRTCommonUtils::FebInfo_t const& CRTCommonUtils::FebInfo(uint8_t mac) const {
+    FebInfo_t const* info = FindFebInfo(mac);
+    if(!info) {
+        throw cet::exception("CRTCommonUtils::FebInfo")
+          << "unknown mac " << (int)mac << " passed to function";
+    }
+    return *info;
+}
+
+//------------------------------------------------------------------------------------
+CRTCommonUtils::ChannelInfo_t const& CRTCommonUtils::ChannelInfo(uint8_t mac, int chan) const {
+    ChannelInfo_t const* info = FindChannelInfo(mac, chan);
+    if(!info) {
+        throw cet::exception("CRTCommonUtils::ChannelInfo")
+          << "unknown channel " << chan << " of mac " << (int)mac << " passed to function";
+    }
+    return *info;
+}
+
+//------------------------------------------------------------------------------------
+CRTCommonUtils::FebInfo_t const* CRTCommonUtils::FindFebInfo(uint8_t mac) const {
+    if(mac >= fFebInfo.size() || !fFebInfo[mac].valid) return nullptr;
+    return &fFebInfo[mac];
+}
+
+//------------------------------------------------------------------------------------
+CRTCommonUtils::ChannelInfo_t const* CRTCommonUtils::FindChannelInfo(uint8_t mac, int chan) const {
+    if(chan < 0 || chan >= MaxFebChannels) return nullptr;
+    size_t const index = mac * MaxFebChannels + chan;
+    if(index >= fChannelInfo.size() || !fChannelInfo[index].valid) return nullptr;
+    return &fChannelInfo[index];
 }
 
 //given an AuxDetGeo object, returns name of the CRT subsystem to which it belongs
@@ -209,6 +245,8 @@ int CRTCommonUtils::MacToTypeCode(uint8_t mac)
 //--------------------------------------------------------------------------------------
 
 int CRTCommonUtils::ChannelToAuxDetSensitiveID(uint8_t mac, int chan) {
+  if (ChannelInfo_t const* info = FindChannelInfo(mac, chan)) return info->adsid;
+
   char type = MacToType(mac);
   if (type=='d') return chan;
   if (type=='c') return chan/2;
@@ -221,6 +259,8 @@ int CRTCommonUtils::ChannelToAuxDetSensitiveID(uint8_t mac, int chan) {
 
 size_t CRTCommonUtils::MacToAuxDetID(uint8_t mac, int chan)
 {
+    if (ChannelInfo_t const* info = FindChannelInfo(mac, chan)) return info->adid;
+
     char type = MacToType(mac);
     int pos=1;
     
@@ -430,6 +470,9 @@ int CRTCommonUtils::GetLayerID(const art::Ptr<sim::AuxDetSimChannel> adsc){
 
 //--------------------------------------------------------------------------------------------------
 int CRTCommonUtils::GetMINOSLayerID(size_t adid) {
+    auto const itLayer = fAuxDetIdToMINOSLayer.find(adid);
+    if(itLayer != fAuxDetIdToMINOSLayer.end()) return itLayer->second;
+
     int layer = -1;
 
     int region = AuxDetRegionNameToNum(GetAuxDetRegion(adid));
@@ -479,6 +522,8 @@ int CRTCommonUtils::GetMINOSLayerID(size_t adid) {
         mf::LogError("CRTCommonUtils::GetMINOSLayerID")
            << "layer ID not set!";
 
+    // the geometry navigation above is slow: remember the answer
+    fAuxDetIdToMINOSLayer[adid] = layer;
     return layer;
 
 
@@ -488,6 +533,9 @@ int CRTCommonUtils::GetMINOSLayerID(size_t adid) {
 // given mac address and mac channel, return CRT strip center in module coordinates (w.r.t. module center)
 TVector3 CRTCommonUtils::ChanToLocalCoords(uint8_t mac, int chan) {
 
+    if (ChannelInfo_t const* info = FindChannelInfo(mac, chan))
+        return TVector3(info->localPos.X(),info->localPos.Y(),info->localPos.Z());
+
     TVector3 coords(0.,0.,0.);
     size_t adid  = MacToAuxDetID(mac,chan); //CRT module ID
     auto const& adGeo = fGeoService->AuxDet(adid); //CRT module
@@ -505,6 +553,9 @@ TVector3 CRTCommonUtils::ChanToLocalCoords(uint8_t mac, int chan) {
 // given mac address and mac channel, return CRT strip center in World coordinates (w.r.t. LAr active volume center)
 TVector3 CRTCommonUtils::ChanToWorldCoords(uint8_t mac, int chan) {
 
+    if (ChannelInfo_t const* info = FindChannelInfo(mac, chan))
+        return TVector3(info->worldPos.X(),info->worldPos.Y(),info->worldPos.Z());
+
     TVector3 coords(0.,0.,0.);
     int adid  = MacToAuxDetID(mac,chan); //CRT module ID
     auto const& adGeo = fGeoService->AuxDet(adid); //CRT module
@@ -594,6 +645,54 @@ void CRTCommonUtils::FillAuxDetMaps() {
 
 }
 
+//------------------------------------------------------------------------
+//fills the flat mac5 x channel tables used in the hit reconstruction,
+// with the same answers as MacToAuxDetID(), ChannelToAuxDetSensitiveID(),
+// ChanToLocalCoords() and ChanToWorldCoords(); channels for which those
+// functions would throw are left invalid
+void CRTCommonUtils::FillChannelTables() {
+
+    fFebInfo.assign(256, FebInfo_t{});
+    size_t const nMacs = fFebToAuxDetId.empty()? 0: fFebToAuxDetId.rbegin()->first + 1;
+    fChannelInfo.assign(nMacs * MaxFebChannels, ChannelInfo_t{});
+
+    for(auto const& feb : fFebToAuxDetId) {
+        uint8_t const mac = feb.first;
+        char const type = MacToType(mac);
+        int const nChannels = (type=='d')? 64: 32;
+
+        for(int chan = 0; chan < nChannels; ++chan) {
+            int const pos = (type=='m')? chan/10 + 1: 1;
+            auto const itAD = std::find_if(feb.second.begin(), feb.second.end(),
+              [this,pos](size_t adid){ return fAuxDetIdToChanGroup.at(adid)==pos; });
+            if(itAD == feb.second.end()) continue;
+
+            auto const& adGeo = fGeoService->AuxDet(*itAD);
+            int const adsid = ChannelToAuxDetSensitiveID(mac,chan);
+            if(adsid < 0 || (size_t)adsid >= adGeo.NSensitiveVolume()) continue;
+            auto const& adsGeo = adGeo.SensitiveVolume(adsid);
+
+            ChannelInfo_t& info = fChannelInfo[mac * MaxFebChannels + chan];
+            info.adid = *itAD;
+            info.adsid = adsid;
+            info.worldPos = adsGeo.GetCenter();
+            info.localPos = adGeo.toLocalCoords(info.worldPos);
+            info.valid = true;
+        }
+
+        ChannelInfo_t const* chan0 = FindChannelInfo(mac,0);
+        if(!chan0) continue;
+        FebInfo_t& info = fFebInfo[mac];
+        info.adid = chan0->adid;
+        info.type = GetAuxDetType(info.adid);
+        info.typeCode = GetAuxDetTypeCode(info.adid);
+        info.regionName = GetAuxDetRegion(info.adid);
+        info.region = AuxDetRegionNameToNum(info.regionName);
+        info.valid = true;
+    }
+
+}
+
 //--------------------------------------------------------------------
 string CRTCommonUtils::AuxDetNameToRegion(string name) {
 
@@ -42,8 +42,54 @@ namespace icarus{
 class icarus::crt::CRTCommonUtils {
 
  public:
+
+    /// Codes of the CRT regions (see `AuxDetRegionNameToNum()`).
+    enum RegionCode_t: int {
+        kTop        = 30,
+        kRimWest    = 31,
+        kRimEast    = 32,
+        kRimSouth   = 33,
+        kRimNorth   = 34,
+        kWestSouth  = 40,
+        kWestCenter = 41,
+        kWestNorth  = 42,
+        kEastSouth  = 43,
+        kEastCenter = 44,
+        kEastNorth  = 45,
+        kSouth      = 46,
+        kNorth      = 47,
+        kBottom     = 50
+    };
+
+    /// Geometry of a front-end board, from the module read by its channel 0.
+    struct FebInfo_t {
+        bool   valid    = false;
+        size_t adid     = 0;  ///< module ID, as `MacToAuxDetID(mac, 0)`
+        char   type     = 0;  ///< module type (`'c'`, `'m'` or `'d'`)
+        int    typeCode = -1; ///< module type code, as `GetAuxDetTypeCode()`
+        int    region   = -1; ///< region code, as `AuxDetRegionNameToNum()`
+        string regionName;    ///< region name, as `GetAuxDetRegion()`
+    };
+
+    /// Geometry of a front-end board channel.
+    struct ChannelInfo_t {
+        bool   valid = false;
+        size_t adid  = 0;  ///< module ID, as `MacToAuxDetID()`
+        int    adsid = -1; ///< strip ID, as `ChannelToAuxDetSensitiveID()`
+        geo::AuxDetGeo::LocalPoint_t localPos; ///< strip center in module frame
+        geo::Point_t worldPos;                 ///< strip center in world frame
+    };
+
+    /// Maximum number of channels of a front-end board.
+    static constexpr int MaxFebChannels = 64;
+
     CRTCommonUtils();
 
+    // Lookup tables filled from the geometry at construction;
+    // these throw cet::exception on unknown boards or channels.
+    FebInfo_t const&     FebInfo(uint8_t mac) const;
+    ChannelInfo_t const& ChannelInfo(uint8_t mac, int chan) const;
+
     int            GetAuxDetTypeCode(size_t adid);
     char           GetAuxDetType(size_t adid);
     string         GetAuxDetRegion(size_t adid);
@@ -91,9 +137,15 @@ class icarus::crt::CRTCommonUtils {
     map<size_t,string>          fAuxDetIdToRegion;
     map<string,size_t>          fNameToAuxDetId;
     map<size_t,int>             fAuxDetIdToChanGroup;
+    map<size_t,int>             fAuxDetIdToMINOSLayer;
+    vector<FebInfo_t>           fFebInfo;     // by mac5
+    vector<ChannelInfo_t>       fChannelInfo; // by mac5*MaxFebChannels+chan
 
     void   FillFebMap();
     void   FillAuxDetMaps();
+    void   FillChannelTables();
+    FebInfo_t const*     FindFebInfo(uint8_t mac) const;
+    ChannelInfo_t const* FindChannelInfo(uint8_t mac, int chan) const;
     string AuxDetNameToRegion(string name);
 
 };//CRTCommonUtils
@@ -52,8 +52,7 @@ vector<art::Ptr<CRTData>> CRTHitRecoAlg::PreselectCRTData(
 
   for (size_t febdat_i = 0; febdat_i < crtList.size(); febdat_i++) {
     uint8_t mac = crtList[febdat_i]->fMac5;
-    int adid = fCrtutils.MacToAuxDetID(mac, 0);
-    char type = fCrtutils.GetAuxDetType(adid);
+    char type = fCrtutils.FebInfo(mac).type;
 
     /// Looking for data within +/- 3ms within trigger time stamp
     /// Here t0 - trigger time -ve
@@ -112,8 +111,8 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
     mf::LogInfo("CRTHitRecoAlg: ")
         << "Found " << crtList.size() << " FEB events" << '\n';
 
-  map<string, int> regCounts;
-  std::set<string> regs;
+  map<int, int> regCounts;  // hits by region code
+  // keyed by region name, to process the regions in the same order as ever
   map<string, vector<size_t>> sideRegionToIndices;
 
   // sort by the time
@@ -130,10 +129,8 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
   
   for (size_t crtdat_i = 0; crtdat_i < crtList.size(); crtdat_i++) {
     uint8_t mac = crtList[crtdat_i]->fMac5;
-    int adid = fCrtutils.MacToAuxDetID(mac, 0);
-    char type = fCrtutils.GetAuxDetType(adid);
-    string region = fCrtutils.GetAuxDetRegion(adid);
-    
+    char type = fCrtutils.FebInfo(mac).type;
+
     // For the time being, Only Top CRT delays are loaded, nothing to do for
     // Side CRT yet
     if (type == 'c' && crtList[crtdat_i]->IsReference_TS1()) {
@@ -162,10 +159,8 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
   // loop over time-ordered CRTData
   for (size_t febdat_i = 0; febdat_i < crtList.size(); febdat_i++) {
     uint8_t mac = crtList[febdat_i]->fMac5;
-    int adid = fCrtutils.MacToAuxDetID(mac, 0);  // module ID
-
-    string region = fCrtutils.GetAuxDetRegion(adid);
-    char type = fCrtutils.GetAuxDetType(adid);
+    CRTCommonUtils::FebInfo_t const& febInfo = fCrtutils.FebInfo(mac);
+    char type = febInfo.type;
     CRTHit hit;
 
     dataIds.clear();
@@ -179,10 +174,7 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
       else {
         dataIds.push_back(febdat_i);
         returnHits.push_back(std::make_pair(hit, dataIds));
-        if ((regs.insert(region)).second)
-          regCounts[region] = 1;
-        else
-          regCounts[region]++;
+        regCounts[febInfo.region]++;
 
         nHitC++;
       }
@@ -196,16 +188,14 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
       else {
         dataIds.push_back(febdat_i);
         returnHits.push_back(std::make_pair(hit, dataIds));
-        if ((regs.insert(region)).second)
-          regCounts[region] = 1;
-        else
-          regCounts[region]++;
+        regCounts[febInfo.region]++;
 
         nHitD++;
       }
     }
 
-    if (type == 'm') sideRegionToIndices[region].push_back(febdat_i);
+    if (type == 'm')
+      sideRegionToIndices[febInfo.regionName].push_back(febdat_i);
 
   }  // End loop over time-ordered CRTData products
 
@@ -288,9 +278,6 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
             mf::LogInfo("CRTHitRecoAlg: ")
                 << "attempting to produce MINOS hit from " << coinData.size()
                 << " data products..." << '\n';
-          uint8_t imac = (int)crtList[indices[index_i]]->fMac5;
-          int adid = fCrtutils.MacToAuxDetID(imac, 0);
-          string region = fCrtutils.GetAuxDetRegion(adid);
           CRTHit hit = MakeSideHit(coinData, TriggerArray);  // using top CRT GT
 
           if (IsEmptyHit(hit)) {
@@ -301,11 +288,7 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
               mf::LogInfo("CRTHitRecoAlg: ") << "MINOS hit produced" << '\n';
 
             returnHits.push_back(std::make_pair(hit, dataIds));
-
-            if ((regs.insert(regIndices.first)).second)
-              regCounts[regIndices.first] = 1;
-            else
-              regCounts[regIndices.first]++;
+            regCounts[hit.plane]++;
 
             nHitM++;
           }
@@ -327,7 +310,7 @@ vector<pair<sbn::crt::CRTHit, vector<int>>> CRTHitRecoAlg::CreateCRTHits(
     auto cts = regCounts.begin();
     mf::LogInfo("CRT") << " CRT Hits by region" << '\n';
     while (cts != regCounts.end()) {
-      std::cout << "reg: " << (*cts).first
+      std::cout << "reg: " << fCrtutils.GetRegionNameFromNum((*cts).first)
 		<< " , hits: " << (*cts).second << '\n';
       cts++;
     }
@@ -342,8 +325,8 @@ sbn::crt::CRTHit CRTHitRecoAlg::FillCRTHit(
     float peshit, uint64_t time0, Long64_t time1, int plane, double x,
     double ex, double y, double ey, double z, double ez, string tagger) {
   CRTHit crtHit;
-  crtHit.feb_id = tfeb_id;
-  crtHit.pesmap = tpesmap;
+  crtHit.feb_id = std::move(tfeb_id);
+  crtHit.pesmap = std::move(tpesmap);
   crtHit.peshit = peshit;
   crtHit.ts0_s_corr = time0 / 1'000'000'000;
   crtHit.ts0_ns = time0 % 1'000'000'000;
@@ -360,16 +343,17 @@ sbn::crt::CRTHit CRTHitRecoAlg::FillCRTHit(
   crtHit.y_err = ey;
   crtHit.z_pos = z;
   crtHit.z_err = ez;
-  crtHit.tagger = tagger;
+  crtHit.tagger = std::move(tagger);
 
   return crtHit;
 
 }  // CRTHitRecoAlg::FillCRTHit()
 
 //------------------------------------------------------------------------------------------
-int64_t CRTHitRecoAlg::RegionDelay(std::string const& region) const {
+int64_t CRTHitRecoAlg::RegionDelay(int region) const {
   return fSiPMtoFEBdelay +
-         uint64_t(((region == "North" || region == "South") ? 200. : 400) *
+         uint64_t(((region == CRTCommonUtils::kNorth ||
+                    region == CRTCommonUtils::kSouth) ? 200. : 400) *
                   fPropDelay);
 }
 //------------------------------------------------------------------------------------------
@@ -379,15 +363,17 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeTopHit(
     ULong64_t GlobalTrigger[305]) {  // single GT: GlobalTrigger[305], 3
                                      // seperate GT: GlobalTrigger[232]
   uint8_t mac = data->fMac5;
-  if (fCrtutils.MacToType(mac) != 'c')
+  CRTCommonUtils::FebInfo_t const& febInfo = fCrtutils.FebInfo(mac);
+  if (febInfo.type != 'c')
     mf::LogError("CRTHitRecoAlg::MakeTopHit")
         << "CRTUtils returned wrong type!" << '\n';
 
   map<uint8_t, vector<pair<int, float>>> pesmap;
-  int adid = fCrtutils.MacToAuxDetID(mac, 0);          // module ID
+  vector<pair<int, float>>& pes = pesmap[mac];  // all channels are stored
+  pes.reserve(32);
+  int adid = febInfo.adid;                             // module ID
   auto const& adGeo = fGeometryService->AuxDet(adid);  // module
-  string region = fCrtutils.GetAuxDetRegion(adid);
-  int plane = fCrtutils.AuxDetRegionNameToNum(region);
+  int plane = febInfo.region;
   double hitpointerr[3];
   TVector3 hitpos(0., 0., 0.);
   float petot = 0., pemax = 0., pemaxx = 0., pemaxz = 0.;
@@ -407,7 +393,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeTopHit(
     nabove++;
     int adsid = fCrtutils.ChannelToAuxDetSensitiveID(mac, chan);
     petot += pe;
-    pesmap[mac].push_back(std::make_pair(chan, pe));
+    pes.push_back(std::make_pair(chan, pe));
 
     // TVector3 postmp = fCrtutils.ChanToLocalCoords(mac,chan);
     // strip along z-direction
@@ -497,9 +483,10 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeTopHit(
       data->IsReference_TS1() || data->IsReference_TS0())
     return FillCRTHit({}, {}, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, "");
 
-  CRTHit hit = FillCRTHit({mac}, pesmap, petot, thit, thit1, plane,
+  CRTHit hit = FillCRTHit({mac}, std::move(pesmap), petot, thit, thit1, plane,
                           hitpoint.X(), hitpointerr[0], hitpoint.Y(),
-                          hitpointerr[1], hitpoint.Z(), hitpointerr[2], region);
+                          hitpointerr[1], hitpoint.Z(), hitpointerr[2],
+                          febInfo.regionName);
 
   return hit;
 
@@ -508,11 +495,14 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeTopHit(
 //------------------------------------------------------------------------------------------
 sbn::crt::CRTHit CRTHitRecoAlg::MakeBottomHit(art::Ptr<CRTData> data) {
   uint8_t mac = data->fMac5;
+  CRTCommonUtils::FebInfo_t const& febInfo = fCrtutils.FebInfo(mac);
   map<uint8_t, vector<pair<int, float>>> pesmap;
-  int adid = fCrtutils.MacToAuxDetID(mac, 0);          // module ID
+  // the hit is discarded unless at least one channel is stored
+  vector<pair<int, float>>& pes = pesmap[mac];
+  pes.reserve(64);
+  int adid = febInfo.adid;                             // module ID
   auto const& adGeo = fGeometryService->AuxDet(adid);  // module
-  string region = fCrtutils.GetAuxDetRegion(adid);
-  int plane = fCrtutils.AuxDetRegionNameToNum(region);
+  int plane = febInfo.region;
   double hitpointerr[3];
   TVector3 hitpos(0., 0., 0.);
   float petot = 0., pemax = 0.;
@@ -524,11 +514,14 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeBottomHit(art::Ptr<CRTData> data) {
     float pe = (data->fAdc[chan] - fQPed) / fQSlope;
     if (pe <= fPEThresh) continue;
     nabove++;
-    int adsid = fCrtutils.ChannelToAuxDetSensitiveID(mac, chan);
+    CRTCommonUtils::ChannelInfo_t const& chanInfo =
+        fCrtutils.ChannelInfo(mac, chan);
+    int adsid = chanInfo.adsid;
     petot += pe;
-    pesmap[mac].push_back(std::make_pair(chan, pe));
+    pes.push_back(std::make_pair(chan, pe));
 
-    TVector3 postmp = fCrtutils.ChanToLocalCoords(mac, chan);
+    TVector3 postmp(chanInfo.localPos.X(), chanInfo.localPos.Y(),
+                    chanInfo.localPos.Z());
     // all strips along z-direction
     hitpos.SetX(pe * postmp.X() + hitpos.X());
     if (postmp.X() < xmin) xmin = postmp.X();
@@ -560,9 +553,10 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeBottomHit(art::Ptr<CRTData> data) {
   hitpointerr[1] = adGeo.HalfHeight();
   hitpointerr[2] = adsGeo.Length() / sqrt(12);
 
-  CRTHit hit = FillCRTHit({mac}, pesmap, petot, thit, thit1, plane, hitpoint.X(),
-                          hitpointerr[0], hitpoint.Y(), hitpointerr[1],
-                          hitpoint.Z(), hitpointerr[2], region);
+  CRTHit hit = FillCRTHit({mac}, std::move(pesmap), petot, thit, thit1, plane,
+                          hitpoint.X(), hitpointerr[0], hitpoint.Y(),
+                          hitpointerr[1], hitpoint.Z(), hitpointerr[2],
+                          febInfo.regionName);
 
   return hit;
 
@@ -587,10 +581,12 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   vector<info> informationA, informationB;
 
-  int adid = fCrtutils.MacToAuxDetID(coinData[0]->fMac5, 0);  // module ID
+  CRTCommonUtils::FebInfo_t const& febInfo =
+      fCrtutils.FebInfo(coinData[0]->fMac5);
+  int adid = febInfo.adid;                                    // module ID
   auto const& adGeo = fGeometryService->AuxDet(adid);         // module
-  string region = fCrtutils.GetAuxDetRegion(adid);            //region name
-  int plane = fCrtutils.AuxDetRegionNameToNum(region);        //region code (ranges from 30-50)
+  int const region = febInfo.region;  //region code (ranges from 30-50)
+  int plane = region;
   double hitpoint[3], hitpointerr[3];
   TVector3 hitpos(0., 0., 0.);
 
@@ -614,7 +610,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   // loop over coinData to group FEBs into inner or outer layers (febA or febB)
   for (auto const& data : coinData) {
-    if (adid == (int)fCrtutils.MacToAuxDetID((int)data->fMac5, 0)) {
+    if (adid == (int)fCrtutils.FebInfo(data->fMac5).adid) {
       febA.push_back(data->fMac5);
     } else {
       febB.push_back(data->fMac5);
@@ -629,7 +625,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
   for (auto const& data : coinData) {
     // if(!(region=="South")) continue;
     macs.push_back(data->fMac5);
-    adid = fCrtutils.MacToAuxDetID(macs.back(), 0);
+    adid = fCrtutils.FebInfo(macs.back()).adid;
 
     int layer = fCrtutils.GetMINOSLayerID(adid);
     layID.push_back(layer);
@@ -666,11 +662,13 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
                 << (int)data->fMac5 << ", " << chan << ", " << chg_cal.first
                 << ", " << chg_cal.second << "," << data->fAdc[chan] << ","
                 << pe << ")\n";
-          int adsidA = fCrtutils.ChannelToAuxDetSensitiveID(macs.back(), chan);
-          TVector3 postmp = fCrtutils.ChanToWorldCoords(macs.back(), chan);
+          CRTCommonUtils::ChannelInfo_t const& chanInfo =
+              fCrtutils.ChannelInfo(macs.back(), chan);
+          TVector3 postmp(chanInfo.worldPos.X(), chanInfo.worldPos.Y(),
+                          chanInfo.worldPos.Z());
 
           informationA.push_back(
-              {macs.back(), chan, data->fTs0, postmp, adsidA});
+              {macs.back(), chan, data->fTs0, postmp, chanInfo.adsid});
         }
 
         if (fVerbose)
@@ -692,11 +690,13 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
                 << (int)data->fMac5 << ", " << chan << ", " << chg_cal.first
                 << ", " << chg_cal.second << "," << data->fAdc[chan] << ","
                 << pe << ")\n";
-          int adsidB = fCrtutils.ChannelToAuxDetSensitiveID(macs.back(), chan);
-          TVector3 postmp = fCrtutils.ChanToWorldCoords(macs.back(), chan);
+          CRTCommonUtils::ChannelInfo_t const& chanInfo =
+              fCrtutils.ChannelInfo(macs.back(), chan);
+          TVector3 postmp(chanInfo.worldPos.X(), chanInfo.worldPos.Y(),
+                          chanInfo.worldPos.Z());
 
           informationB.push_back(
-              {macs.back(), chan, data->fTs0, postmp, adsidB});
+              {macs.back(), chan, data->fTs0, postmp, chanInfo.adsid});
         }
         if (fVerbose)
           mf::LogInfo("CRTHitRecoAlg: ")
@@ -719,6 +719,9 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
           << (int)macs.back() << "  with module number " << adid
           << ", no. of FEB " << '\n';
 
+    // created with the first channel above threshold
+    vector<pair<int, float>>* pes = nullptr;
+
     // loop over channels
     for (int chan = 0; chan < 32; chan++) {
       // std :: cout << "chan: ---------------- " << chan << " , "<<
@@ -734,11 +737,15 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
             << "\nfebC (mac5, channel, gain, pedestal, adc, pe) = ("
             << (int)data->fMac5 << ", " << chan << ", " << chg_cal.first << ", "
             << chg_cal.second << "," << data->fAdc[chan] << "," << pe << ")\n";
-      int adsid = fCrtutils.ChannelToAuxDetSensitiveID(macs.back(), chan);
+      CRTCommonUtils::ChannelInfo_t const& chanInfo =
+          fCrtutils.ChannelInfo(macs.back(), chan);
+      int adsid = chanInfo.adsid;
       petot += pe;
-      pesmap[macs.back()].push_back(std::make_pair(chan, pe));
+      if (!pes) pes = &pesmap[macs.back()];
+      pes->push_back(std::make_pair(chan, pe));
 
-      TVector3 postmp = fCrtutils.ChanToWorldCoords(macs.back(), chan);
+      TVector3 postmp(chanInfo.worldPos.X(), chanInfo.worldPos.Y(),
+                      chanInfo.worldPos.Z());
 
       if (fVerbose)
         mf::LogInfo("CRTHitRecoAlg: ")
@@ -751,7 +758,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
       // East/West Walls (all strips along z-direction) or
       // North/South inner walls (all strips along x-direction)
       // All the horizontal layers measure Y first,
-      if (!(region == "South" && layer == 1)) {
+      if (!(region == CRTCommonUtils::kSouth && layer == 1)) {
         // hitpos.SetY(pe*postmp.Y()+hitpos.Y());
         // southvertypos.SetX(pe*postmp.X()+southvertypos.X());
         hitpos.SetY(1.0 * postmp.Y() + hitpos.Y());
@@ -768,7 +775,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
         // pey += pe; // unused
         if (postmp.Y() < ymin) ymin = postmp.Y();
         if (postmp.Y() > ymax) ymax = postmp.Y();
-        if (region != "South") {  // region is E/W/N
+        if (region != CRTCommonUtils::kSouth) {  // region is E/W/N
           //    hitpos.SetX(pe*postmp.X()+hitpos.X());
           hitpos.SetX(1.0 * postmp.X() + hitpos.X());
           nx++;
@@ -801,7 +808,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
       hitpos.SetZ(1.0 * postmp.Z() + hitpos.Z());
       nz++;
       if (fVerbose) {
-        if (region == "South")
+        if (region == CRTCommonUtils::kSouth)
           mf::LogInfo("CRTHitRecoAlg: ")
               << " South wall z: \t"
               << " feb: " << (int)macs.back() << " ,chan : \t" << chan
@@ -843,12 +850,12 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
           << " ,corrected time: "
           << data->fTs0 - uint64_t(adsGeo.HalfLength() * fPropDelay) << '\n';
 
-    if (region == "South" && layer == 1) {
+    if (region == CRTCommonUtils::kSouth && layer == 1) {
       southt0_h = data->fTs0;
       if (fVerbose)
         mf::LogInfo("CRTHitRecoAlg: ")
             << "southt0_h : " << layer << "\t" << southt0_h << '\n';
-    } else if (region == "South" && layer != 1) {
+    } else if (region == CRTCommonUtils::kSouth && layer != 1) {
       southt0_v = data->fTs0;
       if (fVerbose)
         mf::LogInfo("CRTHitRecoAlg: ")
@@ -1020,8 +1027,8 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
   int crossfeb = std::abs(mac5_1 - mac5_2);
 
   // side crt and match the both layers
-  if (layer1 && layer2 && region != "South" &&
-      region != "North") {  //&& nx==4){
+  if (layer1 && layer2 && region != CRTCommonUtils::kSouth &&
+      region != CRTCommonUtils::kNorth) {  //&& nx==4){
     float avg = 0.5 * (posA.Z() + posB.Z());
     hitpos.SetZ(avg);
     hitpos.SetX(hitpos.X() * 1.0 / nx);
@@ -1036,8 +1043,8 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   } else if ((int)informationA.size() == 1 and
              (int) informationB.size() == 1 and
-             (crossfeb == 7 or crossfeb == 5) and region != "South" &&
-             region != "North") {
+             (crossfeb == 7 or crossfeb == 5) and region != CRTCommonUtils::kSouth &&
+             region != CRTCommonUtils::kNorth) {
     int z_pos = int64_t(t0_1 - t0_2) / (uint64_t(2 * fPropDelay));
     crossfebpos = center + geo::Zaxis() * z_pos;
 
@@ -1050,7 +1057,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
       mf::LogInfo("CRTHitRecoAlg: ")
           << "hello hi namaskar,  hitpos z " << hitpos[2] << '\n';
     // side crt and only single layer match
-  } else if (layer1 && region != "South" && region != "North") {  // && nx==1){
+  } else if (layer1 && region != CRTCommonUtils::kSouth && region != CRTCommonUtils::kNorth) {  // && nx==1){
     hitpos.SetZ(posA.Z());
     hitpos.SetX(hitpos.X() * 1.0 / nx);
     hitpos.SetY(hitpos.Y() * 1.0 / nx);
@@ -1062,7 +1069,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
           << " ,hitpos z " << hitpos[2] << '\n';
 
     // side crt and only single layer match
-  } else if (layer2 && region != "South" && region != "North") {  //&& nx==1){
+  } else if (layer2 && region != CRTCommonUtils::kSouth && region != CRTCommonUtils::kNorth) {  //&& nx==1){
     hitpos.SetZ(posB.Z());
     hitpos.SetX(hitpos.X() * 1.0 / nx);
     hitpos.SetY(hitpos.Y() * 1.0 / nx);
@@ -1073,7 +1080,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
           << " same layer coincidence: z position in layer 2 " << posB.Z()
           << " ,hitpos z " << hitpos[2] << '\n';
 
-  } else if (region != "South" && region != "North") {  //&& nx==2){
+  } else if (region != CRTCommonUtils::kSouth && region != CRTCommonUtils::kNorth) {  //&& nx==2){
     hitpos *= 1.0 / nx;
     // hitpos.SetX(hitpos.X()*1.0/petot);
     // hitpos.SetY(hitpos.Y()*1.0/petot);
@@ -1089,7 +1096,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
    }*/
 
   // finish averaging and fill hit point array
-  if (region == "South") {
+  if (region == CRTCommonUtils::kSouth) {
     /*
     hitpos.SetX(hitpos.X()*1.0/pex);
     hitpos.SetZ(hitpos.Z()*1.0/petot);
@@ -1102,7 +1109,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
     // }else
     // hitpos*=1.0/petot; //hit position weighted by deposited charge
 
-  } else if (region == "North") {
+  } else if (region == CRTCommonUtils::kNorth) {
     // hitpos*=1.0/petot;
     hitpos *= 1.0 / nz;
 
@@ -1119,7 +1126,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
   hitpoint[1] = hitpos.Y();
   hitpoint[2] = hitpos.Z();
 
-  if (region == "South" && hitpoint[0] >= 366. && hitpoint[1] > 200. &&
+  if (region == CRTCommonUtils::kSouth && hitpoint[0] >= 366. && hitpoint[1] > 200. &&
       fVerbose)
     mf::LogInfo("CRTHitRecoAlg: ")
         << "I am looking for south wall :   macs " << (int)macs.back()
@@ -1127,7 +1134,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
         << hitpoint[2] << '\n';
 
   if (fVerbose) {
-    if (region == "North")
+    if (region == CRTCommonUtils::kNorth)
       mf::LogInfo("CRTHitRecoAlg: ")
           << "north wall x: \t" << hitpoint[0] << " ,y: \t" << hitpoint[1]
           << " ,z: \t" << hitpoint[2] << '\n';
@@ -1180,7 +1187,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   t1hit = t1hit / uint64_t(t1trigs.size());
 
-  if (region == "South" && fVerbose)
+  if (region == CRTCommonUtils::kSouth && fVerbose)
     mf::LogInfo("CRTHitRecoAlg: ")
         << "..................... Hello ....Welcome to Beam............"
         << '\n';
@@ -1189,7 +1196,7 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
         << " <time>: T0: \t" << thit << " T1 : " << t1hit << " size ttrig: \t"
         << ttrigs.size() << '\n';
 
-  if (region == "South" && fVerbose)
+  if (region == CRTCommonUtils::kSouth && fVerbose)
     mf::LogInfo("CRTHitRecoAlg: ")
         << "southt0_h: " << southt0_h << " ,southt0_v : " << southt0_v
         << " ,deltaT: \t" << int64_t(southt0_h - southt0_v) << '\n';
@@ -1199,20 +1206,20 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
 
   // error estimates (likely need to be revisted)
   auto const& adsGeo = adGeo.SensitiveVolume(adsid_max);
-  if (region != "North" && region != "South") {
+  if (region != CRTCommonUtils::kNorth && region != CRTCommonUtils::kSouth) {
     hitpointerr[0] = (xmax - xmin) / sqrt(12);
     hitpointerr[1] = (ymax - ymin) / sqrt(12);
     hitpointerr[2] = (zmax - zmin) / sqrt(12);
     //      hitpointerr[2] = adsGeo.Length()/sqrt(12);
   }
 
-  if (region == "North") {
+  if (region == CRTCommonUtils::kNorth) {
     hitpointerr[0] = (xmax - xmin) / sqrt(12);
     hitpointerr[1] = (ymax - ymin) / sqrt(12);
     hitpointerr[2] = (zmax - zmin) / sqrt(12);
   }
 
-  if (region == "South") {
+  if (region == CRTCommonUtils::kSouth) {
     hitpointerr[0] = adsGeo.HalfWidth1() * 2 / sqrt(12);
     hitpointerr[1] = adsGeo.HalfWidth1() * 2 / sqrt(12);
     hitpointerr[2] = (zmax - zmin) / sqrt(12);
@@ -1224,9 +1231,10 @@ sbn::crt::CRTHit CRTHitRecoAlg::MakeSideHit(
   else thit1 = thit - fGlobalT0Offset;
 
   // generate hit
-  CRTHit hit = FillCRTHit(macs, pesmap, petot, thit, thit1, plane, hitpoint[0],
-                          hitpointerr[0], hitpoint[1], hitpointerr[1],
-                          hitpoint[2], hitpointerr[2], region);
+  CRTHit hit = FillCRTHit(std::move(macs), std::move(pesmap), petot, thit,
+                          thit1, plane, hitpoint[0], hitpointerr[0],
+                          hitpoint[1], hitpointerr[1], hitpoint[2],
+                          hitpointerr[2], febInfo.regionName);
 
   return hit;
 }
@@ -133,8 +133,8 @@ class icarus::crt::CRTHitRecoAlg {
   // Check if a hit is empty
   bool IsEmptyHit(CRTHit hit);
   // function to appply appropriate prop delay for Side full vs cut modules
-  // (North and South walls are cut modules)
-  int64_t RegionDelay(std::string const& region) const;
+  // (North and South walls are cut modules); takes the region code
+  int64_t RegionDelay(int region) const;
 
   std::map<uint8_t, int32_t> FEB_T1delay_side;  //<mac5, delay in ns>
   std::map<uint8_t, int32_t> FEB_T0delay_side;  //<mac5, delay in ns>
@@ -1,6 +1,10 @@
 #include "CRTT0MatchAlg.h"
 #include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
 
+#include "tbb/parallel_for.h"
+
+#include <algorithm> // std::sort(), std::lower_bound(), std::upper_bound()
+
 namespace icarus{
 
 
@@ -27,6 +31,7 @@ namespace icarus{
     fDoverLLimit        = pset.get<double>("DoverLLimit", 1);
     fPEcut              = pset.get<double>("PEcut", 0.0);
     fMaxUncert          = pset.get<double>("MaxUncert", 1000.);
+    fRegionMargin       = pset.get<double>("RegionMargin", -1.);
     fTPCTrackLabel      = pset.get<std::vector<art::InputTag> >("TPCTrackLabel", {""});
     //  fDistEndpointAVedge = pset.get<double>(.DistEndpointAVedge();
 
@@ -328,6 +333,7 @@ namespace icarus{
 										 const art::Event& event, uint64_t trigger_timestamp) const{
     //    matchCand newmc = makeNULLmc();
     std::vector<std::pair<sbn::crt::CRTHit, double> > crthitpair;
+    CRTHitIndex const crtHitIndex = MakeCRTHitIndex(crtHits, trigger_timestamp, false);
     
     for(const auto& trackLabel : fTPCTrackLabel){
       auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(trackLabel);
@@ -337,7 +343,8 @@ namespace icarus{
       for (auto const& tpcTrack : (*tpcTrackHandle)){
 	std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
 	
-	crthitpair.push_back(ClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp));
+	matchCand bestmatch = GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex);
+	crthitpair.push_back(std::make_pair(bestmatch.thishit, bestmatch.dca));
 	//	return ClosestCRTHit(detProp, tpcTrack, hits, crtHits);
       }
     }
@@ -401,6 +408,7 @@ namespace icarus{
 							 const art::Event& event, uint64_t trigger_timestamp) const{
     //    matchCand nullmatch = makeNULLmc();
     std::vector<matchCand> matchcanvec;
+    CRTHitIndex const crtHitIndex = MakeCRTHitIndex(crtHits, trigger_timestamp, false);
     //std::vector<std::pair<sbn::crt::CRTHit, double> > matchedCan;
     for(const auto& trackLabel : fTPCTrackLabel){
       auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(trackLabel);
@@ -409,7 +417,7 @@ namespace icarus{
       art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, trackLabel);
       for (auto const& tpcTrack : (*tpcTrackHandle)){
 	std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-        matchcanvec.push_back(GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp, false));
+        matchcanvec.push_back(GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex));
 	//return ClosestCRTHit(detProp, tpcTrack, hits, crtHits);
 	//matchCand closestHit = GetClosestCRTHit(detProp, tpcTrack, hits, crtHits);
 
@@ -430,33 +438,15 @@ namespace icarus{
 					    recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
 					    std::vector<sbn::crt::CRTHit> const& crtHits, int driftDirection, uint64_t& trigger_timestamp, bool IsData) const {
 
-    auto start = tpcTrack.Vertex();
-    auto end   = tpcTrack.End();
-
-    bool simple_cathode_crosscheck =( (std::abs(start.X()) < 210.215) != (std::abs(end.X()) < 210.215));
     // ====================== Matching Algorithm ========================== //
-    //  std::vector<std::pair<sbn::crt::CRTHit, double>> t0Candidates;
     std::vector<matchCand> t0Candidates;
 
-    //    if (crtHits.size() == 0) continue;
+    if (tpcTrack.Length() < fMinTrackLength) return BestMatch(t0Candidates);
+
     // Loop over all the CRT hits
     for(auto &crtHit : crtHits){
       // Check if hit is within the allowed t0 range
       double crtTime = GetCRTTime(crtHit,trigger_timestamp,IsData);  // units are us
-/*      
-     if(IsData){
-      if (fTSMode == 1) {
-	crtTime = ((double)(int)crtHit.ts1_ns) * 1e-3; //+ fTimeCorrection;
-      }//end if (fTSMode == 1)
-      else {
-		crtTime = double(crtHit.ts0_ns - (trigger_timestamp%1'000'000'000))/1e3;
-		if(crtTime<-0.5e6) 	crtTime+=1e6;
-		else if(crtTime>=0.5e6) 	crtTime-=1e6;		
-      }//end else
-     }//end if(IsData)
-     else if(!IsData){	
-	crtTime = crtHit.ts0_ns/1e3;
-     }//end else if(!IsData)*/
       // If track is stitched then try all hits
       if (!((crtTime >= t0MinMax.first - 10. && crtTime <= t0MinMax.second + 10.) 
             || t0MinMax.first == t0MinMax.second)) continue;
@@ -466,86 +456,87 @@ namespace icarus{
       if (crtHit.x_err>fMaxUncert) continue;
       if (crtHit.y_err>fMaxUncert) continue;
       if (crtHit.z_err>fMaxUncert) continue;
-      if (tpcTrack.Length() < fMinTrackLength) continue;
 
-      geo::Point_t crtPoint(crtHit.x_pos, crtHit.y_pos, crtHit.z_pos);
+      matchCand newmc;
+      if (MatchCRTHit(detProp, tpcTrack, t0MinMax, crtHit, crtTime, driftDirection, newmc))
+	t0Candidates.push_back(newmc);
+    }//end loop over CRT Hits
 
-      //Calculate Track direction
-      std::pair<TVector3, TVector3> startEndDir;
-      // dirmethod=2 is original algorithm, dirmethod=1 is simple algorithm for which SCE corrections are possible
-      if (fDirMethod==2)  startEndDir = TrackDirectionAverage(tpcTrack, fTrackDirectionFrac);
-      else startEndDir = TrackDirection(detProp, tpcTrack, fTrackDirectionFrac, crtTime, driftDirection);
-      TVector3 startDir = startEndDir.first;
-      TVector3 endDir = startEndDir.second;
-    
-      // Calculate the distance between the crossing point and the CRT hit, SCE corrections are done inside but dropped
-      double startDist = DistOfClosestApproach(detProp, start, startDir, crtHit, driftDirection, crtTime);
-      double endDist = DistOfClosestApproach(detProp, end, endDir, crtHit, driftDirection, crtTime);
+    return BestMatch(t0Candidates);
 
-    
-      double xshift = driftDirection * crtTime * detProp.DriftVelocity();
-      auto thisstart = start; 
-      thisstart.SetX(start.X()+xshift);
-      auto thisend = end; 
-      thisend.SetX(end.X()+xshift);
-      // repeat SCE correction for endpoints
-      if (fSCE->EnableCalSpatialSCE() && fSCEposCorr) {
-//	geo::Point_t temppt = {thisstart.X(),thisstart.Y(),thisstart.Z()};
-	geo::TPCID tpcid = fGeometryService->PositionToTPCID(thisstart);
-//	geo::Vector_t  fPosOffsets = fSCE->GetCalPosOffsets(temppt,tpcid.TPC);
-	thisstart+= fSCE->GetCalPosOffsets(thisstart,tpcid.TPC);
-/*	thisstart[0] += fPosOffsets.X();
-	thisstart[1] += fPosOffsets.Y();
-	thisstart[2] += fPosOffsets.Z();*/
-//	temppt.SetX(thisend.X());
-//	temppt.SetY(thisend.Y());
-//	temppt.SetZ(thisend.Z());
-	tpcid = fGeometryService->PositionToTPCID(thisend);
-	thisend+= fSCE->GetCalPosOffsets(thisend,tpcid.TPC);
-/*	fPosOffsets = fSCE->GetCalPosOffsets(temppt,tpcid.TPC);
-	thisend[0] += fPosOffsets.X();
-	thisend[1] += fPosOffsets.Y();
-	thisend[2] += fPosOffsets.Z();*/
+  }//end function defn
 
-      }
-//      TVector3 thisstart_v(thisstart.X(),thisstart.Y(),thisstart.Z());
-//      TVector3 thisend_v(thisend.X(),thisend.Y(),thisend.Z());
 
+  bool CRTT0MatchAlg::MatchCRTHit(detinfo::DetectorPropertiesData const& detProp,
+				  recob::Track const& tpcTrack, std::pair<double, double> t0MinMax,
+				  sbn::crt::CRTHit const& crtHit, double crtTime, int driftDirection, matchCand& newmc) const {
 
-      matchCand newmc;// = makeNULLmc();
-      if (startDist<fDistanceLimit || endDist<fDistanceLimit) {
-	double distS = (crtPoint-thisstart).R();
-	double distE =  (crtPoint-thisend).R();
-	if (distS <= distE && startDist<fDistanceLimit){ 
-	  newmc.dca = startDist;
-	  newmc.extrapLen = distS;
-	  newmc.best_DCA_pos=0;
-	}//end if(distS < distE)
-	else if(distE<=distS && endDist<fDistanceLimit ){
-	  newmc.dca = endDist;
-	  newmc.extrapLen = distE;
-	  newmc.best_DCA_pos=1;
-	}//end else if(distE<=distS && endDist<fDistanceLimit )
-	else continue;
-	newmc.thishit = crtHit;
-	newmc.t0= crtTime;
-	newmc.simple_cathodecrosser = simple_cathode_crosscheck;
-	newmc.driftdir = driftDirection;
-	newmc.t0min = t0MinMax.first;
-	newmc.t0max = t0MinMax.second;
-	newmc.crtTime = crtTime;
-	newmc.startDir = startDir;
-	newmc.endDir = endDir;
-	newmc.tpc_track_start.SetXYZ(thisstart.X(),thisstart.Y(),thisstart.Z());
-	newmc.tpc_track_end.SetXYZ(thisend.X(),thisend.Y(),thisend.Z());
-	t0Candidates.push_back(newmc);
+    auto start = tpcTrack.Vertex();
+    auto end   = tpcTrack.End();
 
-      }//end if (startDist<fDistanceLimit || endDist<fDistanceLimit) 
-    }//end loop over CRT Hits
+    bool simple_cathode_crosscheck =( (std::abs(start.X()) < 210.215) != (std::abs(end.X()) < 210.215));
 
+    geo::Point_t crtPoint(crtHit.x_pos, crtHit.y_pos, crtHit.z_pos);
+
+    //Calculate Track direction
+    std::pair<TVector3, TVector3> startEndDir;
+    // dirmethod=2 is original algorithm, dirmethod=1 is simple algorithm for which SCE corrections are possible
+    if (fDirMethod==2)  startEndDir = TrackDirectionAverage(tpcTrack, fTrackDirectionFrac);
+    else startEndDir = TrackDirection(detProp, tpcTrack, fTrackDirectionFrac, crtTime, driftDirection);
+    TVector3 startDir = startEndDir.first;
+    TVector3 endDir = startEndDir.second;
+
+    // Calculate the distance between the crossing point and the CRT hit, SCE corrections are done inside but dropped
+    double startDist = DistOfClosestApproach(detProp, start, startDir, crtHit, driftDirection, crtTime);
+    double endDist = DistOfClosestApproach(detProp, end, endDir, crtHit, driftDirection, crtTime);
+
+    double xshift = driftDirection * crtTime * detProp.DriftVelocity();
+    auto thisstart = start; 
+    thisstart.SetX(start.X()+xshift);
+    auto thisend = end; 
+    thisend.SetX(end.X()+xshift);
+    // repeat SCE correction for endpoints
+    if (fSCE->EnableCalSpatialSCE() && fSCEposCorr) {
+      geo::TPCID tpcid = fGeometryService->PositionToTPCID(thisstart);
+      thisstart+= fSCE->GetCalPosOffsets(thisstart,tpcid.TPC);
+      tpcid = fGeometryService->PositionToTPCID(thisend);
+      thisend+= fSCE->GetCalPosOffsets(thisend,tpcid.TPC);
+    }
 
-      //std::cout << " found " << t0Candidates.size() << " candidates" << std::endl;
-    matchCand bestmatch;// = makeNULLmc();
+    if (!(startDist<fDistanceLimit || endDist<fDistanceLimit)) return false;
+
+    double distS = (crtPoint-thisstart).R();
+    double distE =  (crtPoint-thisend).R();
+    if (distS <= distE && startDist<fDistanceLimit){ 
+      newmc.dca = startDist;
+      newmc.extrapLen = distS;
+      newmc.best_DCA_pos=0;
+    }//end if(distS < distE)
+    else if(distE<=distS && endDist<fDistanceLimit ){
+      newmc.dca = endDist;
+      newmc.extrapLen = distE;
+      newmc.best_DCA_pos=1;
+    }//end else if(distE<=distS && endDist<fDistanceLimit )
+    else return false;
+    newmc.thishit = crtHit;
+    newmc.t0= crtTime;
+    newmc.simple_cathodecrosser = simple_cathode_crosscheck;
+    newmc.driftdir = driftDirection;
+    newmc.t0min = t0MinMax.first;
+    newmc.t0max = t0MinMax.second;
+    newmc.crtTime = crtTime;
+    newmc.startDir = startDir;
+    newmc.endDir = endDir;
+    newmc.tpc_track_start.SetXYZ(thisstart.X(),thisstart.Y(),thisstart.Z());
+    newmc.tpc_track_end.SetXYZ(thisend.X(),thisend.Y(),thisend.Z());
+    return true;
+
+  } // CRTT0MatchAlg::MatchCRTHit()
+
+
+  matchCand CRTT0MatchAlg::BestMatch(std::vector<matchCand> const& t0Candidates) const {
+
+    matchCand bestmatch;
     if(t0Candidates.size() > 0){
       // Find candidate with shortest DCA or DCA/L value
       bestmatch=t0Candidates[0];
@@ -565,24 +556,181 @@ namespace icarus{
       }//end else [use DCA for best match method]
     }//end if(t0Candidates.size() > 0)
 
-    //std::cout << "best match has dca of " << bestmatch.dca << std::endl;
     return bestmatch;
 
-  }//end function defn
+  } // CRTT0MatchAlg::BestMatch()
+
+
+  CRTHitIndex CRTT0MatchAlg::MakeCRTHitIndex(std::vector<sbn::crt::CRTHit> const& crtHits, uint64_t trigger_timestamp, bool IsData) const {
+
+    CRTHitIndex index;
+    index.crtHits = &crtHits;
+
+    // the cuts which do not depend on the track are applied here once
+    std::map<std::string, size_t> regionIndex;
+    std::vector<std::vector<std::pair<double, size_t>>> regionHits;
+    for(size_t hit_i = 0; hit_i < crtHits.size(); ++hit_i){
+      auto const& crtHit = crtHits[hit_i];
+      if (crtHit.peshit<fPEcut) continue;
+      if (crtHit.x_err>fMaxUncert) continue;
+      if (crtHit.y_err>fMaxUncert) continue;
+      if (crtHit.z_err>fMaxUncert) continue;
+
+      auto const [ it, newRegion ] = regionIndex.emplace(crtHit.tagger, index.regions.size());
+      if (newRegion) {
+	index.regions.emplace_back();
+	index.regions.back().tagger = crtHit.tagger;
+	regionHits.emplace_back();
+      }
+      auto& region = index.regions[it->second];
+      region.min.SetXYZ(std::min(region.min.X(), crtHit.x_pos - crtHit.x_err),
+			std::min(region.min.Y(), crtHit.y_pos - crtHit.y_err),
+			std::min(region.min.Z(), crtHit.z_pos - crtHit.z_err));
+      region.max.SetXYZ(std::max(region.max.X(), crtHit.x_pos + crtHit.x_err),
+			std::max(region.max.Y(), crtHit.y_pos + crtHit.y_err),
+			std::max(region.max.Z(), crtHit.z_pos + crtHit.z_err));
+      regionHits[it->second].emplace_back(GetCRTTime(crtHit, trigger_timestamp, IsData), hit_i);
+    }
+
+    for(size_t region_i = 0; region_i < index.regions.size(); ++region_i){
+      auto& hits = regionHits[region_i];
+      std::sort(hits.begin(), hits.end());
+      auto& region = index.regions[region_i];
+      region.times.reserve(hits.size());
+      region.hits.reserve(hits.size());
+      for(auto const& [ time, hit_i ] : hits){
+	region.times.push_back(time);
+	region.hits.push_back(hit_i);
+      }
+    }
+
+    return index;
+
+  } // CRTT0MatchAlg::MakeCRTHitIndex()
+
+
+  matchCand CRTT0MatchAlg::GetClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+					    recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+					    CRTHitIndex const& crtHitIndex) const {
+
+    auto start = tpcTrack.Vertex();
+    auto end   = tpcTrack.End();
+
+    // Get the drift direction from the TPC
+    int driftDirection = TPCGeoUtil::DriftDirectionFromHits(fGeometryService, hits);
+    std::pair<double, double> xLimits = TPCGeoUtil::XLimitsFromHits(fGeometryService, hits);
+    // Get the allowed t0 range
+    std::pair<double, double> t0MinMax = TrackT0Range(detProp, start.X(), end.X(), driftDirection, xLimits);
+
+    return GetClosestCRTHit(detProp, tpcTrack, t0MinMax, crtHitIndex, driftDirection);
+
+  }
+
+
+  matchCand CRTT0MatchAlg::GetClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+					    recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
+					    CRTHitIndex const& crtHitIndex, int driftDirection) const {
+
+    std::vector<matchCand> t0Candidates;
+
+    if (tpcTrack.Length() < fMinTrackLength) return BestMatch(t0Candidates);
+
+    // If track is stitched then try all hits
+    bool const allTimes = (t0MinMax.first == t0MinMax.second);
+    double const minTime = t0MinMax.first - 10.;
+    double const maxTime = t0MinMax.second + 10.;
+
+    // Geometric preselection of the regions: the track extrapolations are taken at the
+    // centre of the time window, and the x shift over the rest of the window is covered
+    // by stretching the region boxes; with an unbounded window and a drift shift, skip it
+    bool const checkRegions = (fRegionMargin >= 0.) && (!allTimes || driftDirection == 0);
+    std::pair<TVector3, TVector3> startEndDir;
+    double xShiftMin = 0.;
+    double xShiftMax = 0.;
+    if (checkRegions) {
+      double const midTime = allTimes? 0.: (minTime + maxTime) / 2.;
+      if (fDirMethod==2)  startEndDir = TrackDirectionAverage(tpcTrack, fTrackDirectionFrac);
+      else startEndDir = TrackDirection(detProp, tpcTrack, fTrackDirectionFrac, midTime, driftDirection);
+      if (!allTimes) {
+	double const shift1 = driftDirection * minTime * detProp.DriftVelocity();
+	double const shift2 = driftDirection * maxTime * detProp.DriftVelocity();
+	xShiftMin = std::min(shift1, shift2);
+	xShiftMax = std::max(shift1, shift2);
+      }
+    }
+
+    // Collect the hits in the time window of the reachable regions
+    std::vector<std::pair<size_t, double>> selected; // (hit index, time)
+    for(auto const& region : crtHitIndex.regions){
+      if (checkRegions
+	  && !RegionInReach(region, tpcTrack.Vertex(), startEndDir.first, xShiftMin, xShiftMax)
+	  && !RegionInReach(region, tpcTrack.End(), startEndDir.second, xShiftMin, xShiftMax)) continue;
+
+      auto const begin = allTimes? region.times.begin()
+	: std::lower_bound(region.times.begin(), region.times.end(), minTime);
+      auto const end = allTimes? region.times.end()
+	: std::upper_bound(begin, region.times.end(), maxTime);
+      for(auto it = begin; it != end; ++it)
+	selected.emplace_back(region.hits[it - region.times.begin()], *it);
+    }
+
+    // Check them in their original order, so that ties are resolved as in the loop over all hits
+    std::sort(selected.begin(), selected.end());
+    for(auto const& [ hit_i, crtTime ] : selected){
+      matchCand newmc;
+      if (MatchCRTHit(detProp, tpcTrack, t0MinMax, (*crtHitIndex.crtHits)[hit_i], crtTime, driftDirection, newmc))
+	t0Candidates.push_back(newmc);
+    }
+
+    return BestMatch(t0Candidates);
+
+  }
+
+
+  std::vector<matchCand> CRTT0MatchAlg::GetClosestCRTHits(detinfo::DetectorPropertiesData const& detProp,
+							  std::vector<art::Ptr<recob::Track>> const& tpcTracks,
+							  std::vector<std::vector<art::Ptr<recob::Hit>>> const& trackHits,
+							  CRTHitIndex const& crtHitIndex) const {
+
+    std::vector<matchCand> matches(tpcTracks.size());
+    tbb::parallel_for(size_t(0), tpcTracks.size(), [&](size_t track_i)
+      {
+	if (trackHits[track_i].empty()) return;
+	matches[track_i] = GetClosestCRTHit(detProp, *tpcTracks[track_i], trackHits[track_i], crtHitIndex);
+      });
+    return matches;
+
+  }
+
+
+  bool CRTT0MatchAlg::RegionInReach(CRTHitIndex::Region_t const& region, geo::Point_t const& trackPos, TVector3 const& trackDir,
+				    double xShiftMin, double xShiftMax) const {
+
+    // a line farther than this from the box can't be within DistanceLimit of any of its hits;
+    // the margin covers the changes of direction and position from the SCE corrections
+    double const reach = fDistanceLimit + fRegionMargin;
+    TVector3 const min(region.min.X() - xShiftMax - reach, region.min.Y() - reach, region.min.Z() - reach);
+    TVector3 const max(region.max.X() - xShiftMin + reach, region.max.Y() + reach, region.max.Z() + reach);
+    TVector3 const start(trackPos.X(), trackPos.Y(), trackPos.Z());
+    return CubeIntersection(min, max, start, start + trackDir).first.X() != -99999;
+
+  }
 
 
   std::vector<double> CRTT0MatchAlg::T0FromCRTHits(detinfo::DetectorPropertiesData const& detProp,
 						   recob::Track const& tpcTrack, std::vector<sbn::crt::CRTHit> const& crtHits, 
 						   const art::Event& event, uint64_t trigger_timestamp) const{
     std::vector<double> ftime;
+    CRTHitIndex const crtHitIndex = MakeCRTHitIndex(crtHits, trigger_timestamp, false);
     for(const auto& trackLabel : fTPCTrackLabel){
       auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(trackLabel);
       if (!tpcTrackHandle.isValid()) continue;
 
       art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, trackLabel);
       for (auto const& tpcTrack : (*tpcTrackHandle)){
+	if (tpcTrack.Length() < fMinTrackLength) { ftime.push_back(-99999); continue; }
 	std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-	ftime.push_back(T0FromCRTHits(detProp, tpcTrack, hits, crtHits, trigger_timestamp));
+	ftime.push_back(T0FromMatch(GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex)));
 	// return T0FromCRTHits(detProp, tpcTrack, hits, crtHits);
       }
     }
@@ -602,7 +750,12 @@ namespace icarus{
 
     if (tpcTrack.Length() < fMinTrackLength) return -99999; 
 
-    matchCand closestHit = GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp, false);
+    return T0FromMatch(GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp, false));
+
+  }
+
+  double CRTT0MatchAlg::T0FromMatch(matchCand const& closestHit) const{
+
     if(closestHit.dca <0) return -99999;
 
     double crtTime;
@@ -623,14 +776,16 @@ namespace icarus{
 									     const art::Event& event, uint64_t trigger_timestamp) const{ 
    
     std::vector<std::pair<double, double> > ft0anddca;
+    CRTHitIndex const crtHitIndex = MakeCRTHitIndex(crtHits, trigger_timestamp, false);
     for(const auto& trackLabel : fTPCTrackLabel){
       auto tpcTrackHandle = event.getValidHandle<std::vector<recob::Track>>(trackLabel);
       if (!tpcTrackHandle.isValid()) continue;
 
       art::FindManyP<recob::Hit> findManyHits(tpcTrackHandle, event, trackLabel);
       for (auto const& tpcTrack : (*tpcTrackHandle)){
+	if (tpcTrack.Length() < fMinTrackLength) { ft0anddca.push_back(std::make_pair(-9999., -9999.)); continue; }
 	std::vector<art::Ptr<recob::Hit>> hits = findManyHits.at(tpcTrack.ID());
-	ft0anddca.push_back(T0AndDCAFromCRTHits(detProp, tpcTrack, hits, crtHits, trigger_timestamp));
+	ft0anddca.push_back(T0AndDCAFromMatch(GetClosestCRTHit(detProp, tpcTrack, hits, crtHitIndex)));
 	//        return T0AndDCAFromCRTHits(detProp, tpcTrack, hits, crtHits);
       }
     }
@@ -649,7 +804,11 @@ namespace icarus{
 
     if (tpcTrack.Length() < fMinTrackLength) return std::make_pair(-9999., -9999.);
 
-    matchCand closestHit = GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp, false);
+    return T0AndDCAFromMatch(GetClosestCRTHit(detProp, tpcTrack, hits, crtHits, trigger_timestamp, false));
+
+  }
+
+  std::pair<double, double> CRTT0MatchAlg::T0AndDCAFromMatch(matchCand const& closestHit) const{
 
     if(closestHit.dca < 0 ) return std::make_pair(-9999., -9999.);
     if (closestHit.dca < fDistanceLimit && (closestHit.dca/closestHit.extrapLen) < fDoverLLimit) return std::make_pair(closestHit.t0, closestHit.dca);
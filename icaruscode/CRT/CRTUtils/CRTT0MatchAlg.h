@@ -54,6 +54,8 @@
 #include <utility>
 #include <cmath> 
 #include <memory>
+#include <string>
+#include <cfloat> // DBL_MAX
 
 // ROOT
 #include "TVector3.h"
@@ -109,6 +111,23 @@ namespace icarus{
     double simpleDCA_endDir = DBL_MIN;
   };
 
+  // CRT hits of an event, sorted by time and grouped by CRT region (tagger).
+  // Built once per event with CRTT0MatchAlg::MakeCRTHitIndex(), it lets the
+  // matching of each track visit only the hits in its allowed time window and
+  // in the regions its extrapolations can reach. It refers to the original
+  // hit collection, which must outlive it.
+  struct CRTHitIndex {
+    struct Region_t {
+      std::string tagger;
+      std::vector<double> times;      // hit times [us], sorted
+      std::vector<size_t> hits;       // index of each hit in crtHits
+      TVector3 min{DBL_MAX,DBL_MAX,DBL_MAX};    // bounding box of the hits,
+      TVector3 max{-DBL_MAX,-DBL_MAX,-DBL_MAX}; // including their uncertainties
+    };
+    std::vector<sbn::crt::CRTHit> const* crtHits = nullptr;
+    std::vector<Region_t> regions;    // only hits passing the PE and uncertainty cuts
+  };
+
 
 
   class CRTT0MatchAlg {
@@ -208,8 +227,43 @@ namespace icarus{
 
     double GetCRTTime(sbn::crt::CRTHit const& crthit, uint64_t trigger_timestamp, bool isdata) const;
 
+    // Index the CRT hits of an event for the matching functions below
+    CRTHitIndex MakeCRTHitIndex(std::vector<sbn::crt::CRTHit> const& crtHits, uint64_t trigger_timestamp, bool IsData) const;
+
+    // Same as the GetClosestCRTHit above, using only the hits of the index in reach of the track
+    matchCand GetClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+			       recob::Track const& tpcTrack, std::vector<art::Ptr<recob::Hit>> const& hits, 
+			       CRTHitIndex const& crtHitIndex) const;
+
+    matchCand GetClosestCRTHit(detinfo::DetectorPropertiesData const& detProp,
+			       recob::Track const& tpcTrack, std::pair<double, double> t0MinMax, 
+			       CRTHitIndex const& crtHitIndex, int driftDirection) const;
+
+    // Match all the tracks in parallel; tracks without hits get a default matchCand
+    std::vector<matchCand> GetClosestCRTHits(detinfo::DetectorPropertiesData const& detProp,
+					     std::vector<art::Ptr<recob::Track>> const& tpcTracks,
+					     std::vector<std::vector<art::Ptr<recob::Hit>>> const& trackHits,
+					     CRTHitIndex const& crtHitIndex) const;
+
   private:
 
+    // Fill the match candidate if the CRT hit (at crtTime) is close enough to the track
+    bool MatchCRTHit(detinfo::DetectorPropertiesData const& detProp,
+		     recob::Track const& tpcTrack, std::pair<double, double> t0MinMax,
+		     sbn::crt::CRTHit const& crtHit, double crtTime, int driftDirection, matchCand& newmc) const;
+
+    // Candidate with the shortest DCA (or DCA/L); ties go to the first candidate
+    matchCand BestMatch(std::vector<matchCand> const& t0Candidates) const;
+
+    // Whether the line from trackPos along trackDir, shifted in x by any amount between
+    // xShiftMin and xShiftMax, passes within DistanceLimit + RegionMargin of the region
+    bool RegionInReach(CRTHitIndex::Region_t const& region, geo::Point_t const& trackPos, TVector3 const& trackDir,
+		       double xShiftMin, double xShiftMax) const;
+
+    // Results of T0FromCRTHits and T0AndDCAFromCRTHits from the closest hit
+    double T0FromMatch(matchCand const& closestHit) const;
+    std::pair<double, double> T0AndDCAFromMatch(matchCand const& closestHit) const;
+
     geo::GeometryCore const* fGeometryService;
     spacecharge::SpaceCharge  const* fSCE;
 
@@ -225,6 +279,7 @@ namespace icarus{
     double fDoverLLimit;
     double fPEcut;
     double fMaxUncert;
+    double fRegionMargin;
     //    double fDistEndpointAVedge;
     std::vector<art::InputTag> fTPCTrackLabel;
 //    bool IsData;
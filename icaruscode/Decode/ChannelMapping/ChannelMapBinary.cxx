@@ -0,0 +1,183 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ChannelMapBinary.cxx
+ * @brief  Channel mapping backend reading a binary export of the database.
+ * @see    icaruscode/Decode/ChannelMapping/ChannelMapBinary.h
+ */
+
+// library header
+#include "icaruscode/Decode/ChannelMapping/ChannelMapBinary.h"
+
+// framework libraries
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "cetlib_except/exception.h"
+#include "cetlib/search_path.h"
+
+// POSIX
+#include <fcntl.h> // open()
+#include <sys/mman.h> // mmap(), munmap()
+#include <sys/stat.h> // fstat()
+#include <unistd.h> // close()
+
+// C++ standard libraries
+#include <cerrno>
+#include <cstring> // std::strerror()
+
+
+// -----------------------------------------------------------------------------
+icarusDB::ChannelMapBinary::ChannelMapBinary(Config const& config)
+  : icarus::ns::util::mfLoggingClass{ config.LogCategory() }
+  , fFileName{ config.FileName() }
+{
+
+  std::string fullFileName;
+  cet::search_path searchPath("FW_SEARCH_PATH");
+  if (!searchPath.find_file(fFileName, fullFileName)) {
+    throw cet::exception{ "ChannelMapBinary" }
+      << "Can't find the binary channel mapping file: '" << fFileName << "'\n";
+  }
+  mfLogDebug() << "Binary channel mapping file: '" << fullFileName << "'.";
+
+  mapFile(fullFileName);
+
+  try {
+    fReader.emplace(fMapAddress, fMapSize);
+    if (fReader->nPeriods() != RunPeriods::NPeriods) {
+      throw cet::exception{ "ChannelMapBinary" }
+        << "Binary channel mapping file '" << fullFileName << "' has "
+        << fReader->nPeriods() << " run periods, while " << RunPeriods::NPeriods
+        << " are supported: it needs to be regenerated.\n";
+    }
+  }
+  catch (...) {
+    munmap(fMapAddress, fMapSize); // destructor is not called
+    throw;
+  }
+
+} // icarusDB::ChannelMapBinary::ChannelMapBinary()
+
+
+// -----------------------------------------------------------------------------
+icarusDB::ChannelMapBinary::~ChannelMapBinary() {
+  fReader.reset();
+  if (fMapAddress) munmap(fMapAddress, fMapSize);
+}
+
+
+// -----------------------------------------------------------------------------
+bool icarusDB::ChannelMapBinary::SelectPeriod(RunPeriod period) {
+
+  auto const iPeriod = static_cast<std::size_t>(period);
+  if (iPeriod >= RunPeriods::NPeriods) {
+    throw cet::exception{ "ChannelMapBinary" }
+      << "SelectPeriod(): invalid period #" << iPeriod << "\n";
+  }
+
+  if (fCurrentPeriod == iPeriod) {
+    mfLogDebug() << "Period #" << iPeriod << " already selected";
+    return false;
+  }
+
+  mfLogDebug() << "Switching to period #" << iPeriod;
+  fCurrentPeriod = iPeriod;
+  return true;
+
+} // icarusDB::ChannelMapBinary::SelectPeriod()
+
+
+// -----------------------------------------------------------------------------
+int icarusDB::ChannelMapBinary::BuildTPCFragmentIDToReadoutIDMap
+  (TPCFragmentIDToReadoutIDMap& fragmentBoardMap) const
+{
+  return readTable(fragmentBoardMap);
+}
+
+
+// -----------------------------------------------------------------------------
+int icarusDB::ChannelMapBinary::BuildTPCReadoutBoardToChannelMap
+  (TPCReadoutBoardToChannelMap& rbChanMap) const
+{
+  return readTable(rbChanMap);
+}
+
+
+// -----------------------------------------------------------------------------
+int icarusDB::ChannelMapBinary::BuildPMTFragmentToDigitizerChannelMap
+  (PMTFragmentToDigitizerChannelMap& fragmentToDigitizerChannelMap) const
+{
+  return readTable(fragmentToDigitizerChannelMap);
+}
+
+
+// -----------------------------------------------------------------------------
+int icarusDB::ChannelMapBinary::BuildCRTChannelIDToHWtoSimMacAddressPairMap
+  (CRTChannelIDToHWtoSimMacAddressPairMap& crtChannelIDToHWtoSimMacAddressPairMap)
+  const
+{
+  return readTable(crtChannelIDToHWtoSimMacAddressPairMap);
+}
+
+
+// -----------------------------------------------------------------------------
+int icarusDB::ChannelMapBinary::BuildTopCRTHWtoSimMacAddressPairMap
+  (TopCRTHWtoSimMacAddressPairMap& topcrtHWtoSimMacAddressPairMap) const
+{
+  return readTable(topcrtHWtoSimMacAddressPairMap);
+}
+
+
+// -----------------------------------------------------------------------------
+int icarusDB::ChannelMapBinary::BuildSideCRTCalibrationMap
+  (SideCRTChannelToCalibrationMap& sideCRTChannelToCalibrationMap) const
+{
+  return readTable(sideCRTChannelToCalibrationMap);
+}
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapBinary::mapFile(std::string const& fileName) {
+
+  int const fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw cet::exception{ "ChannelMapBinary" }
+      << "Can't open '" << fileName << "': " << std::strerror(errno) << "\n";
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0) {
+    int const error = errno;
+    close(fd);
+    throw cet::exception{ "ChannelMapBinary" } << "Can't get the size of '"
+      << fileName << "': " << std::strerror(error) << "\n";
+  }
+  fMapSize = static_cast<std::size_t>(fileStat.st_size);
+
+  // shared read-only mapping: all processes on the node share the same pages
+  void* const address = mmap(nullptr, fMapSize, PROT_READ, MAP_SHARED, fd, 0);
+  int const error = errno;
+  close(fd); // the mapping stays valid after the file is closed
+  if (address == MAP_FAILED) {
+    fMapSize = 0;
+    throw cet::exception{ "ChannelMapBinary" } << "Can't map '" << fileName
+      << "' into memory: " << std::strerror(error) << "\n";
+  }
+  fMapAddress = address;
+
+} // icarusDB::ChannelMapBinary::mapFile()
+
+
+// -----------------------------------------------------------------------------
+template <typename Map>
+int icarusDB::ChannelMapBinary::readTable(Map& map) const {
+
+  if (fCurrentPeriod >= RunPeriods::NPeriods) {
+    mfLogError() << "No run period selected before reading the mapping.";
+    return 1;
+  }
+
+  fReader->read(fCurrentPeriod, map);
+  return 0;
+
+} // icarusDB::ChannelMapBinary::readTable()
+
+
+// -----------------------------------------------------------------------------
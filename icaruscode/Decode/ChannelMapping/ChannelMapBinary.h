@@ -0,0 +1,134 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ChannelMapBinary.h
+ * @brief  Channel mapping backend reading a binary export of the database.
+ * @see    icaruscode/Decode/ChannelMapping/ChannelMapBinary.cxx
+ */
+
+#ifndef ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPBINARY_H
+#define ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPBINARY_H
+
+#include "icaruscode/Decode/ChannelMapping/RunPeriods.h"
+#include "icaruscode/Decode/ChannelMapping/IChannelMapping.h"
+#include "icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.h"
+#include "icarusalg/Utilities/mfLoggingClass.h"
+
+#include "fhiclcpp/types/Atom.h"
+
+#include <optional>
+#include <string>
+#include <cstddef> // std::size_t
+
+
+namespace icarusDB { class ChannelMapBinary; };
+
+/**
+ * @brief Interface with a binary export of the ICARUS channel mapping.
+ *
+ * This interface fills "standard" data structures from a binary file written
+ * by `ChannelMapDumper` (see `icarusDB::ChannelMapBinaryFormat`), which holds
+ * the fully resolved mapping of all the run periods.
+ * The file is memory mapped read-only, so that many processes on the same node
+ * share the same physical copy of it, and no database is queried at all.
+ *
+ * These data structures are then managed by a ICARUS service provider
+ * (`icarusDB::IICARUSChannelMap`).
+ *
+ *
+ * Configuration parameters
+ * -------------------------
+ *
+ * * `FileName` (string, mandatory): name of the binary mapping file, searched
+ *     for in `FW_SEARCH_PATH`.
+ * * `LogCategory` (string, default: `ChannelMapBinary`): name of the streams
+ *     to send console messages to.
+ *
+ */
+class icarusDB::ChannelMapBinary
+  : public IChannelMapping, private icarus::ns::util::mfLoggingClass
+{
+
+    public:
+
+  struct Config {
+    using Name = fhicl::Name;
+    using Comment = fhicl::Comment;
+
+    fhicl::Atom<std::string> FileName {
+      Name{ "FileName" },
+      Comment{ "name of the binary channel mapping file" }
+      };
+
+    fhicl::Atom<std::string> LogCategory {
+      Name{ "LogCategory" },
+      Comment{ "name of the streams to send console messages to" },
+      "ChannelMapBinary" // default
+      };
+
+  }; // Config
+
+
+  explicit ChannelMapBinary(Config const& config);
+
+  /// Destructor: releases the memory mapping.
+  ~ChannelMapBinary();
+
+  // the memory mapping is owned, and can't be copied
+  ChannelMapBinary(ChannelMapBinary const&) = delete;
+  ChannelMapBinary& operator= (ChannelMapBinary const&) = delete;
+
+
+  /**
+   * @brief   Prepares the object for queries pertaining the specified period.
+   * @param   period the period to be prepared for
+   * @return  whether values cached from the previous period are invalidated
+   *
+   * Periods are defined in `icarusDB::RunPeriods` class.
+   */
+  virtual bool SelectPeriod(RunPeriod period) override;
+
+
+  virtual int BuildTPCFragmentIDToReadoutIDMap
+    (TPCFragmentIDToReadoutIDMap&) const override;
+
+  virtual int BuildTPCReadoutBoardToChannelMap
+    (TPCReadoutBoardToChannelMap&) const override;
+
+  virtual int BuildPMTFragmentToDigitizerChannelMap
+    (PMTFragmentToDigitizerChannelMap&) const override;
+
+
+  virtual int BuildCRTChannelIDToHWtoSimMacAddressPairMap
+    (CRTChannelIDToHWtoSimMacAddressPairMap&) const override;
+
+  virtual int BuildTopCRTHWtoSimMacAddressPairMap(TopCRTHWtoSimMacAddressPairMap&) const
+    override;
+
+  virtual int BuildSideCRTCalibrationMap(SideCRTChannelToCalibrationMap&) const
+    override;
+
+
+    private:
+
+  std::string const fFileName; ///< Name of the binary mapping file.
+
+  void* fMapAddress = nullptr; ///< Start of the memory mapping of the file.
+
+  std::size_t fMapSize = 0; ///< Size of the memory mapping of the file.
+
+  /// Decoder of the content of the mapped file.
+  std::optional<ChannelMapBinaryFormat::Reader> fReader;
+
+  /// The period being served (`RunPeriods::NPeriods` if none).
+  std::size_t fCurrentPeriod = RunPeriods::NPeriods;
+
+  /// Maps the file `fileName` into memory.
+  void mapFile(std::string const& fileName);
+
+  /// Reads the table into `map` for the current period.
+  template <typename Map>
+  int readTable(Map& map) const;
+
+}; // icarusDB::ChannelMapBinary
+
+
+#endif // ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPBINARY_H
@@ -0,0 +1,387 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.cxx
+ * @brief  Binary on-disk format of the fully resolved ICARUS channel mapping.
+ * @see    icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.h
+ */
+
+// library header
+#include "icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C++ standard libraries
+#include <algorithm> // std::equal()
+#include <string>
+#include <type_traits> // std::is_trivially_copyable_v
+#include <cstring> // std::memcpy()
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using namespace icarusDB::ChannelMapBinaryFormat;
+
+  cet::exception formatError()
+    { return cet::exception{ "ChannelMapBinaryFormat" }; }
+
+
+  // --- BEGIN --- Writing -----------------------------------------------------
+  /// Appends the binary representation of `value` to `buffer`.
+  template <typename T>
+  void put(std::string& buffer, T value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    buffer.append(reinterpret_cast<char const*>(&value), sizeof(value));
+  }
+
+  void putString(std::string& buffer, std::string const& s) {
+    put<std::uint32_t>(buffer, s.size());
+    buffer.append(s);
+  }
+
+
+  void putTable
+    (std::string& buffer, icarusDB::TPCFragmentIDToReadoutIDMap const& map)
+  {
+    put<std::uint32_t>(buffer, map.size());
+    for (auto const& [ fragmentID, crateInfo ]: map) {
+      auto const& [ crateName, boardIDs ] = crateInfo;
+      put<std::uint32_t>(buffer, fragmentID);
+      putString(buffer, crateName);
+      put<std::uint32_t>(buffer, boardIDs.size());
+      for (unsigned int boardID: boardIDs) put<std::uint32_t>(buffer, boardID);
+    }
+  } // putTable(TPCFragmentIDToReadoutIDMap)
+
+  void putTable
+    (std::string& buffer, icarusDB::TPCReadoutBoardToChannelMap const& map)
+  {
+    put<std::uint32_t>(buffer, map.size());
+    for (auto const& [ boardID, boardInfo ]: map) {
+      auto const& [ slot, channels ] = boardInfo;
+      put<std::uint32_t>(buffer, boardID);
+      put<std::uint32_t>(buffer, slot);
+      put<std::uint32_t>(buffer, channels.size());
+      for (auto const& [ channel, plane ]: channels) {
+        put<std::uint32_t>(buffer, channel);
+        put<std::uint32_t>(buffer, plane);
+      }
+    }
+  } // putTable(TPCReadoutBoardToChannelMap)
+
+  void putTable
+    (std::string& buffer, icarusDB::PMTFragmentToDigitizerChannelMap const& map)
+  {
+    put<std::uint32_t>(buffer, map.size());
+    for (auto const& [ DBkey, channels ]: map) {
+      put<std::uint32_t>(buffer, DBkey);
+      put<std::uint32_t>(buffer, channels.size());
+      for (icarusDB::PMTChannelInfo_t const& info: channels) {
+        putString(buffer, info.digitizerLabel);
+        put<std::uint32_t>(buffer, info.digitizerChannelNo);
+        put<std::uint32_t>(buffer, info.channelID);
+        put<std::uint32_t>(buffer, info.laserChannelNo);
+        put<std::uint16_t>(buffer, info.LVDSconnector);
+        put<std::uint16_t>(buffer, info.LVDSbit);
+        put<std::uint16_t>(buffer, info.adderConnector);
+        put<std::uint16_t>(buffer, info.adderBit);
+      }
+    }
+  } // putTable(PMTFragmentToDigitizerChannelMap)
+
+  void putTable(
+    std::string& buffer,
+    icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap const& map
+  ) {
+    put<std::uint32_t>(buffer, map.size());
+    for (auto const& [ channel, addresses ]: map) {
+      put<std::uint32_t>(buffer, channel);
+      put<std::uint32_t>(buffer, addresses.first);
+      put<std::uint32_t>(buffer, addresses.second);
+    }
+  } // putTable(CRTChannelIDToHWtoSimMacAddressPairMap)
+
+  void putTable
+    (std::string& buffer, icarusDB::TopCRTHWtoSimMacAddressPairMap const& map)
+  {
+    put<std::uint32_t>(buffer, map.size());
+    for (auto const& [ hwaddress, simaddress ]: map) {
+      put<std::uint32_t>(buffer, hwaddress);
+      put<std::uint32_t>(buffer, simaddress);
+    }
+  } // putTable(TopCRTHWtoSimMacAddressPairMap)
+
+  void putTable
+    (std::string& buffer, icarusDB::SideCRTChannelToCalibrationMap const& map)
+  {
+    put<std::uint32_t>(buffer, map.size());
+    for (auto const& [ key, calib ]: map) {
+      put<std::uint32_t>(buffer, key.first);
+      put<std::uint32_t>(buffer, key.second);
+      put<double>(buffer, calib.first);
+      put<double>(buffer, calib.second);
+    }
+  } // putTable(SideCRTChannelToCalibrationMap)
+
+  // --- END ----- Writing -----------------------------------------------------
+
+
+  // --- BEGIN --- Reading -----------------------------------------------------
+  /// Sequential, bound-checked reading of binary data.
+  class Cursor {
+    char const* fPos;
+    char const* const fEnd;
+
+      public:
+    Cursor(char const* begin, char const* end): fPos{ begin }, fEnd{ end } {}
+
+    template <typename T>
+    T get()
+      {
+        static_assert(std::is_trivially_copyable_v<T>);
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, fPos, sizeof(T)); // data may be unaligned
+        fPos += sizeof(T);
+        return value;
+      }
+
+    std::string getString()
+      {
+        std::size_t const length = get<std::uint32_t>();
+        require(length);
+        std::string s{ fPos, length };
+        fPos += length;
+        return s;
+      }
+
+    void skip(std::size_t n) { require(n); fPos += n; }
+
+    void require(std::size_t n) const
+      {
+        if (static_cast<std::size_t>(fEnd - fPos) >= n) return;
+        throw formatError() << "Attempt to read " << n << " bytes past the end"
+          " of the channel mapping data (file truncated or corrupted?).\n";
+      }
+
+  }; // Cursor
+
+  // --- END ----- Reading -----------------------------------------------------
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapBinaryFormat::write
+  (std::ostream& out, std::vector<ICARUSChannelMapSnapshot const*> const& periods)
+{
+  // all tables are prepared in memory first, so that their offsets are known
+  std::vector<std::string> tables;
+  tables.reserve(periods.size() * NTables);
+  for (ICARUSChannelMapSnapshot const* snapshot: periods) {
+    if (!snapshot) {
+      throw formatError() << "write(): missing the mapping of period #"
+        << (tables.size() / NTables) << ".\n";
+    }
+    // this must follow the order of `Table`
+    putTable(tables.emplace_back(), snapshot->TPCfragmentToReadout);
+    putTable(tables.emplace_back(), snapshot->TPCboardToChannels);
+    putTable(tables.emplace_back(), snapshot->PMTfragmentToDigitizers);
+    putTable(tables.emplace_back(), snapshot->sideCRTchannelToMacAddresses);
+    putTable(tables.emplace_back(), snapshot->topCRTmacAddresses);
+    putTable(tables.emplace_back(), snapshot->sideCRTcalibration);
+  } // for periods
+
+  std::string header;
+  header.append(Magic.data(), Magic.size());
+  put<std::uint32_t>(header, FormatVersion);
+  put<std::uint32_t>(header, ByteOrderMark);
+  put<std::uint32_t>(header, periods.size());
+  put<std::uint32_t>(header, NTables);
+
+  std::uint64_t offset = header.size()
+    + (tables.size() + 1) * sizeof(std::uint64_t); // offsets and file size
+  for (std::string const& table: tables) {
+    put<std::uint64_t>(header, offset);
+    offset += table.size();
+  }
+  put<std::uint64_t>(header, offset); // total size
+
+  out.write(header.data(), header.size());
+  for (std::string const& table: tables) out.write(table.data(), table.size());
+  if (!out) {
+    throw formatError()
+      << "write(): failed writing the binary channel mapping.\n";
+  }
+
+} // icarusDB::ChannelMapBinaryFormat::write()
+
+
+// -----------------------------------------------------------------------------
+icarusDB::ChannelMapBinaryFormat::Reader::Reader
+  (void const* data, std::size_t size)
+  : fData{ static_cast<char const*>(data) }
+  , fSize{ size }
+{
+  Cursor header{ fData, fData + fSize };
+
+  header.require(Magic.size());
+  if (!std::equal(Magic.begin(), Magic.end(), fData))
+    throw formatError() << "Data is not a binary ICARUS channel mapping.\n";
+  header.skip(Magic.size());
+
+  std::uint32_t const version = header.get<std::uint32_t>();
+  if (version != FormatVersion) {
+    throw formatError() << "Binary channel mapping has format version "
+      << version << ", only version " << FormatVersion << " is supported.\n";
+  }
+
+  if (header.get<std::uint32_t>() != ByteOrderMark) {
+    throw formatError()
+      << "Binary channel mapping was written with a different byte order.\n";
+  }
+
+  fNPeriods = header.get<std::uint32_t>();
+  std::uint32_t const nTables = header.get<std::uint32_t>();
+  if (nTables != NTables) {
+    throw formatError() << "Binary channel mapping has " << nTables
+      << " tables per period, " << NTables << " expected.\n";
+  }
+
+  header.require((fNPeriods * NTables + 1) * sizeof(std::uint64_t));
+  std::uint64_t totalSize;
+  std::memcpy(&totalSize,
+    fData + Magic.size() + 4 * sizeof(std::uint32_t)
+      + fNPeriods * NTables * sizeof(std::uint64_t),
+    sizeof(totalSize)
+    );
+  if (totalSize != fSize) {
+    throw formatError() << "Binary channel mapping should be " << totalSize
+      << " bytes long, but it is " << fSize << ".\n";
+  }
+
+} // icarusDB::ChannelMapBinaryFormat::Reader::Reader()
+
+
+// -----------------------------------------------------------------------------
+char const* icarusDB::ChannelMapBinaryFormat::Reader::tableStart
+  (std::size_t period, Table table) const
+{
+  if (period >= fNPeriods) {
+    throw formatError() << "Binary channel mapping has no period #" << period
+      << " (only " << fNPeriods << " periods available).\n";
+  }
+  std::size_t const iTable
+    = period * NTables + static_cast<std::size_t>(table);
+  std::uint64_t offset;
+  std::memcpy(&offset,
+    fData + Magic.size() + 4 * sizeof(std::uint32_t)
+      + iTable * sizeof(std::uint64_t),
+    sizeof(offset)
+    );
+  if (offset >= fSize) {
+    throw formatError() << "Binary channel mapping table #" << iTable
+      << " starts at offset " << offset << ", past the end of the data.\n";
+  }
+  return fData + offset;
+} // icarusDB::ChannelMapBinaryFormat::Reader::tableStart()
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapBinaryFormat::Reader::read
+  (std::size_t period, TPCFragmentIDToReadoutIDMap& map) const
+{
+  Cursor data{ tableStart(period, Table::TPCfragments), fData + fSize };
+  for (std::uint32_t n = data.get<std::uint32_t>(); n; --n) {
+    unsigned int const fragmentID = data.get<std::uint32_t>();
+    auto& [ crateName, boardIDs ] = map[fragmentID];
+    crateName = data.getString();
+    boardIDs.resize(data.get<std::uint32_t>());
+    for (unsigned int& boardID: boardIDs) boardID = data.get<std::uint32_t>();
+  }
+} // icarusDB::ChannelMapBinaryFormat::Reader::read(TPCFragmentIDToReadoutIDMap)
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapBinaryFormat::Reader::read
+  (std::size_t period, TPCReadoutBoardToChannelMap& map) const
+{
+  Cursor data{ tableStart(period, Table::TPCboards), fData + fSize };
+  for (std::uint32_t n = data.get<std::uint32_t>(); n; --n) {
+    unsigned int const boardID = data.get<std::uint32_t>();
+    auto& [ slot, channels ] = map[boardID];
+    slot = data.get<std::uint32_t>();
+    channels.resize(data.get<std::uint32_t>());
+    for (auto& [ channel, plane ]: channels) {
+      channel = data.get<std::uint32_t>();
+      plane = data.get<std::uint32_t>();
+    }
+  }
+} // icarusDB::ChannelMapBinaryFormat::Reader::read(TPCReadoutBoardToChannelMap)
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapBinaryFormat::Reader::read
+  (std::size_t period, PMTFragmentToDigitizerChannelMap& map) const
+{
+  Cursor data{ tableStart(period, Table::PMTfragments), fData + fSize };
+  for (std::uint32_t n = data.get<std::uint32_t>(); n; --n) {
+    unsigned int const DBkey = data.get<std::uint32_t>();
+    PMTdigitizerInfoVec& channels = map[DBkey];
+    channels.resize(data.get<std::uint32_t>());
+    for (PMTChannelInfo_t& info: channels) {
+      info.digitizerLabel     = data.getString();
+      info.digitizerChannelNo = data.get<std::uint32_t>();
+      info.channelID          = data.get<std::uint32_t>();
+      info.laserChannelNo     = data.get<std::uint32_t>();
+      info.LVDSconnector      = data.get<std::uint16_t>();
+      info.LVDSbit            = data.get<std::uint16_t>();
+      info.adderConnector     = data.get<std::uint16_t>();
+      info.adderBit           = data.get<std::uint16_t>();
+    }
+  }
+} // icarusDB::ChannelMapBinaryFormat::Reader::read(PMTFragmentToDigitizerChannelMap)
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapBinaryFormat::Reader::read
+  (std::size_t period, CRTChannelIDToHWtoSimMacAddressPairMap& map) const
+{
+  Cursor data{ tableStart(period, Table::sideCRTaddresses), fData + fSize };
+  for (std::uint32_t n = data.get<std::uint32_t>(); n; --n) {
+    unsigned int const channel = data.get<std::uint32_t>();
+    unsigned int const hwaddress = data.get<std::uint32_t>();
+    unsigned int const simaddress = data.get<std::uint32_t>();
+    map[channel] = { hwaddress, simaddress };
+  }
+} // icarusDB::ChannelMapBinaryFormat::Reader::read(CRTChannelIDToHWtoSimMacAddressPairMap)
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapBinaryFormat::Reader::read
+  (std::size_t period, TopCRTHWtoSimMacAddressPairMap& map) const
+{
+  Cursor data{ tableStart(period, Table::topCRTaddresses), fData + fSize };
+  for (std::uint32_t n = data.get<std::uint32_t>(); n; --n) {
+    unsigned int const hwaddress = data.get<std::uint32_t>();
+    map[hwaddress] = data.get<std::uint32_t>();
+  }
+} // icarusDB::ChannelMapBinaryFormat::Reader::read(TopCRTHWtoSimMacAddressPairMap)
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ChannelMapBinaryFormat::Reader::read
+  (std::size_t period, SideCRTChannelToCalibrationMap& map) const
+{
+  Cursor data{ tableStart(period, Table::sideCRTcalibration), fData + fSize };
+  for (std::uint32_t n = data.get<std::uint32_t>(); n; --n) {
+    unsigned int const mac5 = data.get<std::uint32_t>();
+    unsigned int const chan = data.get<std::uint32_t>();
+    double const gain = data.get<double>();
+    double const pedestal = data.get<double>();
+    map[{ mac5, chan }] = { gain, pedestal };
+  }
+} // icarusDB::ChannelMapBinaryFormat::Reader::read(SideCRTChannelToCalibrationMap)
+
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,131 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.h
+ * @brief  Binary on-disk format of the fully resolved ICARUS channel mapping.
+ * @see    icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.cxx
+ */
+
+#ifndef ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPBINARYFORMAT_H
+#define ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPBINARYFORMAT_H
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapSnapshot.h"
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapDataTypes.h"
+
+// C/C++ standard libraries
+#include <array>
+#include <ostream>
+#include <vector>
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t, std::uint64_t
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Binary export of the ICARUS channel mapping.
+ *
+ * The file holds the complete mapping of each run period, as the database
+ * backends would build it, in a form that can be memory mapped and read
+ * without any further database access.
+ *
+ * Layout (all integers in the native byte order of the writer, which is
+ * verified on reading via `ByteOrderMark`):
+ *  * header:
+ *     * `Magic` (8 bytes)
+ *     * format version (`std::uint32_t`, `FormatVersion`)
+ *     * byte order mark (`std::uint32_t`, `ByteOrderMark`)
+ *     * number of run periods _P_ (`std::uint32_t`)
+ *     * number of tables per period _T_ (`std::uint32_t`, `NTables`)
+ *     * _P_ x _T_ table offsets from the start of the file (`std::uint64_t`)
+ *     * total size of the file (`std::uint64_t`)
+ *  * the tables, each starting with the number of entries (`std::uint32_t`);
+ *    strings are stored as length (`std::uint32_t`) followed by the characters.
+ *
+ * The order of the tables within a period is the one in `Table`.
+ * A change in any of the layouts requires a new `FormatVersion`.
+ */
+namespace icarusDB::ChannelMapBinaryFormat {
+
+  /// Identification of the file format.
+  inline constexpr std::array<char, 8> Magic
+    = { 'I', 'C', 'A', 'R', 'U', 'S', 'C', 'M' };
+
+  /// Version of the format being written, and the only one being read.
+  constexpr std::uint32_t FormatVersion = 1;
+
+  /// Known value whose byte representation reveals the byte order.
+  constexpr std::uint32_t ByteOrderMark = 0x01020304;
+
+  /// The tables stored for each period, in order.
+  enum class Table: unsigned int {
+    TPCfragments,      ///< TPC fragment to crate and readout boards.
+    TPCboards,         ///< TPC readout board to slot and channels.
+    PMTfragments,      ///< PMT digitizer to channel information.
+    sideCRTaddresses,  ///< Side CRT channel to hardware and sim MAC address.
+    topCRTaddresses,   ///< Top CRT hardware to sim MAC address.
+    sideCRTcalibration ///< Side CRT channel gain and pedestal.
+  };
+
+  /// Number of tables per period.
+  constexpr std::size_t NTables
+    = static_cast<std::size_t>(Table::sideCRTcalibration) + 1;
+
+  /**
+   * @brief Writes the mapping of all the `periods` into `out`.
+   * @param out binary stream to write into
+   * @param periods the mapping of each period, in `icarusDB::RunPeriod` order
+   */
+  void write
+    (std::ostream& out, std::vector<ICARUSChannelMapSnapshot const*> const& periods);
+
+
+  class Reader;
+
+} // namespace icarusDB::ChannelMapBinaryFormat
+
+
+/**
+ * @brief Decodes the tables of a binary channel mapping in memory.
+ *
+ * The reader does not own the memory, which is usually a read-only memory
+ * mapping of the file.
+ * The header is validated on construction; inconsistencies of the data are
+ * reported via `cet::exception` (category `"ChannelMapBinaryFormat"`).
+ */
+class icarusDB::ChannelMapBinaryFormat::Reader {
+
+    public:
+
+  /// Constructor: validates the header of the `size` bytes from `data`.
+  Reader(void const* data, std::size_t size);
+
+  /// Returns the number of periods in the file.
+  std::size_t nPeriods() const { return fNPeriods; }
+
+  /// @name Table readers
+  /// @{
+  void read(std::size_t period, TPCFragmentIDToReadoutIDMap& map) const;
+  void read(std::size_t period, TPCReadoutBoardToChannelMap& map) const;
+  void read(std::size_t period, PMTFragmentToDigitizerChannelMap& map) const;
+  void read
+    (std::size_t period, CRTChannelIDToHWtoSimMacAddressPairMap& map) const;
+  void read(std::size_t period, TopCRTHWtoSimMacAddressPairMap& map) const;
+  void read(std::size_t period, SideCRTChannelToCalibrationMap& map) const;
+  /// @}
+
+    private:
+
+  char const* fData; ///< Start of the file content.
+
+  std::size_t fSize; ///< Size of the file content.
+
+  std::size_t fNPeriods = 0; ///< Number of periods in the file.
+
+  /// Returns the start of the specified `table` of the specified `period`.
+  char const* tableStart(std::size_t period, Table table) const;
+
+}; // icarusDB::ChannelMapBinaryFormat::Reader
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_DECODE_CHANNELMAPPING_CHANNELMAPBINARYFORMAT_H
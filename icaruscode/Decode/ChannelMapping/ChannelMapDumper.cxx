@@ -9,6 +9,12 @@
  * It may be using _art_ facilities for tool loading, but it does not run in
  * _art_ environment. So it may break without warning and without solution.
  * 
+ * If a second argument is specified, the complete mapping of all run periods
+ * is also exported into a binary file with that name, which can then be used
+ * with the `ICARUSChannelMapBinary` service (see
+ * `icarusDB::ChannelMapBinaryFormat`). Legacy service is not supported for
+ * this export.
+ * 
  */
 
 
@@ -16,6 +22,8 @@
 #include "icaruscode/Decode/ChannelMapping/Legacy/ICARUSChannelMapProvider.h"
 #include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapSQLiteProvider.h"
 #include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapPostGresProvider.h"
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapBinaryProvider.h"
+#include "icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.h"
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMapProvider.h"
 #include "icaruscode/Decode/ChannelMapping/RunPeriods.h"
 
@@ -28,6 +36,9 @@
 // C/C++ standard libraries
 #include <iomanip> // std::setw()
 #include <iostream>
+#include <fstream>
+#include <functional> // std::function<>
+#include <vector>
 #include <algorithm>
 #include <memory>
 #include <numeric> // std::iota()
@@ -233,6 +244,24 @@ void dumpMapping(icarusDB::IICARUSChannelMapProvider const& channelMapping) {
 }
 
 
+// -----------------------------------------------------------------------------
+/// Writes the mapping of all run periods from `provider` into `fileName`.
+template <typename Provider>
+void exportBinaryMapping(Provider const& provider, std::string const& fileName)
+{
+  std::vector<icarusDB::ICARUSChannelMapSnapshot const*> periods;
+  for (icarusDB::RunPeriod const period: icarusDB::RunPeriods::All)
+    periods.push_back(&provider.periodSnapshot(period));
+  
+  std::ofstream out{ fileName, std::ios::binary | std::ios::trunc };
+  icarusDB::ChannelMapBinaryFormat::write(out, periods);
+  
+  mf::LogVerbatim("ChannelMapDumper") << "Exported " << periods.size()
+    << " run periods into binary file '" << fileName << "'.";
+  
+} // exportBinaryMapping()
+
+
 // -----------------------------------------------------------------------------
 int main(int argc, char** argv) {
   
@@ -255,6 +284,9 @@ int main(int argc, char** argv) {
     return 1;
   }
   
+  // second argument: binary export file name (optional)
+  std::string const binaryFileName = (++iParam < argc)? argv[iParam]: "";
+  
   Environment const Env { config };
   
   //
@@ -263,6 +295,7 @@ int main(int argc, char** argv) {
   // limited selection of available service providers, hard-coded
   // 
   std::unique_ptr<icarusDB::IICARUSChannelMapProvider> channelMapping;
+  std::function<void(std::string const&)> exportBinary;
   fhicl::ParameterSet channelMapConfig
     = Env.ServiceParameters("IICARUSChannelMap");
   std::string const serviceType = channelMapConfig.get<std::string>
@@ -274,13 +307,26 @@ int main(int argc, char** argv) {
     << "with configuration:\n{" << channelMapConfig.to_indented_string(1)
     << "\n}";
   if (serviceType == "ICARUSChannelMapSQLite") {
-    channelMapping = std::make_unique<icarusDB::ICARUSChannelMapSQLiteProvider>
+    auto provider = std::make_unique<icarusDB::ICARUSChannelMapSQLiteProvider>
       (channelMapConfig);
+    exportBinary = [&p=*provider](std::string const& fileName)
+      { exportBinaryMapping(p, fileName); };
+    channelMapping = std::move(provider);
   }
   else if (serviceType == "ICARUSChannelMapPostGres") {
-    channelMapping
+    auto provider
       = std::make_unique<icarusDB::ICARUSChannelMapPostGresProvider>
       (channelMapConfig);
+    exportBinary = [&p=*provider](std::string const& fileName)
+      { exportBinaryMapping(p, fileName); };
+    channelMapping = std::move(provider);
+  }
+  else if (serviceType == "ICARUSChannelMapBinary") {
+    auto provider = std::make_unique<icarusDB::ICARUSChannelMapBinaryProvider>
+      (channelMapConfig);
+    exportBinary = [&p=*provider](std::string const& fileName)
+      { exportBinaryMapping(p, fileName); };
+    channelMapping = std::move(provider);
   }
   else if (serviceType == "ICARUSChannelMap") { // legacy
     channelMapping = std::make_unique<icarusDB::ICARUSChannelMapProvider>
@@ -309,6 +355,19 @@ int main(int argc, char** argv) {
     << "\nDumped " << icarusDB::RunPeriods::All.size() << " run periods."
     ;
   
+  //
+  // binary export
+  //
+  if (!binaryFileName.empty()) {
+    if (!exportBinary) {
+      mf::LogError("ChannelMapDumper")
+        << "Fatal: binary export not supported for IICARUSChannelMap.service_type: '"
+        << serviceType << "'.";
+      return 1;
+    }
+    exportBinary(binaryFileName);
+  }
+  
   return 0;
 } // main()
 
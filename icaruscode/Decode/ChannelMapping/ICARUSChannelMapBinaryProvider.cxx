@@ -0,0 +1,9 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ICARUSChannelMapBinaryProvider.cxx
+ * @see    icaruscode/Decode/ChannelMapping/ICARUSChannelMapBinaryProvider.h
+ */
+
+// library header
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapBinaryProvider.h"
+
+// nothing else
@@ -0,0 +1,46 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ICARUSChannelMapBinaryProvider.h
+ * @see    icaruscode/Decode/ChannelMapping/ICARUSChannelMapBinaryProvider.cxx
+ */
+
+#ifndef ICARUSCODE_DECODE_CHANNELMAPPING_ICARUSCHANNELMAPBINARYPROVIDER_H
+#define ICARUSCODE_DECODE_CHANNELMAPPING_ICARUSCHANNELMAPBINARYPROVIDER_H
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapProviderBase.h"
+#include "icaruscode/Decode/ChannelMapping/ChannelMapBinary.h"
+
+
+// -----------------------------------------------------------------------------
+namespace icarusDB { class ICARUSChannelMapBinaryProvider; }
+/**
+ * @brief Interface to a binary export of the ICARUS channel mapping database.
+ * 
+ * The binary file is written by `ChannelMapDumper` from one of the database
+ * backends, and it is memory mapped read-only.
+ * 
+ * 
+ * The implementation is fully delegated to
+ * `icarusDB::ICARUSChannelMapProviderBase`.
+ * 
+ * 
+ * Configuration parameters
+ * =========================
+ * 
+ * See `icarusDB::ICARUSChannelMapProviderBase`, except for:
+ * 
+ * * `ChannelMappingTool` (algorithm configuration): see
+ *     `icarusDB::ChannelMapBinary` configuration.
+ * 
+ */
+class icarusDB::ICARUSChannelMapBinaryProvider
+  : public icarusDB::ICARUSChannelMapProviderBase<icarusDB::ChannelMapBinary>
+{
+  using Base_t = ICARUSChannelMapProviderBase<icarusDB::ChannelMapBinary>;
+  using Base_t::Base_t; 
+};
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_DECODE_CHANNELMAPPING_ICARUSCHANNELMAPBINARYPROVIDER_H
@@ -0,0 +1,103 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ICARUSChannelMapBinary_service.cc
+ * @brief  Wrapper service for `icarusDB::ICARUSChannelMapBinaryProvider`.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapBinaryProvider.h"
+#include "icaruscode/Decode/ChannelMapping/IICARUSChannelMap.h"
+#include "icaruscode/Decode/ChannelMapping/RunPeriods.h"
+
+// framework libraries
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceDefinitionMacros.h"
+#include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
+#include "art/Framework/Services/Registry/ServiceTable.h"
+#include "art/Framework/Principal/Run.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+
+// -----------------------------------------------------------------------------
+namespace icarusDB { class ICARUSChannelMapBinary; }
+/**
+ * @brief LArSoft service for ICARUS channel mapping (binary file backend).
+ * 
+ * This service provides access to ICARUS channel mapping, using a binary
+ * export of the database (see `icarusDB::ChannelMapBinary`). The file can be
+ * produced with `ChannelMapDumper` from either of the database backends.
+ * 
+ * This service implements the generic channel mapping access service provider
+ * interface `icarusDB::IICARUSChannelMapProvider`.
+ * To use the channel mapping, include in your code the header of the service
+ * interface `icarusDB::IICARUSChannelMap`, and access the service provider via:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * icarusDB::IICARUSChannelMapProvider const& channelMapping
+ *   = *lar::providerFrom<icarusDB::IICARUSChannelMap>();
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * or similar (`lar::providerFrom()` is in `larcore/CoreUtils/ServiceUtils.h`)
+ * or directly the service via
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * icarusDB::IICARUSChannelMapProvider const& channelMapping
+ *   = *art::ServiceHandle<icarusDB::IICARUSChannelMap>();
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * 
+ * For details on the interface, see `icarusDB::IICARUSChannelMapProvider`.
+ * For details on the implementation, see
+ * `icarusDB::ICARUSChannelMapBinaryProvider`.
+ * 
+ * @note The binary file is a snapshot of the database content at the time it
+ *       was exported, and it needs to be regenerated when the database or the
+ *       list of run periods change.
+ * 
+ */
+class icarusDB::ICARUSChannelMapBinary
+  : public IICARUSChannelMap, public ICARUSChannelMapBinaryProvider
+{
+  
+  /// Prepares the mapping for the specified run.
+  void preBeginRun(art::Run const& run);
+  
+    public:
+  
+  using provider_type = icarusDB::ICARUSChannelMapBinaryProvider;
+  
+  using Parameters = art::ServiceTable<provider_type::Config>;
+  
+  /// Constructor: configures the provider and hooks to the framework.
+  ICARUSChannelMapBinary(Parameters const& params, art::ActivityRegistry& reg);
+  
+  /// Returns the service provider (for use with `lar::providerFrom()`).
+  provider_type const* provider() const { return this; }
+  
+}; // class icarusDB::ICARUSChannelMapBinary
+
+
+// -----------------------------------------------------------------------------
+// ---  Implementation
+// -----------------------------------------------------------------------------
+icarusDB::ICARUSChannelMapBinary::ICARUSChannelMapBinary
+  (Parameters const& params, art::ActivityRegistry& reg)
+  : provider_type(params())
+{
+  reg.sPreBeginRun.watch(this, &ICARUSChannelMapBinary::preBeginRun);
+  forPeriod(RunPeriod::Runs0to2); // prepare for some run, in case anybody asks
+}
+
+
+// -----------------------------------------------------------------------------
+void icarusDB::ICARUSChannelMapBinary::preBeginRun(art::Run const& run) {
+  if (forRun(run.run())) {
+    mf::LogDebug{ "ICARUSChannelMapBinary" }
+      << "Loaded mapping for run " << run.run();
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+DECLARE_ART_SERVICE_INTERFACE_IMPL
+  (icarusDB::ICARUSChannelMapBinary, icarusDB::IICARUSChannelMap, SHARED)
+DEFINE_ART_SERVICE_INTERFACE_IMPL
+  (icarusDB::ICARUSChannelMapBinary, icarusDB::IICARUSChannelMap)
+
+
+// -----------------------------------------------------------------------------
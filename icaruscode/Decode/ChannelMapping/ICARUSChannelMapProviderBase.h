@@ -9,6 +9,8 @@
 
 // ICARUS libraries
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMapProvider.h"
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapSnapshot.h"
+#include "icaruscode/Decode/ChannelMapping/RunPeriods.h"
 #include "icarusalg/Utilities/mfLoggingClass.h"
 
 // framework libraries
@@ -18,8 +20,11 @@
 #include "cetlib_except/exception.h"
 
 // C/C++ standard libraries
+#include <array>
+#include <atomic>
 #include <string>
 #include <memory> // std::unique_ptr<>
+#include <cstddef> // std::size_t
 
 
 // -----------------------------------------------------------------------------
@@ -35,10 +40,16 @@ namespace icarusDB {
  * -------
  * 
  * This implementation relies on a database backend reading the full information
- * from the database and caching the result, every time a new run period is
- * requested. To help users who in turn cache information from this object to
- * track whether _their_ caches are invalidated by such occurrences, this object
- * uses the `util::CacheCounter` facility to version every cache.
+ * from the database. The information of all the run periods
+ * (`icarusDB::RunPeriods::All`) is read at construction and stored in
+ * immutable snapshots (`icarusDB::ICARUSChannelMapSnapshot`); selecting a run
+ * period just makes the provider point to the snapshot of that period, and
+ * all lookups by fragment and board ID are direct table accesses.
+ * The database is never accessed again after construction.
+ * 
+ * To help users who in turn cache information from this object to
+ * track whether _their_ caches are invalidated by a change of period, this
+ * object uses the `util::CacheCounter` facility to version every cache.
  * Users will want to use the `util::CacheGuard` tool to monitor the cache.
  * Three caches are tracked, with tags `"TPC"`, `"PMT"` and `"CRT"`, plus
  * the overall cache tracking (tagged with an empty name `""`).
@@ -133,6 +144,11 @@ class icarusDB::ICARUSChannelMapProviderBase
   /// Loads the mapping for `period`, returns whether a new mapping was loaded.
   virtual bool forPeriod(icarusDB::RunPeriod period) override;
   
+  /// Returns the complete mapping of the specified `period`.
+  ICARUSChannelMapSnapshot const& periodSnapshot
+    (icarusDB::RunPeriod period) const
+    { return *fSnapshots.at(static_cast<std::size_t>(period)); }
+  
   /// @}
   /// --- END ----- Data period selection --------------------------------------
   
@@ -261,24 +277,23 @@ class icarusDB::ICARUSChannelMapProviderBase
   
   // --- BEGIN --- Cache -------------------------------------------------------
   
-  icarusDB::TPCFragmentIDToReadoutIDMap fTPCFragmentToReadoutMap;
+  /// The mapping of each run period, indexed by `icarusDB::RunPeriod`.
+  std::array<std::unique_ptr<ICARUSChannelMapSnapshot const>, RunPeriods::NPeriods>
+    fSnapshots;
   
-  icarusDB::TPCReadoutBoardToChannelMap fTPCReadoutBoardToChannelMap;
-
-  icarusDB::PMTFragmentToDigitizerChannelMap fPMTFragmentToDigitizerMap; 
-
-  icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap
-    fCRTChannelIDToHWtoSimMacAddressPairMap;
-
-  icarusDB::TopCRTHWtoSimMacAddressPairMap fTopCRTHWtoSimMacAddressPairMap;
-
-  icarusDB::SideCRTChannelToCalibrationMap fSideCRTChannelToCalibrationMap;
+  /// The mapping of the currently selected period (`nullptr` if none yet).
+  std::atomic<ICARUSChannelMapSnapshot const*> fCurrentSnapshot{ nullptr };
   
   // --- END ----- Cache -------------------------------------------------------
   
 
-  /// Has the channel mapping tool fill the mapping caches.
-  void readFromDatabase();
+  /// Has the channel mapping tool read the full mapping for `period`.
+  std::unique_ptr<ICARUSChannelMapSnapshot const> readFromDatabase
+    (icarusDB::RunPeriod period);
+  
+  /// Returns the mapping of the currently selected period.
+  /// @throw cet::exception if no period has been selected yet
+  ICARUSChannelMapSnapshot const& currentSnapshot() const;
   
   /// Returns the list of records of all channels in the PMT readout board with
   /// the specified fragment.
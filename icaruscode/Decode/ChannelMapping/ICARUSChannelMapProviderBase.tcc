@@ -9,15 +9,16 @@
 
 // ICARUS libraries
 #include "icaruscode/Decode/ChannelMapping/RunPeriods.h"
-#include "larcorealg/CoreUtils/values.h" // util::const_values()
 
 // framework libraries
 #include "cetlib_except/exception.h"
 #include "cetlib/cpu_timer.h"
 
 // C++ standard libraries
+#include <memory> // std::make_unique()
 #include <string>
 #include <cassert>
+#include <cstddef> // std::size_t
 
 
 // -----------------------------------------------------------------------------
@@ -30,6 +31,17 @@ icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::ICARUSChannelMapProviderBase
   , fChannelMappingAlg { config.ChannelMappingTool() }
 {
   addCacheTags({ "TPC", "PMT", "CRT" }); // all caches updated at the same time
+  
+  // all periods are loaded now, and the database is not touched again
+  cet::cpu_timer theClock;
+  theClock.start();
+  for (RunPeriod const period: RunPeriods::All)
+    fSnapshots[static_cast<std::size_t>(period)] = readFromDatabase(period);
+  theClock.stop();
+  
+  mfLogInfo() << "Channel mapping for " << RunPeriods::NPeriods
+    << " run periods loaded in " << theClock.accumulated_real_time() << " s";
+  
 }
 
 
@@ -62,10 +74,15 @@ bool icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::forPeriod
   (icarusDB::RunPeriod period)
 {
   
-  // if cache is not invalidated, we don't refresh it
-  if (!fChannelMappingAlg.SelectPeriod(period)) return false;
+  ICARUSChannelMapSnapshot const* snapshot
+    = fSnapshots.at(static_cast<std::size_t>(period)).get();
+  
+  // if the period does not change, neither does the cache
+  if (fCurrentSnapshot.exchange(snapshot) == snapshot) return false;
   
-  readFromDatabase();
+  updateCacheID("TPC");
+  updateCacheID("PMT");
+  updateCacheID("CRT");
   return true;
 }
 
@@ -75,15 +92,14 @@ template <typename ChMapAlg>
 bool icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::hasFragmentID
   (const unsigned int fragmentID) const
 {
-  return
-    fTPCFragmentToReadoutMap.find(fragmentID) != fTPCFragmentToReadoutMap.end();
+  return currentSnapshot().TPCfragmentIndex.find(fragmentID) != nullptr;
 }
 
 
 // -----------------------------------------------------------------------------
 template <typename ChMapAlg>
 unsigned int icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::nTPCfragmentIDs() const {
-  return fTPCFragmentToReadoutMap.size();
+  return currentSnapshot().TPCfragmentToReadout.size();
 }
 
 
@@ -92,14 +108,15 @@ template <typename ChMapAlg>
 std::string const& icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::getCrateName
   (const unsigned int fragmentID) const
 {
-  auto const fragToReadoutItr = fTPCFragmentToReadoutMap.find(fragmentID);
+  CrateNameReadoutIDPair const* crateInfo
+    = currentSnapshot().TPCfragmentIndex.find(fragmentID);
 
-  if (fragToReadoutItr == fTPCFragmentToReadoutMap.end()) {
+  if (!crateInfo) {
     throw myException() << "Fragment ID " << fragmentID
       << " not found in lookup map when looking up crate name \n";
   }
 
-  return fragToReadoutItr->second.first;
+  return crateInfo->first;
 }
 
 
@@ -108,14 +125,15 @@ template <typename ChMapAlg>
 auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::getReadoutBoardVec
   (const unsigned int fragmentID) const -> icarusDB::ReadoutIDVec const&
 {
-  auto const fragToReadoutItr = fTPCFragmentToReadoutMap.find(fragmentID);
+  CrateNameReadoutIDPair const* crateInfo
+    = currentSnapshot().TPCfragmentIndex.find(fragmentID);
 
-  if (fragToReadoutItr == fTPCFragmentToReadoutMap.end()) {
+  if (!crateInfo) {
     throw myException() << "Fragment ID " << fragmentID
       << " not found in lookup map when looking up board vector.\n";
   }
 
-  return fragToReadoutItr->second.second;
+  return crateInfo->second;
 }
 
 
@@ -124,7 +142,7 @@ template <typename ChMapAlg>
 auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::getReadoutBoardToChannelMap()
   const -> const TPCReadoutBoardToChannelMap&
 {
-  return fTPCReadoutBoardToChannelMap;
+  return currentSnapshot().TPCboardToChannels;
 }
 
 
@@ -133,15 +151,14 @@ template <typename ChMapAlg>
 bool icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::hasBoardID
   (const unsigned int boardID)  const
 {
-  return
-    fTPCReadoutBoardToChannelMap.find(boardID) != fTPCReadoutBoardToChannelMap.end();
+  return currentSnapshot().TPCboardIndex.find(boardID) != nullptr;
 }
 
 
 // -----------------------------------------------------------------------------
 template <typename ChMapAlg>
 unsigned int icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::nTPCboardIDs() const {
-  return fTPCReadoutBoardToChannelMap.size();
+  return currentSnapshot().TPCboardToChannels.size();
 }
 
 
@@ -150,14 +167,15 @@ template <typename ChMapAlg>
 unsigned int icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::getBoardSlot
   (const unsigned int boardID)  const
 {
-  auto const readoutBoardItr = fTPCReadoutBoardToChannelMap.find(boardID);
+  SlotChannelVecPair const* boardInfo
+    = currentSnapshot().TPCboardIndex.find(boardID);
 
-  if (readoutBoardItr == fTPCReadoutBoardToChannelMap.end()) {
+  if (!boardInfo) {
     throw myException() << "Board ID " << boardID
       << " not found in lookup map when looking up board slot.\n";
   }
 
-  return readoutBoardItr->second.first;
+  return boardInfo->first;
 }
 
 
@@ -166,14 +184,15 @@ template <typename ChMapAlg>
 auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::getChannelPlanePair
   (const unsigned int boardID) const -> ChannelPlanePairVec const&
 {
-  auto const readoutBoardItr = fTPCReadoutBoardToChannelMap.find(boardID);
+  SlotChannelVecPair const* boardInfo
+    = currentSnapshot().TPCboardIndex.find(boardID);
 
-  if (readoutBoardItr == fTPCReadoutBoardToChannelMap.end()) {
+  if (!boardInfo) {
     throw myException() << "Board ID " << boardID
       << " not found in lookup map when looking up channel/plane pair.\n";
   }
 
-  return readoutBoardItr->second.second;
+  return boardInfo->second;
 }
 
 
@@ -191,7 +210,7 @@ template <typename ChMapAlg>
 unsigned int icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::nPMTfragmentIDs()
   const
 {
-  return fPMTFragmentToDigitizerMap.size();
+  return currentSnapshot().PMTfragmentToDigitizers.size();
 }
 
 
@@ -217,13 +236,9 @@ template <typename ChMapAlg>
 unsigned int icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::getSimMacAddress
   (const unsigned int hwmacaddress)  const
 {
-  for(auto const& [ hw, sim ]
-    : util::const_values(fCRTChannelIDToHWtoSimMacAddressPairMap)
-  ) {
-    if (hw == hwmacaddress) return sim;
-  }
-
-  return 0;
+  unsigned int const* simmacaddress
+    = currentSnapshot().sideCRThwToSimIndex.find(hwmacaddress);
+  return simmacaddress? *simmacaddress: 0;
 }
 
 
@@ -233,8 +248,9 @@ unsigned int
 icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::gettopSimMacAddress
   (const unsigned int hwmacaddress) const
 {
-  auto const it = fTopCRTHWtoSimMacAddressPairMap.find(hwmacaddress);
-  return (it == fTopCRTHWtoSimMacAddressPairMap.end())? 0: it->second;
+  unsigned int const* simmacaddress
+    = currentSnapshot().topCRThwToSimIndex.find(hwmacaddress);
+  return simmacaddress? *simmacaddress: 0;
 }
 
 
@@ -243,9 +259,10 @@ template <typename ChMapAlg>
 auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::getSideCRTCalibrationMap
   (int mac5, int chan) const -> std::pair<double, double>
 {
-  auto const itGainAndPedestal
-    = fSideCRTChannelToCalibrationMap.find({ mac5, chan });
-  return (itGainAndPedestal == fSideCRTChannelToCalibrationMap.cend())
+  SideCRTChannelToCalibrationMap const& calibration
+    = currentSnapshot().sideCRTcalibration;
+  auto const itGainAndPedestal = calibration.find({ mac5, chan });
+  return (itGainAndPedestal == calibration.cend())
     ? std::pair{ -99., -99. }: itGainAndPedestal->second;
 }
 
@@ -255,26 +272,43 @@ template <typename ChMapAlg>
 auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::findPMTfragmentEntry
   (unsigned int fragmentID) const -> PMTdigitizerInfoVec const*
 {
-  auto it = fPMTFragmentToDigitizerMap.find(PMTfragmentIDtoDBkey(fragmentID));
-  return (it == fPMTFragmentToDigitizerMap.end())? nullptr: &(it->second);
+  return
+    currentSnapshot().PMTfragmentIndex.find(PMTfragmentIDtoDBkey(fragmentID));
 }
 
 
 // -----------------------------------------------------------------------------
 template <typename ChMapAlg>
-void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
+auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::currentSnapshot() const
+  -> ICARUSChannelMapSnapshot const&
+{
+  ICARUSChannelMapSnapshot const* snapshot
+    = fCurrentSnapshot.load(std::memory_order_acquire);
+  if (snapshot) return *snapshot;
+  throw myException()
+    << "Channel mapping requested before any run period was selected.\n";
+}
 
-  mfLogInfo() << "Building the channel mapping";
 
-  updateCacheID("TPC");
+// -----------------------------------------------------------------------------
+template <typename ChMapAlg>
+auto icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase
+  (icarusDB::RunPeriod period) -> std::unique_ptr<ICARUSChannelMapSnapshot const>
+{
+
+  mfLogInfo() << "Building the channel mapping for period #"
+    << static_cast<unsigned int>(period);
+  
+  fChannelMappingAlg.SelectPeriod(period);
+  
+  auto snapshot = std::make_unique<ICARUSChannelMapSnapshot>();
   
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // TPC fragment-based mapping
   cet::cpu_timer theClockFragmentIDs;
   theClockFragmentIDs.start();
-  fTPCFragmentToReadoutMap.clear();
   if (
-   fChannelMappingAlg.BuildTPCFragmentIDToReadoutIDMap(fTPCFragmentToReadoutMap)
+   fChannelMappingAlg.BuildTPCFragmentIDToReadoutIDMap(snapshot->TPCfragmentToReadout)
   ) {
     throw myException()
       << "Cannot recover the TPC fragment ID channel map from the database.\n";
@@ -282,9 +316,9 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
   else if (fDiagnosticOutput) {
     
     auto log = mfLogVerbatim();
-    log << "FragmentID to Readout ID map has " << fTPCFragmentToReadoutMap.size()
+    log << "FragmentID to Readout ID map has " << snapshot->TPCfragmentToReadout.size()
       << " elements";
-    for(auto const& [ fragmentID, crateAndBoards ]: fTPCFragmentToReadoutMap) {
+    for(auto const& [ fragmentID, crateAndBoards ]: snapshot->TPCfragmentToReadout) {
       log << "\n   Frag: " << std::hex << fragmentID << std::dec << ", Crate: "
         << crateAndBoards.first << ", # boards: "
         << crateAndBoards.second.size();
@@ -300,9 +334,8 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
   cet::cpu_timer theClockReadoutIDs;
   theClockReadoutIDs.start();
 
-  fTPCReadoutBoardToChannelMap.clear();
   if (fChannelMappingAlg.BuildTPCReadoutBoardToChannelMap
-    (fTPCReadoutBoardToChannelMap)
+    (snapshot->TPCboardToChannels)
   ) {
     mfLogError() << "******* FAILED TO CONFIGURE CHANNEL MAP ********";
     throw myException() << "Failed to read the database.\n";
@@ -315,34 +348,28 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
     << ", Readout IDs time: " << readoutIDsTime;
   
   
-  updateCacheID("PMT");
-  
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // PMT channel mapping
-  fPMTFragmentToDigitizerMap.clear();
-  if (fChannelMappingAlg.BuildPMTFragmentToDigitizerChannelMap(fPMTFragmentToDigitizerMap))
+  if (fChannelMappingAlg.BuildPMTFragmentToDigitizerChannelMap(snapshot->PMTfragmentToDigitizers))
   {
     throw myException() 
       << "Cannot recover the PMT fragment ID channel map from the database.\n";
   }
   else if (fDiagnosticOutput) {
     auto log = mfLogVerbatim();
-    log << "FragmentID to Readout ID map has " << fPMTFragmentToDigitizerMap.size()
+    log << "FragmentID to Readout ID map has " << snapshot->PMTfragmentToDigitizers.size()
       << " Fragment IDs";
     
-    for(auto const& [ fragmentID, digitizers ]: fPMTFragmentToDigitizerMap) {
+    for(auto const& [ fragmentID, digitizers ]: snapshot->PMTfragmentToDigitizers) {
       log << "\n   Frag: " << std::hex << fragmentID << std::dec
         << ", # pairs: " << digitizers.size();
     }
   }
   
   
-  updateCacheID("CRT");
-  
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // Side CRT channel mapping
-  fCRTChannelIDToHWtoSimMacAddressPairMap.clear();
-  if (fChannelMappingAlg.BuildCRTChannelIDToHWtoSimMacAddressPairMap(fCRTChannelIDToHWtoSimMacAddressPairMap))
+  if (fChannelMappingAlg.BuildCRTChannelIDToHWtoSimMacAddressPairMap(snapshot->sideCRTchannelToMacAddresses))
   {
     throw myException()
       << "Cannot recover the HW MAC Address  from the database.\n";
@@ -350,8 +377,8 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
   else if (fDiagnosticOutput) {
     auto log = mfLogVerbatim();
     log << "ChannelID to MacAddress map has "
-      << fCRTChannelIDToHWtoSimMacAddressPairMap.size() << " Channel IDs";
-    for(auto const& [ channel, addresses ]: fCRTChannelIDToHWtoSimMacAddressPairMap) {
+      << snapshot->sideCRTchannelToMacAddresses.size() << " Channel IDs";
+    for(auto const& [ channel, addresses ]: snapshot->sideCRTchannelToMacAddresses) {
       log <<"\n ChannelID: "<< channel
         << ", hw mac address: " << addresses.first
         << ", sim mac address: " << addresses.second;
@@ -361,16 +388,15 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
   
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // Top CRT channel mapping
-  fTopCRTHWtoSimMacAddressPairMap.clear();
-  if (fChannelMappingAlg.BuildTopCRTHWtoSimMacAddressPairMap(fTopCRTHWtoSimMacAddressPairMap))
+  if (fChannelMappingAlg.BuildTopCRTHWtoSimMacAddressPairMap(snapshot->topCRTmacAddresses))
   {
     throw myException()
       << "Cannot recover the Top CRT HW MAC Address  from the database.\n";
   }
   else if (fDiagnosticOutput) {
     auto log = mfLogVerbatim();
-    log << "Top CRT MacAddress map has " << fTopCRTHWtoSimMacAddressPairMap.size() << " rows";
-    for(auto const [ hwaddress, simaddress ]: fTopCRTHWtoSimMacAddressPairMap) {
+    log << "Top CRT MacAddress map has " << snapshot->topCRTmacAddresses.size() << " rows";
+    for(auto const [ hwaddress, simaddress ]: snapshot->topCRTmacAddresses) {
       log << "\n hw mac address: " << hwaddress
         << ", sim mac address: " << simaddress;
     }
@@ -379,9 +405,8 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
   
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // CRT Charge Calibration initialization
-  fSideCRTChannelToCalibrationMap.clear();
   if (fChannelMappingAlg.BuildSideCRTCalibrationMap
-    (fSideCRTChannelToCalibrationMap)
+    (snapshot->sideCRTcalibration)
   ) {
     mfLogError() << "******* FAILED TO CONFIGURE CRT Calibration  ********";
     throw myException()
@@ -390,9 +415,9 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
   else if (fDiagnosticOutput) {
     auto log = mfLogVerbatim();
     log << "side crt calibration map has "
-      << fSideCRTChannelToCalibrationMap.size() << " list of rows";
+      << snapshot->sideCRTcalibration.size() << " list of rows";
     
-    for(auto const& [ key, calib ]: fSideCRTChannelToCalibrationMap) {
+    for(auto const& [ key, calib ]: snapshot->sideCRTcalibration) {
       log << "\n mac5: "<< key.first << ", chan: " << key.second
         << ", Gain: " << calib.first << ", Pedestal: " << calib.second;
     }
@@ -400,6 +425,10 @@ void icarusDB::ICARUSChannelMapProviderBase<ChMapAlg>::readFromDatabase() {
   
   
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // lookup indices
+  snapshot->freeze();
+  
+  return snapshot;
   
 } // icarusDB::ICARUSChannelMapProviderBase<>::readFromDatabase()
 
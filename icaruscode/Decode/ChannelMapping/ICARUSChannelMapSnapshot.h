@@ -0,0 +1,190 @@
+/**
+ * @file   icaruscode/Decode/ChannelMapping/ICARUSChannelMapSnapshot.h
+ * @brief  Immutable, fully resolved channel mapping for a single run period.
+ * @see    icaruscode/Decode/ChannelMapping/ICARUSChannelMapProviderBase.h
+ */
+
+#ifndef ICARUSCODE_DECODE_CHANNELMAPPING_ICARUSCHANNELMAPSNAPSHOT_H
+#define ICARUSCODE_DECODE_CHANNELMAPPING_ICARUSCHANNELMAPSNAPSHOT_H
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapDataTypes.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::lower_bound(), std::stable_sort(), std::unique()
+#include <utility> // std::pair
+#include <vector>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarusDB {
+  template <typename Value> class FlatIDLookup;
+  struct ICARUSChannelMapSnapshot;
+}
+
+/**
+ * @brief Constant time lookup of objects by an unsigned integral ID.
+ * @tparam Value type of the object being looked up
+ *
+ * The object does not own the values, but it only points to them.
+ * If the known IDs span a range not larger than `MaxDenseSpan`, lookup is
+ * a direct indexing of a table; otherwise the lookup falls back to a binary
+ * search in a sorted list.
+ */
+template <typename Value>
+class icarusDB::FlatIDLookup {
+
+    public:
+
+  /// Largest span of IDs for which a direct access table is built.
+  static constexpr std::size_t MaxDenseSpan = 0x10000;
+
+  /// Registers `value` under `ID`; the first registration of an ID wins.
+  void add(unsigned int ID, Value const& value)
+    { fEntries.emplace_back(ID, &value); }
+
+  /// Builds the lookup structures. No `add()` is allowed after this.
+  void freeze();
+
+  /// Returns a pointer to the value with the specified `ID`, `nullptr` if none.
+  Value const* find(unsigned int ID) const
+    {
+      if (!fDense.empty()) {
+        std::size_t const index = ID - fFirstID; // wraps around if ID < fFirstID
+        return (index < fDense.size())? fDense[index]: nullptr;
+      }
+      auto const it = std::lower_bound(fEntries.begin(), fEntries.end(), ID,
+        [](Entry_t const& entry, unsigned int ID){ return entry.first < ID; });
+      return ((it == fEntries.end()) || (it->first != ID))? nullptr: it->second;
+    }
+
+    private:
+
+  using Entry_t = std::pair<unsigned int, Value const*>;
+
+  std::vector<Entry_t> fEntries; ///< Known IDs and their values, sorted.
+
+  unsigned int fFirstID = 0U; ///< ID of the first element of `fDense`.
+
+  std::vector<Value const*> fDense; ///< Direct access table, if built.
+
+}; // icarusDB::FlatIDLookup
+
+
+/**
+ * @brief Complete ICARUS channel mapping information for one run period.
+ *
+ * The mapping tables are filled from the database once, then `freeze()` builds
+ * the constant time lookup indices pointing into them.
+ * After that the object is not supposed to change anymore, which makes it
+ * safe to be read concurrently from any number of threads.
+ *
+ * The object is not copyable nor movable, since the indices point into its own
+ * tables.
+ */
+struct icarusDB::ICARUSChannelMapSnapshot {
+
+  // --- BEGIN --- Mapping tables ----------------------------------------------
+
+  TPCFragmentIDToReadoutIDMap TPCfragmentToReadout;
+
+  TPCReadoutBoardToChannelMap TPCboardToChannels;
+
+  PMTFragmentToDigitizerChannelMap PMTfragmentToDigitizers;
+
+  CRTChannelIDToHWtoSimMacAddressPairMap sideCRTchannelToMacAddresses;
+
+  TopCRTHWtoSimMacAddressPairMap topCRTmacAddresses;
+
+  SideCRTChannelToCalibrationMap sideCRTcalibration;
+
+  // --- END ----- Mapping tables ----------------------------------------------
+
+
+  // --- BEGIN --- Lookup indices ----------------------------------------------
+
+  /// TPC fragment ID to crate name and boards.
+  FlatIDLookup<CrateNameReadoutIDPair> TPCfragmentIndex;
+
+  /// TPC readout board ID to slot and channels.
+  FlatIDLookup<SlotChannelVecPair> TPCboardIndex;
+
+  /// PMT database key (see `PMTfragmentIDtoDBkey()`) to digitizer channels.
+  FlatIDLookup<PMTdigitizerInfoVec> PMTfragmentIndex;
+
+  /// Side CRT hardware MAC address to simulation MAC address.
+  FlatIDLookup<unsigned int> sideCRThwToSimIndex;
+
+  /// Top CRT hardware MAC address to simulation MAC address.
+  FlatIDLookup<unsigned int> topCRThwToSimIndex;
+
+  // --- END ----- Lookup indices ----------------------------------------------
+
+
+  ICARUSChannelMapSnapshot() = default;
+  ICARUSChannelMapSnapshot(ICARUSChannelMapSnapshot const&) = delete;
+  ICARUSChannelMapSnapshot& operator= (ICARUSChannelMapSnapshot const&) = delete;
+
+  /// Builds all the lookup indices from the mapping tables.
+  void freeze();
+
+}; // icarusDB::ICARUSChannelMapSnapshot
+
+
+// -----------------------------------------------------------------------------
+// ---  template implementation
+// -----------------------------------------------------------------------------
+template <typename Value>
+void icarusDB::FlatIDLookup<Value>::freeze() {
+
+  // stable sort keeps the first registered value of duplicate IDs first
+  std::stable_sort(fEntries.begin(), fEntries.end(),
+    [](Entry_t const& a, Entry_t const& b){ return a.first < b.first; });
+  fEntries.erase(std::unique(fEntries.begin(), fEntries.end(),
+    [](Entry_t const& a, Entry_t const& b){ return a.first == b.first; }),
+    fEntries.end());
+
+  fDense.clear();
+  if (fEntries.empty()) return;
+
+  fFirstID = fEntries.front().first;
+  std::size_t const span = std::size_t(fEntries.back().first - fFirstID) + 1;
+  if (span > MaxDenseSpan) return;
+
+  fDense.assign(span, nullptr);
+  for (auto const& [ ID, value ]: fEntries) fDense[ID - fFirstID] = value;
+
+} // icarusDB::FlatIDLookup<>::freeze()
+
+
+// -----------------------------------------------------------------------------
+inline void icarusDB::ICARUSChannelMapSnapshot::freeze() {
+
+  for (auto const& [ fragmentID, crateInfo ]: TPCfragmentToReadout)
+    TPCfragmentIndex.add(fragmentID, crateInfo);
+  TPCfragmentIndex.freeze();
+
+  for (auto const& [ boardID, boardInfo ]: TPCboardToChannels)
+    TPCboardIndex.add(boardID, boardInfo);
+  TPCboardIndex.freeze();
+
+  for (auto const& [ DBkey, digitizerInfo ]: PMTfragmentToDigitizers)
+    PMTfragmentIndex.add(DBkey, digitizerInfo);
+  PMTfragmentIndex.freeze();
+
+  // the first channel (in channel ID order) with a hardware address wins
+  for (auto const& addresses: sideCRTchannelToMacAddresses)
+    sideCRThwToSimIndex.add(addresses.second.first, addresses.second.second);
+  sideCRThwToSimIndex.freeze();
+
+  for (auto const& [ hwaddress, simaddress ]: topCRTmacAddresses)
+    topCRThwToSimIndex.add(hwaddress, simaddress);
+  topCRThwToSimIndex.freeze();
+
+} // icarusDB::ICARUSChannelMapSnapshot::freeze()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_DECODE_CHANNELMAPPING_ICARUSCHANNELMAPSNAPSHOT_H
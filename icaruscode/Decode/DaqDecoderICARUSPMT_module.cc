@@ -66,10 +66,14 @@
 #include "fhiclcpp/types/Atom.h"
 #include "cetlib_except/exception.h"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+
 // ROOT libraries
 #include "TTree.h"
 
 // C/C++ standard libraries
+#include <algorithm> // std::make_heap(), std::sort()
 #include <memory>
 #include <ostream>
 #include <unordered_map>
@@ -78,6 +82,7 @@
 #include <vector>
 #include <string>
 #include <optional>
+#include <utility> // std::pair, std::move()
 #include <cassert>
 
 
@@ -213,6 +218,10 @@ namespace icarus { class DaqDecoderICARUSPMT; }
  *     the framework will be asked to remove the PMT data fragment from memory.
  *     Set this to `false` in the unlikely case where raw PMT fragments are
  *     still needed after decoding.
+ * * `ParallelDecoding` (flag, default: `false`): if set, the data of the
+ *     different readout boards is decoded concurrently (with TBB); the output
+ *     is the same as with serial decoding. The `PMTfragments` tree can't be
+ *     filled concurrently: when it is requested, decoding stays serial.
  * * `LogCategory` (string, default: `DaqDecoderICARUSPMT`): name of the message
  *     facility category where the output is sent.
  * 
@@ -479,8 +488,10 @@ namespace icarus { class DaqDecoderICARUSPMT; }
  *        from all 16 channels _at a given time_ are processed together,
  *        producing up to 16 proto-waveforms
  *     3. merging of contiguous waveforms is performed
+ *    Boards may be processed concurrently (`ParallelDecoding`), since each one
+ *    yields its own list of proto-waveforms sorted by channel and time.
  * 3. post-processing of proto-waveforms:
- *     * sorting by time (as opposed as roughly by channel, as they come)
+ *     * merging of the sorted lists from all boards, by channel then time
  * 4. conversion to data products and output
  * 
  * 
@@ -739,6 +750,12 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
       true // default
       };
     
+    fhicl::Atom<bool> ParallelDecoding {
+      Name("ParallelDecoding"),
+      Comment("decode the data from different boards concurrently"),
+      false // default
+      };
+    
     fhicl::Atom<std::string> LogCategory {
       Name("LogCategory"),
       Comment("name of the category for message stream"),
@@ -896,6 +913,8 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
   /// Clear fragment data product cache after use.
   bool const fDropRawDataAfterUse;
   
+  bool const fParallelDecoding; ///< Whether to decode boards concurrently.
+  
   std::string const fLogCategory; ///< Message facility category.
   
   // --- END ---- Configuration parameters -------------------------------------
@@ -1187,6 +1206,14 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
   /// Sorts in place the specified waveforms in channel order, then in time.
   void sortWaveforms(std::vector<ProtoWaveform_t>& waveforms) const;
   
+  /// Merges lists of waveforms, each already sorted as by `sortWaveforms()`.
+  std::vector<ProtoWaveform_t> mergeSortedWaveforms
+    (std::vector<std::vector<ProtoWaveform_t>>&& waveformLists) const;
+  
+  /// Returns whether `left` comes before `right` (by channel, then by time).
+  static bool byChannelThenTime
+    (ProtoWaveform_t const& left, ProtoWaveform_t const& right);
+  
   /// Returns pointers to all waveforms including the nominal trigger time.
   std::vector<ProtoWaveform_t const*> findWaveformsWithNominalTrigger
     (std::vector<ProtoWaveform_t> const& waveforms) const;
@@ -1610,6 +1637,7 @@ icarus::DaqDecoderICARUSPMT::DaqDecoderICARUSPMT(Parameters const& params)
       )
     }
   , fDropRawDataAfterUse{ params().DropRawDataAfterUse() }
+  , fParallelDecoding{ params().ParallelDecoding() }
   , fLogCategory{ params().LogCategory() }
   , fDetTimings
     { art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob() }
@@ -1828,9 +1856,13 @@ void icarus::DaqDecoderICARUSPMT::produce(art::Event& event) {
   try { // catch-all
     auto const& fragments = readInputFragments(event);
     
+    // collect first the data of all boards, which are then decoded one by one
+    std::vector<artdaq::FragmentPtrs> boardFragments;
+    boardFragments.reserve(fragments.size());
+    
     for (artdaq::Fragment const& fragment: fragments) {
       
-      artdaq::FragmentPtrs const& fragmentCollection
+      artdaq::FragmentPtrs fragmentCollection
         = makeFragmentCollection(fragment);
       
       if (empty(fragmentCollection)) {
@@ -1844,13 +1876,28 @@ void icarus::DaqDecoderICARUSPMT::produce(art::Event& event) {
         = extractFragmentBoardID(*(fragmentCollection.front()));
       if (++boardCounts[boardID] > 1U) duplicateBoards = true;
       
-      appendTo(
-        protoWaveforms,
-        processBoardFragments(fragmentCollection, triggerInfo)
-        );
+      boardFragments.push_back(std::move(fragmentCollection));
       
     } // for all input fragments
     
+    // each board gets its own list of waveforms, sorted by channel and time
+    std::vector<std::vector<ProtoWaveform_t>> boardWaveforms
+      (boardFragments.size());
+    auto decodeBoard = [this,&boardFragments,&boardWaveforms,&triggerInfo]
+      (std::size_t iBoard)
+      {
+        boardWaveforms[iBoard]
+          = processBoardFragments(boardFragments[iBoard], triggerInfo);
+      };
+    
+    // the fragment tree is not thread-safe: it requires serial decoding
+    if (fParallelDecoding && !fTreeFragment)
+      tbb::parallel_for(std::size_t{ 0 }, boardFragments.size(), decodeBoard);
+    else
+      for (std::size_t iBoard: util::counter(boardFragments.size())) decodeBoard(iBoard);
+    
+    protoWaveforms = mergeSortedWaveforms(std::move(boardWaveforms));
+    
   }
   catch (cet::exception const& e) {
     if (!fSurviveExceptions) throw;
@@ -1884,7 +1931,7 @@ void icarus::DaqDecoderICARUSPMT::produce(art::Event& event) {
   //
   // post-processing
   //
-  sortWaveforms(protoWaveforms);
+  // (waveforms are already sorted by channel and time)
   
   std::vector<ProtoWaveform_t const*> const waveformsWithTrigger
     = findWaveformsWithNominalTrigger(protoWaveforms);
@@ -3295,23 +3342,74 @@ unsigned int icarus::DaqDecoderICARUSPMT::extractTriggerTimeTag
 } // icarus::DaqDecoderICARUSPMT::extractTriggerTimeTag()
 
 
+//------------------------------------------------------------------------------
+bool icarus::DaqDecoderICARUSPMT::byChannelThenTime
+  (ProtoWaveform_t const& left, ProtoWaveform_t const& right)
+{
+  return (left.waveform.ChannelNumber() != right.waveform.ChannelNumber())
+    ? left.waveform.ChannelNumber() < right.waveform.ChannelNumber()
+    : left.waveform.TimeStamp() < right.waveform.TimeStamp();
+} // icarus::DaqDecoderICARUSPMT::byChannelThenTime()
+
+
 //------------------------------------------------------------------------------
 void icarus::DaqDecoderICARUSPMT::sortWaveforms
   (std::vector<ProtoWaveform_t>& waveforms) const
 {
-  auto byChannelThenTime = []
-    (ProtoWaveform_t const& left, ProtoWaveform_t const& right)
-    {
-      return (left.waveform.ChannelNumber() != right.waveform.ChannelNumber())
-        ? left.waveform.ChannelNumber() < right.waveform.ChannelNumber()
-        : left.waveform.TimeStamp() < right.waveform.TimeStamp();
-    };
-  
   std::sort(waveforms.begin(), waveforms.end(), byChannelThenTime);
 
 } // icarus::DaqDecoderICARUSPMT::sortWaveforms()
 
 
+//------------------------------------------------------------------------------
+auto icarus::DaqDecoderICARUSPMT::mergeSortedWaveforms
+  (std::vector<std::vector<ProtoWaveform_t>>&& waveformLists) const
+  -> std::vector<ProtoWaveform_t>
+{
+  /*
+   * k-way merge: a heap keeps the next waveform of each list, the smallest on
+   * top. Equal waveforms are taken in list order, so that the result does not
+   * depend on how (or how concurrently) the lists were made.
+   */
+  using Cursor_t = std::pair<std::size_t, std::size_t>; // { list, position }
+  
+  auto const& lists = waveformLists;
+  auto comesAfter = [&lists](Cursor_t const& a, Cursor_t const& b)
+    {
+      ProtoWaveform_t const& left = lists[a.first][a.second];
+      ProtoWaveform_t const& right = lists[b.first][b.second];
+      if (byChannelThenTime(right, left)) return true;
+      if (byChannelThenTime(left, right)) return false;
+      return a.first > b.first;
+    };
+  
+  std::size_t nWaveforms = 0U;
+  std::vector<Cursor_t> heap;
+  heap.reserve(waveformLists.size());
+  for (auto const& [ iList, list ]: util::enumerate(waveformLists)) {
+    if (list.empty()) continue;
+    nWaveforms += list.size();
+    heap.emplace_back(iList, 0U);
+  } // for
+  std::make_heap(heap.begin(), heap.end(), comesAfter);
+  
+  std::vector<ProtoWaveform_t> merged;
+  merged.reserve(nWaveforms);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), comesAfter);
+    Cursor_t& next = heap.back();
+    merged.push_back(std::move(waveformLists[next.first][next.second]));
+    if (++next.second < waveformLists[next.first].size())
+      std::push_heap(heap.begin(), heap.end(), comesAfter);
+    else heap.pop_back();
+  } // while
+  
+  waveformLists.clear();
+  return merged;
+  
+} // icarus::DaqDecoderICARUSPMT::mergeSortedWaveforms()
+
+
 //------------------------------------------------------------------------------
 void icarus::DaqDecoderICARUSPMT::initTrees
   (std::vector<std::string> const& treeNames)
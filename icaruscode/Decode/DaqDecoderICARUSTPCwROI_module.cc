@@ -38,7 +38,6 @@
 #include "tbb/blocked_range.h"
 #include "tbb/task_arena.h"
 #include "tbb/spin_mutex.h"
-#include "tbb/concurrent_vector.h"
 
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
@@ -50,6 +49,8 @@
 
 #include "icaruscode/Utilities/ArtHandleTrackerManager.h"
 #include "icaruscode/Decode/DecoderTools/INoiseFilter.h"
+#include "icaruscode/Decode/DecoderTools/details/A2795Compression.h"
+#include "icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h"
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMap.h"
 
 #include "icarus_signal_processing/ICARUSSigProcDefs.h"
@@ -83,8 +84,10 @@ public:
     using RawDigitCollectionPtr   = std::unique_ptr<RawDigitCollection>;
     using ChannelROICollection    = std::vector<recob::ChannelROI>;
     using ChannelROICollectionPtr = std::unique_ptr<ChannelROICollection>;
-    using ConcurrentRawDigitCol   = tbb::concurrent_vector<raw::RawDigit>;
-    using ConcurrentChannelROICol = tbb::concurrent_vector<recob::ChannelROI>;
+
+    // Each fragment writes its output into its own range of pre-sized collections,
+    // this vector holds the first slot of that range for each fragment
+    using FragmentSlotVec         = std::vector<size_t>;
 
     // Define data structures for organizing the decoded fragments
     // The idea is to form complete "images" organized by "logical" TPC. Here we are including
@@ -106,11 +109,15 @@ public:
     void processSingleFragment(size_t,
                                detinfo::DetectorClocksData const& clockData,
                                art::Handle<artdaq::Fragments>, 
-                               ConcurrentRawDigitCol&,
-                               ConcurrentRawDigitCol&,
-                               ConcurrentRawDigitCol&,
-                               ConcurrentRawDigitCol&,
-                               ConcurrentChannelROICol&) const;
+                               size_t,
+                               RawDigitCollection&,
+                               RawDigitCollection&,
+                               RawDigitCollection&,
+                               RawDigitCollection&,
+                               ChannelROICollection&) const;
+
+    // Determine the output slot range of each fragment, returns the total number of slots
+    size_t computeFragmentSlots(const artdaq::Fragments&, FragmentSlotVec&) const;
 
 private:
     class multiThreadFragmentProcessing
@@ -119,43 +126,42 @@ private:
         multiThreadFragmentProcessing(DaqDecoderICARUSTPCwROI const&        parent,
                                       detinfo::DetectorClocksData const&    clockData,
                                       art::Handle<artdaq::Fragments> const& fragmentsHandle,
-                                      ConcurrentRawDigitCol&                concurrentRawRawDigits,
-                                      ConcurrentRawDigitCol&                concurrentRawDigits,
-                                      ConcurrentRawDigitCol&                coherentRawDigits,
-                                      ConcurrentRawDigitCol&                morphedRawDigits,
-                                      ConcurrentChannelROICol&              concurrentROIs)
+                                      FragmentSlotVec const&                fragmentSlotVec,
+                                      RawDigitCollection&                   rawRawDigits,
+                                      RawDigitCollection&                   rawDigits,
+                                      RawDigitCollection&                   coherentRawDigits,
+                                      RawDigitCollection&                   morphedRawDigits,
+                                      ChannelROICollection&                 channelROIs)
             : fDaqDecoderICARUSTPCwROI(parent),
               fClockData{clockData},
               fFragmentsHandle(fragmentsHandle),
-              fConcurrentRawRawDigits(concurrentRawRawDigits),
-              fConcurrentRawDigits(concurrentRawDigits),
+              fFragmentSlotVec(fragmentSlotVec),
+              fRawRawDigits(rawRawDigits),
+              fRawDigits(rawDigits),
               fCoherentRawDigits(coherentRawDigits),
               fMorphedRawDigits(morphedRawDigits),
-              fConcurrentROIs(concurrentROIs)
+              fChannelROIs(channelROIs)
         {}
 
         void operator()(const tbb::blocked_range<size_t>& range) const
         {
             for (size_t idx = range.begin(); idx < range.end(); idx++)
-              fDaqDecoderICARUSTPCwROI.processSingleFragment(idx, fClockData, fFragmentsHandle, fConcurrentRawRawDigits, fConcurrentRawDigits, fCoherentRawDigits, fMorphedRawDigits, fConcurrentROIs);
+              fDaqDecoderICARUSTPCwROI.processSingleFragment(idx, fClockData, fFragmentsHandle, fFragmentSlotVec[idx], fRawRawDigits, fRawDigits, fCoherentRawDigits, fMorphedRawDigits, fChannelROIs);
         }
     private:
         const DaqDecoderICARUSTPCwROI&        fDaqDecoderICARUSTPCwROI;
         detinfo::DetectorClocksData const&    fClockData;
         art::Handle<artdaq::Fragments> const& fFragmentsHandle;
-        ConcurrentRawDigitCol&                fConcurrentRawRawDigits;
-        ConcurrentRawDigitCol&                fConcurrentRawDigits;
-        ConcurrentRawDigitCol&                fCoherentRawDigits;
-        ConcurrentRawDigitCol&                fMorphedRawDigits;
-        ConcurrentChannelROICol&              fConcurrentROIs;
+        FragmentSlotVec const&                fFragmentSlotVec;
+        RawDigitCollection&                   fRawRawDigits;
+        RawDigitCollection&                   fRawDigits;
+        RawDigitCollection&                   fCoherentRawDigits;
+        RawDigitCollection&                   fMorphedRawDigits;
+        ChannelROICollection&                 fChannelROIs;
     };
 
-    // Function to save our RawDigits
-    void saveRawDigits(const icarus_signal_processing::ArrayFloat&, 
-                       const icarus_signal_processing::VectorFloat&, 
-                       const icarus_signal_processing::VectorFloat&,
-                       const icarus_signal_processing::VectorInt&,
-                       ConcurrentRawDigitCol&) const;
+    // Remove the slots left empty by skipped fragments/boards and put the collection in channel order
+    template <typename T> void finalizeCollection(std::vector<T>&) const;
 
     // Fcl parameters.
     std::vector<art::InputTag>                                  fFragmentsLabelVec;          ///< The input artdaq fragment label vector (for more than one)
@@ -192,6 +198,9 @@ private:
     // Tools for decoding fragments depending on type
     std::vector<std::unique_ptr<INoiseFilter>>                  fDecoderToolVec;       ///< Decoder tools
 
+    // Payload of compressed fragments, decompressed (one buffer per thread, reused across fragments)
+    mutable std::vector<std::vector<uint16_t>>                  fDecompressedDataVec;
+
     // Useful services, keep copies for now (we can update during begin run periods)
     geo::GeometryCore const*                                    fGeometry;             ///< pointer to Geometry service
     const icarusDB::IICARUSChannelMap*                          fChannelMap;
@@ -230,6 +239,8 @@ DaqDecoderICARUSTPCwROI::DaqDecoderICARUSTPCwROI(fhicl::ParameterSet const & pse
         decoderTool = art::make_tool<INoiseFilter>(decoderToolParams);
     }
 
+    fDecompressedDataVec.resize(max_concurrency);
+
     // Set up our "producers" 
     // Note that we can have multiple instances input to the module
     // Our convention will be to create a similar number of outputs with the same instance names
@@ -361,11 +372,17 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
         art::Handle<artdaq::Fragments> const& daq_handle
           = dataCacheRemover.getHandle<artdaq::Fragments>(fragmentLabel);
 
-        ConcurrentRawDigitCol   concurrentRawDigits;
-        ConcurrentRawDigitCol   concurrentRawRawDigits;
-        ConcurrentRawDigitCol   coherentRawDigits;
-        ConcurrentRawDigitCol   morphedRawDigits;
-        ConcurrentChannelROICol concurrentROIs;
+        // Pre-size the output so each fragment owns a fixed range of slots, this keeps the
+        // output independent of the thread scheduling and avoids any locking or copying
+        FragmentSlotVec fragmentSlotVec;
+
+        size_t nSlots = computeFragmentSlots(*daq_handle, fragmentSlotVec);
+
+        RawDigitCollectionPtr   rawDigitCollection    = std::make_unique<RawDigitCollection>(nSlots);
+        RawDigitCollectionPtr   rawRawDigitCollection = std::make_unique<RawDigitCollection>(fOutputRawWaveform ? nSlots : 0);
+        RawDigitCollectionPtr   coherentCollection    = std::make_unique<RawDigitCollection>(fOutputCorrection  ? nSlots : 0);
+        RawDigitCollectionPtr   morphedCollection     = std::make_unique<RawDigitCollection>(fOutputMorphed     ? nSlots : 0);
+        ChannelROICollectionPtr channelROICollection  = std::make_unique<ChannelROICollection>(nSlots);
 
         PlaneIdxToImageMap   planeIdxToImageMap;
         PlaneIdxToChannelMap planeIdxToChannelMap;
@@ -388,7 +405,7 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
         // ... Launch multiple threads with TBB to do the deconvolution and find ROIs in parallel
         auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService>()->DataFor(event);
 
-        multiThreadFragmentProcessing fragmentProcessing(*this, clockData, daq_handle, concurrentRawRawDigits, concurrentRawDigits, coherentRawDigits, morphedRawDigits, concurrentROIs);
+        multiThreadFragmentProcessing fragmentProcessing(*this, clockData, daq_handle, fragmentSlotVec, *rawRawDigitCollection, *rawDigitCollection, *coherentCollection, *morphedCollection, *channelROICollection);
 
         tbb::parallel_for(tbb::blocked_range<size_t>(0, daq_handle->size()), fragmentProcessing);
 
@@ -397,12 +414,8 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
 
     //    tbb::parallel_for(tbb::blocked_range<size_t>(0, fNumROPs), imageProcessing);
     
-        // Copy the raw digits from the concurrent vector to our output vector
-        RawDigitCollectionPtr rawDigitCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(concurrentRawDigits.begin()), 
-                                                                                                std::move_iterator(concurrentRawDigits.end()));
-    
         // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-        std::sort(rawDigitCollection->begin(),rawDigitCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
+        finalizeCollection(*rawDigitCollection);
 
         // What did we get back?
         mf::LogDebug("DaqDecoderICARUSTPCwROI") << "****> Total size of map: " << planeIdxToImageMap.size() << std::endl;
@@ -415,22 +428,15 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
         event.put(std::move(rawDigitCollection), fragmentLabel.instance());
 
         // Do the same to output the candidate ROIs
-        ChannelROICollectionPtr channelROICollection = std::make_unique<std::vector<recob::ChannelROI>>(std::move_iterator(concurrentROIs.begin()),
-                                                                                                        std::move_iterator(concurrentROIs.end()));
-
-        std::sort(channelROICollection->begin(),channelROICollection->end(),[](const auto& left, const auto& right){return left.Channel() < right.Channel();});
+        finalizeCollection(*channelROICollection);
 
         event.put(std::move(channelROICollection), fragmentLabel.instance());
     
     
         if (fOutputRawWaveform)
         {
-            // Copy the raw digits from the concurrent vector to our output vector
-            RawDigitCollectionPtr rawRawDigitCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(concurrentRawRawDigits.begin()), 
-                                                                                                       std::move_iterator(concurrentRawRawDigits.end()));
-    
             // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-            std::sort(rawRawDigitCollection->begin(),rawRawDigitCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
+            finalizeCollection(*rawRawDigitCollection);
     
             // Now transfer ownership to the event store
             event.put(std::move(rawRawDigitCollection),fragmentLabel.instance() + fOutputRawWavePath);
@@ -438,12 +444,8 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
     
         if (fOutputCorrection)
         {
-            // Copy the raw digits from the concurrent vector to our output vector
-            RawDigitCollectionPtr coherentCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(coherentRawDigits.begin()), 
-                                                                                                    std::move_iterator(coherentRawDigits.end()));
-    
             // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-            std::sort(coherentCollection->begin(),coherentCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
+            finalizeCollection(*coherentCollection);
     
             // Now transfer ownership to the event store
             event.put(std::move(coherentCollection),fragmentLabel.instance() + fOutputCoherentPath);
@@ -451,12 +453,8 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
     
         if (fOutputMorphed)
         {
-            // Copy the raw digits from the concurrent vector to our output vector
-            RawDigitCollectionPtr morphedCollection = std::make_unique<std::vector<raw::RawDigit>>(std::move_iterator(morphedRawDigits.begin()), 
-                                                                                                   std::move_iterator(morphedRawDigits.end()));
-    
             // Want the RawDigits to be sorted in channel order... has to be done somewhere so why not now?
-            std::sort(morphedCollection->begin(),morphedCollection->end(),[](const auto& left,const auto&right){return left.Channel() < right.Channel();});
+            finalizeCollection(*morphedCollection);
     
             // Now transfer ownership to the event store
             event.put(std::move(morphedCollection),fragmentLabel.instance() + fOutputMorphedPath);
@@ -475,11 +473,12 @@ void DaqDecoderICARUSTPCwROI::produce(art::Event & event, art::ProcessingFrame c
 void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t                             idx,
                                                     detinfo::DetectorClocksData const& clockData,
                                                     art::Handle<artdaq::Fragments>     fragmentHandle,
-                                                    ConcurrentRawDigitCol&             concurrentRawRawDigitCol,
-                                                    ConcurrentRawDigitCol&             concurrentRawDigitCol,
-                                                    ConcurrentRawDigitCol&             coherentRawDigitCol,
-                                                    ConcurrentRawDigitCol&             morphedRawDigitCol,
-                                                    ConcurrentChannelROICol&           concurrentROIs) const
+                                                    size_t                             fragmentSlot,
+                                                    RawDigitCollection&                rawRawDigitCol,
+                                                    RawDigitCollection&                rawDigitCol,
+                                                    RawDigitCollection&                coherentRawDigitCol,
+                                                    RawDigitCollection&                morphedRawDigitCol,
+                                                    ChannelROICollection&              channelROICol) const
 {
     cet::cpu_timer theClockProcess;
 
@@ -551,6 +550,19 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
     // Recover pointer to the decoder needed here
     INoiseFilter* decoderTool = fDecoderToolVec[tbb::this_task_arena::current_thread_index()].get();
 
+    // Compressed fragments are decompressed all at once (only once they are known to be decoded), then unpacked as the uncompressed ones
+    std::vector<uint16_t>& decompressedData   = fDecompressedDataVec[tbb::this_task_arena::current_thread_index()];
+    bool const             isDeltaCompressed  = (physCrateFragment.metadata()->compression_scheme() == daq::details::A2795DeltaCompression);
+
+    if (isDeltaCompressed)
+    {
+        decompressedData.resize(nBoardsPerFragment * daq::details::A2795BoardWords(nChannelsPerBoard, nSamplesPerChannel));
+        daq::details::decompressA2795Boards(reinterpret_cast<uint16_t const*>(fragmentPtr->dataBeginBytes()),
+                                            fragmentPtr->dataSizeBytes() / sizeof(uint16_t),
+                                            nBoardsPerFragment, nChannelsPerBoard, nSamplesPerChannel,
+                                            decompressedData.data());
+    }
+
     // Create a local channel pair  to hold at most a boards worth of info (64 channels x 4096 ticks)
     ChannelArrayPair channelArrayPair;
 
@@ -585,16 +597,36 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
         {
             mf::LogInfo(fLogCategory) << "==> Found board/boardSlot mismatch, crate: " << crateName << ", board: " << board << ", boardSlot: " << boardSlot << " channelPlanePair: " << fChannelMap->getChannelPlanePair(boardIDVec[board]).front().first << "/"  << fChannelMap->getChannelPlanePair(boardIDVec[board]).front().second << ", slot: " << channelPlanePairVec[0].first << "/" << channelPlanePairVec[0].second;
         }
-        // Copy to input data array
-        for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++)
+        // Copy to input data array, unpacking the whole board at once unless it is compressed in an unknown way
+        if (physCrateFragment.metadata()->compression_scheme() == 0)
+        {
+            daq::details::unpackTPCBoardWaveforms(physCrateFragment.BoardData(board),
+                                                  nChannelsPerBoard,
+                                                  nSamplesPerChannel,
+                                                  daq::details::TPCBoardADCmask(physCrateFragment.metadata()->num_adc_bits()),
+                                                  channelArrayPair.second.begin());
+        }
+        else if (isDeltaCompressed)
         {
-           icarus_signal_processing::VectorFloat& rawDataVec = channelArrayPair.second[chanIdx];
-           for (size_t tick = 0; tick < nSamplesPerChannel; ++tick)
-             rawDataVec[tick] = -physCrateFragment.adc_val(board, chanIdx, tick);
+            daq::details::unpackTPCBoardWaveforms(daq::details::A2795BoardSamples(decompressedData.data(), board, nChannelsPerBoard, nSamplesPerChannel),
+                                                  nChannelsPerBoard,
+                                                  nSamplesPerChannel,
+                                                  daq::details::TPCBoardADCmask(physCrateFragment.metadata()->num_adc_bits()),
+                                                  channelArrayPair.second.begin());
+        }
+        else
+        {
+            for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++)
+            {
+               icarus_signal_processing::VectorFloat& rawDataVec = channelArrayPair.second[chanIdx];
+               for (size_t tick = 0; tick < nSamplesPerChannel; ++tick)
+                 rawDataVec[tick] = -physCrateFragment.adc_val(board, chanIdx, tick);
+            }
+        }
 
-          // Keep track of the channel
+        // Keep track of the channels
+        for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++)
           channelArrayPair.first[chanIdx] = channelPlanePairVec[chanIdx];
-        }
 
         //process_fragment(event, rawfrag, product_collection, header_collection);
         decoderTool->process_fragment(clockData, channelArrayPair.first, channelArrayPair.second, fCoherentNoiseGrouping);
@@ -621,6 +653,9 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
             // Get the channel number on the Fragment
             raw::ChannelID_t channel = channelPlanePairVec[chanIdx].first;
 
+            // The output slot reserved for this channel
+            size_t slot = fragmentSlot + board * nChannelsPerBoard + chanIdx;
+
             // Are we storing the raw waveforms?
             if (fOutputRawWaveform)
             {
@@ -630,9 +665,9 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
                 // Need to convert from float to short int
                 std::transform(waveform.begin(),waveform.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
     
-                ConcurrentRawDigitCol::iterator newRawObjItr = concurrentRawRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
+                rawRawDigitCol[slot] = raw::RawDigit(channel,wvfm.size(),wvfm);
 
-                newRawObjItr->SetPedestal(decoderTool->getPedestalVals()[chanIdx],decoderTool->getFullRMSVals()[chanIdx]);
+                rawRawDigitCol[slot].SetPedestal(decoderTool->getPedestalVals()[chanIdx],decoderTool->getFullRMSVals()[chanIdx]);
             }
 
             if (fOutputCorrection)
@@ -642,10 +677,9 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
                 // Need to convert from float to short int
                 std::transform(corrections.begin(),corrections.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
 
-                //ConcurrentRawDigitCol::iterator newRawObjItr = coherentRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
-                ConcurrentRawDigitCol::iterator newRawObjItr = coherentRawDigitCol.push_back(raw::RawDigit(channel,wvfm.size(),wvfm)); 
+                coherentRawDigitCol[slot] = raw::RawDigit(channel,wvfm.size(),wvfm);
 
-                newRawObjItr->SetPedestal(0.,0.);
+                coherentRawDigitCol[slot].SetPedestal(0.,0.);
             }
 
             if (fOutputMorphed)
@@ -655,10 +689,9 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
                 // Need to convert from float to short int
                 std::transform(corrections.begin(),corrections.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
 
-                //ConcurrentRawDigitCol::iterator newRawObjItr = coherentRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
-                ConcurrentRawDigitCol::iterator newRawObjItr = morphedRawDigitCol.push_back(raw::RawDigit(channel,wvfm.size(),wvfm)); 
+                morphedRawDigitCol[slot] = raw::RawDigit(channel,wvfm.size(),wvfm);
 
-                newRawObjItr->SetPedestal(0.,0.);
+                morphedRawDigitCol[slot].SetPedestal(0.,0.);
             }
 
             // Now determine the pedestal and correct for it
@@ -674,9 +707,9 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
             // Need to convert from float to short int
             std::transform(pedCorWaveforms.begin(),pedCorWaveforms.end(),wvfm.begin(),[](const auto& val){return short(std::round(val));});
 
-            ConcurrentRawDigitCol::iterator newObjItr = concurrentRawDigitCol.emplace_back(channel,wvfm.size(),wvfm); 
+            rawDigitCol[slot] = raw::RawDigit(channel,wvfm.size(),wvfm);
 
-            newObjItr->SetPedestal(localPedestal,localFullRMS);
+            rawDigitCol[slot].SetPedestal(localPedestal,localFullRMS);
 
             // And, finally, the ROIs 
             const icarus_signal_processing::VectorBool& chanROIs = decoderTool->getROIVals()[chanIdx];
@@ -703,7 +736,7 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
                 roiIdx++;
             }
         
-            concurrentROIs.push_back(recob::ChannelROICreator(std::move(ROIVec),channel).move());
+            channelROICol[slot] = recob::ChannelROICreator(std::move(ROIVec),channel).move();
         }
     }
 
@@ -722,6 +755,43 @@ void DaqDecoderICARUSTPCwROI::processSingleFragment(size_t
     return;
 }
 
+size_t DaqDecoderICARUSTPCwROI::computeFragmentSlots(const artdaq::Fragments& fragments, FragmentSlotVec& fragmentSlotVec) const
+{
+    size_t nSlots(0);
+
+    fragmentSlotVec.resize(fragments.size());
+
+    for(size_t idx = 0; idx < fragments.size(); idx++)
+    {
+        fragmentSlotVec[idx] = nSlots;
+
+        artdaq::detail::RawFragmentHeader::fragment_id_t fragmentID = fragments[idx].fragmentID();
+
+        // Fragments unknown to the channel map are skipped in processSingleFragment
+        if (!fChannelMap->hasFragmentID(fragmentID)) continue;
+
+        icarus::PhysCrateFragment physCrateFragment(fragments[idx]);
+
+        // Only boards both in the channel map and in the fragment are decoded
+        size_t nBoards = std::min(fChannelMap->getReadoutBoardVec(fragmentID).size(), size_t(physCrateFragment.nBoards()));
+
+        nSlots += nBoards * physCrateFragment.nChannelsPerBoard();
+    }
+
+    return nSlots;
+}
+
+template <typename T> void DaqDecoderICARUSTPCwROI::finalizeCollection(std::vector<T>& collection) const
+{
+    // Slots which were never filled still have the invalid channel of a default constructed object
+    collection.erase(std::remove_if(collection.begin(),collection.end(),[](const auto& obj){return obj.Channel() == raw::InvalidChannelID;}),collection.end());
+
+    // The input order no longer depends on the threads so the sort is reproducible
+    std::sort(collection.begin(),collection.end(),[](const auto& left,const auto& right){return left.Channel() < right.Channel();});
+
+    return;
+}
+
 //----------------------------------------------------------------------------
 /// End job method.
 void DaqDecoderICARUSTPCwROI::endJob(art::ProcessingFrame const&)
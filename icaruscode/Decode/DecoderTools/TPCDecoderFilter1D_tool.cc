@@ -23,6 +23,8 @@
 #include "sbndaq-artdaq-core/Overlays/ICARUS/PhysCrateFragment.hh"
 
 #include "icaruscode/Decode/DecoderTools/IDecoderFilter.h"
+#include "icaruscode/Decode/DecoderTools/details/A2795Compression.h"
+#include "icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h"
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMap.h"
 
 #include "icarus_signal_processing/WaveformTools.h"
@@ -74,70 +76,73 @@ public:
     /**
      *  @brief Recover the channels for the processed fragment
      */
-    const icarus_signal_processing::VectorInt  getChannelIDs()       const override {return fChannelIDVec;}
+    const icarus_signal_processing::VectorInt& getChannelIDs()       const override {return fChannelIDVec;}
 
     /**
      *  @brief Recover the selection values
      */
-    const icarus_signal_processing::ArrayBool  getSelectionVals()    const override {return fSelectVals;};
+    const icarus_signal_processing::ArrayBool& getSelectionVals()    const override {return fSelectVals;};
 
     /**
      *  @brief Recover the ROI values
      */
-    const icarus_signal_processing::ArrayBool  getROIVals()          const override {return fROIVals;};
+    const icarus_signal_processing::ArrayBool& getROIVals()          const override {return fROIVals;};
 
     /**
      *  @brief Recover the pedestal subtracted waveforms
      */
-    const icarus_signal_processing::ArrayFloat getRawWaveforms()     const override {return fRawWaveforms;};
+    const icarus_signal_processing::ArrayFloat& getRawWaveforms()     const override {return fRawWaveforms;};
 
     /**
      *  @brief Recover the pedestal subtracted waveforms
      */
-    const icarus_signal_processing::ArrayFloat getPedCorWaveforms()  const override {return fPedCorWaveforms;};
+    const icarus_signal_processing::ArrayFloat& getPedCorWaveforms()  const override {return fPedCorWaveforms;};
 
     /**
      *  @brief Recover the "intrinsic" RMS
      */
-    const icarus_signal_processing::ArrayFloat getIntrinsicRMS()     const override {return fIntrinsicRMS;};
+    const icarus_signal_processing::ArrayFloat& getIntrinsicRMS()     const override {return fIntrinsicRMS;};
 
     /**
      *  @brief Recover the correction median values
      */
-    const icarus_signal_processing::ArrayFloat getCorrectedMedians()  const override {return fCorrectedMedians;};
+    const icarus_signal_processing::ArrayFloat& getCorrectedMedians()  const override {return fCorrectedMedians;};
 
     /**
      *  @brief Recover the waveforms less coherent noise
      */
-    const icarus_signal_processing::ArrayFloat getWaveLessCoherent()  const override {return fWaveLessCoherent;};
+    const icarus_signal_processing::ArrayFloat& getWaveLessCoherent()  const override {return fWaveLessCoherent;};
 
     /**
      *  @brief Recover the morphological filter waveforms
      */
-    const icarus_signal_processing::ArrayFloat getMorphedWaveforms()  const override {return fMorphedWaveforms;};
+    const icarus_signal_processing::ArrayFloat& getMorphedWaveforms()  const override {return fMorphedWaveforms;};
 
     /**
      *  @brief Recover the pedestals for each channel
      */
-    const icarus_signal_processing::VectorFloat getPedestalVals()     const override {return fPedestalVals;};
+    const icarus_signal_processing::VectorFloat& getPedestalVals()     const override {return fPedestalVals;};
 
     /**
      *  @brief Recover the full RMS before coherent noise
      */
-    const icarus_signal_processing::VectorFloat getFullRMSVals()      const override {return fFullRMSVals;};
+    const icarus_signal_processing::VectorFloat& getFullRMSVals()      const override {return fFullRMSVals;};
 
     /**
      *  @brief Recover the truncated RMS noise
      */
-    const icarus_signal_processing::VectorFloat getTruncRMSVals()     const override {return fTruncRMSVals;};
+    const icarus_signal_processing::VectorFloat& getTruncRMSVals()     const override {return fTruncRMSVals;};
 
     /**
      *  @brief Recover the number of bins after truncation
      */
-    const icarus_signal_processing::VectorInt   getNumTruncBins()     const override {return fNumTruncBins;};
+    const icarus_signal_processing::VectorInt&  getNumTruncBins()     const override {return fNumTruncBins;};
 
 private:
 
+    // Create the morphological filter function configured for the given plane
+    icarus_signal_processing::FilterFunctionVec::value_type makeFilterFunction(unsigned int plane) const;
+
     using FloatPairVec = std::vector<std::pair<float,float>>;
 
     uint32_t                                       fFragment_id_offset;     //< Allow offset for id
@@ -170,6 +175,7 @@ private:
     icarus_signal_processing::ArrayFloat           fCorrectedMedians;
     icarus_signal_processing::ArrayFloat           fWaveLessCoherent;
     icarus_signal_processing::ArrayFloat           fMorphedWaveforms;
+    std::vector<uint16_t>                          fDecompressedData;       //< Payload of compressed fragments, decompressed
       
     icarus_signal_processing::VectorFloat          fPedestalVals;
     icarus_signal_processing::VectorFloat          fFullRMSVals;
@@ -180,6 +186,11 @@ private:
     icarus_signal_processing::VectorFloat          fThresholdVec;
 
     icarus_signal_processing::FilterFunctionVec    fFilterFunctionVec;
+    std::vector<unsigned int>                      fFilterFunctionPlaneVec; //< Plane each filter function was made for
+
+    // Statistics
+    size_t                                         fNumFilterAllocations;   //< Number of filter functions created
+    size_t                                         fNumFragments;           //< Number of fragments processed
     
     const geo::Geometry*                           fGeometry;              //< pointer to the Geometry service
     const icarusDB::IICARUSChannelMap*             fChannelMap;
@@ -189,7 +200,9 @@ private:
 
 };
 
-TPCDecoderFilter1D::TPCDecoderFilter1D(fhicl::ParameterSet const &pset)
+TPCDecoderFilter1D::TPCDecoderFilter1D(fhicl::ParameterSet const &pset) :
+    fNumFilterAllocations(0),
+    fNumFragments(0)
 {
     std::cout << "TPCDecoderFilter1D is calling configure method" << std::endl;
     this->configure(pset);
@@ -216,6 +229,7 @@ TPCDecoderFilter1D::TPCDecoderFilter1D(fhicl::ParameterSet const &pset)
 
 TPCDecoderFilter1D::~TPCDecoderFilter1D()
 {
+    mf::LogInfo("TPCDecoderFilter1D") << "Created " << fNumFilterAllocations << " filter functions over " << fNumFragments << " fragments";
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -242,6 +256,10 @@ void TPCDecoderFilter1D::configure(fhicl::ParameterSet const &pset)
     fGeometry   = art::ServiceHandle<geo::Geometry const>{}.get();
     fChannelMap = art::ServiceHandle<icarusDB::IICARUSChannelMap const>{}.get();
 
+    // Filter functions made with a previous configuration can't be reused
+    fFilterFunctionVec.clear();
+    fFilterFunctionPlaneVec.clear();
+
     fFFTFilterFunctionVec.clear();
 
     if (fUseFFTFilter)
@@ -267,6 +285,8 @@ void TPCDecoderFilter1D::process_fragment(detinfo::DetectorClocksData const&,
 
     theClockTotal.start();
 
+    fNumFragments++;
+
     // convert fragment to Nevis fragment
     icarus::PhysCrateFragment physCrateFragment(fragment);
 
@@ -275,6 +295,17 @@ void TPCDecoderFilter1D::process_fragment(detinfo::DetectorClocksData const&,
     size_t nSamplesPerChannel   = physCrateFragment.nSamplesPerChannel();
 //    size_t nChannelsPerFragment = nBoardsPerFragment * nChannelsPerBoard;
 
+    // Compressed fragments are decompressed all at once, then unpacked as the uncompressed ones
+    bool const isDeltaCompressed = (physCrateFragment.metadata()->compression_scheme() == daq::details::A2795DeltaCompression);
+    if (isDeltaCompressed)
+    {
+        fDecompressedData.resize(nBoardsPerFragment * daq::details::A2795BoardWords(nChannelsPerBoard, nSamplesPerChannel));
+        daq::details::decompressA2795Boards(reinterpret_cast<uint16_t const*>(fragment.dataBeginBytes()),
+                                            fragment.dataSizeBytes() / sizeof(uint16_t),
+                                            nBoardsPerFragment, nChannelsPerBoard, nSamplesPerChannel,
+                                            fDecompressedData.data());
+    }
+
     // Recover the Fragment id:
     artdaq::detail::RawFragmentHeader::fragment_id_t fragmentID = fragment.fragmentID();
 
@@ -362,6 +393,7 @@ void TPCDecoderFilter1D::process_fragment(detinfo::DetectorClocksData const&,
     if (fThresholdVec.empty())      fThresholdVec     = icarus_signal_processing::VectorFloat(maxChannelsPerFragment / fCoherentNoiseGrouping);
 
     if (fFilterFunctionVec.empty()) fFilterFunctionVec.resize(maxChannelsPerFragment);
+    if (fFilterFunctionPlaneVec.empty()) fFilterFunctionPlaneVec.resize(maxChannelsPerFragment);
    
     // Allocate the de-noising object
     icarus_signal_processing::Denoiser1D           denoiser;
@@ -396,6 +428,33 @@ void TPCDecoderFilter1D::process_fragment(detinfo::DetectorClocksData const&,
         // This is where we would recover the base channel for the board from database/module
         size_t boardOffset = nChannelsPerBoard * board;
 
+        // Unpack the whole board at once, data compressed in unknown ways is left to the fragment overlay
+        if (physCrateFragment.metadata()->compression_scheme() == 0)
+        {
+            daq::details::unpackTPCBoardWaveforms(physCrateFragment.BoardData(board),
+                                                  nChannelsPerBoard,
+                                                  nSamplesPerChannel,
+                                                  daq::details::TPCBoardADCmask(physCrateFragment.metadata()->num_adc_bits()),
+                                                  fRawWaveforms.begin() + boardOffset);
+        }
+        else if (isDeltaCompressed)
+        {
+            daq::details::unpackTPCBoardWaveforms(daq::details::A2795BoardSamples(fDecompressedData.data(), board, nChannelsPerBoard, nSamplesPerChannel),
+                                                  nChannelsPerBoard,
+                                                  nSamplesPerChannel,
+                                                  daq::details::TPCBoardADCmask(physCrateFragment.metadata()->num_adc_bits()),
+                                                  fRawWaveforms.begin() + boardOffset);
+        }
+        else
+        {
+            for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++)
+            {
+                icarus_signal_processing::VectorFloat& rawDataVec = fRawWaveforms[boardOffset + chanIdx];
+                for (size_t tick = 0; tick < nSamplesPerChannel; ++tick)
+                  rawDataVec[tick] = -physCrateFragment.adc_val(board, chanIdx, tick);
+            }
+        }
+
         // Copy to input data array
         for(size_t chanIdx = 0; chanIdx < nChannelsPerBoard; chanIdx++)
         {
@@ -403,8 +462,6 @@ void TPCDecoderFilter1D::process_fragment(detinfo::DetectorClocksData const&,
             size_t channelOnBoard = boardOffset + chanIdx;
 
             icarus_signal_processing::VectorFloat& rawDataVec = fRawWaveforms[channelOnBoard];
-            for (size_t tick = 0; tick < nSamplesPerChannel; ++tick)
-              rawDataVec[tick] = -physCrateFragment.adc_val(board, chanIdx, tick);
 
             icarus_signal_processing::VectorFloat& pedCorDataVec = fPedCorWaveforms[channelOnBoard];
 
@@ -423,26 +480,12 @@ void TPCDecoderFilter1D::process_fragment(detinfo::DetectorClocksData const&,
                 continue;
             }
 
-            switch(fFilterModeVec[plane][0])
+            // The filter functions are kept from one fragment to the next, only make a new one when this slot changes plane
+            if (!fFilterFunctionVec[channelOnBoard] || fFilterFunctionPlaneVec[channelOnBoard] != plane)
             {
-                case 'd' :
-                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus_signal_processing::Dilation1D>(fStructuringElement);
-                    break;
-                case 'e' :
-                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus_signal_processing::Erosion1D>(fStructuringElement);
-                    break;
-                case 'g' :
-                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus_signal_processing::Gradient1D>(fStructuringElement);
-                    break;
-                case 'a' :
-                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus_signal_processing::Average1D>(fStructuringElement);
-                    break;
-                case 'm' :
-                    fFilterFunctionVec[channelOnBoard] = std::make_unique<icarus_signal_processing::Median1D>(fStructuringElement);
-                    break;
-                default:
-                    std::cout << "***** FOUND NO MATCH FOR TYPE: " << fFilterModeVec[plane] << ", plane " << plane << " DURING INITIALIZATION OF FILTER FUNCTIONS IN TPCDecoderFilter1D" << std::endl;
-                    break;
+                fFilterFunctionVec[channelOnBoard]      = makeFilterFunction(plane);
+                fFilterFunctionPlaneVec[channelOnBoard] = plane;
+                fNumFilterAllocations++;
             }
 
             // Now determine the pedestal and correct for it
@@ -584,5 +627,28 @@ void TPCDecoderFilter1D::process_fragment(detinfo::DetectorClocksData const&,
 }
 
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+icarus_signal_processing::FilterFunctionVec::value_type TPCDecoderFilter1D::makeFilterFunction(unsigned int plane) const
+{
+    switch(fFilterModeVec[plane][0])
+    {
+        case 'd' :
+            return std::make_unique<icarus_signal_processing::Dilation1D>(fStructuringElement);
+        case 'e' :
+            return std::make_unique<icarus_signal_processing::Erosion1D>(fStructuringElement);
+        case 'g' :
+            return std::make_unique<icarus_signal_processing::Gradient1D>(fStructuringElement);
+        case 'a' :
+            return std::make_unique<icarus_signal_processing::Average1D>(fStructuringElement);
+        case 'm' :
+            return std::make_unique<icarus_signal_processing::Median1D>(fStructuringElement);
+        default:
+            std::cout << "***** FOUND NO MATCH FOR TYPE: " << fFilterModeVec[plane] << ", plane " << plane << " DURING INITIALIZATION OF FILTER FUNCTIONS IN TPCDecoderFilter1D" << std::endl;
+            break;
+    }
+
+    return nullptr;
+}
+
 DEFINE_ART_CLASS_TOOL(TPCDecoderFilter1D)
 } // namespace lar_cluster3d
@@ -74,67 +74,67 @@ public:
     /**
      *  @brief Recover the channels for the processed fragment
      */
-    const icarus_signal_processing::VectorInt  getChannelIDs()       const override {return fChannelIDVec;}
+    const icarus_signal_processing::VectorInt& getChannelIDs()       const override {return fChannelIDVec;}
 
     /**
      *  @brief Recover the selection values
      */
-    const icarus_signal_processing::ArrayBool  getSelectionVals()    const override {return fSelectVals;};
+    const icarus_signal_processing::ArrayBool& getSelectionVals()    const override {return fSelectVals;};
 
     /**
      *  @brief Recover the ROI values
      */
-    const icarus_signal_processing::ArrayBool  getROIVals()          const override {return fROIVals;};
+    const icarus_signal_processing::ArrayBool& getROIVals()          const override {return fROIVals;};
 
     /**
      *  @brief Recover the pedestal subtracted waveforms
      */
-    const icarus_signal_processing::ArrayFloat getRawWaveforms()     const override {return fRawWaveforms;};
+    const icarus_signal_processing::ArrayFloat& getRawWaveforms()     const override {return fRawWaveforms;};
 
     /**
      *  @brief Recover the pedestal subtracted waveforms
      */
-    const icarus_signal_processing::ArrayFloat getPedCorWaveforms()  const override {return fPedCorWaveforms;};
+    const icarus_signal_processing::ArrayFloat& getPedCorWaveforms()  const override {return fPedCorWaveforms;};
 
     /**
      *  @brief Recover the "intrinsic" RMS
      */
-    const icarus_signal_processing::ArrayFloat getIntrinsicRMS()     const override {return fIntrinsicRMS;};
+    const icarus_signal_processing::ArrayFloat& getIntrinsicRMS()     const override {return fIntrinsicRMS;};
 
     /**
      *  @brief Recover the correction median values
      */
-    const icarus_signal_processing::ArrayFloat getCorrectedMedians()  const override {return fCorrectedMedians;};
+    const icarus_signal_processing::ArrayFloat& getCorrectedMedians()  const override {return fCorrectedMedians;};
 
     /**
      *  @brief Recover the waveforms less coherent noise
      */
-    const icarus_signal_processing::ArrayFloat getWaveLessCoherent()  const override {return fWaveLessCoherent;};
+    const icarus_signal_processing::ArrayFloat& getWaveLessCoherent()  const override {return fWaveLessCoherent;};
 
     /**
      *  @brief Recover the morphological filter waveforms
      */
-    const icarus_signal_processing::ArrayFloat getMorphedWaveforms()  const override {return fMorphedWaveforms;};
+    const icarus_signal_processing::ArrayFloat& getMorphedWaveforms()  const override {return fMorphedWaveforms;};
 
     /**
      *  @brief Recover the pedestals for each channel
      */
-    const icarus_signal_processing::VectorFloat getPedestalVals()     const override {return fPedestalVals;};
+    const icarus_signal_processing::VectorFloat& getPedestalVals()     const override {return fPedestalVals;};
 
     /**
      *  @brief Recover the full RMS before coherent noise
      */
-    const icarus_signal_processing::VectorFloat getFullRMSVals()      const override {return fFullRMSVals;};
+    const icarus_signal_processing::VectorFloat& getFullRMSVals()      const override {return fFullRMSVals;};
 
     /**
      *  @brief Recover the truncated RMS noise
      */
-    const icarus_signal_processing::VectorFloat getTruncRMSVals()     const override {return fTruncRMSVals;};
+    const icarus_signal_processing::VectorFloat& getTruncRMSVals()     const override {return fTruncRMSVals;};
 
     /**
      *  @brief Recover the number of bins after truncation
      */
-    const icarus_signal_processing::VectorInt   getNumTruncBins()     const override {return fNumTruncBins;};
+    const icarus_signal_processing::VectorInt&  getNumTruncBins()     const override {return fNumTruncBins;};
 
 private:
 
@@ -146,6 +146,9 @@ public:
 
 private:
 
+    // Create the morphological filter function configured for the given plane
+    icarus_signal_processing::FilterFunctionVec::value_type makeFilterFunction(unsigned int plane) const;
+
     using FloatPairVec = std::vector<std::pair<float,float>>;
 
     float                                          fSigmaForTruncation;     //< Selection cut for truncated rms calculation
@@ -182,6 +185,11 @@ private:
     icarus_signal_processing::VectorFloat          fThresholdVec;
 
     icarus_signal_processing::FilterFunctionVec    fFilterFunctionVec;
+    std::vector<unsigned int>                      fFilterFunctionPlaneVec; //< Plane each filter function was made for
+
+    // Statistics
+    size_t                                         fNumFilterAllocations;   //< Number of filter functions created
+    size_t                                         fNumFragments;           //< Number of fragments processed
     
     const geo::Geometry*                           fGeometry;              //< pointer to the Geometry service
 
@@ -189,7 +197,9 @@ private:
     icarus_signal_processing::FFTFilterFunctionVec fFFTFilterFunctionVec;
 };
 
-TPCNoiseFilter1DMC::TPCNoiseFilter1DMC(fhicl::ParameterSet const &pset)
+TPCNoiseFilter1DMC::TPCNoiseFilter1DMC(fhicl::ParameterSet const &pset) :
+    fNumFilterAllocations(0),
+    fNumFragments(0)
 {
     this->configure(pset);
 
@@ -215,6 +225,7 @@ TPCNoiseFilter1DMC::TPCNoiseFilter1DMC(fhicl::ParameterSet const &pset)
 
 TPCNoiseFilter1DMC::~TPCNoiseFilter1DMC()
 {
+    mf::LogInfo("TPCNoiseFilter1DMC") << "Created " << fNumFilterAllocations << " filter functions over " << fNumFragments << " fragments";
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -237,6 +248,10 @@ void TPCNoiseFilter1DMC::configure(fhicl::ParameterSet const &pset)
 
     fGeometry   = art::ServiceHandle<geo::Geometry const>{}.get();
 
+    // Filter functions made with a previous configuration can't be reused
+    fFilterFunctionVec.clear();
+    fFilterFunctionPlaneVec.clear();
+
     fFFTFilterFunctionVec.clear();
 
     std::cout << "TPCNoiseFilter1D configure, fUseFFTFilter: " << fUseFFTFilter << std::endl;
@@ -265,6 +280,8 @@ void TPCNoiseFilter1DMC::process_fragment(detinfo::DetectorClocksData const&,
 
     theClockTotal.start();
 
+    fNumFragments++;
+
     // Recover the number of channels and ticks
     unsigned int numChannels = dataArray.size();
     unsigned int numTicks    = dataArray[0].size();
@@ -288,6 +305,7 @@ void TPCNoiseFilter1DMC::process_fragment(detinfo::DetectorClocksData const&,
     if (fThresholdVec.size()     < numChannels)  fThresholdVec.resize(numChannels);
 
     if (fFilterFunctionVec.size() < numChannels) fFilterFunctionVec.resize(numChannels);
+    if (fFilterFunctionPlaneVec.size() < numChannels) fFilterFunctionPlaneVec.resize(numChannels);
 
     //icarus_signal_processing::IDenoiser1D* denoiser = nullptr;
 
@@ -327,26 +345,12 @@ void TPCNoiseFilter1DMC::process_fragment(detinfo::DetectorClocksData const&,
         // Set the threshold which toggles between planes
         fThresholdVec[idx] = fThreshold[plane];
 
-        switch(fFilterModeVec[plane][0])
+        // The filter functions are kept from one fragment to the next, only make a new one when this slot changes plane
+        if (!fFilterFunctionVec[idx] || fFilterFunctionPlaneVec[idx] != plane)
         {
-            case 'd' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Dilation1D>(fStructuringElement);
-                break;
-            case 'e' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Erosion1D>(fStructuringElement);
-                break;
-            case 'g' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Gradient1D>(fStructuringElement);
-                break;
-            case 'a' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Average1D>(fStructuringElement);
-                break;
-            case 'm' :
-                fFilterFunctionVec[idx] = std::make_unique<icarus_signal_processing::Median1D>(fStructuringElement);
-                break;
-            default:
-                std::cout << "***** FOUND NO MATCH FOR TYPE: " << fFilterModeVec[plane] << ", plane " << plane << " DURING INITIALIZATION OF FILTER FUNCTIONS IN TPCNoiseFilter1DMC" << std::endl;
-                break;
+            fFilterFunctionVec[idx]      = makeFilterFunction(plane);
+            fFilterFunctionPlaneVec[idx] = plane;
+            fNumFilterAllocations++;
         }
 
         std::copy(dataArray[idx].begin(),dataArray[idx].end(),rawDataVec.begin());
@@ -425,5 +429,28 @@ void TPCNoiseFilter1DMC::process_fragment(detinfo::DetectorClocksData const&,
 }
 
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+icarus_signal_processing::FilterFunctionVec::value_type TPCNoiseFilter1DMC::makeFilterFunction(unsigned int plane) const
+{
+    switch(fFilterModeVec[plane][0])
+    {
+        case 'd' :
+            return std::make_unique<icarus_signal_processing::Dilation1D>(fStructuringElement);
+        case 'e' :
+            return std::make_unique<icarus_signal_processing::Erosion1D>(fStructuringElement);
+        case 'g' :
+            return std::make_unique<icarus_signal_processing::Gradient1D>(fStructuringElement);
+        case 'a' :
+            return std::make_unique<icarus_signal_processing::Average1D>(fStructuringElement);
+        case 'm' :
+            return std::make_unique<icarus_signal_processing::Median1D>(fStructuringElement);
+        default:
+            std::cout << "***** FOUND NO MATCH FOR TYPE: " << fFilterModeVec[plane] << ", plane " << plane << " DURING INITIALIZATION OF FILTER FUNCTIONS IN TPCNoiseFilter1DMC" << std::endl;
+            break;
+    }
+
+    return nullptr;
+}
+
 DEFINE_ART_CLASS_TOOL(TPCNoiseFilter1DMC)
 } // namespace lar_cluster3d
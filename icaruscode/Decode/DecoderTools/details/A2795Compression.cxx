@@ -0,0 +1,428 @@
+/**
+ * @file   icaruscode/Decode/DecoderTools/details/A2795Compression.cxx
+ * @brief  Delta compression of the ADC samples of TPC readout boards (A2795).
+ * @see    icaruscode/Decode/DecoderTools/details/A2795Compression.h
+ */
+
+// library header
+#include "icaruscode/Decode/DecoderTools/details/A2795Compression.h"
+#include "icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h" // MaxTPCBoardChannels
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <arpa/inet.h> // htonl()
+#include <array>
+#include <cstring> // std::memcpy()
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif // __SSE2__
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Tag of the words with a sample (or a difference) not packed.
+  constexpr std::uint16_t UnpackedTag = 0x8000;
+
+  /// Whether the `word` starts a block of 4 packed differences.
+  constexpr bool isPacked(std::uint16_t word)
+    { return (word & 0xF000) != UnpackedTag; }
+
+  /// The 12-bit difference in an unpacked `word`, sign-extended.
+  constexpr std::uint16_t unpackedDiff(std::uint16_t word)
+    { return static_cast<std::uint16_t>(static_cast<std::int16_t>(word << 4) >> 4); }
+
+  /// For each byte, its two nibbles sign-extended to 16 bits (low nibble first).
+  constexpr std::array<std::uint32_t, 256> makeNibbleTable() {
+    std::array<std::uint32_t, 256> table {};
+    for (std::uint32_t byte = 0; byte < 256; ++byte) {
+      std::uint32_t const low = (byte & 0xF) ^ 0x8, high = (byte >> 4) ^ 0x8;
+      table[byte] = ((low - 0x8) & 0xFFFF) | (((high - 0x8) & 0xFFFF) << 16);
+    }
+    return table;
+  } // makeNibbleTable()
+
+  constexpr std::array<std::uint32_t, 256> NibbleTable = makeNibbleTable();
+
+
+  void checkChannels(char const* where, std::size_t nChannels) {
+    if ((nChannels % 4 != 0) || (nChannels > daq::details::MaxTPCBoardChannels)) {
+      throw cet::exception(where)
+        << "Board with " << nChannels << " channels, only multiples of 4 up to "
+        << daq::details::MaxTPCBoardChannels << " are supported.\n";
+    }
+  } // checkChannels()
+
+  [[noreturn]] void throwTruncated
+    (char const* where, std::size_t nWords, std::size_t sample)
+  {
+    throw cet::exception(where)
+      << "Compressed data (" << nWords << " words) ends before sample "
+      << sample << " is complete.\n";
+  } // throwTruncated()
+
+
+  /// Writes the first sample of each channel, as is.
+  std::size_t compressFirstSample(std::uint16_t const* samples,
+    std::size_t nChannels, std::uint16_t adcMask, std::uint16_t* out)
+  {
+    for (std::size_t channel = 0; channel < nChannels; ++channel)
+      out[channel] = (samples[channel] & adcMask & 0x0FFF) + UnpackedTag;
+    return nChannels;
+  } // compressFirstSample()
+
+
+  /// Compresses the differences of a whole sample, block by block.
+  std::size_t compressSampleScalar(std::uint16_t const* prev,
+    std::uint16_t const* curr, std::size_t nChannels, std::uint16_t adcMask,
+    std::uint16_t* out)
+  {
+    std::size_t n = 0;
+    bool oddPacked = false;
+    for (std::size_t channel = 0; channel < nChannels; channel += 4) {
+      std::int16_t diff[4];
+      bool packable = true;
+      for (std::size_t i = 0; i < 4; ++i) {
+        diff[i] = static_cast<std::int16_t>
+          ((curr[channel + i] & adcMask) - (prev[channel + i] & adcMask));
+        packable = packable && (diff[i] > -8) && (diff[i] < 8);
+      }
+      if (packable) {
+        out[n++] = (diff[0] & 0xF) | ((diff[1] & 0xF) << 4)
+          | ((diff[2] & 0xF) << 8) | ((diff[3] & 0xF) << 12);
+        oddPacked = !oddPacked;
+      }
+      else {
+        for (std::size_t i = 0; i < 4; ++i)
+          out[n++] = (diff[i] & 0x0FFF) + UnpackedTag;
+      }
+    } // for blocks
+    if (oddPacked) out[n++] = 0; // spacer
+    return n;
+  } // compressSampleScalar()
+
+
+#if defined(__SSE2__)
+
+  /// Compresses the differences of a whole sample, two blocks at a time.
+  std::size_t compressSampleSSE2(std::uint16_t const* prev,
+    std::uint16_t const* curr, std::size_t nChannels, __m128i mask,
+    std::uint16_t* out)
+  {
+    __m128i const lowerLimit = _mm_set1_epi16(-8);
+    __m128i const upperLimit = _mm_set1_epi16(8);
+    __m128i const diffMask = _mm_set1_epi16(0x0FFF);
+    __m128i const tag = _mm_set1_epi16(static_cast<short>(UnpackedTag));
+    __m128i const nibbleMask = _mm_set1_epi16(0x000F);
+    __m128i const nibbleShift = _mm_setr_epi16(1, 16, 256, 4096, 1, 16, 256, 4096);
+    __m128i const one = _mm_set1_epi16(1);
+
+    std::size_t n = 0;
+    bool oddPacked = false;
+    for (std::size_t channel = 0; channel < nChannels; channel += 8) {
+      __m128i const c = _mm_and_si128
+        (_mm_loadu_si128(reinterpret_cast<__m128i const*>(curr + channel)), mask);
+      __m128i const p = _mm_and_si128
+        (_mm_loadu_si128(reinterpret_cast<__m128i const*>(prev + channel)), mask);
+      __m128i const diff = _mm_sub_epi16(c, p);
+
+      // which differences fit a nibble: 8 bits of the mask per block
+      int const small = _mm_movemask_epi8(_mm_and_si128
+        (_mm_cmpgt_epi16(diff, lowerLimit), _mm_cmplt_epi16(diff, upperLimit)));
+
+      __m128i const unpacked
+        = _mm_or_si128(_mm_and_si128(diff, diffMask), tag);
+
+      // packed words: nibbles moved into place and summed in each block;
+      // only the lower 16 bits of each sum matter
+      __m128i const nibbles
+        = _mm_mullo_epi16(_mm_and_si128(diff, nibbleMask), nibbleShift);
+      __m128i const pairs = _mm_madd_epi16(nibbles, one);
+      __m128i const sums = _mm_add_epi32(pairs, _mm_srli_epi64(pairs, 32));
+      std::uint16_t const packed[2] = {
+        static_cast<std::uint16_t>(_mm_cvtsi128_si32(sums)),
+        static_cast<std::uint16_t>(_mm_extract_epi16(sums, 4))
+        };
+
+      // the unpacked words are always written, and overwritten when packed
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(out + n), unpacked);
+      if ((small & 0x00FF) == 0x00FF) {
+        out[n++] = packed[0];
+        oddPacked = !oddPacked;
+      }
+      else n += 4;
+
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(out + n), _mm_srli_si128(unpacked, 8));
+      if ((small & 0xFF00) == 0xFF00) {
+        out[n++] = packed[1];
+        oddPacked = !oddPacked;
+      }
+      else n += 4;
+    } // for pairs of blocks
+    if (oddPacked) out[n++] = 0; // spacer
+    return n;
+  } // compressSampleSSE2()
+
+#endif // __SSE2__
+
+
+  /// Decodes the first sample of each channel.
+  std::size_t decompressFirstSample(std::uint16_t const* data, std::size_t nWords,
+    std::size_t nChannels, std::uint16_t* samples)
+  {
+    // the first sample is normally not packed; if it is, it is summed to 0
+    std::size_t n = 0;
+    std::size_t nPacked = 0;
+    for (std::size_t channel = 0; channel < nChannels; channel += 4) {
+      if (n >= nWords) throwTruncated("decompressA2795Samples", nWords, 0);
+      std::uint16_t const word = data[n];
+      if (isPacked(word)) {
+        for (std::size_t i = 0; i < 4; ++i) {
+          samples[channel + i] = static_cast<std::uint16_t>
+            (NibbleTable[(word >> (4 * i)) & 0xF] & 0xFFFF);
+        }
+        ++n;
+        ++nPacked;
+      }
+      else {
+        if (n + 4 > nWords) throwTruncated("decompressA2795Samples", nWords, 0);
+        for (std::size_t i = 0; i < 4; ++i) samples[channel + i] = data[n + i] & 0x0FFF;
+        n += 4;
+      }
+    } // for blocks
+    if (nPacked % 2 == 1) ++n; // spacer
+    return n;
+  } // decompressFirstSample()
+
+
+  /// Expands the differences of a whole sample; returns the words used.
+  template <bool CheckBounds>
+  std::size_t expandSampleDiffs(std::uint16_t const* data, std::size_t nWords,
+    std::size_t nChannels, std::size_t sample, std::uint16_t* diff)
+  {
+    std::size_t n = 0;
+    std::size_t nPacked = 0;
+    for (std::size_t channel = 0; channel < nChannels; channel += 4) {
+      if (CheckBounds && (n >= nWords))
+        throwTruncated("decompressA2795Samples", nWords, sample);
+      std::uint16_t const word = data[n];
+      if (isPacked(word)) {
+        std::uint32_t const low = NibbleTable[word & 0xFF];
+        std::uint32_t const high = NibbleTable[word >> 8];
+        diff[channel    ] = static_cast<std::uint16_t>(low);
+        diff[channel + 1] = static_cast<std::uint16_t>(low >> 16);
+        diff[channel + 2] = static_cast<std::uint16_t>(high);
+        diff[channel + 3] = static_cast<std::uint16_t>(high >> 16);
+        ++n;
+        ++nPacked;
+      }
+      else {
+        if (CheckBounds && (n + 4 > nWords))
+          throwTruncated("decompressA2795Samples", nWords, sample);
+        for (std::size_t i = 0; i < 4; ++i)
+          diff[channel + i] = unpackedDiff(data[n + i]);
+        n += 4;
+      }
+    } // for blocks
+    if (nPacked % 2 == 1) ++n; // spacer
+    return n;
+  } // expandSampleDiffs()
+
+
+  /// Expands the differences of a whole sample, checking the data bounds
+  /// only if the sample may not fit in them.
+  std::size_t expandSampleDiffs(std::uint16_t const* data, std::size_t nWords,
+    std::size_t nChannels, std::size_t sample, std::uint16_t* diff)
+  {
+    // a sample takes at most one word per channel and a spacer
+    return (nWords > nChannels)
+      ? expandSampleDiffs<false>(data, nWords, nChannels, sample, diff)
+      : expandSampleDiffs<true>(data, nWords, nChannels, sample, diff);
+  } // expandSampleDiffs()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+std::size_t daq::details::compressA2795SamplesScalar(
+  std::uint16_t const* samples,
+  std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t adcMask,
+  std::uint16_t* out
+) {
+  checkChannels("compressA2795Samples", nChannels);
+  if (nSamples == 0) return 0;
+
+  std::size_t n = compressFirstSample(samples, nChannels, adcMask, out);
+  for (std::size_t sample = 1; sample < nSamples; ++sample) {
+    std::uint16_t const* curr = samples + sample * nChannels;
+    n += compressSampleScalar(curr - nChannels, curr, nChannels, adcMask, out + n);
+  }
+  return n;
+} // daq::details::compressA2795SamplesScalar()
+
+
+// -----------------------------------------------------------------------------
+std::size_t daq::details::compressA2795Samples(
+  std::uint16_t const* samples,
+  std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t adcMask,
+  std::uint16_t* out
+) {
+#if defined(__SSE2__)
+
+  checkChannels("compressA2795Samples", nChannels);
+  if ((nChannels % 8 != 0) || (nSamples == 0))
+    return compressA2795SamplesScalar(samples, nChannels, nSamples, adcMask, out);
+
+  __m128i const mask = _mm_set1_epi16(static_cast<short>(adcMask));
+
+  std::size_t n = compressFirstSample(samples, nChannels, adcMask, out);
+  for (std::size_t sample = 1; sample < nSamples; ++sample) {
+    std::uint16_t const* curr = samples + sample * nChannels;
+    n += compressSampleSSE2(curr - nChannels, curr, nChannels, mask, out + n);
+  }
+  return n;
+
+#else // no SSE2
+
+  return compressA2795SamplesScalar(samples, nChannels, nSamples, adcMask, out);
+
+#endif // __SSE2__
+} // daq::details::compressA2795Samples()
+
+
+// -----------------------------------------------------------------------------
+std::size_t daq::details::decompressA2795SamplesScalar(
+  std::uint16_t const* data, std::size_t nWords,
+  std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t* samples
+) {
+  checkChannels("decompressA2795Samples", nChannels);
+  if (nSamples == 0) return 0;
+
+  std::size_t n = decompressFirstSample(data, nWords, nChannels, samples);
+  std::array<std::uint16_t, MaxTPCBoardChannels> diff;
+  for (std::size_t sample = 1; sample < nSamples; ++sample) {
+    if (n > nWords) throwTruncated("decompressA2795Samples", nWords, sample - 1);
+    n += expandSampleDiffs(data + n, nWords - n, nChannels, sample, diff.data());
+    std::uint16_t const* prev = samples + (sample - 1) * nChannels;
+    std::uint16_t* curr = samples + sample * nChannels;
+    for (std::size_t channel = 0; channel < nChannels; ++channel)
+      curr[channel] = prev[channel] + diff[channel];
+  } // for samples
+  if (n > nWords) throwTruncated("decompressA2795Samples", nWords, nSamples - 1);
+  return n;
+} // daq::details::decompressA2795SamplesScalar()
+
+
+// -----------------------------------------------------------------------------
+std::size_t daq::details::decompressA2795Samples(
+  std::uint16_t const* data, std::size_t nWords,
+  std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t* samples
+) {
+#if defined(__SSE2__)
+
+  checkChannels("decompressA2795Samples", nChannels);
+  if ((nChannels % 8 != 0) || (nSamples == 0))
+    return decompressA2795SamplesScalar(data, nWords, nChannels, nSamples, samples);
+
+  std::size_t n = decompressFirstSample(data, nWords, nChannels, samples);
+  std::array<std::uint16_t, MaxTPCBoardChannels> diff;
+  for (std::size_t sample = 1; sample < nSamples; ++sample) {
+    if (n > nWords) throwTruncated("decompressA2795Samples", nWords, sample - 1);
+    n += expandSampleDiffs(data + n, nWords - n, nChannels, sample, diff.data());
+    std::uint16_t const* prev = samples + (sample - 1) * nChannels;
+    std::uint16_t* curr = samples + sample * nChannels;
+    for (std::size_t channel = 0; channel < nChannels; channel += 8) {
+      __m128i const p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(prev + channel));
+      __m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(diff.data() + channel));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(curr + channel), _mm_add_epi16(p, d));
+    }
+  } // for samples
+  if (n > nWords) throwTruncated("decompressA2795Samples", nWords, nSamples - 1);
+  return n;
+
+#else // no SSE2
+
+  return decompressA2795SamplesScalar(data, nWords, nChannels, nSamples, samples);
+
+#endif // __SSE2__
+} // daq::details::decompressA2795Samples()
+
+
+// -----------------------------------------------------------------------------
+std::size_t daq::details::compressA2795Boards(
+  std::uint16_t const* data, std::size_t nBoards,
+  std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t adcMask,
+  std::uint16_t* out
+) {
+  std::size_t const boardWords = A2795BoardWords(nChannels, nSamples);
+
+  std::size_t n = 0;
+  for (std::size_t board = 0; board < nBoards; ++board) {
+    std::uint16_t const* boardData = data + board * boardWords;
+    std::size_t const start = n;
+
+    std::memcpy(out + n, boardData, A2795BoardHeaderWords * sizeof(std::uint16_t));
+    n += A2795BoardHeaderWords;
+
+    n += compressA2795Samples(boardData + A2795BoardHeaderWords,
+      nChannels, nSamples, adcMask, out + n);
+
+    std::memcpy(out + n, boardData + boardWords - A2795BoardTrailerWords,
+      A2795BoardTrailerWords * sizeof(std::uint16_t));
+    n += A2795BoardTrailerWords;
+
+    // the size of the data tile in the header is big endian
+    std::uint32_t const packSize
+      = htonl(static_cast<std::uint32_t>((n - start) * sizeof(std::uint16_t)));
+    std::memcpy(out + start + A2795PackSizeWord, &packSize, sizeof(packSize));
+  } // for boards
+  return n;
+} // daq::details::compressA2795Boards()
+
+
+// -----------------------------------------------------------------------------
+std::size_t daq::details::decompressA2795Boards(
+  std::uint16_t const* data, std::size_t nWords,
+  std::size_t nBoards,
+  std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t* out
+) {
+  std::size_t const boardWords = A2795BoardWords(nChannels, nSamples);
+
+  std::size_t n = 0;
+  for (std::size_t board = 0; board < nBoards; ++board) {
+    std::uint16_t* boardData = out + board * boardWords;
+
+    if (n + A2795BoardHeaderWords > nWords) {
+      throw cet::exception("decompressA2795Boards")
+        << "Compressed data (" << nWords << " words) ends in the header of board "
+        << board << ".\n";
+    }
+    std::memcpy(boardData, data + n, A2795BoardHeaderWords * sizeof(std::uint16_t));
+    n += A2795BoardHeaderWords;
+
+    n += decompressA2795Samples(data + n, nWords - n, nChannels, nSamples,
+      boardData + A2795BoardHeaderWords);
+
+    if (n + A2795BoardTrailerWords > nWords) {
+      throw cet::exception("decompressA2795Boards")
+        << "Compressed data (" << nWords << " words) ends in the trailer of board "
+        << board << ".\n";
+    }
+    std::memcpy(boardData + boardWords - A2795BoardTrailerWords, data + n,
+      A2795BoardTrailerWords * sizeof(std::uint16_t));
+    n += A2795BoardTrailerWords;
+  } // for boards
+  return n;
+} // daq::details::decompressA2795Boards()
+
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,155 @@
+/**
+ * @file   icaruscode/Decode/DecoderTools/details/A2795Compression.h
+ * @brief  Delta compression of the ADC samples of TPC readout boards (A2795).
+ * @see    icaruscode/Decode/DecoderTools/details/A2795Compression.cxx
+ *
+ * The compression scheme is the one written by `ICARUSProduceCompressed`
+ * (`compression_scheme()` value `A2795DeltaCompression` in the fragment
+ * metadata).
+ * The samples of each board are stored sample after sample; the channels of
+ * a sample are grouped in blocks of 4:
+ *  * the first sample of each channel is stored as is, in one 16-bit word
+ *    tagged with `0x8000` in the upper nibble;
+ *  * from the second sample on, the difference with the previous sample of
+ *    the same channel is stored: if the differences of all 4 channels of a
+ *    block are within +/-7 ADC counts, they are packed as four 4-bit nibbles
+ *    in a single word (the first channel in the lowest nibble), otherwise
+ *    each one takes a tagged word with its 12 lower bits;
+ *  * if an odd number of blocks of a sample is packed, a `0` spacer word
+ *    follows the sample.
+ *
+ * Board header and trailer are copied untouched, except for the size of the
+ * data tile in the header, which is updated to the compressed size.
+ */
+
+#ifndef ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_A2795COMPRESSION_H
+#define ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_A2795COMPRESSION_H
+
+// C/C++ standard libraries
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint16_t
+
+
+// -----------------------------------------------------------------------------
+namespace daq::details {
+
+  /// Value of the fragment `compression_scheme()` for this compression.
+  constexpr unsigned int A2795DeltaCompression = 1U;
+
+  /// 16-bit words in front of the samples of each board (tile and board headers).
+  constexpr std::size_t A2795BoardHeaderWords = 18U;
+
+  /// 16-bit words after the samples of each board.
+  constexpr std::size_t A2795BoardTrailerWords = 4U;
+
+  /// 16-bit word of the board header where the size of the data tile starts.
+  constexpr std::size_t A2795PackSizeWord = 12U;
+
+  /// Number of 16-bit words of an uncompressed board.
+  constexpr std::size_t A2795BoardWords
+    (std::size_t nChannels, std::size_t nSamples)
+    {
+      return A2795BoardHeaderWords + nChannels * nSamples
+        + A2795BoardTrailerWords;
+    }
+
+  /// Pointer to the samples of the specified board in uncompressed `data`.
+  constexpr std::uint16_t const* A2795BoardSamples(std::uint16_t const* data,
+    std::size_t board, std::size_t nChannels, std::size_t nSamples)
+    {
+      return data + board * A2795BoardWords(nChannels, nSamples)
+        + A2795BoardHeaderWords;
+    }
+
+
+  /**
+   * @brief Compresses the samples of a board.
+   * @param samples the uncompressed samples of the board (sample-major)
+   * @param nChannels number of channels on the board (multiple of 4)
+   * @param nSamples number of samples per channel
+   * @param adcMask mask applied to each sample (see `TPCBoardADCmask()`)
+   * @param out where to write the compressed samples
+   * @return the number of 16-bit words written
+   *
+   * `out` must have room for `nChannels * nSamples` words, the uncompressed
+   * size, even if fewer are used.
+   * Blocks of 8 channels are processed with SSE2 when available.
+   */
+  std::size_t compressA2795Samples(std::uint16_t const* samples,
+                                   std::size_t nChannels, std::size_t nSamples,
+                                   std::uint16_t adcMask,
+                                   std::uint16_t* out);
+
+  /// Same as the above, always using the block by block compression.
+  std::size_t compressA2795SamplesScalar(std::uint16_t const* samples,
+                                         std::size_t nChannels, std::size_t nSamples,
+                                         std::uint16_t adcMask,
+                                         std::uint16_t* out);
+
+  /**
+   * @brief Decompresses the samples of a board.
+   * @param data the compressed samples of the board
+   * @param nWords number of 16-bit words available in `data`
+   * @param nChannels number of channels on the board (multiple of 4)
+   * @param nSamples number of samples per channel
+   * @param samples where to write the uncompressed samples (sample-major)
+   * @return the number of 16-bit words of `data` used
+   * @throw cet::exception if `data` ends before all samples are decoded
+   *
+   * The samples are the running sum of the differences, modulo 2^16; they
+   * match the original samples in the bits kept by the compression (the
+   * 12 lower bits, and all of them when the differences fit 12 bits).
+   * The samples of each sample time are summed with SSE2 when available.
+   */
+  std::size_t decompressA2795Samples(std::uint16_t const* data, std::size_t nWords,
+                                     std::size_t nChannels, std::size_t nSamples,
+                                     std::uint16_t* samples);
+
+  /// Same as the above, always decoding the samples one by one.
+  std::size_t decompressA2795SamplesScalar(std::uint16_t const* data, std::size_t nWords,
+                                           std::size_t nChannels, std::size_t nSamples,
+                                           std::uint16_t* samples);
+
+
+  /**
+   * @brief Compresses the payload of a whole fragment.
+   * @param data the uncompressed payload, with `nBoards` boards
+   * @param nBoards number of boards in the payload
+   * @param nChannels number of channels per board
+   * @param nSamples number of samples per channel
+   * @param adcMask mask applied to each sample (see `TPCBoardADCmask()`)
+   * @param out where to write the compressed payload
+   * @return the number of 16-bit words of the compressed payload
+   *
+   * `out` must have room for the whole uncompressed payload
+   * (`nBoards * A2795BoardWords(nChannels, nSamples)` words).
+   */
+  std::size_t compressA2795Boards(std::uint16_t const* data, std::size_t nBoards,
+                                  std::size_t nChannels, std::size_t nSamples,
+                                  std::uint16_t adcMask,
+                                  std::uint16_t* out);
+
+  /**
+   * @brief Decompresses the payload of a whole fragment.
+   * @param data the compressed payload
+   * @param nWords number of 16-bit words in the compressed payload
+   * @param nBoards number of boards in the payload
+   * @param nChannels number of channels per board
+   * @param nSamples number of samples per channel
+   * @param out where to write the uncompressed payload
+   * @return the number of 16-bit words of `data` used
+   * @throw cet::exception if `data` ends before all boards are decoded
+   *
+   * `out` must have room for `nBoards * A2795BoardWords(nChannels, nSamples)`
+   * words; the samples of each board can be found with `A2795BoardSamples()`.
+   * Headers and trailers are copied as they are.
+   */
+  std::size_t decompressA2795Boards(std::uint16_t const* data, std::size_t nWords,
+                                    std::size_t nBoards,
+                                    std::size_t nChannels, std::size_t nSamples,
+                                    std::uint16_t* out);
+
+} // namespace daq::details
+
+
+#endif // ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_A2795COMPRESSION_H
@@ -0,0 +1,156 @@
+/**
+ * @file   icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.cxx
+ * @brief  Bulk unpacking of the ADC samples of a TPC readout board.
+ * @see    icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h
+ */
+
+// library header
+#include "icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h"
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif // __SSE2__
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Unpacks the samples `[firstSample, lastSample)` of the channels
+  /// `[firstChannel, lastChannel)` one at a time.
+  void unpackTPCBoardBlock(
+    std::uint16_t const* boardData, std::size_t nChannels,
+    std::size_t firstChannel, std::size_t lastChannel,
+    std::size_t firstSample, std::size_t lastSample,
+    std::uint16_t adcMask, float* const* channelData
+  ) {
+    for (std::size_t channel = firstChannel; channel < lastChannel; ++channel) {
+      float* waveform = channelData[channel];
+      for (std::size_t sample = firstSample; sample < lastSample; ++sample) {
+        waveform[sample]
+          = -static_cast<int>(boardData[sample * nChannels + channel] & adcMask);
+      }
+    } // for channel
+  } // unpackTPCBoardBlock()
+
+
+#if defined(__SSE2__)
+
+  /// Converts 8 unsigned 16-bit samples to negated floats and stores them.
+  inline void storeNegatedSamples
+    (__m128i samples, __m128i mask, float* dest)
+  {
+    __m128i const zero = _mm_setzero_si128();
+    __m128 const fzero = _mm_setzero_ps();
+    samples = _mm_and_si128(samples, mask);
+    // 0 - x rather than flipping the sign bit, so that 0 stays +0 as in scalar
+    _mm_storeu_ps(dest,
+      _mm_sub_ps(fzero, _mm_cvtepi32_ps(_mm_unpacklo_epi16(samples, zero))));
+    _mm_storeu_ps(dest + 4,
+      _mm_sub_ps(fzero, _mm_cvtepi32_ps(_mm_unpackhi_epi16(samples, zero))));
+  } // storeNegatedSamples()
+
+
+  /// Transposes a block of 8 samples times 8 channels starting at the
+  /// specified channel and sample.
+  inline void unpackTPCBoardTile(
+    std::uint16_t const* boardData, std::size_t nChannels,
+    std::size_t channel, std::size_t sample,
+    __m128i mask, float* const* channelData
+  ) {
+    std::uint16_t const* src = boardData + sample * nChannels + channel;
+
+    // each row holds the 8 channels of one sample
+    __m128i const r0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+    __m128i const r1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + nChannels));
+    __m128i const r2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 2 * nChannels));
+    __m128i const r3 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 3 * nChannels));
+    __m128i const r4 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 4 * nChannels));
+    __m128i const r5 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 5 * nChannels));
+    __m128i const r6 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 6 * nChannels));
+    __m128i const r7 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 7 * nChannels));
+
+    // 8x8 transposition of 16-bit words
+    __m128i const a0 = _mm_unpacklo_epi16(r0, r1);
+    __m128i const a1 = _mm_unpackhi_epi16(r0, r1);
+    __m128i const a2 = _mm_unpacklo_epi16(r2, r3);
+    __m128i const a3 = _mm_unpackhi_epi16(r2, r3);
+    __m128i const a4 = _mm_unpacklo_epi16(r4, r5);
+    __m128i const a5 = _mm_unpackhi_epi16(r4, r5);
+    __m128i const a6 = _mm_unpacklo_epi16(r6, r7);
+    __m128i const a7 = _mm_unpackhi_epi16(r6, r7);
+
+    __m128i const b0 = _mm_unpacklo_epi32(a0, a2);
+    __m128i const b1 = _mm_unpackhi_epi32(a0, a2);
+    __m128i const b2 = _mm_unpacklo_epi32(a1, a3);
+    __m128i const b3 = _mm_unpackhi_epi32(a1, a3);
+    __m128i const b4 = _mm_unpacklo_epi32(a4, a6);
+    __m128i const b5 = _mm_unpackhi_epi32(a4, a6);
+    __m128i const b6 = _mm_unpacklo_epi32(a5, a7);
+    __m128i const b7 = _mm_unpackhi_epi32(a5, a7);
+
+    // each column holds the 8 samples of one channel
+    storeNegatedSamples(_mm_unpacklo_epi64(b0, b4), mask, channelData[channel    ] + sample);
+    storeNegatedSamples(_mm_unpackhi_epi64(b0, b4), mask, channelData[channel + 1] + sample);
+    storeNegatedSamples(_mm_unpacklo_epi64(b1, b5), mask, channelData[channel + 2] + sample);
+    storeNegatedSamples(_mm_unpackhi_epi64(b1, b5), mask, channelData[channel + 3] + sample);
+    storeNegatedSamples(_mm_unpacklo_epi64(b2, b6), mask, channelData[channel + 4] + sample);
+    storeNegatedSamples(_mm_unpackhi_epi64(b2, b6), mask, channelData[channel + 5] + sample);
+    storeNegatedSamples(_mm_unpacklo_epi64(b3, b7), mask, channelData[channel + 6] + sample);
+    storeNegatedSamples(_mm_unpackhi_epi64(b3, b7), mask, channelData[channel + 7] + sample);
+
+  } // unpackTPCBoardTile()
+
+#endif // __SSE2__
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void daq::details::unpackTPCBoardScalar(
+  std::uint16_t const* boardData,
+  std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t adcMask,
+  float* const* channelData
+) {
+  unpackTPCBoardBlock
+    (boardData, nChannels, 0, nChannels, 0, nSamples, adcMask, channelData);
+} // daq::details::unpackTPCBoardScalar()
+
+
+// -----------------------------------------------------------------------------
+void daq::details::unpackTPCBoard(
+  std::uint16_t const* boardData,
+  std::size_t nChannels, std::size_t nSamples,
+  std::uint16_t adcMask,
+  float* const* channelData
+) {
+#if defined(__SSE2__)
+
+  constexpr std::size_t TileSize = 8U;
+
+  std::size_t const nTiledChannels = nChannels - nChannels % TileSize;
+  std::size_t const nTiledSamples = nSamples - nSamples % TileSize;
+
+  __m128i const mask = _mm_set1_epi16(static_cast<short>(adcMask));
+
+  // move along the payload one block of samples at a time (cache friendly)
+  for (std::size_t sample = 0; sample < nTiledSamples; sample += TileSize) {
+    for (std::size_t channel = 0; channel < nTiledChannels; channel += TileSize)
+      unpackTPCBoardTile(boardData, nChannels, channel, sample, mask, channelData);
+  } // for sample
+
+  // leftovers: channels not fitting a tile, then samples not fitting a tile
+  unpackTPCBoardBlock(boardData, nChannels, nTiledChannels, nChannels,
+    0, nTiledSamples, adcMask, channelData);
+  unpackTPCBoardBlock(boardData, nChannels, 0, nChannels,
+    nTiledSamples, nSamples, adcMask, channelData);
+
+#else // no SSE2
+
+  unpackTPCBoardScalar(boardData, nChannels, nSamples, adcMask, channelData);
+
+#endif // __SSE2__
+} // daq::details::unpackTPCBoard()
+
+
+// -----------------------------------------------------------------------------
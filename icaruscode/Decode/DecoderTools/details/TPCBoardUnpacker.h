@@ -0,0 +1,92 @@
+/**
+ * @file   icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h
+ * @brief  Bulk unpacking of the ADC samples of a TPC readout board.
+ * @see    icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.cxx
+ */
+
+#ifndef ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_TPCBOARDUNPACKER_H
+#define ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_TPCBOARDUNPACKER_H
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <array>
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint16_t
+
+
+// -----------------------------------------------------------------------------
+namespace daq::details {
+
+  /// Largest number of channels on a TPC readout board (A2795).
+  constexpr std::size_t MaxTPCBoardChannels = 64U;
+
+  /**
+   * @brief Mask applied to each ADC sample, as `icarus::PhysCrateFragment::adc_val()` does.
+   * @param nADCbits number of ADC bits from the fragment metadata
+   */
+  constexpr std::uint16_t TPCBoardADCmask(unsigned int nADCbits)
+    { return static_cast<std::uint16_t>(~(1U << (nADCbits + 1))); }
+
+  /**
+   * @brief Transposes the samples of a whole board into channel waveforms.
+   * @param boardData pointer to the first sample of the board payload
+   * @param nChannels number of channels on the board
+   * @param nSamples number of samples per channel
+   * @param adcMask mask applied to each sample (see `TPCBoardADCmask()`)
+   * @param channelData pointers to the output waveform of each channel
+   *
+   * The (uncompressed) A2795 payload is sample-major: all channels of the
+   * first sample, then all channels of the second sample and so on.
+   * Each output waveform is filled with the negated, masked samples of its
+   * channel, which is the same as filling it sample by sample with
+   * `-physCrateFragment.adc_val(board, channel, sample)`.
+   *
+   * Blocks of 8 channels and 8 samples are transposed with SSE2 when
+   * available; the remaining channels and samples are unpacked one by one.
+   * `channelData` must hold at least `nChannels` pointers, each pointing to
+   * at least `nSamples` elements.
+   */
+  void unpackTPCBoard(std::uint16_t const* boardData,
+                      std::size_t nChannels, std::size_t nSamples,
+                      std::uint16_t adcMask,
+                      float* const* channelData);
+
+  /// Same as the above, always using the sample by sample unpacking.
+  void unpackTPCBoardScalar(std::uint16_t const* boardData,
+                            std::size_t nChannels, std::size_t nSamples,
+                            std::uint16_t adcMask,
+                            float* const* channelData);
+
+  /**
+   * @brief Unpacks a whole board into a sequence of channel waveforms.
+   * @tparam RowIter random access iterator to vectors of `float`
+   * @param firstRow iterator to the waveform of the first channel on the board
+   *
+   * Each of the `nChannels` waveforms from `firstRow` on must already have
+   * room for `nSamples` samples.
+   */
+  template <typename RowIter>
+  void unpackTPCBoardWaveforms(std::uint16_t const* boardData,
+                               std::size_t nChannels, std::size_t nSamples,
+                               std::uint16_t adcMask,
+                               RowIter firstRow)
+  {
+    if (nChannels > MaxTPCBoardChannels) {
+      throw cet::exception("unpackTPCBoardWaveforms")
+        << "Board with " << nChannels << " channels, only up to "
+        << MaxTPCBoardChannels << " are supported.\n";
+    }
+
+    std::array<float*, MaxTPCBoardChannels> channelData;
+    for (std::size_t channel = 0; channel < nChannels; ++channel)
+      channelData[channel] = firstRow[channel].data();
+
+    unpackTPCBoard(boardData, nChannels, nSamples, adcMask, channelData.data());
+  } // unpackTPCBoardWaveforms()
+
+} // namespace daq::details
+
+
+#endif // ICARUSCODE_DECODE_DECODERTOOLS_DETAILS_TPCBOARDUNPACKER_H
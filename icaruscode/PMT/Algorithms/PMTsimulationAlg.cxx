@@ -23,13 +23,13 @@
 #include "cetlib_except/exception.h"
 
 // CLHEP libraries
+#include "CLHEP/Random/RandBinomial.h"
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandPoisson.h"
 #include "CLHEP/Random/RandExponential.h"
 
 // C++ standard libaries
 #include <chrono> // std::chrono::high_resolution_clock
-#include <unordered_map>
 #include <algorithm>
 #include <utility> // std::move(), std::cref(), ...
 #include <limits> // std::numeric_limits
@@ -146,9 +146,46 @@ icarus::opdet::PMTsimulationAlg::PMTsimulationAlg
   // converge to 0 (10^-3 ADC is quite low though).
   wsp.checkRange(1.0e-3_ADCf, "PMTsimulationAlg");
 
+  // copy of the pulse samples as plain numbers, and buffers for the signal
+  fPulseSamples.reserve(wsp.nSubsamples());
+  for (auto const iSubsample: util::counter(wsp.nSubsamples())) {
+    auto const& pulse = wsp.subsample(iSubsample);
+    std::vector<WaveformValue_t> samples;
+    samples.reserve(pulse.size());
+    for (ADCcount const sample: pulse) samples.push_back(sample.value());
+    fPulseSamples.push_back(std::move(samples));
+  } // for subsamples
+
+  fPEcounts.resize(fNsamples, wsp.nSubsamples());
+
 } // icarus::opdet::PMTsimulationAlg::PMTsimulationAlg()
 
 
+// -----------------------------------------------------------------------------
+void icarus::opdet::PMTsimulationAlg::setEventParameters(
+  std::uint64_t beamGateTimestamp,
+  detinfo::LArProperties const& larProp,
+  detinfo::DetectorClocksData const& clockData
+) {
+  
+  megahertz const sampling { clockData.OpticalClock().Frequency() };
+  if (sampling != fSampling) {
+    throw cet::exception("PMTsimulationAlg")
+      << "Optical clock frequency changed from " << fSampling << " to "
+      << sampling
+      << ": the sampled photoelectron response is not valid any more.\n";
+  }
+  
+  fParams.beamGateTimestamp = beamGateTimestamp;
+  fParams.larProp = &larProp;
+  fParams.clockData = &clockData;
+  fParams.detTimings = detinfo::makeDetectorTimings(fParams.clockData);
+  
+  fQE = fParams.QEbase / fParams.larProp->ScintPreScale();
+  
+} // icarus::opdet::PMTsimulationAlg::setEventParameters()
+
+
 // -----------------------------------------------------------------------------
 std::tuple<std::vector<raw::OpDetWaveform>, std::optional<sim::SimPhotons>>
   icarus::opdet::PMTsimulationAlg::simulate(sim::SimPhotons const& photons,
@@ -186,7 +223,7 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
   (sim::SimPhotons const& photons,
    sim::SimPhotonsLite const& lite_photons,
    std::optional<sim::SimPhotons>& photons_used)
-  const -> Waveform_t
+  -> Waveform_t
 {
 
     using namespace util::quantities::time_literals;
@@ -203,17 +240,13 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
 
     //
     // collect the amount of photoelectrons arriving at each subtick;
-    // the waveform is split in groups of photons at the same relative subtick
-    // (i.e. first all the photons on the first subtick of a tick, then
-    // all the photons on the second subtick of a tick, and so on);
-    // storage is by subtick group (vector index is the subtick), then by
-    // tick (unordered map index is the tick number).
+    // the counts are stored in a dense array (by tick, then by subtick)
+    // which is reused from channel to channel
     //
-    std::vector<std::unordered_map<tick, unsigned int>> peMaps
-      (wsp.nSubsamples());
+    fPEcounts.clear();
 
     // returns tick and relative subtick number
-    TimeToTickAndSubtickConverter const toTickAndSubtick(peMaps.size());
+    TimeToTickAndSubtickConverter const toTickAndSubtick(wsp.nSubsamples());
 
 //     auto start = std::chrono::high_resolution_clock::now();
     
@@ -244,7 +277,7 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
         ;
       */
       if (tick >= endSample) continue;
-      ++peMaps[subtick][tick];
+      fPEcounts.add(tick.value(), subtick);
     } // for photons
 
 //     auto end = std::chrono::high_resolution_clock::now();
@@ -256,14 +289,6 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
 
     for(auto const& [ time_ns, nphotons ]: lite_photons.DetectedPhotons) {
 
-      // Count photoelectrons.
-
-      unsigned int nPE = 0;
-      for(int i=0; i<nphotons; ++i) {
-        if(KicksPhotoelectron())
-          ++nPE;
-      }
-
       // Convert photon time bin to ticks.
 
       simulation_time const photonTime { time_ns + 0.5 };
@@ -274,49 +299,45 @@ auto icarus::opdet::PMTsimulationAlg::CreateFullWaveform
 
       auto const [ tick, subtick ]
         = toTickAndSubtick(mytime.quantity() * fSampling);
-      if (tick < endSample)
-        peMaps[subtick][tick] += nPE;
+      if (tick >= endSample) continue;
+
+      // Count photoelectrons (all the photons of the bin at once).
+
+      fPEcounts.add(tick.value(), subtick, CountPhotoelectrons(nphotons));
     }
 
     //
     // add the collected photoelectrons to the waveform
     //
-    Waveform_t waveform(fNsamples, 0_ADCf);
-    
     unsigned int nTotalPE [[maybe_unused]] = 0U; // unused if not in `debug` mode
     double nTotalEffectivePE [[maybe_unused]] = 0U; // unused if not in `debug` mode
 
     auto gainFluctuation = makeGainFluctuator();
 
-    // go though all subsamples (starting each at a fraction of a tick)
-    for (auto const& [ iSubsample, peMap ]: util::enumerate(peMaps)) {
-
-      // this is the waveform sampling for the selected subsample:
-      auto const& subsample = wsp.subsample(iSubsample);
-
-      for (auto const& [ startTick, nPE ]: peMap) {
+    // the signal is accumulated as plain numbers, one pulse per occupied
+    // tick and subsample (scaled by the number of photoelectrons there)
+    fSignal.assign(fNsamples, 0.0);
+    fPEcounts.forEach(
+      [&](std::size_t startTick, std::size_t iSubsample, unsigned int nPE)
+      {
         nTotalPE += nPE;
 
         double const nEffectivePE = gainFluctuation(nPE);
         nTotalEffectivePE += nEffectivePE;
 
-        AddPhotoelectrons(
-          subsample, waveform, startTick,
+        addScaledPulse(
+          fPulseSamples[iSubsample], fSignal, startTick,
           static_cast<WaveformValue_t>(nEffectivePE)
           );
-        //        std::cout << "Channel=" << channel << ", subsample=" << iSubsample << ", tick=" << startTick << ", nPE=" << nPE << ", ePE=" << nEffectivePE << std::endl;
-
-      } // for sample
-    } // for subsamples
+      }
+      );
     MF_LOG_TRACE("PMTsimulationAlg")
-      << nTotalPE << " photoelectrons at "
-      << std::accumulate(
-           peMaps.begin(), peMaps.end(), 0U,
-           [](unsigned int n, auto const& map){ return n + map.size(); }
-         )
+      << nTotalPE << " photoelectrons at " << fPEcounts.nFilled()
       << " times in channel " << channel
       ;
 
+    Waveform_t waveform(fSignal.begin(), fSignal.end());
+
 //       end=std::chrono::high_resolution_clock::now(); diff = end-start;
 //       std::cout << "\tadded pes... " << channel << " " << diff.count() << std::endl;
 //       start=std::chrono::high_resolution_clock::now();
@@ -599,6 +620,18 @@ bool icarus::opdet::PMTsimulationAlg::KicksPhotoelectron() const
   { return CLHEP::RandFlat::shoot(fParams.randomEngine) < fQE; }
 
 
+// -----------------------------------------------------------------------------
+unsigned int icarus::opdet::PMTsimulationAlg::CountPhotoelectrons
+  (unsigned int nPhotons) const
+{
+  // same distribution as `nPhotons` calls to `KicksPhotoelectron()`
+  if (fQE >= 1.0) return nPhotons;
+  if ((nPhotons == 0U) || (fQE <= 0.0)) return 0U;
+  return static_cast<unsigned int>
+    (CLHEP::RandBinomial::shoot(fParams.randomEngine, nPhotons, fQE));
+} // icarus::opdet::PMTsimulationAlg::CountPhotoelectrons()
+
+
 // -----------------------------------------------------------------------------
 void icarus::opdet::PMTsimulationAlg::AddPhotoelectrons(
   PulseSampling_t const& pulse, Waveform_t& wave, tick const time_bin,
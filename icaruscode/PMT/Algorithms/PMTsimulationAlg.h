@@ -19,6 +19,7 @@
 #include "icaruscode/PMT/Algorithms/DiscretePhotoelectronPulse.h"
 #include "icaruscode/PMT/Algorithms/PhotoelectronPulseFunction.h"
 #include "icaruscode/PMT/Algorithms/PedestalGeneratorAlg.h"
+#include "icaruscode/PMT/Algorithms/PhotoelectronCounts.h"
 #include "icaruscode/Utilities/quantities_utils.h" // util::value_t
 #include "icarusalg/Utilities/SampledFunction.h"
 
@@ -182,6 +183,13 @@ class icarus::opdet::OpDetWaveformMakerClass {
  *
  * For each converting photon, a photoelectron is added to the channel by
  * placing a template waveform shape into the channel waveform.
+ * Photons from `sim::SimPhotonsLite` come in bunches sharing the same
+ * nanosecond: the number of photoelectrons from each bunch is extracted at
+ * once from a binomial distribution.
+ * Photoelectrons are first counted by tick and subsample, and a template
+ * waveform is added once for each tick and subsample with photoelectrons,
+ * scaled by their number, so that the cost of the simulation grows with the
+ * number of ticks with signal rather than with the number of photons.
  *
  * The timestamp of each waveform is based on the same scale as the trigger
  * time, as defined by `detinfo::DetectorClocks::TriggerTime()`.
@@ -553,6 +561,24 @@ class icarus::opdet::PMTsimulationAlg {
     simulate(sim::SimPhotons const& photons,
              sim::SimPhotonsLite const& lite_photons);
 
+  /**
+   * @brief Moves the algorithm to a new event.
+   * @param beamGateTimestamp the time of beam gate opening, in UTC [ns]
+   * @param larProp instance of `detinfo::LArProperties` to be used
+   * @param clockData instance of `detinfo::DetectorClocks` for the new event
+   *
+   * Only the parameters which depend on the event are updated: configuration,
+   * sampled single photon response and buffers are kept, so that the same
+   * algorithm object can be reused event after event.
+   * The sampling of the single photon response depends on the frequency of
+   * the optical clock, which is then required not to change.
+   */
+  void setEventParameters(
+    std::uint64_t beamGateTimestamp,
+    detinfo::LArProperties const& larProp,
+    detinfo::DetectorClocksData const& clockData
+    );
+
   /// Prints the configuration into the specified output stream.
   template <typename Stream>
   void printConfiguration(Stream&& out, std::string indent = "") const;
@@ -641,6 +667,14 @@ class icarus::opdet::PMTsimulationAlg {
   /// Member function for the zero suppression discrimination algorithm.
   DiscriminationAlgoProc_t fDiscrAlgo = nullptr;
   
+  /// Single photon pulse samples (one per subsample), as plain numbers.
+  std::vector<std::vector<WaveformValue_t>> fPulseSamples;
+  
+  // --- BEGIN -- Buffers reused across channels -------------------------------
+  PhotoelectronCounts fPEcounts; ///< Photoelectrons by tick and subsample.
+  std::vector<WaveformValue_t> fSignal; ///< Photoelectron signal (no baseline).
+  // --- END -- Buffers reused across channels ---------------------------------
+  
   
   /**
    * @brief Creates `raw::OpDetWaveform` objects from simulated photoelectrons.
@@ -659,12 +693,13 @@ class icarus::opdet::PMTsimulationAlg {
    * configuration of the algorithm requires the creation of a list of used
    * photons.
    * 
+   * The buffers of the algorithm are reused, so this method is not constant.
    */
   Waveform_t CreateFullWaveform(
     sim::SimPhotons const& photons,
     sim::SimPhotonsLite const& lite_photons,
     std::optional<sim::SimPhotons>& photons_used
-    ) const;
+    );
   
   /**
    * @brief Creates `raw::OpDetWaveform` objects from a waveform data.
@@ -879,6 +914,9 @@ class icarus::opdet::PMTsimulationAlg {
   /// Returns a random response whether a photon generates a photoelectron.
   bool KicksPhotoelectron() const;
   
+  /// Returns how many of `nPhotons` photons generate a photoelectron.
+  unsigned int CountPhotoelectrons(unsigned int nPhotons) const;
+  
   /// Returns the ADC range allowed for photoelectron saturation.
   std::pair<ADCcount, ADCcount> saturationRange(ADCcount baseline) const;
   
@@ -0,0 +1,184 @@
+/**
+ * @file   icaruscode/PMT/Algorithms/PhotoelectronCounts.h
+ * @brief  Dense counting of photoelectrons by tick and subsample.
+ * @date   October 16, 2026
+ * @see    `icaruscode/PMT/Algorithms/PMTsimulationAlg.h`
+ *
+ * This library is header only.
+ */
+
+#ifndef ICARUSCODE_PMT_ALGORITHMS_PHOTOELECTRONCOUNTS_H
+#define ICARUSCODE_PMT_ALGORITHMS_PHOTOELECTRONCOUNTS_H
+
+
+// C++ standard library
+#include <algorithm> // std::sort(), std::min()
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::opdet {
+
+  class PhotoelectronCounts;
+
+  template <typename Pulse, typename T>
+  void addScaledPulse
+    (Pulse const& pulse, std::vector<T>& waveform, std::size_t start, T n);
+
+} // namespace icarus::opdet
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Number of photoelectrons in each tick and subsample of a waveform.
+ *
+ * The counts are stored in a dense array covering the whole waveform, with the
+ * subsamples of the same tick next to each other. The cells that have been
+ * filled are also remembered, so that both the iteration on the non-empty
+ * cells and the reset of the counts take a time proportional to the number of
+ * those cells rather than to the length of the waveform.
+ * The object is meant to be reused for many channels.
+ *
+ * Example:
+ * @code{.cpp}
+ * counts.clear();
+ * for (auto const& [ tick, subtick ]: photoelectronTimes)
+ *   counts.add(tick, subtick);
+ * counts.forEach([&](std::size_t tick, std::size_t subtick, unsigned int n)
+ *   { addScaledPulse(pulses[subtick], waveform, tick, float(n)); });
+ * @endcode
+ */
+class icarus::opdet::PhotoelectronCounts {
+
+    public:
+
+  using Count_t = unsigned int; ///< Type of photoelectron count.
+
+  /// Constructor: counts are allocated but empty.
+  PhotoelectronCounts(std::size_t nTicks = 0U, std::size_t nSubsamples = 1U)
+    { resize(nTicks, nSubsamples); }
+
+  /// Changes the size of the counter and empties it.
+  void resize(std::size_t nTicks, std::size_t nSubsamples);
+
+  /// Returns the number of ticks covered by the counter.
+  std::size_t nTicks() const { return fNTicks; }
+
+  /// Returns the number of subsamples in each tick.
+  std::size_t nSubsamples() const { return fNSubsamples; }
+
+  /// Adds `n` photoelectrons at the specified tick and subsample.
+  void add(std::size_t tick, std::size_t subsample, Count_t n = 1U);
+
+  /// Returns the photoelectrons at the specified tick and subsample.
+  Count_t count(std::size_t tick, std::size_t subsample) const
+    { return fCounts[index(tick, subsample)]; }
+
+  /// Returns the number of tick and subsample cells with photoelectrons.
+  std::size_t nFilled() const { return fFilled.size(); }
+
+  /**
+   * @brief Calls `f(tick, subsample, count)` on each filled cell.
+   * @tparam F type of callable object
+   * @param f callable object
+   *
+   * The cells are visited in order of tick and subsample, once each.
+   */
+  template <typename F>
+  void forEach(F&& f);
+
+  /// Removes all the counts.
+  void clear();
+
+
+    private:
+
+  std::size_t fNTicks = 0U; ///< Number of ticks.
+  std::size_t fNSubsamples = 1U; ///< Number of subsamples per tick.
+
+  std::vector<Count_t> fCounts; ///< Count in each cell, tick by tick.
+  std::vector<std::size_t> fFilled; ///< Index of the cells with counts.
+
+  /// Returns the index of the specified cell in `fCounts`.
+  std::size_t index(std::size_t tick, std::size_t subsample) const
+    { return tick * fNSubsamples + subsample; }
+
+}; // class icarus::opdet::PhotoelectronCounts
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Adds `n` times the samples of `pulse` to `waveform`.
+ * @tparam Pulse type of the pulse sampling (random access, plain numbers)
+ * @tparam T type of the waveform samples
+ * @param pulse the sampling to add, scaled, to the waveform
+ * @param waveform the waveform the pulses will be added to
+ * @param start the sample of `waveform` where the pulse starts being added
+ * @param n the scaling factor of the pulse
+ *
+ * The pulse is truncated at the end of the waveform.
+ * The loop is kept simple enough for the compiler to vectorize it.
+ */
+template <typename Pulse, typename T>
+void icarus::opdet::addScaledPulse
+  (Pulse const& pulse, std::vector<T>& waveform, std::size_t start, T n)
+{
+  if (start >= waveform.size()) return;
+  std::size_t const nSamples
+    = std::min<std::size_t>(pulse.size(), waveform.size() - start);
+  T* const out = waveform.data() + start;
+  for (std::size_t i = 0; i < nSamples; ++i) out[i] += n * pulse[i];
+} // icarus::opdet::addScaledPulse()
+
+
+// -----------------------------------------------------------------------------
+// ---  Inline implementation
+// -----------------------------------------------------------------------------
+inline void icarus::opdet::PhotoelectronCounts::resize
+  (std::size_t nTicks, std::size_t nSubsamples)
+{
+  fNTicks = nTicks;
+  fNSubsamples = nSubsamples;
+  fCounts.assign(fNTicks * fNSubsamples, 0U);
+  fFilled.clear();
+} // icarus::opdet::PhotoelectronCounts::resize()
+
+
+// -----------------------------------------------------------------------------
+inline void icarus::opdet::PhotoelectronCounts::add
+  (std::size_t tick, std::size_t subsample, Count_t n /* = 1U */)
+{
+  assert(tick < fNTicks);
+  assert(subsample < fNSubsamples);
+  if (n == 0U) return;
+  std::size_t const i = index(tick, subsample);
+  if (fCounts[i] == 0U) fFilled.push_back(i);
+  fCounts[i] += n;
+} // icarus::opdet::PhotoelectronCounts::add()
+
+
+// -----------------------------------------------------------------------------
+template <typename F>
+void icarus::opdet::PhotoelectronCounts::forEach(F&& f) {
+
+  std::sort(fFilled.begin(), fFilled.end());
+  for (std::size_t const i: fFilled)
+    f(i / fNSubsamples, i % fNSubsamples, fCounts[i]);
+
+} // icarus::opdet::PhotoelectronCounts::forEach()
+
+
+// -----------------------------------------------------------------------------
+inline void icarus::opdet::PhotoelectronCounts::clear() {
+
+  for (std::size_t const i: fFilled) fCounts[i] = 0U;
+  fFilled.clear();
+
+} // icarus::opdet::PhotoelectronCounts::clear()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_PMT_ALGORITHMS_PHOTOELECTRONCOUNTS_H
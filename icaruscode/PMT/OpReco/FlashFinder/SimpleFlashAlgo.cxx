@@ -112,10 +112,6 @@ namespace pmtana{
         size_t max_ch = _opch_to_index_v.size() - 1;
         size_t NOpDet = _index_to_opch_v.size();
         
-        //static std::vector<double> pesum_v;
-        static std::vector<double> mult_v;  //< this is not strictly a multiplicity of PMTs, but multiplicity of hits
-        static std::vector<std::vector<double> > pespec_v;
-        static std::vector<std::vector<unsigned int> > hitidx_v;
         double min_time=1.1e20;
         double max_time=1.1e20;
         for(auto const& oph : ophits) {
@@ -129,14 +125,14 @@ namespace pmtana{
         
         size_t nbins_pesum_v = (size_t)((max_time - min_time) / _time_res) + 1;
         if(_pesum_v.size() < nbins_pesum_v) _pesum_v.resize(nbins_pesum_v,0);
-        if(mult_v.size()   < nbins_pesum_v) mult_v.resize(nbins_pesum_v,0);
-        if(pespec_v.size() < nbins_pesum_v) pespec_v.resize(nbins_pesum_v,std::vector<double>(NOpDet));
-        if(hitidx_v.size() < nbins_pesum_v) hitidx_v.resize(nbins_pesum_v,std::vector<unsigned int>());
+        if(_mult_v.size()   < nbins_pesum_v) _mult_v.resize(nbins_pesum_v,0);
+        if(_pespec_v.size() < nbins_pesum_v) _pespec_v.resize(nbins_pesum_v,std::vector<double>(NOpDet));
+        if(_hitidx_v.size() < nbins_pesum_v) _hitidx_v.resize(nbins_pesum_v,std::vector<unsigned int>());
         for(size_t i=0; i<_pesum_v.size(); ++i) {
             _pesum_v[i] = 0;
-            mult_v[i]  = 0;
-            hitidx_v[i].clear();
-            for(auto& v : pespec_v[i]) v=0;
+            _mult_v[i]  = 0;
+            _hitidx_v[i].clear();
+            for(auto& v : _pespec_v[i]) v=0;
         }
         
         // Fill _pesum_v
@@ -154,16 +150,16 @@ namespace pmtana{
 	    if(_min_pe_hit > 0. && oph.pe < _min_pe_hit) continue;
             size_t index = (size_t)((oph.peak_time - min_time) / _time_res);
             _pesum_v[index] += oph.pe;
-            mult_v[index] += 1;
-            pespec_v[index][_opch_to_index_v[oph.channel]] += oph.pe;
-            hitidx_v[index].push_back(hitidx);
+            _mult_v[index] += 1;
+            _pespec_v[index][_opch_to_index_v[oph.channel]] += oph.pe;
+            _hitidx_v[index].push_back(hitidx);
         }
         
         // Order by pe (above threshold)
         std::map<double,size_t> pesum_idx_map;
         for(size_t idx=0; idx<nbins_pesum_v; ++idx) {
             if(_pesum_v[idx] < _min_pe_coinc   ) continue;
-            if(mult_v[idx]  < _min_mult_coinc ) continue;
+            if(_mult_v[idx]  < _min_mult_coinc ) continue;
             pesum_idx_map[1./(_pesum_v[idx])] = idx;
         }
         
@@ -246,11 +242,11 @@ namespace pmtana{
             auto const& time   = flash_time_v[flash_idx];
             
             std::vector<double> pe_v(max_ch+1,0);
-            for(size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
+            for(size_t index=start; index<(start+period) && index<_pespec_v.size(); ++index) {
                 
                 for(size_t pmt_index=0; pmt_index<NOpDet; ++pmt_index)
                     
-                    pe_v[_index_to_opch_v[pmt_index]] += pespec_v[index][pmt_index];
+                    pe_v[_index_to_opch_v[pmt_index]] += _pespec_v[index][pmt_index];
                 
             }
             
@@ -265,8 +261,8 @@ namespace pmtana{
             }
             
             std::vector<unsigned int> asshit_v;
-            for(size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
-                for(auto const& idx : hitidx_v[index])
+            for(size_t index=start; index<(start+period) && index<_pespec_v.size(); ++index) {
+                for(auto const& idx : _hitidx_v[index])
                     asshit_v.push_back(idx);
             }
             
@@ -25,7 +25,7 @@ namespace pmtana
 
     const double TimeRes() const { return _time_res; }
 
-  private:
+  protected:
 
     double TotalCharge(const std::vector<double>& PEs);
 
@@ -56,6 +56,15 @@ namespace pmtana
     // pw aum array
     std::vector<double> _pesum_v;
 
+    // hit count array (this is not strictly a multiplicity of PMTs, but multiplicity of hits)
+    std::vector<double> _mult_v;
+
+    // pe per opdet array
+    std::vector<std::vector<double> > _pespec_v;
+
+    // hit index array
+    std::vector<std::vector<unsigned int> > _hitidx_v;
+
     // calibration: PEs to be subtracted from each opdet
     std::vector<double> _pe_baseline_v;
 
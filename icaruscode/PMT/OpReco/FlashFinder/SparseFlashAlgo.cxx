@@ -0,0 +1,187 @@
+#ifndef SPARSEFLASHALGO_CXX
+#define SPARSEFLASHALGO_CXX
+
+#include "SparseFlashAlgo.h"
+#include <algorithm>
+#include <set>
+namespace pmtana{
+
+    static SparseFlashAlgoFactory __SparseFlashAlgoFactoryStaticObject__;
+
+    SparseFlashAlgo::SparseFlashAlgo(const std::string name)
+    : SimpleFlashAlgo(name)
+    {}
+
+    SparseFlashAlgo::~SparseFlashAlgo()
+    {}
+
+    LiteOpFlashArray_t SparseFlashAlgo::RecoFlash(const LiteOpHitArray_t ophits) {
+
+        Reset();
+        size_t max_ch = _opch_to_index_v.size() - 1;
+
+        // Same time span as SimpleFlashAlgo, so that the bins are the same
+        double min_time=1.1e20;
+        double max_time=1.1e20;
+        for(auto const& oph : ophits) {
+            if(max_time > 1.e20 || oph.peak_time > max_time) max_time = oph.peak_time;
+            if(min_time > 1.e20 || oph.peak_time < min_time) min_time = oph.peak_time;
+        }
+        min_time -= 10* _time_res;
+        max_time += 10* _time_res;
+        if(_debug)
+            std::cout << "T span: " << min_time << " => " << max_time << " ... " << (size_t)((max_time - min_time) / _time_res) << std::endl;
+
+        // Select the hits and sort them by time bin (and by hit index within a bin)
+        _hit_v.clear();
+        _hit_v.reserve(ophits.size());
+        for(size_t hitidx = 0; hitidx < ophits.size(); ++hitidx) {
+            auto const& oph = ophits[hitidx];
+            if(oph.channel > max_ch || _opch_to_index_v[oph.channel] < 0) {
+                if(_debug) std::cout << "Ignoring OpChannel " << oph.channel << std::endl;
+                continue;
+            }
+            if(Veto(oph.peak_time)) {
+                if(_debug) std::cout << "Ignoring hit @ time " << oph.peak_time << std::endl;
+                continue;
+            }
+            if(oph.pe <= 0.) continue;
+            if(_min_pe_hit > 0. && oph.pe < _min_pe_hit) continue;
+            size_t index = (size_t)((oph.peak_time - min_time) / _time_res);
+            _hit_v.emplace_back(index, hitidx);
+        }
+        std::sort(_hit_v.begin(), _hit_v.end());
+
+        // Collect the bins with hits
+        _bin_v.clear();
+        for(size_t i = 0; i < _hit_v.size(); ++i) {
+            if(_bin_v.empty() || _bin_v.back().index != _hit_v[i].first)
+                _bin_v.push_back(TimeBin_t{_hit_v[i].first, 0., 0., i, i, 0, 0});
+            auto& bin = _bin_v.back();
+            bin.pesum += ophits[_hit_v[i].second].pe;
+            bin.mult  += 1;
+            bin.hit_end = i + 1;
+        }
+
+        // Find the integration window of each bin: its start and end only move forward
+        size_t veto_ctr = (size_t)(_veto_time / _time_res);
+        size_t default_integral_ctr = (size_t)(_integral_time / _time_res);
+        size_t precount = (size_t)(_pre_sample / _time_res);
+        size_t window_begin = 0;
+        size_t window_end = 0;
+        for(auto& bin : _bin_v) {
+            size_t start_time = (bin.index < precount) ? 0 : bin.index - precount;
+            while(_bin_v[window_begin].index < start_time) ++window_begin;
+            while(window_end < _bin_v.size() && _bin_v[window_end].index < start_time + default_integral_ctr) ++window_end;
+            bin.window_begin = window_begin;
+            bin.window_end = window_end;
+        }
+
+        // Order by pe (above threshold); like the std::map<double,size_t> keyed by 1/pe
+        // in SimpleFlashAlgo, only the latest of the bins with the same key is kept
+        std::vector<std::pair<double,size_t> > candidate_v;
+        for(size_t bin_idx = 0; bin_idx < _bin_v.size(); ++bin_idx) {
+            auto const& bin = _bin_v[bin_idx];
+            if(bin.pesum < _min_pe_coinc   ) continue;
+            if(bin.mult  < _min_mult_coinc ) continue;
+            candidate_v.emplace_back(1./(bin.pesum), bin_idx);
+        }
+        std::sort(candidate_v.begin(), candidate_v.end(),
+                  [](auto const& a, auto const& b)
+                  { return (a.first < b.first) || (a.first == b.first && a.second > b.second); });
+        candidate_v.erase(std::unique(candidate_v.begin(), candidate_v.end(),
+                                      [](auto const& a, auto const& b) { return a.first == b.first; }),
+                          candidate_v.end());
+
+        // Get candidate flash times
+        std::set<size_t> used_start_s;
+        std::vector<size_t> flash_bin_v;
+
+        double sum_baseline = 0;
+
+        for(auto const& pe_idx : candidate_v) {
+
+            auto const& bin = _bin_v[pe_idx.second];
+            size_t start_time = (bin.index < precount) ? 0 : bin.index - precount;
+
+            // see if this idx can be used: no accepted flash may start within the veto time;
+            // since IntegralTime does not exceed VetoSize, no flash needs to be truncated
+            auto used = used_start_s.lower_bound(start_time < veto_ctr ? 0 : start_time - veto_ctr + 1);
+            if(used != used_start_s.end() && *used < start_time + veto_ctr) {
+                if(_debug) std::cout << "Skipping a candidate @ " << min_time + start_time * _time_res << " as it is in a veto window!" <<std::endl;
+                continue;
+            }
+
+            // See if this flash is declarable
+            double pesum = 0;
+            for(size_t i = bin.window_begin; i < bin.window_end; ++i)
+                pesum += _bin_v[i].pesum;
+
+            if(pesum < (_min_pe_flash + sum_baseline)) {
+                if(_debug) std::cout << "Skipping a candidate @ " << start_time  << " => " << start_time + default_integral_ctr
+                    << " as it got " << pesum
+                    << " PE which is lower than threshold " << (_min_pe_flash + sum_baseline) << std::endl;
+                continue;
+            }
+
+            used_start_s.insert(start_time);
+            flash_bin_v.push_back(pe_idx.second);
+        }
+
+        // Construct flash
+        LiteOpFlashArray_t res;
+        res.reserve(flash_bin_v.size());
+        _bin_pe_v.assign(max_ch+1,0);
+        std::vector<size_t> bin_channel_v;
+        for(auto const& flash_bin_idx : flash_bin_v) {
+
+            auto const& flash_bin = _bin_v[flash_bin_idx];
+
+            // the PE of each channel are summed in each time bin first, as in SimpleFlashAlgo
+            std::vector<double> pe_v(max_ch+1,0);
+            std::vector<unsigned int> asshit_v;
+            for(size_t bin_idx = flash_bin.window_begin; bin_idx < flash_bin.window_end; ++bin_idx) {
+
+                auto const& bin = _bin_v[bin_idx];
+                bin_channel_v.clear();
+                for(size_t i = bin.hit_begin; i < bin.hit_end; ++i) {
+                    auto const& oph = ophits[_hit_v[i].second];
+                    if(_bin_pe_v[oph.channel] == 0) bin_channel_v.push_back(oph.channel);
+                    _bin_pe_v[oph.channel] += oph.pe;
+                    asshit_v.push_back(_hit_v[i].second);
+                }
+                for(auto const& opch : bin_channel_v) {
+                    pe_v[opch] += _bin_pe_v[opch];
+                    _bin_pe_v[opch] = 0;
+                }
+            }
+
+            for(size_t opch=0; opch<max_ch; ++opch) {
+
+                if(_opch_to_index_v[opch]<0) continue;
+
+                if(pe_v[opch]<0) pe_v[opch]=0;
+
+            }
+
+            if(_debug) {
+                std::cout << "Claiming a flash @ " << min_time + flash_bin.index * _time_res
+                << " : " << std::flush;
+                double tmpsum=0;
+                for(auto const& v : pe_v) { std::cout << v << " "; tmpsum +=v; }
+                std::cout << " ... sum = " << tmpsum << std::endl;
+            }
+
+            LiteOpFlash_t flash( min_time + flash_bin.index * _time_res,
+                                default_integral_ctr * _time_res / 2.,
+                                std::move(pe_v),
+                                std::move(asshit_v));
+            res.emplace_back( std::move(flash) );
+
+        }
+        if(_debug) std::cout << std::endl;
+        return res;
+    }
+
+}
+#endif
@@ -0,0 +1,93 @@
+/**
+ * \file SparseFlashAlgo.h
+ *
+ * \ingroup FlashFinder
+ *
+ * \brief Class def header for a class SparseFlashAlgo
+ *
+ * The algorithm is the same as `SimpleFlashAlgo` (same configuration, same
+ * flashes), but it only stores the time bins which have hits.
+ */
+
+/** \addtogroup FlashFinder
+
+    @{*/
+#ifndef SPARSEFLASHALGO_H
+#define SPARSEFLASHALGO_H
+
+#include "SimpleFlashAlgo.h"
+#include <vector>
+namespace pmtana
+{
+
+  /**
+     \class pmtana::SparseFlashAlgo
+     \brief Event-driven version of pmtana::SimpleFlashAlgo
+
+     `SimpleFlashAlgo` histograms the PE of the hits (total and per channel) in
+     bins of `TimeResolution` covering the whole time span of the hits, which
+     for hits spread over milliseconds means millions of bins (times the number
+     of channels) to be allocated and cleared on each call.
+
+     This algorithm sorts the hits by time bin instead, and keeps only the
+     bins with hits. The integration window of each candidate flash is found
+     with a sweep of two pointers on those bins, and the PE per channel are
+     summed only for the accepted flashes. Memory is then proportional to the
+     number of hits and channels.
+
+     The bins, the order of the candidates and the order of all the sums are
+     the same as in `SimpleFlashAlgo`, so the flashes are exactly the same.
+     `PESumArray()` is not filled.
+  */
+  class SparseFlashAlgo : public SimpleFlashAlgo {
+
+  public:
+
+    SparseFlashAlgo(const std::string name);
+
+    virtual ~SparseFlashAlgo();
+
+    LiteOpFlashArray_t RecoFlash(const LiteOpHitArray_t ophits);
+
+  private:
+
+    /// A time bin with at least one hit.
+    struct TimeBin_t {
+      size_t index;        ///< bin index (as in SimpleFlashAlgo)
+      double pesum;        ///< sum of the PE of the hits in the bin
+      double mult;         ///< number of hits in the bin
+      size_t hit_begin;    ///< first hit of the bin in _hit_v
+      size_t hit_end;      ///< after the last hit of the bin in _hit_v
+      size_t window_begin; ///< first bin of the integration window in _bin_v
+      size_t window_end;   ///< after the last bin of the window in _bin_v
+    };
+
+    // selected hits: (time bin index, hit index), sorted
+    std::vector<std::pair<size_t,unsigned int> > _hit_v;
+
+    // time bins with hits, sorted by index
+    std::vector<TimeBin_t> _bin_v;
+
+    // PE of each channel in a time bin (scratch space, always left at 0)
+    std::vector<double> _bin_pe_v;
+
+  };
+
+  /**
+     \class pmtana::SparseFlashAlgoFactory
+     \brief A concrete factory class for pmtana::SparseFlashAlgo
+  */
+  class SparseFlashAlgoFactory : public FlashAlgoFactoryBase {
+  public:
+    /// ctor
+    SparseFlashAlgoFactory() { FlashAlgoFactory::get().add_factory("SparseFlashAlgo",this); }
+    /// dtor
+    ~SparseFlashAlgoFactory() {}
+    /// creation method
+    FlashAlgoBase* create(const std::string instance_name) { return new SparseFlashAlgo(instance_name); }
+  };
+
+}
+#endif
+
+/** @} */ // end of doxygen group
@@ -16,6 +16,7 @@
 #include "icaruscode/PMT/Algorithms/NoiseGeneratorAlg.h"
 #include "icaruscode/PMT/Algorithms/PhotoelectronPulseFunction.h"
 #include "icaruscode/IcarusObj/OpDetWaveformMeta.h"
+#include "icaruscode/Utilities/EventStreamSeeding.h"
 
 // LArSoft libraries
 #include "larcore/CoreUtils/ServiceUtil.h"
@@ -48,6 +49,11 @@
 
 // CLHEP libraries
 #include "CLHEP/Random/RandEngine.h" // CLHEP::HepRandomEngine
+#include "CLHEP/Random/MixMaxRng.h"
+
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 
 // C/C++ standard library
 #include <vector>
@@ -57,6 +63,7 @@
 #include <memory> // std::make_unique()
 #include <utility> // std::move()
 #include <optional>
+#include <cstdint> // std::uint64_t
 
 
 namespace icarus::opdet {
@@ -95,6 +102,8 @@ namespace icarus::opdet {
    *   `sim::SimPhotons` collection the photons effectively contributing to
    *   the waveforms; currently, no selection ever happens and all photons are
    *   contributing, making this collection the same as the input one.
+   * * **MultiThreaded** (boolean, default: `false`): simulates the channels in
+   *   parallel; see @ref ICARUS_SimPMTIcarus_MultiThreaded "below".
    * 
    * See the @ref ICARUS_PMTSimulationAlg_RandomEngines "documentation" of
    * `icarus::PMTsimulationAlg` for the purpose of the three random number
@@ -104,6 +113,24 @@ namespace icarus::opdet {
    * seeds, which is delegated to `rndm::NuRandomService` service.
    * 
    * 
+   * Multithreading
+   * ---------------
+   * 
+   * @anchor ICARUS_SimPMTIcarus_MultiThreaded
+   * 
+   * With `MultiThreaded` set, the channels are simulated in parallel with
+   * `tbb::parallel_for`. Each thread has its own algorithm, pedestal generator
+   * and random engines (`CLHEP::MixMaxRng`, regardless of the configured
+   * engine types); the algorithms are created on the first event and only
+   * moved to each new event afterwards. Before each channel is simulated, those engines are moved
+   * to a stream which is a function only of the seed of the corresponding
+   * module engine, the event ID and the channel number, so that the result
+   * does not depend on the number of threads nor on the scheduling.
+   * Waveforms, photons and metadata are then collected in the same order as
+   * in the single thread mode. The random sequences are different from the
+   * ones of the single thread mode, which is left unchanged.
+   * 
+   * 
    * Input
    * ======
    * 
@@ -239,6 +266,13 @@ namespace icarus::opdet {
           "HepJamesRandom"
       };
 
+      fhicl::Atom<bool> MultiThreaded {
+          Name("MultiThreaded"),
+          Comment
+            ("simulates the channels in parallel (per-channel random streams)"),
+          false
+      };
+
     }; // struct Config
       
     using Parameters = art::EDProducer::Table<Config>;
@@ -265,11 +299,27 @@ namespace icarus::opdet {
     using PedestalGenerator_t
       = icarus::opdet::PMTpedestalGeneratorTool::Generator_t;
     
+    /// Random engines, pedestal generator and algorithm of a thread
+    /// (multithreaded mode).
+    struct ThreadContext_t {
+      CLHEP::MixMaxRng efficiencyEngine;
+      CLHEP::MixMaxRng darkNoiseEngine;
+      CLHEP::MixMaxRng electronicsNoiseEngine;
+      
+      /// Pedestal generator using `electronicsNoiseEngine`.
+      std::unique_ptr<PedestalGenerator_t> pedestalGen;
+      
+      /// Simulation algorithm using the engines and pedestal generator above
+      /// (created on the first event, then moved from event to event).
+      std::unique_ptr<PMTsimulationAlg> simulator;
+    }; // ThreadContext_t
+    
     /// Input tag for simulated scintillation photons (or photoelectrons).
     art::InputTag fInputModuleName;
     
     bool fMakeMetadata; ///< Whether to produce waveform metadata.
     bool fWritePhotons { false }; ///< Whether to save contributing photons.
+    bool fMultiThreaded; ///< Whether to simulate the channels in parallel.
     
     CLHEP::HepRandomEngine&  fEfficiencyEngine;
     CLHEP::HepRandomEngine&  fDarkNoiseEngine;
@@ -284,6 +334,9 @@ namespace icarus::opdet {
     /// The actual simulation algorithm.
     icarus::opdet::PMTsimulationAlgMaker makePMTsimulator;
 
+    /// Engines and pedestal generators of each thread (multithreaded mode).
+    std::vector<std::unique_ptr<ThreadContext_t>> fThreadContexts;
+
     
     /// True if `firstTime()` has already been called.
     std::atomic_flag fNotFirstTime;
@@ -299,6 +352,25 @@ namespace icarus::opdet {
         detinfo::DetectorTimings const& detTimings
       ) const;
     
+    /**
+     * @brief Simulates all the channels in parallel.
+     * @param event the event being simulated
+     * @param clockData timing information for the event
+     * @param photonVec photons to be simulated (`nullptr` if not available)
+     * @param litePhotonVec photons to be simulated, if `photonVec` is not
+     * @param[out] waveforms the simulated waveforms are appended here
+     * @param[out] photonsUsed if not `nullptr`, used photons are appended here
+     * @return the number of simulated channels
+     */
+    unsigned int simulateInParallel(
+      art::Event const& event,
+      detinfo::DetectorClocksData const& clockData,
+      std::vector<sim::SimPhotons> const* photonVec,
+      std::vector<sim::SimPhotonsLite> const* litePhotonVec,
+      std::vector<raw::OpDetWaveform>& waveforms,
+      std::vector<sim::SimPhotons>* photonsUsed
+      );
+    
     /// Returns whether no other event has been processed yet.
     bool firstTime() { return !fNotFirstTime.test_and_set(); }
     
@@ -314,6 +386,7 @@ SimPMTIcarus::SimPMTIcarus(Parameters const& config)
     , fInputModuleName(config().inputModuleLabel())
     , fMakeMetadata(config().MakeMetadata())
     , fWritePhotons(config().writePhotons())
+    , fMultiThreaded(config().MultiThreaded())
     // random engines
     , fEfficiencyEngine(art::ServiceHandle<rndm::NuRandomService>()->registerAndSeedEngine(
           createEngine(0, "HepJamesRandom", "Efficiencies"),
@@ -354,6 +427,20 @@ SimPMTIcarus::SimPMTIcarus(Parameters const& config)
     }
     if (fWritePhotons) produces<std::vector<sim::SimPhotons> >();
     
+    if (fMultiThreaded) {
+      // the pedestal generators keep a reference to their engine,
+      // so each thread gets one bound to its own electronics noise engine
+      auto const pedestalConfig = config().Pedestal.get<fhicl::ParameterSet>();
+      int const nThreads = tbb::this_task_arena::max_concurrency();
+      for (int iThread = 0; iThread < nThreads; ++iThread) {
+        auto context = std::make_unique<ThreadContext_t>();
+        context->pedestalGen
+          = art::make_tool<icarus::opdet::PMTpedestalGeneratorTool>
+            (pedestalConfig)->makeGenerator(context->electronicsNoiseEngine);
+        fThreadContexts.push_back(std::move(context));
+      } // for
+    } // if multithreaded
+    
     fNotFirstTime.clear(); // superfluous in C++20
   } // SimPMTIcarus::SimPMTIcarus()
   
@@ -408,7 +495,14 @@ SimPMTIcarus::SimPMTIcarus(Parameters const& config)
     // run the algorithm
     //
     unsigned int nopch = 0;
-    if(pmtVector.isValid()) {
+    if (fMultiThreaded) {
+      nopch = simulateInParallel(e, clockData,
+        pmtVector.isValid()? pmtVector.product(): nullptr,
+        pmtLiteVector.isValid()? pmtLiteVector.product(): nullptr,
+        *pulseVecPtr, simphVecPtr.get()
+        );
+    }
+    else if(pmtVector.isValid()) {
       nopch = pmtVector->size();
       for(auto const& photons : *pmtVector) {
       
@@ -477,6 +571,96 @@ SimPMTIcarus::SimPMTIcarus(Parameters const& config)
   } // SimPMTIcarus::produce()
   
   
+  // ---------------------------------------------------------------------------
+  unsigned int SimPMTIcarus::simulateInParallel(
+    art::Event const& event,
+    detinfo::DetectorClocksData const& clockData,
+    std::vector<sim::SimPhotons> const* photonVec,
+    std::vector<sim::SimPhotonsLite> const* litePhotonVec,
+    std::vector<raw::OpDetWaveform>& waveforms,
+    std::vector<sim::SimPhotons>* photonsUsed
+  ) {
+    std::size_t const nChannels = photonVec? photonVec->size()
+      : (litePhotonVec? litePhotonVec->size(): 0U);
+    
+    // one algorithm per thread, bound to the engines of that thread:
+    // it is created once, and then only its event parameters are updated
+    std::uint64_t const beamGateTimestamp = event.time().value(); // as in produce()
+    detinfo::LArProperties const& larProp
+      = *(lar::providerFrom<detinfo::LArPropertiesService>());
+    for (auto const& context: fThreadContexts) {
+      if (context->simulator) {
+        context->simulator->setEventParameters
+          (beamGateTimestamp, larProp, clockData);
+        continue;
+      }
+      context->simulator = makePMTsimulator(
+        beamGateTimestamp,
+        larProp,
+        clockData,
+        *fSinglePhotonResponseFunc,
+        *(context->pedestalGen),
+        context->efficiencyEngine,
+        context->darkNoiseEngine,
+        context->electronicsNoiseEngine,
+        fWritePhotons
+        );
+    } // for threads
+    
+    // the streams of each channel are keyed to the seeds of the module engines
+    long const efficiencySeed = fEfficiencyEngine.getSeed();
+    long const darkNoiseSeed = fDarkNoiseEngine.getSeed();
+    long const electronicsNoiseSeed = fElectronicsNoiseEngine.getSeed();
+    art::EventID const& eventID = event.id();
+    
+    std::vector<std::vector<raw::OpDetWaveform>> channelWaveforms(nChannels);
+    std::vector<std::optional<sim::SimPhotons>> channelPhotons(nChannels);
+    
+    tbb::parallel_for(std::size_t(0), nChannels, [&](std::size_t iChannel)
+      {
+        std::size_t const iThread = tbb::this_task_arena::current_thread_index();
+        ThreadContext_t& context = *(fThreadContexts[iThread]);
+        
+        raw::Channel_t const channel = photonVec
+          ? (*photonVec)[iChannel].OpChannel()
+          : (*litePhotonVec)[iChannel].OpChannel;
+        icarus::ns::util::seedEventStream
+          (context.efficiencyEngine, efficiencySeed, 0, eventID, channel);
+        icarus::ns::util::seedEventStream
+          (context.darkNoiseEngine, darkNoiseSeed, 1, eventID, channel);
+        icarus::ns::util::seedEventStream(context.electronicsNoiseEngine,
+          electronicsNoiseSeed, 2, eventID, channel);
+
+        // make an empty collection of the missing photon type
+        if (photonVec) {
+          sim::SimPhotonsLite const lite_photons(channel);
+          std::tie(channelWaveforms[iChannel], channelPhotons[iChannel])
+            = context.simulator->simulate
+              ((*photonVec)[iChannel], lite_photons);
+        }
+        else {
+          sim::SimPhotons const photons(channel);
+          std::tie(channelWaveforms[iChannel], channelPhotons[iChannel])
+            = context.simulator->simulate
+              (photons, (*litePhotonVec)[iChannel]);
+        }
+      }
+      );
+    
+    // collect the output in channel order, as in the single thread mode
+    for (std::size_t iChannel = 0; iChannel < nChannels; ++iChannel) {
+      std::move(
+        channelWaveforms[iChannel].begin(), channelWaveforms[iChannel].end(),
+        std::back_inserter(waveforms)
+        );
+      if (photonVec && photonsUsed && channelPhotons[iChannel])
+        photonsUsed->emplace_back(std::move(channelPhotons[iChannel].value()));
+    } // for channels
+    
+    return nChannels;
+  } // SimPMTIcarus::simulateInParallel()
+  
+  
   // ---------------------------------------------------------------------------
   std::pair<
     std::vector<sbn::OpDetWaveformMeta>,
@@ -24,6 +24,7 @@
 #include <string>
 #include <optional>
 #include <cassert>
+#include <vector>
 
 namespace icarus {
   namespace calo {
@@ -57,7 +58,8 @@ private:
   };
 
   // Helpers
-  RunInfo GetRunInfo(uint64_t run);
+  const RunInfo& GetRunInfo(uint64_t run);
+  double Normalize(double dQdx, const RunInfo& runelifetime, const recob::Hit &hit, double t0) const;
 
   // Cache run requests
   std::map<uint32_t, RunInfo> fRunInfos;
@@ -82,10 +84,10 @@ void icarus::calo::NormalizeDriftSQLite::setup(const art::Event& e) {
   fClockData.emplace(art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(e));
 }
 
-icarus::calo::NormalizeDriftSQLite::RunInfo icarus::calo::NormalizeDriftSQLite::GetRunInfo(uint64_t run) {
+const icarus::calo::NormalizeDriftSQLite::RunInfo& icarus::calo::NormalizeDriftSQLite::GetRunInfo(uint64_t run) {
   // check the cache
-  if (fRunInfos.count(run)) {
-    return fRunInfos.at(run);
+  if (auto const it = fRunInfos.find(run); it != fRunInfos.end()) {
+    return it->second;
   }
 
   // Look up the run
@@ -112,18 +114,22 @@ icarus::calo::NormalizeDriftSQLite::RunInfo icarus::calo::NormalizeDriftSQLite::
   if (fVerbose) std::cout << "NormalizeDriftSQLite Tool -- Lifetime Data:" << "\nTPC EE: " << thisrun.tau_EE << "\nTPC EW: " << thisrun.tau_EW << "\nTPC WE: " << thisrun.tau_WE << "\nTPC WW: " << thisrun.tau_WW << std::endl;
 
   // Set the cache
-  fRunInfos[run] = thisrun;
-
-  return thisrun;
+  return fRunInfos[run] = thisrun;
 }
 
 double icarus::calo::NormalizeDriftSQLite::Normalize(double dQdx, const art::Event &e, 
     const recob::Hit &hit, const geo::Point_t &location, const geo::Vector_t &direction, double t0) {
 
-  assert(fClockData);
-
   // Get the info
-  RunInfo runelifetime = GetRunInfo(e.id().runID().run());
+  RunInfo const& runelifetime = GetRunInfo(e.id().runID().run());
+
+  return Normalize(dQdx, runelifetime, hit, t0);
+}
+
+double icarus::calo::NormalizeDriftSQLite::Normalize(double dQdx, const RunInfo& runelifetime,
+    const recob::Hit &hit, double t0) const {
+
+  assert(fClockData);
 
   // lookup the TPC
   double thiselifetime = -1;
@@ -22,6 +22,7 @@
 
 // C++
 #include <string>
+#include <vector>
 
 namespace icarus {
   namespace calo {
@@ -49,7 +50,8 @@ private:
   };
 
   // Helpers
-  ScaleInfo GetScaleInfo(uint64_t run);
+  const ScaleInfo& GetScaleInfo(uint64_t run);
+  double Normalize(double dQdx, const ScaleInfo& i, const recob::Hit &hit) const;
 
   // Cache run requests
   std::map<uint64_t, ScaleInfo> fScaleInfos;
@@ -69,10 +71,10 @@ icarus::calo::NormalizeTPCSQL::NormalizeTPCSQL(fhicl::ParameterSet const &pset):
 
 void icarus::calo::NormalizeTPCSQL::configure(const fhicl::ParameterSet& pset) {}
 
-icarus::calo::NormalizeTPCSQL::ScaleInfo icarus::calo::NormalizeTPCSQL::GetScaleInfo(uint64_t run) {
+const icarus::calo::NormalizeTPCSQL::ScaleInfo& icarus::calo::NormalizeTPCSQL::GetScaleInfo(uint64_t run) {
   // check the cache
-  if (fScaleInfos.count(run)) {
-    return fScaleInfos.at(run);
+  if (auto const it = fScaleInfos.find(run); it != fScaleInfos.end()) {
+    return it->second;
   }
 
   // Look up the run
@@ -91,16 +93,18 @@ icarus::calo::NormalizeTPCSQL::ScaleInfo icarus::calo::NormalizeTPCSQL::GetScale
     thisscale.scale[ch] = scale;
   }
   // Set the cache
-  fScaleInfos[run] = thisscale;
-
-  return thisscale;
+  return fScaleInfos[run] = std::move(thisscale);
 }
 
 double icarus::calo::NormalizeTPCSQL::Normalize(double dQdx, const art::Event &e, 
     const recob::Hit &hit, const geo::Point_t &location, const geo::Vector_t &direction, double t0) {
   // Get the info
-  ScaleInfo i = GetScaleInfo(e.id().runID().run());
+  ScaleInfo const& i = GetScaleInfo(e.id().runID().run());
+
+  return Normalize(dQdx, i, hit);
+}
 
+double icarus::calo::NormalizeTPCSQL::Normalize(double dQdx, const ScaleInfo& i, const recob::Hit &hit) const {
   // Lookup the TPC, cryo
   unsigned tpc = hit.WireID().TPC;
   unsigned cryo = hit.WireID().Cryostat;
@@ -110,7 +114,7 @@ double icarus::calo::NormalizeTPCSQL::Normalize(double dQdx, const art::Event &e
   double scale = 1;
 
   // TODO: what to do if no scale is found? throw an exception??
-  if (i.scale.count(itpc)) scale = i.scale.at(itpc);
+  if (auto const it = i.scale.find(itpc); it != i.scale.end()) scale = it->second;
 
   if (fVerbose) std::cout << "NormalizeTPCSQL Tool -- Data at itpc: " << itpc << " scale: " << scale << std::endl;
 
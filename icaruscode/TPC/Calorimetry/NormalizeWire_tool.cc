@@ -20,6 +20,7 @@
 
 // C++
 #include <string>
+#include <vector>
 
 namespace icarus {
   namespace calo {
@@ -42,10 +43,17 @@ private:
   class ScaleInfo {
   public:
     std::map<unsigned, double> scale;
+    std::vector<double> channelScale; // same as `scale`, indexed by channel (1 if missing)
+
+    double ChannelScale(unsigned channel) const;
   };
 
+  // channels beyond this are looked up in the map only
+  static constexpr unsigned MaxDenseChannel = 1 << 20;
+
   // Helpers
-  ScaleInfo GetScaleInfo(uint64_t timestamp);
+  const ScaleInfo& GetScaleInfo(uint64_t timestamp);
+  double Normalize(double dQdx, const ScaleInfo& i, const recob::Hit &hit) const;
   std::string URL(uint64_t timestamp);
 
   // Cache timestamp requests
@@ -72,10 +80,18 @@ std::string icarus::calo::NormalizeWire::URL(uint64_t timestamp) {
   return fURL + std::to_string(timestamp);
 }
 
-icarus::calo::NormalizeWire::ScaleInfo icarus::calo::NormalizeWire::GetScaleInfo(uint64_t timestamp) {
+double icarus::calo::NormalizeWire::ScaleInfo::ChannelScale(unsigned channel) const {
+  if (channel < channelScale.size()) return channelScale[channel];
+
+  // TODO: what to do if no lifetime is found? throw an exception??
+  auto const it = scale.find(channel);
+  return (it != scale.end())? it->second: 1;
+}
+
+const icarus::calo::NormalizeWire::ScaleInfo& icarus::calo::NormalizeWire::GetScaleInfo(uint64_t timestamp) {
   // check the cache
-  if (fScaleInfos.count(timestamp)) {
-    return fScaleInfos.at(timestamp);
+  if (auto const it = fScaleInfos.find(timestamp); it != fScaleInfos.end()) {
+    return it->second;
   }
 
   // Otherwise, look it up
@@ -127,24 +143,30 @@ icarus::calo::NormalizeWire::ScaleInfo icarus::calo::NormalizeWire::GetScaleInfo
     thisscale.scale[ch] = scale;
   }
 
-  // Set the cache
-  fScaleInfos[timestamp] = thisscale;
+  // Dense copy for direct lookup by channel
+  for (auto const& [ ch, scale ]: thisscale.scale) {
+    if (ch >= MaxDenseChannel) break;
+    if (ch >= thisscale.channelScale.size()) thisscale.channelScale.resize(ch + 1, 1.);
+    thisscale.channelScale[ch] = scale;
+  }
 
-  return thisscale;
+  // Set the cache
+  return fScaleInfos[timestamp] = std::move(thisscale);
 }
 
 double icarus::calo::NormalizeWire::Normalize(double dQdx, const art::Event &e, 
     const recob::Hit &hit, const geo::Point_t &location, const geo::Vector_t &direction, double t0) {
   // Get the info
-  ScaleInfo i = GetScaleInfo(e.time().timeHigh());
+  ScaleInfo const& i = GetScaleInfo(e.time().timeHigh());
+
+  return Normalize(dQdx, i, hit);
+}
 
+double icarus::calo::NormalizeWire::Normalize(double dQdx, const ScaleInfo& i, const recob::Hit &hit) const {
   // Lookup the channel
   unsigned channel = hit.Channel();
 
-  double scale = 1;
-
-  // TODO: what to do if no lifetime is found? throw an exception??
-  if (i.scale.count(channel)) scale = i.scale.at(channel);
+  double scale = i.ChannelScale(channel);
 
   if (fVerbose) std::cout << "NormalizeWire Tool -- Data at channel: " << channel << " scale: " << scale << std::endl;
 
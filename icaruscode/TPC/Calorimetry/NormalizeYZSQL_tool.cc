@@ -13,6 +13,7 @@
 
 // Tool include
 #include "larreco/Calorimetry/INormalizeCharge.h"
+#include "icaruscode/TPC/Calorimetry/YZScaleGrid.h"
 
 // Services
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
@@ -22,6 +23,7 @@
 
 // C++
 #include <string>
+#include <vector>
 
 namespace icarus {
   namespace calo {
@@ -45,44 +47,15 @@ private:
   // Class to hold data from DB
   class ScaleInfo {
   public:
-    struct Point {
-      int itpc;
-      double y, z;
-    };
-
-    class ScaleBin {
-      public:
-      int itpc;
-      double ylo;
-      double yhi;
-      double zlo;
-      double zhi;
-
-      double scale;
-
-      bool contains(const Point& point) const noexcept;
-      constexpr bool operator< (const ScaleBin& other) const noexcept;
-    };
-
-    struct BinComp {
-      /// Returns if the point `b` is strictly after the bin `a`.
-      bool operator() (const ScaleBin& a, const Point& b) const noexcept;
-      /// Returns if the point `a` is strictly after the bin `b`.
-      bool operator() (const Point& a, const ScaleBin& b) const noexcept;
-    };
-
     float tzero; // Earliest time that this scale info is valid
-    std::vector<ScaleBin> bins;
-
-    /// Returns the bin containing the `point`, `nullptr` if none.
-    ScaleBin const* findBin(const Point& point) const noexcept;
-
+    YZScaleGrid bins;
   };
   // Cache run requests
   std::map<uint64_t, ScaleInfo> fScaleInfos;
 
   // Helpers
   const ScaleInfo& GetScaleInfo(uint64_t run);
+  double Normalize(double dQdx, const ScaleInfo& i, const recob::Hit &hit, const geo::Point_t &location) const;
 };
 
 DEFINE_ART_CLASS_TOOL(NormalizeYZSQL)
@@ -91,60 +64,6 @@ DEFINE_ART_CLASS_TOOL(NormalizeYZSQL)
 } // end namespace icarus
 
 
-constexpr bool icarus::calo::NormalizeYZSQL::ScaleInfo::ScaleBin::operator<
-  (const ScaleBin& other) const noexcept
-{
-  if (itpc != other.itpc) return itpc < other.itpc;
-  if (yhi != other.yhi) return yhi < other.yhi;
-  return zhi < other.zhi;
-}
-
-bool icarus::calo::NormalizeYZSQL::ScaleInfo::BinComp::operator()
-  (const ScaleBin& a, const Point& b) const noexcept
-{
-  // the bin `a` must be strictly before the point `b`
-  if (a.itpc != b.itpc) return a.itpc < b.itpc;
-  if (a.yhi <= b.y) return true;
-  if (a.ylo > b.y) return false;
-  return a.zhi <= b.z;
-}
-
-bool icarus::calo::NormalizeYZSQL::ScaleInfo::BinComp::operator()
-  (const Point& a, const ScaleBin& b) const noexcept
-{
-  // the point `a` must be strictly before the bin `b`
-  if (a.itpc != b.itpc) return a.itpc < b.itpc;
-  if (a.y < b.ylo) return true;
-  if (a.y >= b.yhi) return false;
-  return a.z < b.zlo;
-}
-
-bool icarus::calo::NormalizeYZSQL::ScaleInfo::ScaleBin::contains
-  (const Point& point) const noexcept
-{
-  if (point.itpc != itpc) return false;
-  if ((point.y < ylo) || (point.y >= yhi)) return false;
-  return ((point.z >= zlo) && (point.z < zhi));
-}
-
-
-auto icarus::calo::NormalizeYZSQL::ScaleInfo::findBin
-  (const Point& point) const noexcept -> ScaleBin const*
-{
-  auto itBin = std::upper_bound(bins.begin(), bins.end(), point, ScaleInfo::BinComp{});
-  /*
-   * because of how upper_bound() works:
-   *  * if the point is before the first bin, `begin()` is returned
-   *  * if the point is after the last bin, `end()` is returned
-   *  * if the point is within the last bin, `end()` is returned
-   *  * if the point is within the domain, the returned bin is the one after the desired one
-   *  * if the point is in a TPC but beyond its last bin, first bin of next TPC is returned
-   */
-  return ((itBin != bins.cbegin()) && (--itBin)->contains(point))? &*itBin: nullptr;
-}
-
-
-
 icarus::calo::NormalizeYZSQL::NormalizeYZSQL(fhicl::ParameterSet const &pset):
   fDBFileName(pset.get<std::string>("DBFileName")),
   fDBTag(pset.get<std::string>("DBTag")),
@@ -155,8 +74,8 @@ void icarus::calo::NormalizeYZSQL::configure(const fhicl::ParameterSet& pset) {}
 
 const icarus::calo::NormalizeYZSQL::ScaleInfo& icarus::calo::NormalizeYZSQL::GetScaleInfo(uint64_t run) {
   // check the cache
-  if (fScaleInfos.count(run)) {
-    return fScaleInfos.at(run);
+  if (auto const it = fScaleInfos.find(run); it != fScaleInfos.end()) {
+    return it->second;
   }
 
   // Look up the run
@@ -172,7 +91,8 @@ const icarus::calo::NormalizeYZSQL::ScaleInfo& icarus::calo::NormalizeYZSQL::Get
   fDB.GetChannelList(channels);
 
   // Iterate over the channels
-  thisscale.bins.reserve(channels.size());
+  std::vector<YZScaleGrid::ScaleBin> bins;
+  bins.reserve(channels.size());
   for (unsigned ch = 0; ch < channels.size(); ch++) {
     std::string tpcname;
     fDB.GetNamedChannelData(ch, "tpc", tpcname);
@@ -196,7 +116,7 @@ const icarus::calo::NormalizeYZSQL::ScaleInfo& icarus::calo::NormalizeYZSQL::Get
     double scale;
     fDB.GetNamedChannelData(ch, "scale", scale);
 
-    ScaleInfo::ScaleBin bin;
+    YZScaleGrid::ScaleBin bin;
     bin.ylo = ylo;
     bin.yhi = yhi;
     bin.zlo = zlo;
@@ -204,9 +124,10 @@ const icarus::calo::NormalizeYZSQL::ScaleInfo& icarus::calo::NormalizeYZSQL::Get
     bin.itpc = itpc;
     bin.scale = scale;
 
-    thisscale.bins.push_back(bin);
+    bins.push_back(bin);
   }
-  std::sort(thisscale.bins.begin(), thisscale.bins.end());
+  // sorts the bins and lays them on a grid for each TPC
+  thisscale.bins = YZScaleGrid{ std::move(bins) };
 
   // Set the cache
   return fScaleInfos[run] = std::move(thisscale);
@@ -218,6 +139,11 @@ double icarus::calo::NormalizeYZSQL::Normalize(double dQdx, const art::Event &e,
   // Get the info
   ScaleInfo const& i = GetScaleInfo(e.id().runID().run());
 
+  return Normalize(dQdx, i, hit, location);
+}
+
+double icarus::calo::NormalizeYZSQL::Normalize(double dQdx, const ScaleInfo& i,
+    const recob::Hit &hit, const geo::Point_t &location) const {
   // compute itpc
   int cryo = hit.WireID().Cryostat;
   int tpc = hit.WireID().TPC;
@@ -226,8 +152,8 @@ double icarus::calo::NormalizeYZSQL::Normalize(double dQdx, const art::Event &e,
   double y = location.y();
   double z = location.z();
 
-  ScaleInfo::Point const point { itpc, y, z };
-  ScaleInfo::ScaleBin const* b = i.findBin(point);
+  YZScaleGrid::Point const point { itpc, y, z };
+  YZScaleGrid::ScaleBin const* b = i.bins.findBin(point);
 
   double const scale = b? b->scale: 1;
   if (!b) {
@@ -0,0 +1,229 @@
+/**
+ * @file   icaruscode/TPC/Calorimetry/YZScaleGrid.h
+ * @brief  Lookup of the y-z dependent charge scale of each TPC.
+ * @date   October 16, 2026
+ *
+ * The y-z calibration is stored in the database as a list of rectangular bins
+ * for each TPC. When the bins of a TPC tile a uniform grid (as they do), the
+ * bin of a point is found by index arithmetic; otherwise (or for points on the
+ * border of a cell, where rounding may matter) it is searched in the sorted
+ * list of bins.
+ */
+
+#ifndef ICARUSCODE_TPC_CALORIMETRY_YZSCALEGRID_H
+#define ICARUSCODE_TPC_CALORIMETRY_YZSCALEGRID_H
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace icarus {
+  namespace calo {
+
+class YZScaleGrid {
+public:
+  struct Point {
+    int itpc;
+    double y, z;
+  };
+
+  class ScaleBin {
+    public:
+    int itpc;
+    double ylo;
+    double yhi;
+    double zlo;
+    double zhi;
+
+    double scale;
+
+    bool contains(const Point& point) const noexcept;
+    constexpr bool operator< (const ScaleBin& other) const noexcept;
+  };
+
+  YZScaleGrid() = default;
+
+  /// Sorts the bins and builds the grid of each TPC.
+  explicit YZScaleGrid(std::vector<ScaleBin> bins);
+
+  /// Returns the bin containing the `point`, `nullptr` if none.
+  ScaleBin const* findBin(const Point& point) const noexcept;
+
+  /// Returns the sorted bins.
+  std::vector<ScaleBin> const& bins() const noexcept { return fBins; }
+
+  /// Returns whether the bins of TPC `itpc` are on a uniform grid.
+  bool hasGrid(int itpc) const noexcept
+    { return (itpc >= 0) && (std::size_t(itpc) < fGrids.size()) && !fGrids[itpc].cells.empty(); }
+
+private:
+  struct BinComp {
+    /// Returns if the point `b` is strictly after the bin `a`.
+    bool operator() (const ScaleBin& a, const Point& b) const noexcept;
+    /// Returns if the point `a` is strictly after the bin `b`.
+    bool operator() (const Point& a, const ScaleBin& b) const noexcept;
+  };
+
+  /// Uniform grid of a TPC: index of the bin of each cell (`-1` if none).
+  struct Grid {
+    double y0 = 0., z0 = 0.;
+    double invDy = 0., invDz = 0.;
+    int ny = 0, nz = 0;
+    std::vector<int> cells;
+  };
+
+  std::vector<ScaleBin> fBins; ///< All bins, sorted by TPC, y and z.
+  std::vector<Grid> fGrids; ///< Grid of each TPC (no cells if not uniform).
+
+  /// Binary search of the bin containing the `point`.
+  ScaleBin const* searchBin(const Point& point) const noexcept;
+
+  /// Builds the grid of the bins in [ `first`, `last` [, all in the same TPC.
+  Grid makeGrid(std::size_t first, std::size_t last) const;
+};
+
+  } // end namespace calo
+} // end namespace icarus
+
+
+// -----------------------------------------------------------------------------
+constexpr bool icarus::calo::YZScaleGrid::ScaleBin::operator<
+  (const ScaleBin& other) const noexcept
+{
+  if (itpc != other.itpc) return itpc < other.itpc;
+  if (yhi != other.yhi) return yhi < other.yhi;
+  return zhi < other.zhi;
+}
+
+inline bool icarus::calo::YZScaleGrid::BinComp::operator()
+  (const ScaleBin& a, const Point& b) const noexcept
+{
+  // the bin `a` must be strictly before the point `b`
+  if (a.itpc != b.itpc) return a.itpc < b.itpc;
+  if (a.yhi <= b.y) return true;
+  if (a.ylo > b.y) return false;
+  return a.zhi <= b.z;
+}
+
+inline bool icarus::calo::YZScaleGrid::BinComp::operator()
+  (const Point& a, const ScaleBin& b) const noexcept
+{
+  // the point `a` must be strictly before the bin `b`
+  if (a.itpc != b.itpc) return a.itpc < b.itpc;
+  if (a.y < b.ylo) return true;
+  if (a.y >= b.yhi) return false;
+  return a.z < b.zlo;
+}
+
+inline bool icarus::calo::YZScaleGrid::ScaleBin::contains
+  (const Point& point) const noexcept
+{
+  if (point.itpc != itpc) return false;
+  if ((point.y < ylo) || (point.y >= yhi)) return false;
+  return ((point.z >= zlo) && (point.z < zhi));
+}
+
+
+inline icarus::calo::YZScaleGrid::YZScaleGrid(std::vector<ScaleBin> bins)
+  : fBins(std::move(bins))
+{
+  std::sort(fBins.begin(), fBins.end());
+
+  // one grid per TPC
+  for (std::size_t first = 0; first < fBins.size(); ) {
+    int const itpc = fBins[first].itpc;
+    std::size_t last = first;
+    while ((last < fBins.size()) && (fBins[last].itpc == itpc)) ++last;
+    if (itpc >= 0) {
+      if (fGrids.size() <= std::size_t(itpc)) fGrids.resize(itpc + 1);
+      fGrids[itpc] = makeGrid(first, last);
+    }
+    first = last;
+  }
+}
+
+
+inline auto icarus::calo::YZScaleGrid::makeGrid
+  (std::size_t first, std::size_t last) const -> Grid
+{
+  ScaleBin const& firstBin = fBins[first];
+  double const dy = firstBin.yhi - firstBin.ylo;
+  double const dz = firstBin.zhi - firstBin.zlo;
+  if ((dy <= 0.) || (dz <= 0.)) return {};
+
+  double y0 = firstBin.ylo, yMax = firstBin.yhi;
+  double z0 = firstBin.zlo, zMax = firstBin.zhi;
+  for (std::size_t i = first; i < last; ++i) {
+    y0 = std::min(y0, fBins[i].ylo);
+    yMax = std::max(yMax, fBins[i].yhi);
+    z0 = std::min(z0, fBins[i].zlo);
+    zMax = std::max(zMax, fBins[i].zhi);
+  }
+
+  Grid grid;
+  grid.y0 = y0;
+  grid.z0 = z0;
+  grid.invDy = 1. / dy;
+  grid.invDz = 1. / dz;
+  grid.ny = std::lround((yMax - y0) / dy);
+  grid.nz = std::lround((zMax - z0) / dz);
+  // the grid must not take much more memory than the bins themselves
+  if (double(grid.ny) * grid.nz > 16. * (last - first) + 1024.) return {};
+
+  // every bin must be exactly one cell
+  double const tolerance = 1e-6;
+  grid.cells.assign(std::size_t(grid.ny) * grid.nz, -1);
+  for (std::size_t i = first; i < last; ++i) {
+    ScaleBin const& bin = fBins[i];
+    long const iy = std::lround((bin.ylo - y0) / dy);
+    long const iz = std::lround((bin.zlo - z0) / dz);
+    if ((iy < 0) || (iy >= grid.ny) || (iz < 0) || (iz >= grid.nz)) return {};
+    if (std::abs(bin.ylo - (y0 + iy * dy)) > tolerance * dy) return {};
+    if (std::abs(bin.yhi - bin.ylo - dy) > tolerance * dy) return {};
+    if (std::abs(bin.zlo - (z0 + iz * dz)) > tolerance * dz) return {};
+    if (std::abs(bin.zhi - bin.zlo - dz) > tolerance * dz) return {};
+    int& cell = grid.cells[iy * grid.nz + iz];
+    if (cell >= 0) return {}; // overlapping bins
+    cell = i;
+  }
+  return grid;
+}
+
+
+inline auto icarus::calo::YZScaleGrid::findBin
+  (const Point& point) const noexcept -> ScaleBin const*
+{
+  if (hasGrid(point.itpc)) {
+    Grid const& grid = fGrids[point.itpc];
+    double const fy = (point.y - grid.y0) * grid.invDy;
+    double const fz = (point.z - grid.z0) * grid.invDz;
+    if ((fy >= 0.) && (fy < grid.ny) && (fz >= 0.) && (fz < grid.nz)) {
+      int const iBin = grid.cells[int(fy) * grid.nz + int(fz)];
+      // the bin edges have the last word on the points at the cell border
+      if ((iBin >= 0) && fBins[iBin].contains(point)) return &fBins[iBin];
+    }
+  }
+  return searchBin(point);
+}
+
+
+inline auto icarus::calo::YZScaleGrid::searchBin
+  (const Point& point) const noexcept -> ScaleBin const*
+{
+  auto itBin = std::upper_bound(fBins.begin(), fBins.end(), point, BinComp{});
+  /*
+   * because of how upper_bound() works:
+   *  * if the point is before the first bin, `begin()` is returned
+   *  * if the point is after the last bin, `end()` is returned
+   *  * if the point is within the last bin, `end()` is returned
+   *  * if the point is within the domain, the returned bin is the one after the desired one
+   *  * if the point is in a TPC but beyond its last bin, first bin of next TPC is returned
+   */
+  return ((itBin != fBins.cbegin()) && (--itBin)->contains(point))? &*itBin: nullptr;
+}
+
+
+#endif // ICARUSCODE_TPC_CALORIMETRY_YZSCALEGRID_H
@@ -1,4 +1,8 @@
 //std includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 //ROOT includes
@@ -20,6 +24,8 @@
 
 //icarus includes
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMap.h"
+#include "icaruscode/Decode/DecoderTools/details/A2795Compression.h"
+#include "icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h"
 
 //sbndaq includes
 #include "sbndaq-artdaq-core/Overlays/ICARUS/PhysCrateFragment.cc"
@@ -35,14 +41,35 @@ namespace tcpCompression {
     void clear() override;
 
   private:
+    using Clock_t = std::chrono::steady_clock;
+    using Seconds_t = std::chrono::duration<double>;
+
     art::InputTag fFragmentsLabel;
-    bool          fCheckOldFragments;
-    bool          fDumpADCs;
-    bool          fFoundFirstUncompressed = false;
-    bool          fFoundFirstCompressed   = false;
+    unsigned int  fRepetitions;
+    bool          fCompareWithOverlay;
     TH1F*         fCompHist;
     TH1F*         fDcmpHist;
     const icarusDB::IICARUSChannelMap* fChannelMap;
+
+    // buffers, reused fragment after fragment
+    std::vector<uint16_t> fCompressed;
+    std::vector<uint16_t> fDecompressed;
+
+    // totals for the throughput
+    size_t    fNFragments        = 0;
+    size_t    fUncompressedBytes = 0;
+    size_t    fCompressedBytes   = 0;
+    size_t    fNMismatches       = 0;
+    size_t    fNOverlayMismatches = 0;
+    Seconds_t fCompressTime      { 0.0 };
+    Seconds_t fDecompressTime    { 0.0 };
+
+    /// Compresses and decompresses an uncompressed fragment; returns the mismatches.
+    size_t roundTripUncompressed(icarus::PhysCrateFragment const& fragOverlay, artdaq::Fragment const& frag);
+    /// Decompresses and compresses again a compressed fragment; returns the mismatches.
+    size_t roundTripCompressed(icarus::PhysCrateFragment const& fragOverlay, artdaq::Fragment const& frag);
+    /// Compares the last decompressed samples with `PhysCrateFragment::adc_val()`; returns the mismatches.
+    size_t compareWithOverlay(icarus::PhysCrateFragment const& fragOverlay) const;
   };// end ValidateCompression class
 
   //------------------------------------------------------------------
@@ -55,8 +82,8 @@ namespace tcpCompression {
   void ValidateCompression::reconfigure(fhicl::ParameterSet const& pset)
   {
     fFragmentsLabel    = pset.get<art::InputTag>("FragmentsLabel"   , "daq:PHYSCRATEDATA");
-    fCheckOldFragments = pset.get<bool>         ("CheckOldFragments", false);
-    fDumpADCs          = pset.get<bool>         ("DumpADCs"         , false);
+    fRepetitions       = pset.get<unsigned int> ("Repetitions"      , 1);
+    fCompareWithOverlay = pset.get<bool>        ("CompareWithOverlay", true);
 
     art::ServiceHandle<art::TFileService> tfs;
     fChannelMap = art::ServiceHandle<icarusDB::IICARUSChannelMap const>{}.get();
@@ -66,152 +93,177 @@ namespace tcpCompression {
   }
 
   //------------------------------------------------------------------
-  void ValidateCompression::event(art::Event const& evt)
+  size_t ValidateCompression::roundTripUncompressed(icarus::PhysCrateFragment const& fragOverlay, artdaq::Fragment const& frag)
   {
-    std::vector<artdaq::Fragment> originalFragments = evt.getProduct<std::vector<artdaq::Fragment>>(fFragmentsLabel);
+    size_t nBoards   = fragOverlay.nBoards();
+    size_t nChannels = fragOverlay.nChannelsPerBoard();
+    size_t nSamples  = fragOverlay.nSamplesPerChannel();
+    uint16_t adcMask = daq::details::TPCBoardADCmask(fragOverlay.metadata()->num_adc_bits());
 
-    // if we want to make a histogram for the waveform
-    art::ServiceHandle<art::TFileService> tfs;
+    uint16_t const* data = reinterpret_cast<uint16_t const*>(frag.dataBeginBytes());
+    size_t const nWords  = nBoards*daq::details::A2795BoardWords(nChannels, nSamples);
+    fCompressed.resize(nWords);
+    fDecompressed.resize(nWords);
 
-    // this is useful
-    size_t fragNumber = 0;
-    for (auto const& frag : originalFragments)
+    size_t nCompressed = 0;
+    auto const startCompress = Clock_t::now();
+    for (unsigned int rep = 0; rep < fRepetitions; ++rep)
+      nCompressed = daq::details::compressA2795Boards(data, nBoards, nChannels, nSamples, adcMask, fCompressed.data());
+    auto const startDecompress = Clock_t::now();
+    for (unsigned int rep = 0; rep < fRepetitions; ++rep)
+      daq::details::decompressA2795Boards(fCompressed.data(), nCompressed, nBoards, nChannels, nSamples, fDecompressed.data());
+    auto const end = Clock_t::now();
+
+    fCompressTime      += startDecompress - startCompress;
+    fDecompressTime    += end - startDecompress;
+    fUncompressedBytes += fRepetitions*nWords*sizeof(uint16_t);
+    fCompressedBytes   += fRepetitions*nCompressed*sizeof(uint16_t);
+    fCompHist->Fill(nCompressed*sizeof(uint16_t));
+    fDcmpHist->Fill(nWords*sizeof(uint16_t));
+
+    // the decompressed samples must be the original ones
+    size_t nMismatches = 0;
+    for (size_t board = 0; board < nBoards; ++board)
+    {
+      uint16_t const* oldSamples = daq::details::A2795BoardSamples(data, board, nChannels, nSamples);
+      uint16_t const* newSamples = daq::details::A2795BoardSamples(fDecompressed.data(), board, nChannels, nSamples);
+      for (size_t i = 0; i < nChannels*nSamples; ++i)
+        nMismatches += ((oldSamples[i] & adcMask) != newSamples[i]);
+    }
+    return nMismatches;
+  }
+
+  //------------------------------------------------------------------
+  size_t ValidateCompression::roundTripCompressed(icarus::PhysCrateFragment const& fragOverlay, artdaq::Fragment const& frag)
+  {
+    size_t nBoards   = fragOverlay.nBoards();
+    size_t nChannels = fragOverlay.nChannelsPerBoard();
+    size_t nSamples  = fragOverlay.nSamplesPerChannel();
+    uint16_t adcMask = daq::details::TPCBoardADCmask(fragOverlay.metadata()->num_adc_bits());
+
+    uint16_t const* data   = reinterpret_cast<uint16_t const*>(frag.dataBeginBytes());
+    size_t const nCompressed = frag.dataSizeBytes()/sizeof(uint16_t);
+    size_t const nWords      = nBoards*daq::details::A2795BoardWords(nChannels, nSamples);
+    fCompressed.resize(nWords);
+    fDecompressed.resize(nWords);
+
+    size_t nRecompressed = 0;
+    auto const startDecompress = Clock_t::now();
+    for (unsigned int rep = 0; rep < fRepetitions; ++rep)
+      daq::details::decompressA2795Boards(data, nCompressed, nBoards, nChannels, nSamples, fDecompressed.data());
+    auto const startCompress = Clock_t::now();
+    for (unsigned int rep = 0; rep < fRepetitions; ++rep)
+      nRecompressed = daq::details::compressA2795Boards(fDecompressed.data(), nBoards, nChannels, nSamples, adcMask, fCompressed.data());
+    auto const end = Clock_t::now();
+
+    fDecompressTime    += startCompress - startDecompress;
+    fCompressTime      += end - startCompress;
+    fUncompressedBytes += fRepetitions*nWords*sizeof(uint16_t);
+    fCompressedBytes   += fRepetitions*nCompressed*sizeof(uint16_t);
+    fCompHist->Fill(nCompressed*sizeof(uint16_t));
+    fDcmpHist->Fill(nWords*sizeof(uint16_t));
+
+    // compressing again must give back the same payload
+    size_t nMismatches = (nRecompressed > nCompressed)? (nRecompressed - nCompressed): (nCompressed - nRecompressed);
+    for (size_t i = 0; i < std::min(nRecompressed, nCompressed); ++i)
+      nMismatches += (data[i] != fCompressed[i]);
+    return nMismatches;
+  }
+
+  //------------------------------------------------------------------
+  size_t ValidateCompression::compareWithOverlay(icarus::PhysCrateFragment const& fragOverlay) const
+  {
+    size_t nBoards   = fragOverlay.nBoards();
+    size_t nChannels = fragOverlay.nChannelsPerBoard();
+    size_t nSamples  = fragOverlay.nSamplesPerChannel();
+    uint16_t adcMask = daq::details::TPCBoardADCmask(fragOverlay.metadata()->num_adc_bits());
+
+    // the overlay decodes the original fragment sample by sample, with its own decoder
+    size_t nMismatches = 0;
+    for (size_t board = 0; board < nBoards; ++board)
     {
+      uint16_t const* samples = daq::details::A2795BoardSamples(fDecompressed.data(), board, nChannels, nSamples);
+      for (size_t sample = 0; sample < nSamples; ++sample)
+        for (size_t channel = 0; channel < nChannels; ++channel)
+          nMismatches += ((samples[sample*nChannels + channel] & adcMask) != (fragOverlay.adc_val(board, channel, sample) & adcMask));
+    }
+    return nMismatches;
+  }
 
+  //------------------------------------------------------------------
+  void ValidateCompression::event(art::Event const& evt)
+  {
+    auto const& originalFragments = evt.getProduct<std::vector<artdaq::Fragment>>(fFragmentsLabel);
+
+    for (auto const& frag : originalFragments)
+    {
       // put the fragment in a compression compliant overlay
       icarus::PhysCrateFragment fragOverlay(frag);
       std::string fragCrateName = fChannelMap->getCrateName(frag.fragmentID());
 
-      if (true)
+      uint32_t const scheme = fragOverlay.metadata()->compression_scheme();
+      size_t nMismatches = 0;
+      if (scheme == 0)
+        nMismatches = roundTripUncompressed(fragOverlay, frag);
+      else if (scheme == daq::details::A2795DeltaCompression)
+        nMismatches = roundTripCompressed(fragOverlay, frag);
+      else
       {
-        // iterate through the fragment which wasn't compressed and check which boards are or aren't working
         MF_LOG_VERBATIM("ValidateCompression")
-          << "****************************" << '\n'
-          << "Crate " << fragCrateName;
-        size_t cumulativePrevBlockSize = 0;
-        icarus::A2795DataBlock::data_t const* boardData = new icarus::A2795DataBlock::data_t[frag.dataSize()];
-        for (size_t board = 0; board < fragOverlay.nBoards(); ++board)
-        {
-          bool boardCompressed = true;
-          size_t word = 0;
-          boardData = reinterpret_cast<icarus::A2795DataBlock::data_t const*>
-                      ( frag.dataBeginBytes()
-                      + (1+board)*sizeof(icarus::PhysCrateDataTileHeader)
-                      + (1+board)*sizeof(icarus::A2795DataBlock::Header)
-                      + 4*board*sizeof(uint16_t)
-                      + cumulativePrevBlockSize                     );
-
-          for (size_t sample = 0; sample < fragOverlay.nSamplesPerChannel(); ++sample)
-          {
-            bool oddCompressions = false;
-            std::vector<icarus::A2795DataBlock::data_t> prevSample(fragOverlay.nChannelsPerBoard(), 0);
-            for (size_t cSet = 0; cSet < fragOverlay.nChannelsPerBoard() / 4; ++cSet)
-            {
-              // get word
-              icarus::A2795DataBlock::data_t dataWord = boardData[word];
-              
-              // check if the word is interpretable as a compressed set of 4 ADC differences
-              bool wordNotTagged = ((dataWord & 0xF000) != 0x8000);
-              if (not wordNotTagged)
-              {
-                // if the word is tagged, then it's not compressed, but should exist in a compressed fragment
-                // check the next three words are also tagged, if they are then we are good (might need to check the delta sizes)
-                // otherwise something has gone wrong
-                bool wordTagged_plus1 = (boardData[word + 1] & 0xF000) == 0x8000;
-                bool wordTagged_plus2 = (boardData[word + 2] & 0xF000) == 0x8000;
-                bool wordTagged_plus3 = (boardData[word + 3] & 0xF000) == 0x8000;
-                if (wordTagged_plus1 && wordTagged_plus2 && wordTagged_plus3)
-                {
-                  if (not boardCompressed)
-                  {
-                    MF_LOG_VERBATIM("ValidateCompression")
-                      << "SOMEHOW FOUND COMPRESSED SEQUENCE IN UNCOMPRESSED BOARD";
-                  }
-                  // it's good
-                  word += 4;
-                  cumulativePrevBlockSize += 8;
-                  for (size_t cInSet = 0; cInSet < 4; ++cInSet)
-                  {
-                    icarus::A2795DataBlock::data_t twelveBitDiff = (boardData[word + 1] & 0x0FFF);
-                    bool isNeg = (sample != 0) && (twelveBitDiff >> 11);
-                    prevSample[4*cSet + cInSet] += isNeg*0xF000 + twelveBitDiff;
-                  }
-                } else {
-                  // something has gone wrong
-                  MF_LOG_VERBATIM("ValidateCompression")
-                    << "TAGGED BUT NOT FROM COMPRESSED FRAGMENT";
-                  boardCompressed = false;
-                  word += 4;
-                  cumulativePrevBlockSize += 8;
-                  for (size_t cInSet = 0; cInSet < 4; ++cInSet)
-                  {
-                    prevSample[4*cSet + cInSet] = (boardData[word + cInSet] & (~(1<<(fragOverlay.metadata()->num_adc_bits()+1))));
-                  }
-                }
-              } else {
-                if (sample == 0)
-                {
-                  boardCompressed = false;
-                }
-                if (boardCompressed)
-                {
-                  oddCompressions = (not oddCompressions);
-                  // if we don't have the tag check if it makes more sense as one value or 4 differences
-                  // first try adding to previous samples and see if the results are reasonable
-                  for (size_t cInSet = 0; cInSet < 4; ++cInSet)
-                  {
-                    icarus::A2795DataBlock::data_t fourBitDiff = (dataWord >> (4*cInSet)) & 0x000F;
-                    bool isNeg = (fourBitDiff >> 3);
-                    prevSample[4*cSet + cInSet] += (isNeg*0xFFF0 + fourBitDiff);
-                  }
-                  ++word;
-                  cumulativePrevBlockSize += 2;
-                } else {
-                  word += 4;
-                  cumulativePrevBlockSize += 8;
-                  for (size_t cInSet = 0; cInSet < 4; ++cInSet)
-                  {
-                    prevSample[4*cSet + cInSet] = (boardData[word + cInSet] & (~(1<<(fragOverlay.metadata()->num_adc_bits()+1))));
-                  }
-                }
-              }
-            }
-            if (oddCompressions)
-            {
-              ++word;
-              cumulativePrevBlockSize += 2;
-            }
-          }
-          std::string boardCompStr = (boardCompressed) ? " is compressed" : " is UNCOMPRESSED";
-          MF_LOG_VERBATIM("ValidateCompression")
-            << "  Board " << board << boardCompStr;
-        }
-        uint32_t totalBytes = fragOverlay.nBoards()*sizeof(icarus::PhysCrateDataTileHeader)
-                            + fragOverlay.nBoards()*sizeof(icarus::A2795DataBlock::Header)
-                            + 4*fragOverlay.nBoards()*sizeof(uint16_t)
-                            + cumulativePrevBlockSize;
-        MF_LOG_DEBUG("ValidateCompression")
-          << "****************************" << '\n'
-          << "Crate " << fragCrateName << '\n'
-          << "  Estimated data bytes " << totalBytes << '\n'
-          << "  should be            " << frag.dataSizeBytes() << '\n'
-          << "****************************";
+          << "Crate " << fragCrateName << ": unknown compression scheme " << scheme << ", skipped";
+        continue;
       }
+      size_t const nOverlayMismatches = fCompareWithOverlay ? compareWithOverlay(fragOverlay) : 0;
 
-      ++fragNumber;
+      ++fNFragments;
+      fNMismatches        += nMismatches;
+      fNOverlayMismatches += nOverlayMismatches;
+      std::string const compStr = (scheme == 0) ? "uncompressed" : "compressed";
+      if (nMismatches != 0)
+      {
+        MF_LOG_VERBATIM("ValidateCompression")
+          << "ERROR - Crate " << fragCrateName << " (" << compStr << "): "
+          << nMismatches << " mismatches after the round trip";
+      }
+      if (nOverlayMismatches != 0)
+      {
+        MF_LOG_VERBATIM("ValidateCompression")
+          << "ERROR - Crate " << fragCrateName << " (" << compStr << "): "
+          << nOverlayMismatches << " samples differ from PhysCrateFragment::adc_val()";
+      }
+      if (nMismatches == 0 && nOverlayMismatches == 0)
+      {
+        MF_LOG_DEBUG("ValidateCompression")
+          << "Crate " << fragCrateName << " (" << compStr << "): round trip is exact";
+      }
     }
   }
 
   //------------------------------------------------------------------
   void ValidateCompression::writeResults(art::Results& r)
   {
+    double const MB = fUncompressedBytes/1048576.;
     MF_LOG_VERBATIM("ValidateCompression")
-      << "Not writing results (yet)";
+      << "****************************" << '\n'
+      << "Fragments " << fFragmentsLabel.encode() << ": " << fNFragments
+      << " (" << fRepetitions << " repetitions each), " << fNMismatches << " mismatches" << '\n'
+      << "  overlay check:    " << (fCompareWithOverlay ? std::to_string(fNOverlayMismatches) + " mismatches" : "disabled") << '\n'
+      << "  compressed size:  " << (fUncompressedBytes ? 100.*fCompressedBytes/fUncompressedBytes : 0.) << "%" << '\n'
+      << "  compression:      " << (fCompressTime.count() > 0. ? MB/fCompressTime.count() : 0.) << " MB/s" << '\n'
+      << "  decompression:    " << (fDecompressTime.count() > 0. ? MB/fDecompressTime.count() : 0.) << " MB/s" << '\n'
+      << "****************************";
   }
 
   //------------------------------------------------------------------
   void ValidateCompression::clear()
   {
+    fNFragments        = 0;
+    fUncompressedBytes = 0;
+    fCompressedBytes   = 0;
+    fNMismatches       = 0;
+    fNOverlayMismatches = 0;
+    fCompressTime      = Seconds_t{ 0.0 };
+    fDecompressTime    = Seconds_t{ 0.0 };
   }
 
   DEFINE_ART_RESULTS_PLUGIN(ValidateCompression)
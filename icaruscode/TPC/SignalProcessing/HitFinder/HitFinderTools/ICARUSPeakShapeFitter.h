@@ -0,0 +1,539 @@
+/**
+ * @file   icaruscode/TPC/SignalProcessing/HitFinder/HitFinderTools/ICARUSPeakShapeFitter.h
+ * @brief  Least squares fit of ICARUS asymmetric peak shapes on waveforms.
+ *
+ * This is a header-only library, with no dependency on ROOT.
+ */
+
+#ifndef ICARUSCODE_TPC_SIGNALPROCESSING_HITFINDER_HITFINDERTOOLS_ICARUSPEAKSHAPEFITTER_H
+#define ICARUSCODE_TPC_SIGNALPROCESSING_HITFINDER_HITFINDERTOOLS_ICARUSPEAKSHAPEFITTER_H
+
+// C/C++ standard libraries
+#include <algorithm> // std::clamp(), std::fill()
+#include <cmath> // std::exp(), std::floor(), std::sqrt()
+#include <cstddef> // std::size_t
+#include <limits>
+#include <utility> // std::swap()
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus {
+
+  namespace details {
+
+    /// Exponential factor `g` of the asymmetric shape and the weight `s` of
+    /// its turn-on, `g = e^a / (1 + e^c)` and `s = e^c / (1 + e^c)`.
+    struct AsymmetricPeakTerms_t { double g; double s; };
+
+    /// Computes the terms avoiding the overflow of the turn-on exponential.
+    inline AsymmetricPeakTerms_t asymmetricPeakTerms(double a, double c) {
+      if (c > 0.0) {
+        double const e = std::exp(-c);
+        return { std::exp(a - c) / (1.0 + e), 1.0 / (1.0 + e) };
+      }
+      double const e = std::exp(c);
+      return { std::exp(a) / (1.0 + e), e / (1.0 + e) };
+    } // asymmetricPeakTerms()
+
+  } // namespace details
+
+
+  /**
+   * @brief ICARUS hit shape, as fitted by `ICARUSHitFinder` multi-peak fits.
+   *
+   * Each peak has five parameters: baseline @f$ b @f$, amplitude @f$ A @f$,
+   * position @f$ t_{0} @f$, decay time @f$ \tau_{1} @f$ and rise time
+   * @f$ \tau_{2} @f$:
+   * @f[ b + A e^{-(t - t_{0})/\tau_{1}} / (1 + e^{-(t - t_{0})/\tau_{2}}) @f]
+   */
+  struct ICARUSPeakShape {
+
+    static constexpr std::size_t NParams = 5; ///< Parameters of each peak.
+
+    /// Returns the shape in `x`; fills `grad` with the derivatives if not null.
+    static double evaluate(double x, double const* par, double* grad)
+      {
+        double const u = x - par[2];
+        auto const [ g, s ]
+          = details::asymmetricPeakTerms(-u / par[3], -u / par[4]);
+        if (grad) {
+          grad[0] = 1.0;
+          grad[1] = g;
+          grad[2] = par[1] * g * (1.0 / par[3] - s / par[4]);
+          grad[3] = par[1] * g * u / (par[3] * par[3]);
+          grad[4] = -par[1] * g * s * u / (par[4] * par[4]);
+        }
+        return par[0] + par[1] * g;
+      } // evaluate()
+
+  }; // ICARUSPeakShape
+
+
+  /**
+   * @brief ICARUS shape of long pulses, as fitted by `ICARUSHitFinder`.
+   *
+   * Each peak is a `ICARUSPeakShape` (first five parameters) scaled by a
+   * factor @f$ (s + k s (s - 1) / 2) / w @f$ where @f$ w @f$ is the sixth
+   * parameter and @f$ s = \lfloor w \rfloor @f$, and @f$ k @f$ the seventh.
+   * Peaks with @f$ s = 0 @f$ do not contribute.
+   */
+  struct ICARUSLongPeakShape {
+
+    static constexpr std::size_t NParams = 7; ///< Parameters of each peak.
+
+    /// Returns the shape in `x`; fills `grad` with the derivatives if not null.
+    static double evaluate(double x, double const* par, double* grad)
+      {
+        double const sMax = std::floor(par[5]);
+        if (sMax == 0.0) {
+          if (grad) std::fill(grad, grad + NParams, 0.0);
+          return 0.0;
+        }
+        double const pairs = sMax * (sMax - 1.0) / 2.0;
+        double const scale = (sMax + par[6] * pairs) / par[5];
+        double const pulse = ICARUSPeakShape::evaluate(x, par, grad);
+        if (grad) {
+          for (std::size_t i = 0; i < ICARUSPeakShape::NParams; ++i)
+            grad[i] *= scale;
+          grad[5] = -scale * pulse / par[5]; // the floor is piecewise constant
+          grad[6] = pairs * pulse / par[5];
+        }
+        return scale * pulse;
+      } // evaluate()
+
+  }; // ICARUSLongPeakShape
+
+
+  /**
+   * @brief Single peak shape of the `PeakFitterICARUS` tool.
+   *
+   * Parameters are baseline, amplitude, position, decay and rise time, as in
+   * `ICARUSPeakShape`, but the turn-on is centered on the decay time:
+   * @f[ b + A e^{-(t - t_{0})/\tau_{1}} / (1 + e^{-(t - \tau_{1})/\tau_{2}}) @f]
+   * which is the function that tool has always been fitting.
+   */
+  struct ICARUSSinglePeakShape {
+
+    static constexpr std::size_t NParams = 5; ///< Parameters of each peak.
+
+    /// Returns the shape in `x`; fills `grad` with the derivatives if not null.
+    static double evaluate(double x, double const* par, double* grad)
+      {
+        double const u = x - par[2];
+        double const v = x - par[3];
+        auto const [ g, s ]
+          = details::asymmetricPeakTerms(-u / par[3], -v / par[4]);
+        if (grad) {
+          grad[0] = 1.0;
+          grad[1] = g;
+          grad[2] = par[1] * g / par[3];
+          grad[3] = par[1] * g * (u / (par[3] * par[3]) - s / par[4]);
+          grad[4] = -par[1] * g * s * v / (par[4] * par[4]);
+        }
+        return par[0] + par[1] * g;
+      } // evaluate()
+
+  }; // ICARUSSinglePeakShape
+
+
+  template <typename Shape> class PeakShapeFitter;
+
+} // namespace icarus
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Levenberg-Marquardt fit of a sum of peaks to a waveform.
+ * @tparam Shape the shape of each peak (e.g. `icarus::ICARUSPeakShape`)
+ *
+ * The fitted function is the sum of `nPeaks()` peaks, each described by
+ * `Shape::NParams` consecutive parameters. The shape is evaluated inline
+ * together with its analytic derivatives: `Shape` must provide a static
+ * `evaluate(x, par, grad)` returning the value of the peak with parameters
+ * `par` at `x`, and filling `grad` (if not null) with the derivatives of the
+ * value with respect to each of them.
+ *
+ * The interface and the fit conventions mimic the `TF1` fits with option
+ * `"QNWB"` that the ICARUS hit finders used to perform on a histogram:
+ * * sample `i` of the waveform is at `x = i + 0.5` (the bin center);
+ * * all samples have the same weight, and samples exactly `0` are skipped;
+ * * parameter limits are set by `setParLimits()`, and a parameter whose
+ *   lower limit is not smaller than the upper one is fixed (unless one of the
+ *   limits is zero, in which case the parameter is unbounded);
+ * * the uncertainties on the parameters are rescaled by
+ *   @f$ \sqrt{\chi^{2}/NDF} @f$.
+ * Parameters are kept within their limits by projecting each step on them.
+ *
+ * The work areas are owned by the fitter and they only grow, so that no
+ * allocation happens after the largest fit is met. A fitter object can't be
+ * used by more than one thread at a time: keep one per thread.
+ */
+template <typename Shape>
+class icarus::PeakShapeFitter {
+
+    public:
+
+  /// Number of parameters for each peak.
+  static constexpr std::size_t NPeakParams = Shape::NParams;
+
+  /// Outcome of a fit.
+  struct FitResult_t {
+    bool valid = false; ///< Whether the function was finite at the minimum.
+    bool converged = false; ///< Whether the minimization converged.
+    double chi2 = std::numeric_limits<double>::infinity(); ///< Sum of squares.
+    std::size_t nPoints = 0; ///< Number of samples included in the fit.
+    std::size_t nFree = 0; ///< Number of parameters left free.
+    unsigned int nIterations = 0; ///< Number of iterations performed.
+  }; // FitResult_t
+
+
+  /// Maximum number of iterations in a fit.
+  static constexpr unsigned int MaxIterations = 200;
+
+  /// Relative change in @f$ \chi^{2} @f$ below which the fit has converged.
+  static constexpr double Tolerance = 1e-8;
+
+
+  /// Constructor: a function with `nPeaks` peaks.
+  explicit PeakShapeFitter(std::size_t nPeaks = 1) { setNPeaks(nPeaks); }
+
+  /// Sets the number of peaks; parameters of existing peaks are preserved.
+  void setNPeaks(std::size_t nPeaks)
+    {
+      std::size_t const nParams = nPeaks * NPeakParams;
+      fParams.resize(nParams, 0.0);
+      fErrors.resize(nParams, 0.0);
+      fLowerLimits.resize(nParams, 0.0);
+      fUpperLimits.resize(nParams, 0.0);
+    }
+
+  /// Returns the number of peaks in the function.
+  std::size_t nPeaks() const { return fParams.size() / NPeakParams; }
+
+  /// Returns the total number of parameters.
+  std::size_t nParameters() const { return fParams.size(); }
+
+  /// Sets the value of the parameter `iPar`.
+  void setParameter(std::size_t iPar, double value) { fParams[iPar] = value; }
+
+  /// Sets the limits of the parameter `iPar` (see class documentation).
+  void setParLimits(std::size_t iPar, double low, double high)
+    { fLowerLimits[iPar] = low; fUpperLimits[iPar] = high; }
+
+  /// Returns the value of the parameter `iPar`.
+  double parameter(std::size_t iPar) const { return fParams[iPar]; }
+
+  /// Returns the uncertainty on the parameter `iPar` from the last fit.
+  double parError(std::size_t iPar) const { return fErrors[iPar]; }
+
+  /// Returns the value of the function in `x`.
+  double operator() (double x) const
+    { return evaluate(x, fParams.data(), nullptr); }
+
+  /// Returns the integral of the function between `a` and `b`.
+  double integral(double a, double b) const;
+
+  /**
+   * @brief Fits the function to the waveform in `data`.
+   * @param data the first sample of the waveform
+   * @param nSamples number of samples of the waveform
+   * @return the outcome of the fit
+   *
+   * The current parameter values are the starting point of the fit, and they
+   * are replaced by the result.
+   */
+  FitResult_t fit(float const* data, std::size_t nSamples);
+
+
+    private:
+
+  std::vector<double> fParams; ///< Parameter values.
+  std::vector<double> fErrors; ///< Parameter uncertainties.
+  std::vector<double> fLowerLimits; ///< Lower limit of each parameter.
+  std::vector<double> fUpperLimits; ///< Upper limit of each parameter.
+
+  // --- BEGIN -- Work areas ---------------------------------------------------
+  std::vector<std::size_t> fFree; ///< Indices of the free parameters.
+  std::vector<double> fGradient; ///< Derivatives at one sample.
+  std::vector<double> fAlpha; ///< Curvature matrix (free parameters).
+  std::vector<double> fBeta; ///< Gradient of @f$ \chi^{2}/2 @f$ (free par.).
+  std::vector<double> fMatrix; ///< Damped curvature matrix, factorized.
+  std::vector<double> fStep; ///< Step on the free parameters.
+  std::vector<double> fTrial; ///< Parameter values being tried.
+  // --- END ---- Work areas ---------------------------------------------------
+
+
+  /// Whether parameter `iPar` is fixed during the fit.
+  bool isFixed(std::size_t iPar) const
+    {
+      double const low = fLowerLimits[iPar], high = fUpperLimits[iPar];
+      return (low * high != 0.0) && (low >= high);
+    }
+
+  /// Returns `value` constrained within the limits of parameter `iPar`.
+  double constrain(std::size_t iPar, double value) const
+    {
+      double const low = fLowerLimits[iPar], high = fUpperLimits[iPar];
+      return (low < high)? std::clamp(value, low, high): value;
+    }
+
+  /// Returns the sum of the peaks with parameters `par` at `x`.
+  double evaluate(double x, double const* par, double* grad) const
+    {
+      double value = 0.0;
+      std::size_t const nParams = fParams.size();
+      for (std::size_t first = 0; first < nParams; first += NPeakParams) {
+        value
+          += Shape::evaluate(x, par + first, grad? grad + first: nullptr);
+      }
+      return value;
+    }
+
+  /// Returns the @f$ \chi^{2} @f$ of the parameters `par` on `data`.
+  double chiSquare
+    (float const* data, std::size_t nSamples, double const* par) const;
+
+  /// Computes `fAlpha` and `fBeta` at the current parameters, returns
+  /// @f$ \chi^{2} @f$ and the number of samples used.
+  double curvature(float const* data, std::size_t nSamples, std::size_t& n);
+
+  /// Cholesky decomposition of the `n` x `n` matrix in `fMatrix`.
+  bool choleskyDecompose(std::size_t n);
+
+  /// Solves `fMatrix x = b` in place, with `fMatrix` already decomposed.
+  void choleskySolve(std::size_t n, double* b) const;
+
+  /// Fills `fErrors` from the inverse of the curvature matrix.
+  void computeErrors(double scale);
+
+}; // icarus::PeakShapeFitter<>
+
+
+// -----------------------------------------------------------------------------
+// ---  template implementation
+// -----------------------------------------------------------------------------
+template <typename Shape>
+double icarus::PeakShapeFitter<Shape>::integral(double a, double b) const {
+
+  if (b < a) return -integral(b, a);
+
+  // 5-point Gauss-Legendre quadrature on each tick
+  static constexpr double Nodes[]
+    = { 0.0, 0.5384693101056831, 0.9061798459386640 };
+  static constexpr double Weights[]
+    = { 0.5688888888888889, 0.4786286704993665, 0.2369268850561891 };
+
+  std::size_t const nSteps = std::max(1.0, std::ceil(b - a));
+  double const halfStep = (b - a) / nSteps / 2.0;
+
+  double sum = 0.0;
+  for (std::size_t iStep = 0; iStep < nSteps; ++iStep) {
+    double const center = a + (2 * iStep + 1) * halfStep;
+    double stepSum = Weights[0] * (*this)(center);
+    for (std::size_t iNode = 1; iNode < 3; ++iNode) {
+      double const dx = Nodes[iNode] * halfStep;
+      stepSum += Weights[iNode] * ((*this)(center - dx) + (*this)(center + dx));
+    }
+    sum += stepSum;
+  } // for
+  return sum * halfStep;
+
+} // icarus::PeakShapeFitter<>::integral()
+
+
+// -----------------------------------------------------------------------------
+template <typename Shape>
+auto icarus::PeakShapeFitter<Shape>::fit
+  (float const* data, std::size_t nSamples) -> FitResult_t
+{
+  FitResult_t result;
+
+  std::size_t const nParams = fParams.size();
+  fFree.clear();
+  for (std::size_t iPar = 0; iPar < nParams; ++iPar) {
+    fErrors[iPar] = 0.0;
+    if (isFixed(iPar)) continue;
+    fParams[iPar] = constrain(iPar, fParams[iPar]);
+    fFree.push_back(iPar);
+  }
+  std::size_t const nFree = fFree.size();
+  result.nFree = nFree;
+
+  fGradient.resize(nParams);
+  fAlpha.resize(nFree * nFree);
+  fMatrix.resize(nFree * nFree);
+  fBeta.resize(nFree);
+  fStep.resize(nFree);
+
+  double chi2 = curvature(data, nSamples, result.nPoints);
+  if (!std::isfinite(chi2)) return result;
+
+  double lambda = 1e-3;
+  while (result.nIterations < MaxIterations) {
+    ++result.nIterations;
+
+    // damped curvature; directions with no sensitivity are left alone
+    std::copy(fAlpha.begin(), fAlpha.end(), fMatrix.begin());
+    for (std::size_t i = 0; i < nFree; ++i) {
+      double& diag = fMatrix[i * nFree + i];
+      diag = (diag > 0.0)? diag * (1.0 + lambda): 1.0;
+    }
+
+    double trialChi2 = std::numeric_limits<double>::infinity();
+    if (choleskyDecompose(nFree)) {
+      std::copy(fBeta.begin(), fBeta.end(), fStep.begin());
+      choleskySolve(nFree, fStep.data());
+      fTrial = fParams;
+      for (std::size_t i = 0; i < nFree; ++i) {
+        std::size_t const iPar = fFree[i];
+        fTrial[iPar] = constrain(iPar, fParams[iPar] + fStep[i]);
+      }
+      trialChi2 = chiSquare(data, nSamples, fTrial.data());
+    }
+
+    if (trialChi2 <= chi2) {
+      bool const stalled
+        = (chi2 - trialChi2) <= Tolerance * trialChi2 + std::numeric_limits<double>::min();
+      std::swap(fParams, fTrial);
+      chi2 = curvature(data, nSamples, result.nPoints);
+      lambda = std::max(lambda / 10.0, 1e-12);
+      if (stalled) {
+        result.converged = true;
+        break;
+      }
+    }
+    else {
+      // no improvement even with a tiny step: this is the minimum
+      lambda *= 10.0;
+      if (lambda > 1e12) {
+        result.converged = true;
+        break;
+      }
+    }
+  } // while
+
+  result.chi2 = chi2;
+  result.valid = std::isfinite(chi2);
+
+  std::size_t const nDF = result.nPoints - std::min(result.nPoints, nFree);
+  computeErrors((nDF > 0)? chi2 / nDF: 1.0);
+
+  return result;
+
+} // icarus::PeakShapeFitter<>::fit()
+
+
+// -----------------------------------------------------------------------------
+template <typename Shape>
+double icarus::PeakShapeFitter<Shape>::chiSquare
+  (float const* data, std::size_t nSamples, double const* par) const
+{
+  double chi2 = 0.0;
+  for (std::size_t i = 0; i < nSamples; ++i) {
+    if (data[i] == 0.0f) continue;
+    double const residual = data[i] - evaluate(i + 0.5, par, nullptr);
+    chi2 += residual * residual;
+  }
+  return chi2;
+} // icarus::PeakShapeFitter<>::chiSquare()
+
+
+// -----------------------------------------------------------------------------
+template <typename Shape>
+double icarus::PeakShapeFitter<Shape>::curvature
+  (float const* data, std::size_t nSamples, std::size_t& n)
+{
+  std::size_t const nFree = fFree.size();
+  std::fill(fAlpha.begin(), fAlpha.end(), 0.0);
+  std::fill(fBeta.begin(), fBeta.end(), 0.0);
+
+  n = 0;
+  double chi2 = 0.0;
+  for (std::size_t i = 0; i < nSamples; ++i) {
+    if (data[i] == 0.0f) continue;
+    ++n;
+    double const residual
+      = data[i] - evaluate(i + 0.5, fParams.data(), fGradient.data());
+    chi2 += residual * residual;
+    for (std::size_t j = 0; j < nFree; ++j) {
+      double const gj = fGradient[fFree[j]];
+      fBeta[j] += gj * residual;
+      double* row = fAlpha.data() + j * nFree;
+      for (std::size_t k = 0; k <= j; ++k) row[k] += gj * fGradient[fFree[k]];
+    }
+  } // for samples
+
+  for (std::size_t j = 0; j < nFree; ++j)
+    for (std::size_t k = 0; k < j; ++k) fAlpha[k * nFree + j] = fAlpha[j * nFree + k];
+
+  return chi2;
+} // icarus::PeakShapeFitter<>::curvature()
+
+
+// -----------------------------------------------------------------------------
+template <typename Shape>
+bool icarus::PeakShapeFitter<Shape>::choleskyDecompose(std::size_t n) {
+
+  // lower triangle is replaced by L, with A = L L^T
+  for (std::size_t j = 0; j < n; ++j) {
+    double* rowJ = fMatrix.data() + j * n;
+    double diag = rowJ[j];
+    for (std::size_t k = 0; k < j; ++k) diag -= rowJ[k] * rowJ[k];
+    if (!(diag > 0.0)) return false;
+    rowJ[j] = std::sqrt(diag);
+    for (std::size_t i = j + 1; i < n; ++i) {
+      double* rowI = fMatrix.data() + i * n;
+      double value = rowI[j];
+      for (std::size_t k = 0; k < j; ++k) value -= rowI[k] * rowJ[k];
+      rowI[j] = value / rowJ[j];
+    }
+  } // for
+  return true;
+
+} // icarus::PeakShapeFitter<>::choleskyDecompose()
+
+
+// -----------------------------------------------------------------------------
+template <typename Shape>
+void icarus::PeakShapeFitter<Shape>::choleskySolve
+  (std::size_t n, double* b) const
+{
+  for (std::size_t i = 0; i < n; ++i) { // L y = b
+    double const* row = fMatrix.data() + i * n;
+    for (std::size_t k = 0; k < i; ++k) b[i] -= row[k] * b[k];
+    b[i] /= row[i];
+  }
+  for (std::size_t i = n; i-- > 0; ) { // L^T x = y
+    for (std::size_t k = i + 1; k < n; ++k) b[i] -= fMatrix[k * n + i] * b[k];
+    b[i] /= fMatrix[i * n + i];
+  }
+} // icarus::PeakShapeFitter<>::choleskySolve()
+
+
+// -----------------------------------------------------------------------------
+template <typename Shape>
+void icarus::PeakShapeFitter<Shape>::computeErrors(double scale) {
+
+  std::size_t const nFree = fFree.size();
+  std::copy(fAlpha.begin(), fAlpha.end(), fMatrix.begin());
+  for (std::size_t i = 0; i < nFree; ++i) {
+    double& diag = fMatrix[i * nFree + i];
+    if (diag <= 0.0) diag = 1.0;
+  }
+  if (!choleskyDecompose(nFree)) return;
+
+  // diagonal of the inverse, one column at a time
+  for (std::size_t i = 0; i < nFree; ++i) {
+    std::fill(fStep.begin(), fStep.end(), 0.0);
+    fStep[i] = 1.0;
+    choleskySolve(nFree, fStep.data());
+    fErrors[fFree[i]] = std::sqrt(std::max(0.0, fStep[i] * scale));
+  }
+
+} // icarus::PeakShapeFitter<>::computeErrors()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_TPC_SIGNALPROCESSING_HITFINDER_HITFINDERTOOLS_ICARUSPEAKSHAPEFITTER_H
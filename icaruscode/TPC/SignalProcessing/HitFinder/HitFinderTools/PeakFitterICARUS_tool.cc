@@ -4,6 +4,7 @@
 ////////////////////////////////////////////////////////////////////////
 
 #include "icaruscode/TPC/SignalProcessing/HitFinder/HitFinderTools/IPeakFitter.h"
+#include "icaruscode/TPC/SignalProcessing/HitFinder/HitFinderTools/ICARUSPeakShapeFitter.h"
 
 #include "art/Utilities/ToolMacros.h"
 #include "art/Utilities/make_tool.h"
@@ -15,8 +16,6 @@
 
 #include <cmath>
 #include <fstream>
-#include "TH1F.h"
-#include "TF1.h"
 
 namespace reco_tool
 {
@@ -34,25 +33,21 @@ public:
                             double&,
                             int&) const override;
     
-     static Double_t fitf(Double_t *x, Double_t *par);
-    
 private:
+    using Fitter_t = icarus::PeakShapeFitter<icarus::ICARUSSinglePeakShape>;
+    
     // Member variables from the fhicl file
     double                   fMinWidth;     ///< minimum initial width for ICARUS fit
     double                   fMaxWidthMult; ///< multiplier for max width for ICARUS fit
     double                   fPeakRange;    ///< set range limits for peak center
     double                   fAmpRange;     ///< set range limit for peak amplitude
     
-    mutable TH1F             fHistogram;
-    mutable TF1              fFit;          ///< Cache of fit functions (one so far).
-    
     const geo::GeometryCore* fGeometry = lar::providerFrom<geo::Geometry>();
 };
     
 //----------------------------------------------------------------------
 // Constructor.
 PeakFitterICARUS::PeakFitterICARUS(const fhicl::ParameterSet& pset)
-  : fFit("ICARUSfunc", fitf, 0.0, 1.0, 5) // 5 parameters, fake range
 {
     configure(pset);
 }
@@ -65,10 +60,6 @@ void PeakFitterICARUS::configure(const fhicl::ParameterSet& pset)
     fPeakRange    = pset.get<double>("PeakRangeFact", 2.);
     fAmpRange     = pset.get<double>("PeakAmpRange",  2.);
     
-    fHistogram    = TH1F("PeakFitterHitSignal","",500,0.,500.);
-    
-    fHistogram.Sumw2();
-    
     return;
 }
     
@@ -94,19 +85,12 @@ void PeakFitterICARUS::findPeakParameters(const std::vector<float>&
     int endTime   = hitCandidateVec.back().stopTick;
     int roiSize   = endTime - startTime;
     
-    // Check to see if we need a bigger histogram for fitting
-    if (roiSize > fHistogram.GetNbinsX())
-    {
-        std::string histName = "PeakFitterHitSignal_" + std::to_string(roiSize);
-        fHistogram = TH1F(histName.c_str(),"",roiSize,0.,roiSize);
-        fHistogram.Sumw2();
-    }
-    
-    for(int idx = 0; idx < roiSize; idx++) fHistogram.SetBinContent(idx+1,roiSignalVec.at(startTime+idx));
+    if (endTime > int(roiSignalVec.size()))
+        throw cet::exception("PeakFitterICARUS") << "Hit candidates end at tick " << endTime
+            << ", beyond the " << roiSignalVec.size() << " ticks of the ROI\n";
     
-   // for(int idx = 0; idx < roiSize; idx++)
-     //   std::cout << " bin " << idx << " fHistogram " << fHistogram.GetBinContent(idx+1) << std::endl;
-
+    // each thread fits with its own work areas (the tool is shared)
+    thread_local Fitter_t fitter;
     
     // ### Setting the parameters for the ICARUS Fit ###
     //int parIdx(0);
@@ -124,39 +108,33 @@ void PeakFitterICARUS::findPeakParameters(const std::vector<float>&
       //  std::cout << " amplitude " << amplitude << std::endl;
       //  std::cout << " peakMean " << peakMean << std::endl;
 
-        fFit.SetParameter(0,0);
-        fFit.SetParameter(1, amplitude);
-        fFit.SetParameter(2, peakMean);
-        fFit.SetParameter(3,peakWidth/2);
-        fFit.SetParameter(4,peakWidth/2);
+        fitter.setParameter(0,0);
+        fitter.setParameter(1, amplitude);
+        fitter.setParameter(2, peakMean);
+        fitter.setParameter(3,peakWidth/2);
+        fitter.setParameter(4,peakWidth/2);
         
-        fFit.SetParLimits(0, -5, 5);
-        fFit.SetParLimits(1, 0.1 * amplitude,  10. * amplitude);
-        fFit.SetParLimits(2, meanLowLim,meanHiLim);
-        fFit.SetParLimits(3, std::max(fMinWidth, 0.1 * peakWidth), fMaxWidthMult * peakWidth);
-        fFit.SetParLimits(4, std::max(fMinWidth, 0.1 * peakWidth), fMaxWidthMult * peakWidth);
+        fitter.setParLimits(0, -5, 5);
+        fitter.setParLimits(1, 0.1 * amplitude,  10. * amplitude);
+        fitter.setParLimits(2, meanLowLim,meanHiLim);
+        fitter.setParLimits(3, std::max(fMinWidth, 0.1 * peakWidth), fMaxWidthMult * peakWidth);
+        fitter.setParLimits(4, std::max(fMinWidth, 0.1 * peakWidth), fMaxWidthMult * peakWidth);
         
   //      std::cout << " peakWidth limits " << std::max(fMinWidth, 0.1 * peakWidth) <<" " <<  fMaxWidthMult * peakWidth << std::endl;
     //      std::cout << " peakMean limits " << meanLowLim <<" " <<  meanHiLim << std::endl;
         
     }
     
-    int fitResult(-1);
+    Fitter_t::FitResult_t const fitResult = fitter.fit(roiSignalVec.data() + startTime, roiSize);
     
-    // the range of the fit does not matter since we specify the fitting range
-    // explicitly (we do NOT use option "R")
-    try
-    { fitResult = fHistogram.Fit(&fFit,"QNWB","", 0., roiSize);}
-    catch(...)
-    {mf::LogWarning("GausHitFinder") << "Fitter failed finding a hit";}
+    if(!fitResult.valid)
+        mf::LogWarning("GausHitFinder") << "Fitter failed finding a hit";
     
-   if(fitResult!=0)
-//       std::cout << " fit cannot converge " << std::endl;
         // ##################################################
         // ### Getting the fitted parameters from the fit ###
         // ##################################################
-     NDF        = roiSize-5;
-        chi2PerNDF = (fFit.GetChisquare() / NDF);
+        NDF        = roiSize-5;
+        chi2PerNDF = (fitResult.chi2 / NDF);
     
  //   std::cout << " chi2 " << fFit.GetChisquare() << std::endl;
   //  std::cout << " ndf " << NDF << std::endl;
@@ -167,17 +145,17 @@ void PeakFitterICARUS::findPeakParameters(const std::vector<float>&
         {
             PeakFitParams_t peakParams;
             
-            peakParams.peakAmplitude      = fFit.GetParameter(1);
-            peakParams.peakAmplitudeError = fFit.GetParError(1);
-            peakParams.peakCenter         = fFit.GetParameter(2) + float(startTime);
-            peakParams.peakCenterError    = fFit.GetParError(2);
-    //std::cout << " rising time " << fFit.GetParameter(3) << " falling time " <<fFit.GetParameter(4) << std::endl;
-            peakParams.peakTauLeft        = fFit.GetParameter(3);
-            peakParams.peakTauLeftError   = fFit.GetParError(3);
-            peakParams.peakTauRight       = fFit.GetParameter(4);
-            peakParams.peakTauRightError  = fFit.GetParError(4);
-            peakParams.peakBaseline       = fFit.GetParameter(0);
-            peakParams.peakBaselineError  = fFit.GetParError(0);
+            peakParams.peakAmplitude      = fitter.parameter(1);
+            peakParams.peakAmplitudeError = fitter.parError(1);
+            peakParams.peakCenter         = fitter.parameter(2) + float(startTime);
+            peakParams.peakCenterError    = fitter.parError(2);
+    //std::cout << " rising time " << fitter.parameter(3) << " falling time " <<fitter.parameter(4) << std::endl;
+            peakParams.peakTauLeft        = fitter.parameter(3);
+            peakParams.peakTauLeftError   = fitter.parError(3);
+            peakParams.peakTauRight       = fitter.parameter(4);
+            peakParams.peakTauRightError  = fitter.parError(4);
+            peakParams.peakBaseline       = fitter.parameter(0);
+            peakParams.peakBaselineError  = fitter.parError(0);
             
             peakParamsVec.emplace_back(peakParams);
             
@@ -185,12 +163,5 @@ void PeakFitterICARUS::findPeakParameters(const std::vector<float>&
     
 }
 
-Double_t PeakFitterICARUS::fitf(Double_t *x, Double_t *par)
-    {
-        // Double_t arg = 0;
-        
-        Double_t fitval = par[0]+par[1]*TMath::Exp(-(x[0]-par[2])/par[3])/(1+TMath::Exp(-(x[0]-par[3])/par[4]));
-        return fitval;
-    }
 DEFINE_ART_CLASS_TOOL(PeakFitterICARUS)
 }
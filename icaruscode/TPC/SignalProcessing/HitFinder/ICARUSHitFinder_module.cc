@@ -48,15 +48,15 @@
 #include "larcorealg/Geometry/TPCGeo.h"
 #include "larcorealg/Geometry/PlaneGeo.h"
 
-#include "larreco/RecoAlg/GausFitCache.h" // hit::GausFitCache
 #include "larreco/HitFinder/HitFinderTools/ICandidateHitFinder.h"
 //#include "icaruscode/HitFinder/PeakFitterICARUS.h"
+#include "icaruscode/TPC/SignalProcessing/HitFinder/HitFinderTools/ICARUSPeakShapeFitter.h"
 
 //ROOT from CalData
 #include "TComplex.h"
 #include "TFile.h"
 #include "TH2D.h"
-#include "TF1.h"
+#include "TH1F.h"
 
 //ROOT From Gauss
 #include "TH1D.h"
@@ -64,62 +64,7 @@
 #include "TMath.h"
 
 namespace hit {
-  /// Customized function cache for ICARUS hit shape.
-  class ICARUShitFitCache: public hit::GausFitCache {
-      
-          public:
-      /// Constructor (see base class constructor).
-      ICARUShitFitCache(std::string const& new_name="ICARUShitFitCache")
-        : hit::GausFitCache(new_name)
-        {}
-      
-      /// ICARUS hit shape.
-      static Double_t fitf(Double_t const* x, Double_t const* par);
-      
-          protected:
-      
-      /// Creates and returns the function with specified number of peaks.
-      virtual TF1* CreateFunction(size_t nFunc) const
-          {
-               unsigned int const nPeaks = nFunc;
-               std::string const func_name = FunctionName(nFunc);
-               auto* pF = new TF1(func_name.c_str(), fitf, 0.0, 1.0, 1 + nFunc * 5);
-               pF->SetParName(0, "NPeaks");
-               pF->FixParameter(0, (double) nPeaks);
-               return pF;
-          } // CreateFunction()
-      
-  }; // ICARUShitFitCache
-  
-  /// Customized function cache for ICARUS long hit shape.
-  class ICARUSlongHitFitCache: public hit::GausFitCache {
-      
-          public:
-      /// Constructor (see base class constructor).
-      ICARUSlongHitFitCache(std::string const& new_name="ICARUSlongHitFitCache")
-        : hit::GausFitCache(new_name)
-        {}
-      
-      /// ICARUS hit shape.
-      static Double_t fitlong(Double_t const* x, Double_t const* par);
-      
-          protected:
-      
-      /// Creates and returns the function with specified number of peaks.
-      virtual TF1* CreateFunction(size_t nFunc) const
-          {
-               unsigned int const nPeaks = nFunc;
-               std::string const func_name = FunctionName(nFunc);
-               auto* pF = new TF1(func_name.c_str(), fitlong, 0.0, 1.0, 1 + nFunc * 7);
-               pF->SetParName(0, "NPeaks");
-               pF->FixParameter(0, (double) nPeaks);
-               return pF;
-          } // CreateFunction()
-      
-  }; // ICARUSlongHitFitCache
 
- 
-  
   class ICARUSHitFinder : public art::EDProducer {
 
     public:
@@ -164,7 +109,7 @@ namespace hit {
                                   ICARUSPeakParamsVec&,
                                   double&,
                                   int&, int) const;
-      double ComputeChiSquare(TF1 func, TH1 *histo) const;
+      double ComputeChiSquare(const std::vector<float>&, int, int) const;
       double ComputeNullChiSquare(std::vector<float>) const;
 
 
@@ -225,8 +170,8 @@ double                fChi2NDF;                  ///maximum Chisquared / NDF all
 
       int iWire;
       
-      mutable ICARUShitFitCache fFitCache; ///< Cached functions for multi-peak fits.
-      mutable ICARUSlongHitFitCache fLongFitCache; ///< Cached functions for long hits.
+      mutable icarus::PeakShapeFitter<icarus::ICARUSPeakShape> fFitter; ///< Fitter for multi-peak fits.
+      mutable icarus::PeakShapeFitter<icarus::ICARUSLongPeakShape> fLongFitter; ///< Fitter for long hits.
       
       const geo::GeometryCore* fGeometry = lar::providerFrom<geo::Geometry>();
      
@@ -647,10 +592,8 @@ for(unsigned int jhit=0;jhit<mergedCands.size(); jhit++)
               float peakSlope=0, peakFitWidth=0;
               float peakMeanErr, peakAmpErr;
               if(!islong) {
-                // TF1 Func("ICARUSfunc",fitf,start,end,1+5*mergedCands.size());
-                TF1& Func = *(fFitCache.Get(mergedCands.size()));
-                assert(&Func);
-                Func.SetParameter(0, mergedCands.size());
+                // the fitter holds the parameters of the last fit of these candidates
+                fFitter.setNPeaks(mergedCands.size());
                 
                 // float intBaseline=0; // unused
 
@@ -676,29 +619,19 @@ for(unsigned int jhit=0;jhit<mergedCands.size(); jhit++)
                peakAmpErr   = peakParams.peakAmplitudeError;
               peakMeanErr  = peakParams.peakCenterError;
             //  float peakWidthErr = peakParams.peakSigmaError;
-                  Func.SetParameter(1+5*jhit,peakBaseline);
-                  Func.SetParameter(2+5*jhit,peakAmp);
-                  Func.SetParameter(3+5*jhit,peakMean);
-                  Func.SetParameter(4+5*jhit,peakRight);
-                  Func.SetParameter(5+5*jhit,peakLeft);
+                  fFitter.setParameter(0+5*jhit,peakBaseline);
+                  fFitter.setParameter(1+5*jhit,peakAmp);
+                  fFitter.setParameter(2+5*jhit,peakMean);
+                  fFitter.setParameter(3+5*jhit,peakRight);
+                  fFitter.setParameter(4+5*jhit,peakLeft);
 
                   // intBaseline+=(endInt-startInt)*peakBaseline; // unused
                 
-                try
-                  {
-                   fitCharge=Func.Integral(startInt,endInt)-(endInt-startInt)*localmeans[jhit];
-          
-                  }
-                catch(...) {
-                  mf::LogWarning("ICARUSHitFinder") << "Icarus numerical 32 failed";
-                  fitCharge=std::accumulate(holder.begin() + (int) startInt, holder.begin() + (int) endInt, 0.)-(endInt-startInt)*localmeans[jhit];
-                }
+                fitCharge=fFitter.integral(startInt,endInt)-(endInt-startInt)*localmeans[jhit];
               }
               else {
-                  // TF1 FuncLong("ICARUSfuncLong",fitlong,start,end,1+7*mergedCands.size());
-                  TF1& FuncLong = *(fLongFitCache.Get(mergedCands.size()));
-                  assert(&FuncLong);
-                  FuncLong.SetParameter(0, mergedCands.size());
+                  // the fitter holds the parameters of the last fit of these candidates
+                  fLongFitter.setNPeaks(mergedCands.size());
 
                 
                 // float intBaseline=0; // unused
@@ -716,23 +649,16 @@ for(unsigned int jhit=0;jhit<mergedCands.size(); jhit++)
  peakAmpErr   = peakParams.peakAmplitudeError;
               peakMeanErr  = peakParams.peakCenterError;
                
-                      FuncLong.SetParameter(1+7*jhit,peakBaseline);
-                      FuncLong.SetParameter(2+7*jhit,peakAmp);
-                      FuncLong.SetParameter(3+7*jhit,peakMean);
-                      FuncLong.SetParameter(4+7*jhit,peakRight);
-                      FuncLong.SetParameter(5+7*jhit,peakLeft);
-                      FuncLong.SetParameter(6+7*jhit,peakFitWidth);
-                      FuncLong.SetParameter(7+7*jhit,peakSlope);
+                      fLongFitter.setParameter(0+7*jhit,peakBaseline);
+                      fLongFitter.setParameter(1+7*jhit,peakAmp);
+                      fLongFitter.setParameter(2+7*jhit,peakMean);
+                      fLongFitter.setParameter(3+7*jhit,peakRight);
+                      fLongFitter.setParameter(4+7*jhit,peakLeft);
+                      fLongFitter.setParameter(5+7*jhit,peakFitWidth);
+                      fLongFitter.setParameter(6+7*jhit,peakSlope);
              
 
-                  try
-                  { fitCharge=FuncLong.Integral(startInt,endInt)-(endInt-startInt)*localmeans[jhit];
-                      //fitCharge=FuncLong.Integral(start-35,end+35);
-                  }
-                  catch(...)
-                  {mf::LogWarning("ICARUSHitFinder") << "Icarus numerical integration failed";
-                      fitCharge=std::accumulate(holder.begin() + (int) startInt, holder.begin() + (int) endInt, 0.)-(endInt-startInt)*localmeans[jhit];
-                  }
+                  fitCharge=fLongFitter.integral(startInt,endInt)-(endInt-startInt)*localmeans[jhit];
               }
               if(isnan(fitCharge)&&!islong) fitCharge=std::accumulate(holder.begin() + (int) startInt, holder.begin() + (int) endInt, 0.);
               if(isnan(fitCharge)&&islong) fitCharge=std::accumulate(holder.begin() + (int) startInt, holder.begin() + (int) endInt, 0.);
@@ -1080,15 +1006,8 @@ void ICARUSHitFinder::expandHit(reco_tool::ICandidateHitFinder::HitCandidate& h,
                                                    const reco_tool::ICandidateHitFinder::HitCandidateVec& hitCandidateVec,
                                                    ICARUSPeakParamsVec&                              peakParamsVec,
                                                    double&                                     chi2PerNDF,
-                                                   int&                                        NDF, int iWire) const
+                                                   int&                                        NDF, int /* iWire */) const
     {
-
-        ICARUSPeakParamsVec                              peakParamsVec0;
-        TH1F* fHistogram=new TH1F("","",roiSignalVec.size(),0.,roiSignalVec.size());;
-    
-        std::string wireName = "PeakFitterHitSignal_" + std::to_string(iWire);
-        fHistogram->SetName(wireName.c_str());
-        
         if (hitCandidateVec.empty()) return;
         
         // in case of a fit failure, set the chi-square to infinity
@@ -1102,31 +1021,10 @@ void ICARUSHitFinder::expandHit(reco_tool::ICandidateHitFinder::HitCandidate& h,
         
         //std::cout << " roisize " << roiSize << std::endl;
         
-        // Check to see if we need a bigger hianchstogram for fitting
-        if (roiSize > fHistogram->GetNbinsX())
-        {
-            std::string histName = "PeakFitterHitSignal_" + std::to_string(iWire);
-            fHistogram = new TH1F(histName.c_str(),"",roiSize,0.,roiSize);
-            //fHistogram->Sumw2();
-        }
-        
-        fHistogram->Reset();
-        for(int idx = 0; idx < roiSize; idx++)
-            fHistogram->SetBinContent(idx+1,roiSignalVec.at(startTime+idx));
-        for(int idx = 0; idx < roiSize; idx++)
-            fHistogram->SetBinError(idx+1,2.4);
-      //  for(int idx = 0; idx < roiSize; idx++)
-        //   std::cout << " bin " << idx << " Error " << fHistogram->GetBinError(idx+1) << std::endl;
-        
-        
         // Now define the complete function to fit
-        // TF1 Func("ICARUSfunc",fitf,0,roiSize,1+5*hitCandidateVec.size());
-        TF1& Func = *(fFitCache.Get(hitCandidateVec.size()));
-        assert(&Func);
+        fFitter.setNPeaks(hitCandidateVec.size());
         
         // ### Setting the parameters for the ICARUS Fit ###
-        Func.FixParameter(0, hitCandidateVec.size());
-
         int parIdx{0};
         for(auto const& candidateHit : hitCandidateVec)
         {
@@ -1140,90 +1038,60 @@ void ICARUSHitFinder::expandHit(reco_tool::ICandidateHitFinder::HitCandidate& h,
             // double meanLowLim = std::max(peakMean - fPeakRange * peakWidth,              0.);
             // double meanHiLim  = std::min(peakMean + fPeakRange * peakWidth, double(roiSize));
             
-            Func.SetParameter(1+parIdx,0);
-            Func.SetParameter(2+parIdx, amplitude);
-            Func.SetParameter(3+parIdx, peakMean);
-            Func.SetParameter(4+parIdx,peakWidth);
-            Func.SetParameter(5+parIdx,peakWidth);
+            fFitter.setParameter(0+parIdx,0);
+            fFitter.setParameter(1+parIdx, amplitude);
+            fFitter.setParameter(2+parIdx, peakMean);
+            fFitter.setParameter(3+parIdx,peakWidth);
+            fFitter.setParameter(4+parIdx,peakWidth);
             
-            Func.SetParLimits(1+parIdx, -5, 5);
-            Func.SetParLimits(2+parIdx, 0.1 * amplitude,  10. * amplitude);
-            Func.SetParLimits(3+parIdx, peakMean-peakWidth,peakMean+peakWidth);
-            Func.SetParLimits(4+parIdx, std::max(fMinWidth, 0.01 * peakWidth), fMaxWidthMult * peakWidth);
-            Func.SetParLimits(5+parIdx, std::max(fMinWidth, 0.01 * peakWidth), fMaxWidthMult * peakWidth);
+            fFitter.setParLimits(0+parIdx, -5, 5);
+            fFitter.setParLimits(1+parIdx, 0.1 * amplitude,  10. * amplitude);
+            fFitter.setParLimits(2+parIdx, peakMean-peakWidth,peakMean+peakWidth);
+            fFitter.setParLimits(3+parIdx, std::max(fMinWidth, 0.01 * peakWidth), fMaxWidthMult * peakWidth);
+            fFitter.setParLimits(4+parIdx, std::max(fMinWidth, 0.01 * peakWidth), fMaxWidthMult * peakWidth);
         
             parIdx += 5;
             
         }
         
-        int fitResult(-1);
-        // if(hitCandidateVec.size()>2) return;
-        try
-        {  fitResult = fHistogram->Fit(&Func,"QNWB","", 0., roiSize);
-        }
-        catch(...)
-        {mf::LogWarning("GausHitFinder") << "Fitter failed finding a hit";}
+        auto const fitResult = fFitter.fit(roiSignalVec.data() + startTime, roiSize);
+        if(!fitResult.valid)
+            mf::LogWarning("GausHitFinder") << "Fitter failed finding a hit";
         
-        
-       // if(fitResult==0)
-       //     std::cout << " icarus fit converges " << iWire << std::endl;
-        if(fitResult!=0)
-//            std::cout << " icarus fit cannot converge " << iWire << std::endl;
         // ##################################################
         // ### Getting the fitted parameters from the fit ###
         // ##################################################
         NDF        = roiSize-5*hitCandidateVec.size();
-        chi2PerNDF = (Func.GetChisquare() / NDF);
         
-        double chi2mio=ComputeChiSquare(Func,fHistogram);
+        double chi2mio=ComputeChiSquare(roiSignalVec,startTime,roiSize);
 //        std::cout << " chi2mio " << chi2mio << std::endl;
         chi2PerNDF=chi2mio;
-        //  for(int idx = 0; idx < roiSize; idx++)
-        //   std::cout << " bin " << idx << " Error " << fHistogram->GetBinError(idx+1) << std::endl;
-        
-//         std::cout << " chi2 " << Func.GetChisquare() << std::endl;
-//         std::cout << " ndf " << NDF << std::endl;
         
         //      std::cout << " chi2ndf " << chi2PerNDF<< std::endl;
         parIdx = 0;
-        peakParamsVec0.clear();
 
         for(size_t idx = 0; idx < hitCandidateVec.size(); idx++)
         {
             ICARUSPeakFitParams_t peakParams;
             
-            peakParams.peakAmplitude      = Func.GetParameter(2+parIdx);
-            peakParams.peakAmplitudeError = Func.GetParError(2+parIdx);
-            peakParams.peakCenter         = Func.GetParameter(3+parIdx) + float(startTime);
-            peakParams.peakCenterError    = Func.GetParError(3+parIdx);
-            //std::cout << " rising time " << Func.GetParameter(3) << " falling time " <<Func.GetParameter(4) << std::endl;
-            peakParams.peakTauRight        = Func.GetParameter(4+parIdx);
-            peakParams.peakTauRightError        = Func.GetParError(4+parIdx);
-            peakParams.peakTauLeft        = Func.GetParameter(5+parIdx);
-            peakParams.peakTauLeftError        = Func.GetParError(5+parIdx);
-            peakParams.peakBaseline        = Func.GetParameter(1+parIdx);
-            peakParams.peakBaselineError        = Func.GetParError(1+parIdx);
+            peakParams.peakAmplitude      = fFitter.parameter(1+parIdx);
+            peakParams.peakAmplitudeError = fFitter.parError(1+parIdx);
+            peakParams.peakCenter         = fFitter.parameter(2+parIdx) + float(startTime);
+            peakParams.peakCenterError    = fFitter.parError(2+parIdx);
+            peakParams.peakTauRight        = fFitter.parameter(3+parIdx);
+            peakParams.peakTauRightError        = fFitter.parError(3+parIdx);
+            peakParams.peakTauLeft        = fFitter.parameter(4+parIdx);
+            peakParams.peakTauLeftError        = fFitter.parError(4+parIdx);
+            peakParams.peakBaseline        = fFitter.parameter(0+parIdx);
+            peakParams.peakBaselineError        = fFitter.parError(0+parIdx);
             peakParams.peakFitWidth        =0;
             peakParams.peakFitWidthError        = 0;
             peakParams.peakSlope        = 0;
             peakParams.peakSlopeError        = 0;
             peakParamsVec.emplace_back(peakParams);
             parIdx += 5;
-            //std::cout << " first center " << Func.GetParameter(2) + float(startTime) << std::endl;
-            // std::cout << " second center " << Func.GetParameter(7) + float(startTime) << std::endl;
         }
         
-        //Gaus.Delete();
-        //Func.Delete();
-        bool writeWaveform=false;
-        if(writeWaveform) {
-       TFile *f = new TFile("fitICARUS.root","UPDATE");
-    fHistogram->Write();
-        f->Close();
-        f->Delete();
-        }
-
-        fHistogram->Delete();
         return;
     }
 
@@ -1233,10 +1101,6 @@ void ICARUSHitFinder::expandHit(reco_tool::ICandidateHitFinder::HitCandidate& h,
                                                   double&                                     chi2PerNDF,
                                                   int&                                        NDF, int iWire) const
     {
-        TH1F* fHistogram=new TH1F("","",roiSignalVec.size(),0.,roiSignalVec.size());;
-        std::string wireName = "PeakFitterHitSignal_" + std::to_string(iWire);
-        fHistogram->SetName(wireName.c_str());
-        
         if (hitCandidateVec.empty()) return;
         
         // in case of a fit failure, set the chi-square to infinity
@@ -1251,31 +1115,10 @@ void ICARUSHitFinder::expandHit(reco_tool::ICandidateHitFinder::HitCandidate& h,
         
         //std::cout << " roisize " << roiSize << std::endl;
         
-        // Check to see if we need a bigger histogram for fitting
-        if (roiSize > fHistogram->GetNbinsX())
-        {
-            std::string histName = "PeakFitterHitSignal_" + std::to_string(iWire);
-            fHistogram = new TH1F(histName.c_str(),"",roiSize,0.,roiSize);
-            fHistogram->Sumw2();
-        }
-        
-        fHistogram->Reset();
-        for(int idx = 0; idx < roiSize; idx++)
-            fHistogram->SetBinContent(idx+1,roiSignalVec.at(startTime+idx));
-        
-        // Build the string to describe the fit formula
-        std::string equation = "gaus(0)";
-        
-        
-        
         // Now define the complete function to fit
-        // TF1 Func("ICARUSfunc",fitlong,0,roiSize,1+7*hitCandidateVec.size());
-        TF1& Func = *(fLongFitCache.Get(hitCandidateVec.size()));
-        assert(&Func);
-        
-        // ### Setting the parameters for the ICARUS Fit ###
-        Func.FixParameter(0,hitCandidateVec.size());
+        fLongFitter.setNPeaks(hitCandidateVec.size());
             
+        // ### Setting the parameters for the ICARUS Fit ###
         int parIdx { 0 };
         for(auto const& candidateHit : hitCandidateVec)
         {
@@ -1283,40 +1126,35 @@ void ICARUSHitFinder::expandHit(reco_tool::ICandidateHitFinder::HitCandidate& h,
             double const peakWidth  = candidateHit.hitSigma;
             double const amplitude  = candidateHit.hitHeight;
             
-            Func.SetParameter(1+parIdx,0);
-            Func.SetParameter(2+parIdx, amplitude);
-            Func.SetParameter(3+parIdx, peakMean);
-            Func.SetParameter(4+parIdx,peakWidth);
-            Func.SetParameter(5+parIdx,peakWidth);
-            Func.SetParameter(6+parIdx,2*peakWidth);
-            Func.SetParameter(7+parIdx,0);
+            fLongFitter.setParameter(0+parIdx,0);
+            fLongFitter.setParameter(1+parIdx, amplitude);
+            fLongFitter.setParameter(2+parIdx, peakMean);
+            fLongFitter.setParameter(3+parIdx,peakWidth);
+            fLongFitter.setParameter(4+parIdx,peakWidth);
+            fLongFitter.setParameter(5+parIdx,2*peakWidth);
+            fLongFitter.setParameter(6+parIdx,0);
             
             
-            Func.SetParLimits(1+parIdx, -5, 5);
-            Func.SetParLimits(2+parIdx, 0.1 * amplitude,  10. * amplitude);
-            Func.SetParLimits(3+parIdx, peakMean-peakWidth,peakMean+peakWidth);
-            Func.SetParLimits(4+parIdx, std::max(fMinWidth, 0.01 * peakWidth), fMaxWidthMult * peakWidth);
-            Func.SetParLimits(5+parIdx, std::max(fMinWidth, 0.01 * peakWidth), 4 * peakWidth);
-            Func.SetParLimits(6+parIdx, 0,4*peakWidth);
-            Func.SetParLimits(7+parIdx, -1,1);
+            fLongFitter.setParLimits(0+parIdx, -5, 5);
+            fLongFitter.setParLimits(1+parIdx, 0.1 * amplitude,  10. * amplitude);
+            fLongFitter.setParLimits(2+parIdx, peakMean-peakWidth,peakMean+peakWidth);
+            fLongFitter.setParLimits(3+parIdx, std::max(fMinWidth, 0.01 * peakWidth), fMaxWidthMult * peakWidth);
+            fLongFitter.setParLimits(4+parIdx, std::max(fMinWidth, 0.01 * peakWidth), 4 * peakWidth);
+            fLongFitter.setParLimits(5+parIdx, 0,4*peakWidth);
+            fLongFitter.setParLimits(6+parIdx, -1,1);
             
             parIdx += 7;
             
         }
-        int fitResult { -1 };
-        try
-        {  fitResult = fHistogram->Fit(&Func,"QNWB","", 0., roiSize);
-        }
-        catch(...)
-        {mf::LogWarning("GausHitFinder") << "Fitter failed finding a hit";}
+        auto const fitResult = fLongFitter.fit(roiSignalVec.data() + startTime, roiSize);
         
-        if(fitResult < -1) 
-            std::cout << " long fit cannot converge " << iWire << std::endl;
+        if(!fitResult.valid)
+            mf::LogWarning("GausHitFinder") << "Long fit cannot converge on wire " << iWire;
         // ##################################################
         // ### Getting the fitted parameters from the fit ###
         // ##################################################
         NDF        = roiSize-7*hitCandidateVec.size();
-        chi2PerNDF = (Func.GetChisquare() / NDF);
+        chi2PerNDF = (fitResult.chi2 / NDF);
         
         parIdx = 0;
         peakParamsVec.clear();
@@ -1324,83 +1162,45 @@ void ICARUSHitFinder::expandHit(reco_tool::ICandidateHitFinder::HitCandidate& h,
         {
             ICARUSPeakFitParams_t peakParams;
             
-            peakParams.peakAmplitude      = Func.GetParameter(2+parIdx);
-            peakParams.peakAmplitudeError = Func.GetParError(2+parIdx);
-            peakParams.peakCenter         = Func.GetParameter(3+parIdx) + float(startTime);
-            peakParams.peakCenterError    = Func.GetParError(3+parIdx);
+            peakParams.peakAmplitude      = fLongFitter.parameter(1+parIdx);
+            peakParams.peakAmplitudeError = fLongFitter.parError(1+parIdx);
+            peakParams.peakCenter         = fLongFitter.parameter(2+parIdx) + float(startTime);
+            peakParams.peakCenterError    = fLongFitter.parError(2+parIdx);
             
-            peakParams.peakTauRight        = Func.GetParameter(4+parIdx);
-            peakParams.peakTauRightError        = Func.GetParError(4+parIdx);
-            peakParams.peakTauLeft        = Func.GetParameter(5+parIdx);
-            peakParams.peakTauLeftError        = Func.GetParError(5+parIdx);
-            peakParams.peakFitWidth        = Func.GetParameter(6+parIdx);
-            peakParams.peakFitWidthError        = Func.GetParError(6+parIdx);
-            peakParams.peakSlope        = Func.GetParameter(7+parIdx);
-            peakParams.peakSlopeError        = Func.GetParError(7+parIdx);
-            peakParams.peakBaseline        = Func.GetParameter(1+parIdx);
-            peakParams.peakBaselineError        = Func.GetParError(1+parIdx);
-         //   std::cout << " before adding peakparams size  " << peakParamsVec.size() << std::endl;
+            peakParams.peakTauRight        = fLongFitter.parameter(3+parIdx);
+            peakParams.peakTauRightError        = fLongFitter.parError(3+parIdx);
+            peakParams.peakTauLeft        = fLongFitter.parameter(4+parIdx);
+            peakParams.peakTauLeftError        = fLongFitter.parError(4+parIdx);
+            peakParams.peakFitWidth        = fLongFitter.parameter(5+parIdx);
+            peakParams.peakFitWidthError        = fLongFitter.parError(5+parIdx);
+            peakParams.peakSlope        = fLongFitter.parameter(6+parIdx);
+            peakParams.peakSlopeError        = fLongFitter.parError(6+parIdx);
+            peakParams.peakBaseline        = fLongFitter.parameter(0+parIdx);
+            peakParams.peakBaselineError        = fLongFitter.parError(0+parIdx);
             peakParamsVec.emplace_back(peakParams);
-           // std::cout << " after adding peakparams size  " << peakParamsVec.size() << std::endl;
             
             parIdx += 7;
             
         }
         
-        //Func.Delete();
-        bool writeWaveform=false;
-        if(writeWaveform) {
-            TFile *f = new TFile("fitICARUS.root","UPDATE");
-            fHistogram->Write();
-            f->Close();
-            f->Delete();
-        }
-        
-        fHistogram->Delete();
         return;
     }
     
-
-Double_t ICARUShitFitCache::fitf(Double_t const* x, Double_t const* par)
-        {
-            int const npeaks=(int)(par[0]);
-            Double_t fitval=0;
-            for(int jp=0;jp<npeaks;jp++)
-                fitval += par[5*jp+1]+par[5*jp+2]*TMath::Exp(-(x[0]-par[5*jp+3])/par[5*jp+4])/(1+TMath::Exp(-(x[0]-par[5*jp+3])/par[5*jp+5]));
-            return fitval;
-        }
-Double_t ICARUSlongHitFitCache::fitlong(Double_t const* x, Double_t const* par)
-    {
-        auto const nPeaks = static_cast<std::size_t>(par[0]);
-        Double_t fitval = 0.0;
-        for(std::size_t jp = 0; jp < nPeaks; ++jp) {
-            Double_t const* parj = par + (7 * jp);
-            int const smax = std::floor(parj[6]);
-            if (smax == 0) continue;
-            double const neg_dxj = -(x[0] - parj[3]);
-            fitval += (smax + parj[7] * (smax*(smax-1)/2))
-              * (
-                parj[1]+parj[2]*std::exp(neg_dxj/parj[4])
-                / (1.0 + std::exp(neg_dxj/parj[5]))
-              ) / (parj[6]);
-        } // for
-  return fitval;
-    }
-    
-    double ICARUSHitFinder::ComputeChiSquare(TF1 func, TH1 *histo) const
+    double ICARUSHitFinder::ComputeChiSquare(const std::vector<float>& roiSignalVec, int startTime, int roiSize) const
     {
+        // chi square of the last multi-peak fit, with the function evaluated
+        // at the lower edge of each tick and a fixed uncertainty
         double chi=0;
-        int nb=histo->GetNbinsX();
-        double wb=histo->GetBinWidth(0);
+        int nb=roiSignalVec.size();
         
         int jp;
         for( jp=1;jp<nb;jp++) {
-            if(histo->GetBinContent(jp)==0) break;
-            double xb=jp*wb;
-            double fv=(func)(xb);
-            double hv=histo->GetBinContent(jp);
+            double hv=(jp<=roiSize)? roiSignalVec[startTime+jp-1]: 0.;
+            if(hv==0) break;
+            double xb=jp;
+            double fv=fFitter(xb);
             double dv=hv-fv;
-            double cv=dv/(histo->GetBinError(jp));
+            double cv=dv/2.4;
             chi+=cv*cv;
             //std::cout << " chi " << chi << std::endl;
             
@@ -0,0 +1,217 @@
+#ifndef GROUPTICKMEDIAN_H
+#define GROUPTICKMEDIAN_H
+////////////////////////////////////////////////////////////////////////
+//
+// Class:       GroupTickMedian
+// File:        GroupTickMedian.h
+//
+//              Median, tick by tick, of the waveforms of a group of
+//              channels, as used for the correlated noise correction.
+//
+//              The waveforms are stored transposed, in blocks of TickBlock
+//              ticks: in each block, the TickBlock samples of each channel
+//              are contiguous, and the channels follow each other. Groups of
+//              up to 32 (64) channels are padded to 32 (64) lanes and sorted
+//              with a fixed (Batcher odd-even merge) sorting network, where
+//              each comparator is a min/max on a whole row of the block and
+//              is vectorized by the compiler. Larger groups fall back to a
+//              selection on each tick.
+//
+//              Header only.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace caldata
+{
+
+namespace details
+{
+    /// A compare-exchange between two lanes of a sorting network.
+    struct Comparator_t { std::uint8_t low; std::uint8_t high; };
+
+    /// Visits the comparators of Batcher's odd-even merge sort of N lanes.
+    template <std::size_t N, typename Op>
+    constexpr void batcherComparators(Op op)
+    {
+        for(std::size_t p = 1; p < N; p *= 2)
+            for(std::size_t k = p; k >= 1; k /= 2)
+                for(std::size_t j = k % p; j + k < N; j += 2 * k)
+                    for(std::size_t i = 0; i < k && i + j + k < N; i++)
+                        if ((i + j) / (p * 2) == (i + j + k) / (p * 2)) op(i + j, i + j + k);
+    }
+
+    template <std::size_t N>
+    constexpr std::size_t countBatcherComparators()
+    {
+        std::size_t count(0);
+        batcherComparators<N>([&count](std::size_t, std::size_t){ ++count; });
+        return count;
+    }
+
+    /// The sorting network for N lanes (N a power of 2 up to 256).
+    template <std::size_t N>
+    constexpr std::array<Comparator_t, countBatcherComparators<N>()> makeSortingNetwork()
+    {
+        std::array<Comparator_t, countBatcherComparators<N>()> network{};
+        std::size_t idx(0);
+        batcherComparators<N>([&network, &idx](std::size_t low, std::size_t high)
+            { network[idx++] = Comparator_t{ std::uint8_t(low), std::uint8_t(high) }; });
+        return network;
+    }
+} // end details namespace
+
+class GroupTickMedian
+{
+public:
+
+    static constexpr std::size_t TickBlock       = 16; ///< Ticks sorted together
+    static constexpr std::size_t MaxNetworkLanes = 64; ///< Largest sorting network
+
+    /// Prepares the buffer for nChannels waveforms of nTicks, all with no samples
+    void reset(std::size_t nChannels, std::size_t nTicks)
+    {
+        fNChannels = nChannels;
+        fNTicks    = nTicks;
+        fNLanes    = (nChannels <= 32)? 32: (nChannels <= MaxNetworkLanes)? MaxNetworkLanes: nChannels;
+
+        std::size_t nBlocks = (nTicks + TickBlock - 1) / TickBlock;
+
+        fBuffer.assign(nBlocks * fNLanes * TickBlock, std::numeric_limits<float>::infinity());
+        fNValues.assign(nBlocks * TickBlock, 0);
+    }
+
+    /// Sets the samples of channel iChannel to waveform - pedestal in the ticks [begin, end)
+    template <typename T>
+    void setChannel(std::size_t iChannel, const T* waveform, float pedestal, std::size_t begin, std::size_t end)
+    {
+        end = std::min(end, fNTicks);
+
+        for(std::size_t tick = begin; tick < end; tick++)
+        {
+            fBuffer[index(iChannel, tick)] = float(waveform[tick]) - pedestal;
+            fNValues[tick]++;
+        }
+    }
+
+    /// Fills medianVec with the median of the samples at each tick (defaultValue if there are none)
+    ///
+    /// The median follows the definition used in the correlated noise correction: the value
+    /// at position n/2 of the sorted samples, averaged with the next one if n/2 is odd.
+    /// The buffer content is scrambled in the process.
+    void computeMedians(std::vector<float>& medianVec, float defaultValue)
+    {
+        medianVec.resize(fNTicks);
+
+        if      (fNLanes == 32)              sortedMedians<32>(medianVec, defaultValue);
+        else if (fNLanes == MaxNetworkLanes) sortedMedians<MaxNetworkLanes>(medianVec, defaultValue);
+        else                                 selectedMedians(medianVec, defaultValue);
+    }
+
+    std::size_t nLanes() const {return fNLanes;}
+
+private:
+
+    std::size_t index(std::size_t channel, std::size_t tick) const
+    {
+        return ((tick / TickBlock) * fNLanes + channel) * TickBlock + tick % TickBlock;
+    }
+
+    /// The median from a function returning the sorted samples by rank
+    template <typename SortedValue>
+    static float median(std::size_t nValues, float defaultValue, SortedValue sortedValue)
+    {
+        float medianValue(defaultValue);
+
+        if (nValues > 0)
+        {
+            size_t medianIdx = nValues / 2;
+
+            medianValue = sortedValue(medianIdx);
+
+            if (nValues > 1 && medianIdx % 2 && medianIdx + 1 < nValues) medianValue = (medianValue + sortedValue(medianIdx + 1)) / 2;
+        }
+
+        return std::max(medianValue, defaultValue);
+    }
+
+    template <std::size_t NLanes>
+    void sortedMedians(std::vector<float>& medianVec, float defaultValue)
+    {
+        static constexpr auto network = details::makeSortingNetwork<NLanes>();
+
+        for(std::size_t firstTick = 0; firstTick < fNTicks; firstTick += TickBlock)
+        {
+            float* block = fBuffer.data() + (firstTick / TickBlock) * NLanes * TickBlock;
+
+            for(const auto& comparator : network)
+            {
+                float* low  = block + comparator.low  * TickBlock;
+                float* high = block + comparator.high * TickBlock;
+
+                for(std::size_t idx = 0; idx < TickBlock; idx++)
+                {
+                    float lowVal  = low[idx];
+                    float highVal = high[idx];
+
+                    low[idx]  = std::min(lowVal, highVal);
+                    high[idx] = std::max(lowVal, highVal);
+                }
+            }
+
+            std::size_t lastTick = std::min(firstTick + TickBlock, fNTicks);
+
+            for(std::size_t tick = firstTick; tick < lastTick; tick++)
+            {
+                const float* column = block + tick % TickBlock;
+
+                medianVec[tick] = median(fNValues[tick], defaultValue,
+                    [column](std::size_t rank){return column[rank * TickBlock];});
+            }
+        }
+    }
+
+    void selectedMedians(std::vector<float>& medianVec, float defaultValue)
+    {
+        for(std::size_t tick = 0; tick < fNTicks; tick++)
+        {
+            fColumn.clear();
+
+            for(std::size_t channel = 0; channel < fNChannels; channel++)
+            {
+                float value = fBuffer[index(channel, tick)];
+
+                if (value != std::numeric_limits<float>::infinity()) fColumn.push_back(value);
+            }
+
+            medianVec[tick] = median(fColumn.size(), defaultValue,
+                [this](std::size_t rank)
+                {
+                    // ranks are requested in increasing order
+                    if (rank == fColumn.size() / 2)
+                    {
+                        std::nth_element(fColumn.begin(), fColumn.begin() + rank, fColumn.end());
+                        return fColumn[rank];
+                    }
+                    return *std::min_element(fColumn.begin() + rank, fColumn.end());
+                });
+        }
+    }
+
+    std::size_t               fNChannels = 0;
+    std::size_t               fNTicks    = 0;
+    std::size_t               fNLanes    = 32;
+    std::vector<float>        fBuffer;       ///< Transposed samples (infinity for no sample)
+    std::vector<unsigned int> fNValues;      ///< Number of samples at each tick
+    std::vector<float>        fColumn;       ///< Work area for groups without a network
+};
+
+} // end caldata namespace
+
+#endif
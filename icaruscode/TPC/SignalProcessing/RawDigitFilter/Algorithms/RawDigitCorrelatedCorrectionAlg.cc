@@ -143,36 +143,31 @@ void RawDigitCorrelatedCorrectionAlg::removeCorrelatedNoise(RawDigitAdcIdxPair&
     // Don't try to do correction if too few wires unless they have gaps
     if (wireToAdcIdxMap.size() > 2) // || largestGapSize > 2)
     {
-        // Zero? This is probably not necessary
-        std::fill(corValVec.begin(),corValVec.end(),0.);
+        // Accumulate the pedestal corrected ADC values of each time bin, one wire at a time
+        // (the wires are visited in the same order for each time bin, so the sums are unchanged)
+        std::vector<double>       adcSumVec(maxTimeSamples, 0.);
+        std::vector<unsigned int> adcCountVec(maxTimeSamples, 0);
 
-        // Build the vector of corrections for each time bin
-        for(size_t sampleIdx = 0; sampleIdx < maxTimeSamples; sampleIdx++)
+        for(const auto& wireAdcItr : wireToAdcIdxMap)
         {
-            // Define a vector for accumulating values...
-            // Loop over the wires at this time bin and get their pedestal corrected ADC values
-            // We'll use a simple stl vector for this
-            std::vector<float> adcValuesVec;
-
-            for(const auto& wireAdcItr : wireToAdcIdxMap)
-            {
-                // Check that we should be doing something in this range
-                // Note that if the wire is not to be considered then the "start" bin will be after the last bin
-                if (sampleIdx < wireAdcItr.second.first || sampleIdx >= wireAdcItr.second.second) continue;
+            const RawDigitVector& rawDataTimeVec = wireToRawDigitVecMap.at(wireAdcItr.first);
+            float                 truncMean      = truncMeanWireVec[wireAdcItr.first - baseWireIdx];
 
-                int wireIdx(wireAdcItr.first - baseWireIdx);
+            // Note that if the wire is not to be considered then the "start" bin will be after the last bin
+            size_t stopIdx = std::min(wireAdcItr.second.second, maxTimeSamples);
 
-                // Accumulate
-                adcValuesVec.push_back(float(wireToRawDigitVecMap.at(wireAdcItr.first)[sampleIdx]) - truncMeanWireVec[wireIdx]);
+            for(size_t sampleIdx = wireAdcItr.second.first; sampleIdx < stopIdx; sampleIdx++)
+            {
+                adcSumVec[sampleIdx] += float(rawDataTimeVec[sampleIdx]) - truncMean;
+                adcCountVec[sampleIdx]++;
             }
-
-//            float medianValue = getMedian(adcValuesVec, float(-10000.));
-            float aveValue    = std::accumulate(adcValuesVec.begin(),adcValuesVec.end(),0.) / float(adcValuesVec.size());
-
-//            corValVec[sampleIdx] = medianValue;
-            corValVec[sampleIdx] = aveValue;
         }
 
+        // Build the vector of corrections for each time bin
+        // (see GroupTickMedian for the median across the wires, as used in mtRawDigitFilterICARUS)
+        for(size_t sampleIdx = 0; sampleIdx < maxTimeSamples; sampleIdx++)
+            corValVec[sampleIdx] = adcSumVec[sampleIdx] / float(adcCountVec[sampleIdx]);
+
         // Try to eliminate any real outliers
         if (fApplyCorSmoothing) smoothCorrectionVec(corValVec, planeIdx);
 
@@ -226,14 +221,16 @@ void RawDigitCorrelatedCorrectionAlg::removeCorrelatedNoise(RawDigitAdcIdxPair&
           }
         } // fApplyFFTCorrection
 
-        // Now go through and apply the correction
-        for(size_t sampleIdx = 0; sampleIdx < maxTimeSamples; sampleIdx++)
+        // Now go through and apply the correction, one wire at a time
+        for (const auto& wireAdcItr : wireToAdcIdxMap)
         {
+            int             wireIdx(wireAdcItr.first - baseWireIdx);
+            RawDigitVector& rawDataTimeVec = wireToRawDigitVecMap.at(wireAdcItr.first);
+
             // Now run through and apply correction
-            for (const auto& wireAdcItr : wireToAdcIdxMap)
+            for(size_t sampleIdx = 0; sampleIdx < maxTimeSamples; sampleIdx++)
             {
                 float corVal(corValVec[sampleIdx]);
-                int   wireIdx(wireAdcItr.first - baseWireIdx);
 
                 // If the "start" bin is after the "stop" bin then we are meant to skip this wire in the averaging process
                 // Or if the sample index is in a chirping section then no correction is applied.
@@ -241,8 +238,7 @@ void RawDigitCorrelatedCorrectionAlg::removeCorrelatedNoise(RawDigitAdcIdxPair&
                 if (sampleIdx < wireAdcItr.second.first || sampleIdx >= wireAdcItr.second.second)
                     corVal = 0.;
 
-                //RawDigitVector& rawDataTimeVec = wireToRawDigitVecMap.at(wireIdx);
-                short& rawDataTimeVal = wireToRawDigitVecMap.at(wireAdcItr.first)[sampleIdx];
+                short& rawDataTimeVal = rawDataTimeVec[sampleIdx];
 
                 // Probably doesn't matter, but try to get slightly more accuracy by doing float math and rounding
                 float newAdcValueFloat = float(rawDataTimeVal) - corVal - pedCorWireVec[wireIdx];
@@ -253,24 +249,6 @@ void RawDigitCorrelatedCorrectionAlg::removeCorrelatedNoise(RawDigitAdcIdxPair&
     return;
 }
 
-template<class T> T RawDigitCorrelatedCorrectionAlg::getMedian(std::vector<T>& valuesVec, T defaultValue) const
-{
-    T medianValue(defaultValue);
-
-    if (!valuesVec.empty())
-    {
-        std::sort(valuesVec.begin(),valuesVec.end());
-
-        size_t medianIdx = valuesVec.size() / 2;
-
-        medianValue = valuesVec[medianIdx];
-
-        if (valuesVec.size() > 1 && medianIdx % 2) medianValue = (medianValue + valuesVec[medianIdx+1]) / 2;
-    }
-
-    return std::max(medianValue,defaultValue);
-}
-
 template <typename T> void RawDigitCorrelatedCorrectionAlg::findPeaks(typename std::vector<T>::iterator startItr,
                                                                         typename std::vector<T>::iterator stopItr,
                                                                         std::vector<std::tuple<size_t,size_t,size_t>>& peakTupleVec,
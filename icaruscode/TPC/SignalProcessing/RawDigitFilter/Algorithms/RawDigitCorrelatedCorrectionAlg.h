@@ -71,8 +71,6 @@ private:
 
     void smoothCorrectionVec(std::vector<float>&, unsigned int&) const;
 
-    template<class T> T getMedian(std::vector<T>&, T) const;
-
     template <typename T> void findPeaks(typename std::vector<T>::iterator startItr,
                                          typename std::vector<T>::iterator stopItr,
                                          std::vector<std::tuple<size_t,size_t,size_t>>& peakTupleVec,
@@ -59,6 +59,24 @@
 
 namespace tpcnoise {
   class TPCNoise;
+
+  namespace {
+    /// Partially orders `adc` by magnitude: the `nKept` smallest samples come
+    /// first, and the sample at `adc.size()/2` is the one a full sort would
+    /// put there. Sums on the first `nKept` samples are the same as after a
+    /// full sort, at a fraction of the cost.
+    void selectByMagnitude(std::vector<short>& adc, std::size_t nKept) {
+      auto const byMagnitude
+        = [](short left, short right){ return std::abs(left) < std::abs(right); };
+      std::size_t const medianIdx = adc.size() / 2;
+      if (nKept < adc.size())
+        std::nth_element(adc.begin(), adc.begin() + nKept, adc.end(), byMagnitude);
+      if (medianIdx < nKept)
+        std::nth_element(adc.begin(), adc.begin() + medianIdx, adc.begin() + nKept, byMagnitude);
+      else if (medianIdx < adc.size())
+        std::nth_element(adc.begin() + nKept, adc.begin() + medianIdx, adc.end(), byMagnitude);
+    }
+  }
 }
 
 
@@ -325,8 +343,10 @@ std::cout << " run " << fRun << std::endl;
       raw::Uncompress(RawDigit.ADCs(), RawADC, RawDigit.Compression());
 
       // We need a sorted waveform (by absolute value) for the truncated RMS and median calculation.
+      // (a selection of the smallest samples and of the median is enough).
       std::vector<short> SortedADC(RawADC);
-      std::sort(SortedADC.begin(),SortedADC.end(),[](const auto& left, const auto& right){return std::fabs(left) < std::fabs(right);});
+      unsigned int MinBins((1.0 - 0.01)*SortedADC.size());
+      selectByMagnitude(SortedADC, MinBins);
       float median(SortedADC.at(SortedADC.size()/2));
 
       // Calculate mean values.
@@ -345,7 +365,6 @@ std::vector<geo::WireID> widVec = geom->ChannelToWire(RawDigit.Channel());
       float rms(std::sqrt(std::inner_product(ADCLessPed.begin(), ADCLessPed.end(), ADCLessPed.begin(), 0.) / float(ADCLessPed.size())));
 
       // Calculate the truncated RMS.
-      unsigned int MinBins((1.0 - 0.01)*ADCLessPed.size());
       //unsigned int BinsToKeep;
       //for(BinsToKeep = 0; BinsToKeep < ADCLessPed.size(); ++BinsToKeep)
       //{
@@ -409,8 +428,10 @@ std::cout << " intrinsic instance " << fIntrinsicInstance << std::endl;
       raw::Uncompress(RawDigit.ADCs(), RawADC, RawDigit.Compression());
 
       // We need a sorted waveform (by absolute value) for the truncated RMS and median calculation.
+      // (a selection of the smallest samples and of the median is enough).
       std::vector<short> SortedADC(RawADC);
-      std::sort(SortedADC.begin(),SortedADC.end(),[](const auto& left, const auto& right){return std::fabs(left) < std::fabs(right);});
+      unsigned int MinBins((1.0 - 0.2)*SortedADC.size());
+      selectByMagnitude(SortedADC, MinBins);
       float median(SortedADC.at(SortedADC.size()/2));
 
       // Calculate mean values.
@@ -425,7 +446,6 @@ std::cout << " intrinsic instance " << fIntrinsicInstance << std::endl;
       float rms(std::sqrt(std::inner_product(ADCLessPed.begin(), ADCLessPed.end(), ADCLessPed.begin(), 0.) / float(ADCLessPed.size())));
 
       // Calculate the truncated RMS.
-      unsigned int MinBins((1.0 - 0.2)*ADCLessPed.size());
       //unsigned int BinsToKeep;
       //for(BinsToKeep = 0; BinsToKeep < ADCLessPed.size(); ++BinsToKeep)
       //{
@@ -478,8 +498,10 @@ std::cout << " coherent instance " << fCoherentInstance << std::endl;
       raw::Uncompress(RawDigit.ADCs(), RawADC, RawDigit.Compression());
 
       // We need a sorted waveform (by absolute value) for the truncated RMS and median calculation.
+      // (a selection of the smallest samples and of the median is enough).
       std::vector<short> SortedADC(RawADC);
-      std::sort(SortedADC.begin(),SortedADC.end(),[](const auto& left, const auto& right){return std::fabs(left) < std::fabs(right);});
+      unsigned int MinBins((1.0 - 0.2)*SortedADC.size());
+      selectByMagnitude(SortedADC, MinBins);
       float median(SortedADC.at(SortedADC.size()/2));
 //for(unsigned int jadc=0;jadc<SortedADC.size();jadc++)
  //if(SortedADC.at(jadc))
@@ -497,7 +519,6 @@ std::cout << " coherent instance " << fCoherentInstance << std::endl;
       float rms(std::sqrt(std::inner_product(ADCLessPed.begin(), ADCLessPed.end(), ADCLessPed.begin(), 0.) / float(ADCLessPed.size())));
 
       // Calculate the truncated RMS.
-      unsigned int MinBins((1.0 - 0.2)*ADCLessPed.size());
       //unsigned int BinsToKeep;
       //for(BinsToKeep = 0; BinsToKeep < ADCLessPed.size(); ++BinsToKeep)
       //{
@@ -29,6 +29,7 @@
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/RawDigitCorrelatedCorrectionAlg.h"
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/IRawDigitFilter.h"
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/ChannelGroups.h"
+#include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/GroupTickMedian.h"
 #include "icaruscode/TPC/Utilities/tools/IFilter.h"
 
 #include "lardataobj/RawData/RawDigit.h"
@@ -514,33 +515,24 @@ void RawDigitFilterICARUS::RemoveCorrelatedNoise(unsigned int igrp, unsigned int
     if (nwq <= 2) continue;
 
     std::vector<float> corValVec;
-    corValVec.resize(fftSize, 0.);
 
     // ----------------------------------------------------
     // .. Build the vector of corrections for each time bin
     // ----------------------------------------------------
-    for(size_t itck = 0; itck < fftSize; itck++){
-      std::vector<float> adcValuesVec;
-      // .. Loop over each entry in wgqvec[igrp][iq]
-      for (size_t i = 0; i < nwq; i++) {
-  	// .. get index into the wgvec[igrp] array
-  	size_t iwdx = wgqvec[igrp][iq][i];
-  	// .. Check that we should be doing something in this range
-  	//    Note that if the wire is not to be considered then the "start" bin will be after the last bin
-  	if (itck < wgcvec[igrp][iwdx].tcka || itck >= wgcvec[igrp][iwdx].tckb) continue;
-  	// .. Accumulate
-  	adcValuesVec.push_back(float(rawadcgvec[igrp][iwdx][itck]) - wgcvec[igrp][iwdx].truncMean);
-      }
-      // ... Get the median for this time tick across all wires in the group
-      float medval(-10000);
-      if (!adcValuesVec.empty()) {
-  	  std::sort(adcValuesVec.begin(),adcValuesVec.end());
-  	  size_t medidx = adcValuesVec.size() / 2;
-  	  medval = adcValuesVec[medidx];
-  	  if (adcValuesVec.size() > 1 && medidx % 2) medval = (medval + adcValuesVec[medidx+1]) / 2;
-      }
-      corValVec[itck] = std::max(medval,float(-10000.));
-    } // loop over itck
+    // .. Each thread keeps its own (transposed) buffer for the group
+    thread_local caldata::GroupTickMedian groupTickMedian;
+    groupTickMedian.reset(nwq, fftSize);
+    // .. Loop over each entry in wgqvec[igrp][iq]
+    for (size_t i = 0; i < nwq; i++) {
+      // .. get index into the wgvec[igrp] array
+      size_t iwdx = wgqvec[igrp][iq][i];
+      // .. Only the ticks in this range are considered
+      //    Note that if the wire is not to be considered then the "start" bin will be after the last bin
+      groupTickMedian.setChannel(i, rawadcgvec[igrp][iwdx].data(), wgcvec[igrp][iwdx].truncMean,
+                                 wgcvec[igrp][iwdx].tcka, wgcvec[igrp][iwdx].tckb);
+    }
+    // ... Get the median for each time tick across all wires in the group
+    groupTickMedian.computeMedians(corValVec, -10000.);
 
     // .. get the plane number for first wire in this set, for use below
     size_t iwdx0 = wgqvec[igrp][iq][0];
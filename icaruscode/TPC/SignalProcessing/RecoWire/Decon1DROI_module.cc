@@ -13,6 +13,8 @@
 #include <vector>
 #include <utility> // std::pair<>
 #include <memory> // std::unique_ptr<>
+#include <algorithm> // std::is_sorted(), std::stable_sort()
+#include <numeric> // std::iota()
 #include <iomanip>
 #include <fstream>
 #include <random>
@@ -51,18 +53,16 @@
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IROIFinder.h"
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IDeconvolution.h"
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IBaseline.h"
+#include "icaruscode/TPC/Utilities/RobustWaveformStats.h"
 #include "icarus_signal_processing/WaveformTools.h"
 
 #include "tbb/parallel_for.h"
 #include "tbb/blocked_range.h"
 #include "tbb/task_arena.h"
-#include "tbb/spin_mutex.h"
 
 ///creation of calibrated signals on wires
 namespace caldata {
     
-tbb::spin_mutex deconvolutionSpinMutex;
-
 class Decon1DROI : public art::ReplicatedProducer
 {
   public:
@@ -84,29 +84,27 @@ class Decon1DROI : public art::ReplicatedProducer
         multiThreadDeconvolutionProcessing(Decon1DROI const&                        parent,
                                            art::Event&                              event,
                                            art::Handle<std::vector<raw::RawDigit>>& rawDigitHandle, 
-                                           std::vector<recob::Wire>&                wireColVec,
-                                           art::Assns<raw::RawDigit,recob::Wire>&   wireAssns,
-                                           std::string const&                       instance)
+                                           std::vector<size_t> const&               digitOrder,
+                                           std::vector<recob::Wire>&                wireSlots)
             : fDecon1DROI(parent),
               fEvent(event),
               fRawDigitHandle(rawDigitHandle),
-              fWireColVec(wireColVec),
-              fWireAssns(wireAssns),
-              fInstance(instance)
+              fDigitOrder(digitOrder),
+              fWireSlots(wireSlots)
         {}
 
+        // each slot is written by exactly one task: no locking is needed
         void operator()(const tbb::blocked_range<size_t>& range) const
         {
-            for (size_t idx = range.begin(); idx < range.end(); idx++)
-                fDecon1DROI.processChannel(idx, fEvent, fRawDigitHandle, fWireColVec, fWireAssns, fInstance);
+            for (size_t slot = range.begin(); slot < range.end(); slot++)
+                fDecon1DROI.processChannel(fDigitOrder[slot], fEvent, fRawDigitHandle, fWireSlots[slot]);
         }
     private:
         const Decon1DROI&                        fDecon1DROI;
         art::Event&                              fEvent;
         art::Handle<std::vector<raw::RawDigit>>& fRawDigitHandle;
-        std::vector<recob::Wire>&                fWireColVec;
-        art::Assns<raw::RawDigit,recob::Wire>&   fWireAssns;
-        std::string                              fInstance;
+        std::vector<size_t> const&               fDigitOrder;
+        std::vector<recob::Wire>&                fWireSlots;
     };
 
     // It seems there are pedestal shifts that need correcting
@@ -114,13 +112,11 @@ class Decon1DROI : public art::ReplicatedProducer
     
     float getTruncatedRMS(const std::vector<float>&) const;
 
-    // Function to do the work
+    // Function to do the work: the wire is left untouched (invalid channel) if not saved
     void  processChannel(size_t,
                          art::Event&,
                          art::Handle<std::vector<raw::RawDigit>>, 
-                         std::vector<recob::Wire>&, 
-                         art::Assns<raw::RawDigit,recob::Wire>&,
-                         const std::string&) const;
+                         recob::Wire&) const;
     
     std::vector<art::InputTag>                                 fRawDigitLabelVec;           ///< Contains the input tags for finding RawDigits
                                                                                             ///< it is set by the DigitModuleLabel
@@ -286,13 +282,43 @@ void Decon1DROI::produce(art::Event& evt, art::ProcessingFrame const& frame)
             return;
         }
     
-        // Reserve the room for the output
-        wireCol->reserve(digitVecHandle->size());
+        // Order the raw digits by channel (usually they already are), so that
+        // the output slots are already in the final order
+        std::vector<size_t> digitOrder(digitVecHandle->size());
+        
+        std::iota(digitOrder.begin(), digitOrder.end(), 0);
+        
+        auto const byChannel = [&digits=*digitVecHandle](size_t left, size_t right){return digits[left].Channel() < digits[right].Channel();};
+        
+        if (!std::is_sorted(digitOrder.begin(), digitOrder.end(), byChannel))
+            std::stable_sort(digitOrder.begin(), digitOrder.end(), byChannel);
+    
+        // One pre-sized output slot per raw digit
+        std::vector<recob::Wire> wireSlots(digitOrder.size());
     
         // ... Launch multiple threads with TBB to do the deconvolution and find ROIs in parallel
-        multiThreadDeconvolutionProcessing deconvolutionProcessing(*this, evt, digitVecHandle, *wireCol, *wireDigitAssn, rawDigitLabel.instance());
+        multiThreadDeconvolutionProcessing deconvolutionProcessing(*this, evt, digitVecHandle, digitOrder, wireSlots);
     
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, digitVecHandle->size()), deconvolutionProcessing);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, digitOrder.size()), deconvolutionProcessing);
+        
+        // Collect the wires which were saved, and associate them to their raw digits
+        wireCol->reserve(wireSlots.size());
+        
+        for(size_t slot = 0; slot < wireSlots.size(); slot++)
+        {
+            if (wireSlots[slot].Channel() == raw::InvalidChannelID) continue;
+            
+            wireCol->push_back(std::move(wireSlots[slot]));
+            
+            art::Ptr<raw::RawDigit> digitPtr(digitVecHandle, digitOrder[slot]);
+            
+            if (!util::CreateAssn(evt, *wireCol, digitPtr, *wireDigitAssn, rawDigitLabel.instance()))
+            {
+                throw art::Exception(art::errors::ProductRegistrationFailure)
+                    << "Can't associate wire #" << (wireCol->size() - 1)
+                    << " with raw digit #" << digitPtr.key();
+            } // if failed to add association
+        }
         
         // Time to stroe everything
         if(wireCol->size() == 0)
@@ -312,9 +338,6 @@ void Decon1DROI::produce(art::Event& evt, art::ProcessingFrame const& frame)
             }
         }
     
-        // Make sure the collection is sorted
-        std::sort(wireCol->begin(), wireCol->end(), [](const auto& left, const auto& right){return left.Channel() < right.Channel();});
-       
         evt.put(std::move(wireCol), rawDigitLabel.instance());
         evt.put(std::move(wireDigitAssn), rawDigitLabel.instance());
     }
@@ -326,63 +349,22 @@ void Decon1DROI::produce(art::Event& evt, art::ProcessingFrame const& frame)
     
 float Decon1DROI::getTruncatedRMS(const std::vector<float>& waveform) const
 {
-    // do rms calculation - the old fashioned way and over all adc values
-    std::vector<float> locWaveform = waveform;
-    
-    // sort in ascending order so we can truncate the sume
-    std::sort(locWaveform.begin(), locWaveform.end(),[](const auto& left, const auto& right){return std::fabs(left) < std::fabs(right);});
-    
-    float threshold = fTruncRMSThreshold;
-    
-    std::vector<float>::iterator threshItr = std::find_if(locWaveform.begin(),locWaveform.end(),[threshold](const auto& val){return std::fabs(val) > threshold;});
-    
-    int minNumBins = std::max(int(fTruncRMSMinFraction * locWaveform.size()),int(std::distance(locWaveform.begin(),threshItr)));
+    // scratch buffers are per thread, since channels are processed concurrently
+    thread_local icarus::RobustWaveformStats<float> waveformStats;
     
-    // Get the truncated sum
-    float truncRms = std::inner_product(locWaveform.begin(), locWaveform.begin() + minNumBins, locWaveform.begin(), 0.);
-    
-    truncRms = std::sqrt(std::max(0.,truncRms / double(minNumBins)));
-    
-    return truncRms;
+    return waveformStats.truncatedRMS(waveform, fTruncRMSThreshold, fTruncRMSMinFraction);
 }
     
 float Decon1DROI::fixTheFreakingWaveform(const std::vector<float>& waveform, raw::ChannelID_t channel, std::vector<float>& fixedWaveform) const
 {
-    // do rms calculation - the old fashioned way and over all adc values
-    std::vector<float> locWaveform = waveform;
-    
-    // sort in ascending order so we can truncate the sume
-    std::sort(locWaveform.begin(), locWaveform.end(),[](const auto& left, const auto& right){return std::fabs(left) < std::fabs(right);});
-    
-    // Get the mean of the waveform we're checking...
-    float sumWaveform  = std::accumulate(locWaveform.begin(),locWaveform.begin() + locWaveform.size()/2, 0.);
-    float meanWaveform = sumWaveform / float(locWaveform.size()/2);
-    
-    std::vector<float> locWaveformDiff(locWaveform.size()/2);
-    
-    std::transform(locWaveform.begin(),locWaveform.begin() + locWaveform.size()/2,locWaveformDiff.begin(), std::bind(std::minus<float>(),std::placeholders::_1,meanWaveform));
-    
-    float localRMS = std::inner_product(locWaveformDiff.begin(), locWaveformDiff.end(), locWaveformDiff.begin(), 0.);
-    
-    localRMS = std::sqrt(std::max(float(0.),localRMS / float(locWaveformDiff.size())));
+    // scratch buffers are per thread, since channels are processed concurrently
+    thread_local icarus::RobustWaveformStats<float> waveformStats;
     
-    float threshold = 6. * localRMS;
+    // baseline from the samples within 6 "local" RMS of the smaller half of the waveform
+    auto const baseline = waveformStats.lowMagnitudeBaseline(waveform, 6., fTruncRMSMinFraction);
     
-    std::vector<float>::iterator threshItr = std::find_if(locWaveform.begin(),locWaveform.end(),[threshold](const auto& val){return std::fabs(val) > threshold;});
-    
-    int minNumBins = std::max(int(fTruncRMSMinFraction * locWaveform.size()),int(std::distance(locWaveform.begin(),threshItr)));
-    
-    // recalculate the mean
-    float aveSum      = std::accumulate(locWaveform.begin(), locWaveform.begin() + minNumBins, 0.);
-    float newPedestal = aveSum / minNumBins;
-    
-    // recalculate the rms
-    locWaveformDiff.resize(minNumBins);
-    
-    std::transform(locWaveform.begin(),locWaveform.begin() + minNumBins,locWaveformDiff.begin(), std::bind(std::minus<float>(),std::placeholders::_1,newPedestal));
-    
-    localRMS = std::inner_product(locWaveform.begin(), locWaveform.begin() + minNumBins, locWaveform.begin(), 0.);
-    localRMS = std::sqrt(std::max(float(0.),localRMS / float(minNumBins)));
+    float newPedestal = baseline.pedestal;
+    float localRMS    = baseline.RMS;
     
     // Set the waveform to the new baseline
     std::transform(waveform.begin(), waveform.end(), fixedWaveform.begin(), [newPedestal](const auto& val){return val - newPedestal;});
@@ -412,7 +394,7 @@ float Decon1DROI::fixTheFreakingWaveform(const std::vector<float>& waveform, raw
         fPedestalOffsetVec[plane]->Fill(newPedestal,1.);
 //        fFullRMSVec[plane]->Fill(fullRMS, 1.);
         fTruncRMSVec[plane]->Fill(localRMS, 1.);
-        fNumTruncBinsVec[plane]->Fill(minNumBins, 1.);
+        fNumTruncBinsVec[plane]->Fill(baseline.nSamples, 1.);
         fPedByChanVec[plane]->Fill(wire, newPedestal, 1.);
         fTruncRMSByChanVec[plane]->Fill(wire, localRMS, 1.);
     }
@@ -423,9 +405,7 @@ float Decon1DROI::fixTheFreakingWaveform(const std::vector<float>& waveform, raw
 void  Decon1DROI::processChannel(size_t                                  idx,
                                  art::Event&                             event,
                                  art::Handle<std::vector<raw::RawDigit>> digitVecHandle, 
-                                 std::vector<recob::Wire>&               wireColVec, 
-                                 art::Assns<raw::RawDigit,recob::Wire>&  wireAssns,
-                                 const std::string&                      instance) const
+                                 recob::Wire&                            wire) const
 {
     // vector that will be moved into the Wire object
     recob::Wire::RegionsOfInterest_t deconVec;
@@ -545,20 +525,8 @@ void  Decon1DROI::processChannel(size_t                                  idx,
     // Don't save empty wires
     if (ROIVec.empty()) return;
 
-    // First get a lock to make sure we are clear to run
-    tbb::spin_mutex::scoped_lock lock(deconvolutionSpinMutex);
-
-    // create the new wire directly in wirecol
-    wireColVec.push_back(recob::WireCreator(std::move(ROIVec),*digitVec).move());
-
-    // add an association between the last object in wirecol
-    // (that we just inserted) and digitVec
-    if (!util::CreateAssn(event, wireColVec, digitVec, wireAssns, instance))
-    {
-        throw art::Exception(art::errors::ProductRegistrationFailure)
-            << "Can't associate wire #" << (wireColVec.size() - 1)
-            << " with raw digit #" << digitVec.key();
-    } // if failed to add association
+    // create the new wire directly in its output slot
+    wire = recob::WireCreator(std::move(ROIVec),*digitVec).move();
 
     return;
 }
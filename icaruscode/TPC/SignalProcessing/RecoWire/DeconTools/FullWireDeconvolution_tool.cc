@@ -17,6 +17,7 @@
 
 #include "art/Utilities/make_tool.h"
 #include "icarus_signal_processing/WaveformTools.h"
+#include "icaruscode/TPC/Utilities/FFTEngine.h"
 #include "icarus_signal_processing/Filters/ICARUSFFT.h"
 
 #include "TH1D.h"
@@ -45,6 +46,7 @@ public:
 private:
     
     // Member variables from the fhicl file
+    bool                                                         fUseFloatFFT;                ///< Use the single precision FFT engine
     bool                                                         fDodQdxCalib;                ///< Do we apply wire-by-wire calibration?
     std::string                                                  fdQdxCalibFileName;          ///< Text file for constants to do wire-by-wire calibration
     std::map<unsigned int, float>                                fdQdxCalib;                  ///< Map to do wire-by-wire calibration, key is channel
@@ -71,6 +73,8 @@ FullWireDeconvolution::~FullWireDeconvolution()
 void FullWireDeconvolution::configure(const fhicl::ParameterSet& pset)
 {
     // Start by recovering the parameters
+    fUseFloatFFT   = pset.get< bool >("UseFloatFFT", false);
+    
     //wire-by-wire calibration
     fDodQdxCalib   = pset.get< bool >("DodQdxCalib", false);
     
@@ -125,11 +129,8 @@ void FullWireDeconvolution::Deconvolve(IROIFinder::Waveform const&        wavefo
     // The size of the input waveform **should** be the raw buffer size
     size_t dataSize = waveform.size();
     
-    // Make sure the deconvolution size is set correctly (this will probably be a noop after first call)
-    fSignalShaping->SetDecon(samplingRate, dataSize, channel);
-    
     // now make a buffer to contain the waveform which will be of the right size
-    icarusutil::TimeVec rawAdcLessPedVec(dataSize,0.);
+    std::vector<float> rawAdcLessPedVec(dataSize,0.);
     
     size_t binOffset    = 0; //transformSize > dataSize ? (transformSize - dataSize) / 2 : 0;
     float  deconNorm       = fSignalShaping->GetDeconNorm();
@@ -140,7 +141,21 @@ void FullWireDeconvolution::Deconvolve(IROIFinder::Waveform const&        wavefo
     std::copy(waveform.begin(),waveform.end(),rawAdcLessPedVec.begin()+binOffset);
     
     // Strategy is to run deconvolution on the entire channel and then pick out the ROI's we found above
-    fFFT->deconvolute(rawAdcLessPedVec, fSignalShaping->GetResponse(channel).getDeconvKernel(), fSignalShaping->ResponseTOffset(channel));
+    if (fUseFloatFFT)
+    {
+        icarusutil::FFTEngine<float>::deconvolute(rawAdcLessPedVec, fSignalShaping->GetDeconvKernel(channel, dataSize), fSignalShaping->ResponseTOffset(channel));
+    }
+    else
+    {
+        // Make sure the deconvolution size is set correctly (this will probably be a noop after first call)
+        fSignalShaping->SetDecon(samplingRate, dataSize, channel);
+        
+        icarusutil::TimeVec deconVec(rawAdcLessPedVec.begin(), rawAdcLessPedVec.end());
+        
+        fFFT->deconvolute(deconVec, fSignalShaping->GetResponse(channel).getDeconvKernel(), fSignalShaping->ResponseTOffset(channel));
+        
+        std::copy(deconVec.begin(), deconVec.end(), rawAdcLessPedVec.begin());
+    }
     
     std::vector<float> holder;
 
@@ -16,10 +16,12 @@
 #include "icaruscode/TPC/Utilities/SignalShapingICARUSService_service.h"
 
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IBaseline.h"
+#include "icaruscode/TPC/Utilities/FFTEngine.h"
 #include "icarus_signal_processing/Filters/ICARUSFFT.h"
 
 #include "TH1D.h"
 
+#include <algorithm>
 #include <fstream>
 
 namespace icarus_tool
@@ -42,8 +44,29 @@ public:
                     recob::Wire::RegionsOfInterest_t& )    const override;
     
 private:
+    // Placement of a candidate ROI in the deconvolution buffer
+    struct ROIPlacement
+    {
+        size_t firstOffset;  ///< Offset into the ADC vector of buffer start
+        size_t secondOffset; ///< Offset into the ADC vector of buffer end
+        size_t roiStart;     ///< Start in the buffer of the ROI
+        size_t roiStop;      ///< Stop in the buffer of the ROI
+    };
+    
+    ROIPlacement placeROI(IROIFinder::CandidateROI const&, size_t waveformSize) const;
+    
+    // Normalizes, baseline subtracts and calibrates the deconvolved ROI, then stores it
+    void storeROI(std::vector<float>&&, raw::ChannelID_t, size_t roiFirst, double deconNorm, recob::Wire::RegionsOfInterest_t&) const;
+    
+    // Deconvolution of all the ROI of the channel in single precision with a cached kernel
+    void DeconvolveFloat(const IROIFinder::Waveform&,
+                         raw::ChannelID_t,
+                         IROIFinder::CandidateROIVec const&,
+                         recob::Wire::RegionsOfInterest_t& ) const;
+    
     // Member variables from the fhicl file
     size_t                                                     fFFTSize;                    ///< FFT size for ROI deconvolution
+    bool                                                       fUseFloatFFT;                ///< Use the single precision FFT engine
     bool                                                       fDodQdxCalib;                ///< Do we apply wire-by-wire calibration?
     std::string                                                fdQdxCalibFileName;          ///< Text file for constants to do wire-by-wire calibration
     std::map<unsigned int, float>                              fdQdxCalib;                  ///< Map to do wire-by-wire calibration, key is channel
@@ -71,6 +94,7 @@ void ROIDeconvolution::configure(const fhicl::ParameterSet& pset)
 {
     // Start by recovering the parameters
     fFFTSize    = pset.get< size_t >("FFTSize"                );
+    fUseFloatFFT = pset.get< bool  >("UseFloatFFT",      false);
     
     //wire-by-wire calibration
     fDodQdxCalib = pset.get< bool >("DodQdxCalib", false);
@@ -122,6 +146,12 @@ void ROIDeconvolution::Deconvolve(const IROIFinder::Waveform&        waveform,
                                   IROIFinder::CandidateROIVec const& roiVec,
                                   recob::Wire::RegionsOfInterest_t&  ROIVec) const
 {
+    if (fUseFloatFFT)
+    {
+        DeconvolveFloat(waveform, channel, roiVec, ROIVec);
+        return;
+    }
+    
     double deconNorm = fSignalShaping->GetDeconNorm();
 
     // And now process them
@@ -150,45 +180,12 @@ void ROIDeconvolution::Deconvolve(const IROIFinder::Waveform&        waveform,
         // Pad with zeroes if the deconvolution buffer is larger than the input waveform
         if (deconSize > waveform.size()) deconVec.resize(deconSize, 0.);
         
-        // Watch for the case where the input ROI is long enough to want an deconvolution buffer that is
-        // larger than the input waveform.
-        size_t maxActualSize = std::min(deconSize, waveform.size());
+        ROIPlacement const placement = placeROI(roi, waveform.size());
         
-        // Extend the ROI to accommodate the extra bins for the FFT
-        // The idea is to try to center the desired ROI in the buffer used by deconvolution
-        size_t halfLeftOver = (maxActualSize - roiLen) / 2;           // Number bins either side of ROI
-        int    roiStartInt  = halfLeftOver;                           // Start in the buffer of the ROI
-        int    roiStopInt   = halfLeftOver + roiLen;                  // Stop in the buffer of the ROI
-        int    firstOffset  = roi.first - halfLeftOver;               // Offset into the ADC vector of buffer start
-        int    secondOffset = roi.second + halfLeftOver + roiLen % 2; // Offset into the ADC vector of buffer end
-        
-        // Check for the two edge conditions - starting before the ADC vector or running off the end
-        // In either case we shift the actual roi within the FFT buffer
-        // First is the case where we would be starting before the ADC vector
-        if (firstOffset < 0)
-        {
-            roiStartInt  += firstOffset;  // remember that firstOffset is negative
-            roiStopInt   += firstOffset;
-            secondOffset -= firstOffset;
-            firstOffset   = 0;
-        }
-        // Second is the case where we would overshoot the end
-        else if (size_t(secondOffset) > waveform.size())
-        {
-            size_t overshoot = secondOffset - waveform.size();
-            
-            roiStartInt  += overshoot;
-            roiStopInt   += overshoot;
-            firstOffset  -= overshoot;
-            secondOffset  = waveform.size();
-        }
-        
-        size_t roiStart(roiStartInt);
-        size_t roiStop(roiStopInt);
         size_t holderOffset = 0; //deconSize > waveform.size() ? (deconSize - waveform.size()) / 2 : 0;
         
         // Fill the buffer and do the deconvolution
-        std::copy(waveform.begin()+firstOffset, waveform.begin()+secondOffset, deconVec.begin() + holderOffset);
+        std::copy(waveform.begin()+placement.firstOffset, waveform.begin()+placement.secondOffset, deconVec.begin() + holderOffset);
         
         // Deconvolute the raw signal using the channel's nominal response
         fFFT->deconvolute(deconVec, fSignalShaping->GetResponse(channel).getDeconvKernel(), fSignalShaping->ResponseTOffset(channel));
@@ -196,34 +193,139 @@ void ROIDeconvolution::Deconvolve(const IROIFinder::Waveform&        waveform,
         std::vector<float>  holder(deconVec.size());
         
         // Get rid of the leading and trailing "extra" bins needed to keep the FFT happy
-        if (roiStart > 0 || holderOffset > 0) std::copy(deconVec.begin() + holderOffset + roiStart, deconVec.begin() + holderOffset + roiStop, holder.begin());
+        if (placement.roiStart > 0 || holderOffset > 0) std::copy(deconVec.begin() + holderOffset + placement.roiStart, deconVec.begin() + holderOffset + placement.roiStop, holder.begin());
         
         // Resize the holder to the ROI length
         holder.resize(roiLen);
        
-        // "normalize" the vector
-        std::transform(holder.begin(),holder.end(),holder.begin(),[deconNorm](auto& deconVal){return deconVal/deconNorm;});
+        storeROI(std::move(holder), channel, roi.first, deconNorm, ROIVec);
+    } // loop over candidate roi's
+    
+    return;
+}
+    
+void ROIDeconvolution::DeconvolveFloat(const IROIFinder::Waveform&        waveform,
+                                       raw::ChannelID_t                   channel,
+                                       IROIFinder::CandidateROIVec const& roiVec,
+                                       recob::Wire::RegionsOfInterest_t&  ROIVec) const
+{
+    if (roiVec.empty()) return;
+    
+    double deconNorm = fSignalShaping->GetDeconNorm();
+    
+    // All the ROI use the same buffer size, so they are deconvolved in one batch
+    // with the kernel cached by the signal shaping service for this size
+    std::vector<ROIPlacement> placements;
+    placements.reserve(roiVec.size());
+    
+    std::vector<float> deconBuffer(roiVec.size() * fFFTSize, 0.);
+    
+    for(size_t roiIdx = 0; roiIdx < roiVec.size(); roiIdx++)
+    {
+        placements.push_back(placeROI(roiVec[roiIdx], waveform.size()));
+        
+        ROIPlacement const& placement = placements.back();
+        
+        // protect the next buffer from ROI longer than the transform
+        size_t copySize = std::min(placement.secondOffset - placement.firstOffset, fFFTSize);
+        
+        std::copy(waveform.begin()+placement.firstOffset, waveform.begin()+placement.firstOffset+copySize, deconBuffer.begin() + roiIdx * fFFTSize);
+    }
+    
+    icarusutil::FFTEngine<float>::deconvolute(deconBuffer.data(), fFFTSize, roiVec.size(), fSignalShaping->GetDeconvKernel(channel, fFFTSize), fSignalShaping->ResponseTOffset(channel));
+    
+    for(size_t roiIdx = 0; roiIdx < roiVec.size(); roiIdx++)
+    {
+        auto const&         roi       = roiVec[roiIdx];
+        ROIPlacement const& placement = placements[roiIdx];
+        size_t              roiLen    = roi.second - roi.first;
         
-        // Now we do the baseline determination and correct the ROI
-        //float base = fBaseline->GetBaseline(holder, channel, roiStart, roiLen);
-        float base = fBaseline->GetBaseline(holder, channel, 0, roiLen);
+        // same treatment as the double precision deconvolution
+        std::vector<float> holder(roiLen, 0.);
+        
+        if (placement.roiStart > 0)
+        {
+            auto roiItr = deconBuffer.begin() + roiIdx * fFFTSize + placement.roiStart;
+            
+            std::copy(roiItr, roiItr + std::min(roiLen, fFFTSize - std::min(placement.roiStart, fFFTSize)), holder.begin());
+        }
         
-        std::transform(holder.begin(),holder.end(),holder.begin(),[base](const auto& adcVal){return adcVal - base;});
+        storeROI(std::move(holder), channel, roi.first, deconNorm, ROIVec);
+    }
+    
+    return;
+}
+    
+ROIDeconvolution::ROIPlacement ROIDeconvolution::placeROI(IROIFinder::CandidateROI const& roi, size_t waveformSize) const
+{
+    size_t roiLen = roi.second - roi.first;
+    
+    // Watch for the case where the input ROI is long enough to want an deconvolution buffer that is
+    // larger than the input waveform.
+    size_t maxActualSize = std::min(fFFTSize, waveformSize);
+    
+    // Extend the ROI to accommodate the extra bins for the FFT
+    // The idea is to try to center the desired ROI in the buffer used by deconvolution
+    size_t halfLeftOver = (maxActualSize - roiLen) / 2;           // Number bins either side of ROI
+    int    roiStartInt  = halfLeftOver;                           // Start in the buffer of the ROI
+    int    roiStopInt   = halfLeftOver + roiLen;                  // Stop in the buffer of the ROI
+    int    firstOffset  = roi.first - halfLeftOver;               // Offset into the ADC vector of buffer start
+    int    secondOffset = roi.second + halfLeftOver + roiLen % 2; // Offset into the ADC vector of buffer end
+    
+    // Check for the two edge conditions - starting before the ADC vector or running off the end
+    // In either case we shift the actual roi within the FFT buffer
+    // First is the case where we would be starting before the ADC vector
+    if (firstOffset < 0)
+    {
+        roiStartInt  += firstOffset;  // remember that firstOffset is negative
+        roiStopInt   += firstOffset;
+        secondOffset -= firstOffset;
+        firstOffset   = 0;
+    }
+    // Second is the case where we would overshoot the end
+    else if (size_t(secondOffset) > waveformSize)
+    {
+        size_t overshoot = secondOffset - waveformSize;
         
-        // apply wire-by-wire calibration
-        if (fDodQdxCalib)
+        roiStartInt  += overshoot;
+        roiStopInt   += overshoot;
+        firstOffset  -= overshoot;
+        secondOffset  = waveformSize;
+    }
+    
+    return {size_t(firstOffset), size_t(secondOffset), size_t(roiStartInt), size_t(roiStopInt)};
+}
+    
+void ROIDeconvolution::storeROI(std::vector<float>&&             holder,
+                                raw::ChannelID_t                 channel,
+                                size_t                           roiFirst,
+                                double                           deconNorm,
+                                recob::Wire::RegionsOfInterest_t& ROIVec) const
+{
+    size_t roiLen = holder.size();
+    
+    // "normalize" the vector
+    std::transform(holder.begin(),holder.end(),holder.begin(),[deconNorm](auto& deconVal){return deconVal/deconNorm;});
+    
+    // Now we do the baseline determination and correct the ROI
+    //float base = fBaseline->GetBaseline(holder, channel, roiStart, roiLen);
+    float base = fBaseline->GetBaseline(holder, channel, 0, roiLen);
+    
+    std::transform(holder.begin(),holder.end(),holder.begin(),[base](const auto& adcVal){return adcVal - base;});
+    
+    // apply wire-by-wire calibration
+    if (fDodQdxCalib)
+    {
+        if(fdQdxCalib.find(channel) != fdQdxCalib.end())
         {
-            if(fdQdxCalib.find(channel) != fdQdxCalib.end())
-            {
-                float constant = fdQdxCalib.at(channel);
-                
-                for (size_t iholder = 0; iholder < holder.size(); ++iholder) holder[iholder] *= constant;
-            }
+            float constant = fdQdxCalib.at(channel);
+            
+            for (size_t iholder = 0; iholder < holder.size(); ++iholder) holder[iholder] *= constant;
         }
+    }
 
-        // add the range into ROIVec
-        ROIVec.add_range(roi.first, std::move(holder));
-    } // loop over candidate roi's
+    // add the range into ROIVec
+    ROIVec.add_range(roiFirst, std::move(holder));
     
     return;
 }
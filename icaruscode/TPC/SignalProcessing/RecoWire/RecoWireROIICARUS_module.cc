@@ -53,6 +53,7 @@
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IROIFinder.h"
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IDeconvolution.h"
 #include "icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/IBaseline.h"
+#include "icaruscode/TPC/Utilities/RobustWaveformStats.h"
 #include "icarus_signal_processing/WaveformTools.h"
 
 ///creation of calibrated signals on wires
@@ -94,6 +95,7 @@ class RecoWireROIICARUS : public art::EDProducer
     std::unique_ptr<icarus_tool::IDeconvolution>            fDeconvolution;
 
     icarus_signal_processing::WaveformTools<float>          fWaveformTool;
+    mutable icarus::RobustWaveformStats<float>              fWaveformStats;              ///< Truncated RMS estimation (reuses buffers)
     
     const geo::GeometryCore*                                fGeometry = lar::providerFrom<geo::Geometry>();
     
@@ -353,24 +355,7 @@ void RecoWireROIICARUS::produce(art::Event& evt)
     
 float RecoWireROIICARUS::getTruncatedRMS(const std::vector<float>& waveform) const
 {
-    // do rms calculation - the old fashioned way and over all adc values
-    std::vector<float> locWaveform = waveform;
-    
-    // sort in ascending order so we can truncate the sume
-    std::sort(locWaveform.begin(), locWaveform.end(),[](const auto& left, const auto& right){return std::fabs(left) < std::fabs(right);});
-    
-    float threshold = fTruncRMSThreshold;
-    
-    std::vector<float>::iterator threshItr = std::find_if(locWaveform.begin(),locWaveform.end(),[threshold](const auto& val){return std::fabs(val) > threshold;});
-    
-    int minNumBins = std::max(int(fTruncRMSMinFraction * locWaveform.size()),int(std::distance(locWaveform.begin(),threshItr)));
-    
-    // Get the truncated sum
-    float truncRms = std::inner_product(locWaveform.begin(), locWaveform.begin() + minNumBins, locWaveform.begin(), 0.);
-    
-    truncRms = std::sqrt(std::max(0.,truncRms / double(minNumBins)));
-    
-    return truncRms;
+    return fWaveformStats.truncatedRMS(waveform, fTruncRMSThreshold, fTruncRMSMinFraction);
 }
     
 float RecoWireROIICARUS::fixTheFreakingWaveform(const std::vector<float>& waveform, raw::ChannelID_t channel, std::vector<float>& fixedWaveform)
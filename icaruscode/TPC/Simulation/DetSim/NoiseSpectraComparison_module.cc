@@ -0,0 +1,211 @@
+///////////////////////////////////////////////////////////////////////
+//
+// NoiseSpectraComparison class designed to validate a noise generation
+// tool (e.g. the NoiseLibrary one) against a reference tool (e.g. the
+// SBNDataNoise one, generating the noise on the fly).
+//
+// Both tools generate the same number of waveforms for the wires of a
+// chosen plane; the average power spectra and the RMS distributions are
+// stored in histograms and their ratio is summarized at the end of the
+// job, together with the time spent in each tool.
+//
+////////////////////////////////////////////////////////////////////////
+
+// C/C++ standard library
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+// CLHEP libraries
+#include "CLHEP/Random/MixMaxRng.h"
+// ROOT libraries
+#include "TH1D.h"
+#include "TProfile.h"
+// Eigen
+#include <Eigen/Core>
+#include <unsupported/Eigen/FFT>
+// art library and utilities
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "art_root_io/TFileService.h"
+#include "art_root_io/TFileDirectory.h"
+#include "art/Utilities/make_tool.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "cetlib/cpu_timer.h"
+// LArSoft libraries
+#include "larcore/CoreUtils/ServiceUtil.h"
+#include "larcore/Geometry/Geometry.h"
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
+#include "lardata/DetectorInfoServices/DetectorClocksService.h"
+#include "tools/IGenNoise.h"
+
+namespace detsim {
+
+class NoiseSpectraComparison : public art::EDAnalyzer
+{
+public:
+
+    explicit NoiseSpectraComparison(fhicl::ParameterSet const& pset);
+
+    void analyze(const art::Event& evt) override;
+    void beginJob() override;
+    void endJob() override;
+
+private:
+
+    // What we keep for each of the tools being compared
+    struct NoiseGenerator
+    {
+        std::string                              name;
+        std::unique_ptr<icarus_tool::IGenNoise> tool;
+        CLHEP::MixMaxRng                         uncNoiseEngine;
+        CLHEP::MixMaxRng                         corNoiseEngine;
+        cet::cpu_timer                           clock;
+        TProfile*                                powerSpectrum = nullptr;
+        TH1D*                                    rmsHist       = nullptr;
+    };
+
+    std::vector<NoiseGenerator>  fGeneratorVec;      ///< Reference tool first, then the tool to test
+    geo::PlaneID                 fPlaneID;           ///< Plane whose wires are simulated
+    size_t                       fNumWaveforms;      ///< Number of waveforms per tool and event
+    double                       fNoiseFactor;       ///< Noise factor passed to the tools
+    size_t                       fNTimeSamples;      ///< Number of ticks in each waveform
+    TH1D*                        fRatioHist = nullptr;
+
+    Eigen::FFT<double>           fEigenFFT;
+};
+
+DEFINE_ART_MODULE(NoiseSpectraComparison)
+
+//-------------------------------------------------
+NoiseSpectraComparison::NoiseSpectraComparison(fhicl::ParameterSet const& pset)
+    : EDAnalyzer{pset}
+{
+    fPlaneID      = geo::PlaneID(pset.get<unsigned int>("Cryostat", 0), pset.get<unsigned int>("TPC", 0), pset.get<unsigned int>("Plane", 2));
+    fNumWaveforms = pset.get<size_t>("NumWaveforms", 100);
+    fNoiseFactor  = pset.get<double>("NoiseFactor",  1.);
+
+    long seed = pset.get<long>("Seed", 12345);
+
+    fGeneratorVec.resize(2);
+
+    fGeneratorVec[0].name = "Reference";
+    fGeneratorVec[0].tool = art::make_tool<icarus_tool::IGenNoise>(pset.get<fhicl::ParameterSet>("ReferenceNoiseTool"));
+    fGeneratorVec[1].name = "Test";
+    fGeneratorVec[1].tool = art::make_tool<icarus_tool::IGenNoise>(pset.get<fhicl::ParameterSet>("TestNoiseTool"));
+
+    // Both tools get engines of their own, seeded here
+    for(auto& generator : fGeneratorVec)
+    {
+        generator.tool->useExternalSeeds();
+        generator.uncNoiseEngine.setSeed(seed++, 0);
+        generator.corNoiseEngine.setSeed(seed++, 0);
+    }
+
+    auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob();
+    fNTimeSamples = detProp.NumberTimeSamples();
+}
+//-------------------------------------------------
+void NoiseSpectraComparison::beginJob()
+{
+    art::ServiceHandle<art::TFileService> tfs;
+
+    size_t numFreqBins = fNTimeSamples / 2;
+
+    for(auto& generator : fGeneratorVec)
+    {
+        generator.powerSpectrum = tfs->make<TProfile>(("PowerSpectrum" + generator.name).c_str(), ";Frequency bin;Power", numFreqBins, 0., numFreqBins);
+        generator.rmsHist       = tfs->make<TH1D>(("RMS" + generator.name).c_str(), ";RMS (ADC)", 200, 0., 20.);
+    }
+
+    fRatioHist = tfs->make<TH1D>("PowerRatio", ";Frequency bin;Test/Reference", numFreqBins, 0., numFreqBins);
+
+    return;
+}
+//-------------------------------------------------
+void NoiseSpectraComparison::analyze(const art::Event& evt)
+{
+    auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(evt);
+
+    const geo::GeometryCore& geometry = *lar::providerFrom<geo::Geometry>();
+
+    unsigned int numWires = geometry.Nwires(fPlaneID);
+
+    icarusutil::TimeVec               noise(fNTimeSamples, 0.);
+    std::vector<std::complex<double>> spectrum;
+
+    for(auto& generator : fGeneratorVec)
+    {
+        generator.tool->nextEvent();
+
+        for(size_t waveIdx = 0; waveIdx < fNumWaveforms; waveIdx++)
+        {
+            // Spread the waveforms over the plane, so several boards are involved
+            unsigned int wire  = (waveIdx * 97) % numWires;
+            unsigned int board = wire / 32;
+
+            generator.clock.start();
+            generator.tool->generateNoise(generator.uncNoiseEngine, generator.corNoiseEngine, noise, detProp, fNoiseFactor, fPlaneID, board);
+            generator.clock.stop();
+
+            double sumSq = std::inner_product(noise.begin(), noise.end(), noise.begin(), 0.);
+
+            generator.rmsHist->Fill(std::sqrt(sumSq / noise.size()));
+
+            fEigenFFT.fwd(spectrum, noise);
+
+            for(size_t freqIdx = 0; freqIdx < fNTimeSamples / 2; freqIdx++)
+                generator.powerSpectrum->Fill(freqIdx, std::norm(spectrum[freqIdx]) / noise.size());
+        }
+    }
+
+    return;
+}
+//-------------------------------------------------
+void NoiseSpectraComparison::endJob()
+{
+    const NoiseGenerator& reference = fGeneratorVec[0];
+    const NoiseGenerator& test      = fGeneratorVec[1];
+
+    // Compare the average power in each frequency bin, in units of its statistical error
+    double maxPull(0.);
+    double sumPull2(0.);
+    int    numBins(0);
+
+    for(int bin = 1; bin <= fRatioHist->GetNbinsX(); bin++)
+    {
+        double refPower  = reference.powerSpectrum->GetBinContent(bin);
+        double testPower = test.powerSpectrum->GetBinContent(bin);
+        double error     = std::hypot(reference.powerSpectrum->GetBinError(bin), test.powerSpectrum->GetBinError(bin));
+
+        if (refPower > 0.) fRatioHist->SetBinContent(bin, testPower / refPower);
+
+        if (error > 0.)
+        {
+            double pull = (testPower - refPower) / error;
+
+            maxPull   = std::max(maxPull, std::abs(pull));
+            sumPull2 += pull * pull;
+            numBins++;
+        }
+    }
+
+    mf::LogInfo("NoiseSpectraComparison")
+        << "Noise spectra comparison for " << fPlaneID << ":\n"
+        << "  RMS " << reference.name << ": " << reference.rmsHist->GetMean() << " +/- " << reference.rmsHist->GetRMS()
+        << ", " << test.name << ": " << test.rmsHist->GetMean() << " +/- " << test.rmsHist->GetRMS() << "\n"
+        << "  power spectrum chi2/ndf: " << (numBins > 0 ? sumPull2 / numBins : 0.) << " over " << numBins << " bins, largest pull: " << maxPull << "\n"
+        << "  time spent generating: " << reference.name << " " << reference.clock.accumulated_real_time() << " s, "
+        << test.name << " " << test.clock.accumulated_real_time() << " s";
+
+    return;
+}
+
+}
@@ -18,10 +18,16 @@
 #include <functional>
 #include <random>
 #include <chrono>
+#include <cstdint>
+#include <iterator> // std::back_inserter()
+// TBB
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 // CLHEP libraries
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandGaussQ.h"
 #include "CLHEP/Random/JamesRandom.h"
+#include "CLHEP/Random/MixMaxRng.h"
 // ROOT libraries
 #include "TMath.h"
 #include "TComplex.h"
@@ -54,6 +60,7 @@
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "icaruscode/TPC/Utilities/SignalShapingICARUSService_service.h"
+#include "icaruscode/Utilities/EventStreamSeeding.h"
 #include "lardataobj/Simulation/sim.h"
 #include "larevt/CalibrationDBI/Interface/DetPedestalService.h"
 #include "larevt/CalibrationDBI/Interface/DetPedestalProvider.h"
@@ -82,10 +89,37 @@ public:
     
 private:
     
+    using NoiseToolVec = std::vector<std::unique_ptr<icarus_tool::IGenNoise>>;
+    using FFTPointer   = std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>>;
+
+    // The per event information shared by all channels
+    struct EventInfo
+    {
+        const lariov::DetPedestalProvider&         pedestals;
+        const lariov::ChannelStatusProvider&       channelStatus;
+        const detinfo::DetectorClocksData&         clockData;
+        const detinfo::DetectorPropertiesData&     detProp;
+        const std::vector<const sim::SimChannel*>& simChannels;
+    };
+
+    // The charge of a collection plane digit, for the histograms
+    using WireChargePair = std::pair<unsigned int, short>;
+
+    void SimulateBoard(raw::ChannelID_t                 mb,
+                       const EventInfo&                 eventInfo,
+                       CLHEP::HepRandomEngine&          pedestalEngine,
+                       CLHEP::HepRandomEngine&          uncNoiseEngine,
+                       CLHEP::HepRandomEngine&          corNoiseEngine,
+                       const NoiseToolVec&              noiseToolVec,
+                       icarus_signal_processing::ICARUSFFT<double>& fft,
+                       std::vector<raw::RawDigit>&      digitVec,
+                       std::vector<WireChargePair>&     wireChargeVec) const;
+
     void MakeADCVec(std::vector<short>& adc, icarusutil::TimeVec const& noise,
                     icarusutil::TimeVec const& charge, float ped_mean) const;
 
     using TPCIDVec  = std::vector<geo::TPCID>;
+    using MBVec     = std::vector<raw::ChannelID_t>;
     
     art::InputTag                fDriftEModuleLabel; ///< module making the ionization electrons
     std::string                  fOutInstanceLabel;  ///< The label to apply to the output data product
@@ -100,8 +134,9 @@ private:
     bool                         fSuppressNoSignal;  ///< If no signal on wire (simchannel) then suppress the channel
     bool                         fSmearPedestals;    ///< If True then we smear the pedestals
     int                          fNumChanPerMB;      ///< Number of channels per motherboard
+    bool                         fMultiThreaded;     ///< If true, simulate the motherboards in parallel
     
-    std::vector<std::unique_ptr<icarus_tool::IGenNoise>> fNoiseToolVec; ///< Tool for generating noise
+    std::vector<NoiseToolVec>    fNoiseToolVecs;     ///< Tools for generating noise, one set per thread
     
     bool                         fMakeHistograms;
     bool                         fTest; // for forcing a test case
@@ -133,8 +168,7 @@ private:
         size_t m_time;
     };
 
-    using FFTPointer = std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>>;
-    FFTPointer                              fFFT;                   //< Object to handle thread safe FFT
+    std::vector<FFTPointer>                 fFFTVec;                //< Objects to handle the FFT, one per thread
     
     //services
     const geo::GeometryCore&                fGeometry;
@@ -174,6 +208,7 @@ void SimWireICARUS::reconfigure(fhicl::ParameterSet const& p)
     fMakeHistograms    = p.get< bool                >("MakeHistograms",                     false);
     fSmearPedestals    = p.get< bool                >("SmearPedestals",                      true);
     fNumChanPerMB      = p.get< int                 >("NumChanPerMB",                          32);
+    fMultiThreaded     = p.get< bool                >("MultiThreaded",                      false);
     fTest              = p.get< bool                >("Test",                               false);
     fTestWire          = p.get< size_t              >("TestWire",                               0);
     fTestIndex         = p.get< std::vector<size_t> >("TestIndex",          std::vector<size_t>());
@@ -194,8 +229,30 @@ void SimWireICARUS::reconfigure(fhicl::ParameterSet const& p)
     
     std::vector<fhicl::ParameterSet> noiseToolParamSetVec = p.get<std::vector<fhicl::ParameterSet>>("NoiseGenToolVec");
     
-    for(auto& noiseToolParams : noiseToolParamSetVec) {
-        fNoiseToolVec.push_back(art::make_tool<icarus_tool::IGenNoise>(noiseToolParams));
+    // In multithreaded mode each thread gets its own set of noise tools (and FFT), since these keep work areas.
+    // The random engines are then seeded by board, so the tools must not reseed them.
+    // Only the first set books histograms and gets nextEvent(), the others follow it
+    int max_concurrency = fMultiThreaded ? tbb::this_task_arena::max_concurrency() : 1;
+    
+    mf::LogDebug("SimWireICARUS") << "     ==> concurrency: " << max_concurrency << std::endl;
+    
+    fNoiseToolVecs.resize(max_concurrency);
+    
+    for(auto& noiseToolVec : fNoiseToolVecs)
+    {
+        for(auto noiseToolParams : noiseToolParamSetVec) {
+            if (&noiseToolVec != &fNoiseToolVecs.front()) noiseToolParams.put_or_replace("StoreHistograms", false);
+            
+            noiseToolVec.push_back(art::make_tool<icarus_tool::IGenNoise>(noiseToolParams));
+            
+            if (!fMultiThreaded) continue;
+            
+            if (!noiseToolVec.back()->supportsMultiThreading())
+                throw cet::exception("SimWireICARUS") << "Noise tool '" << noiseToolParams.get<std::string>("tool_type")
+                                                      << "' does not support MultiThreaded (it does not only use the engines it is given)\n";
+            
+            noiseToolVec.back()->useExternalSeeds();
+        }
     }
     //Map the Shaping Times to the entry position for the noise ADC
     //level in fNoiseFactInd and fNoiseFactColl
@@ -207,7 +264,9 @@ void SimWireICARUS::reconfigure(fhicl::ParameterSet const& p)
     
     fSignalShapingService = art::ServiceHandle<icarusutil::SignalShapingICARUSService>{}.get();
 
-    fFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(fNTimeSamples);
+    fFFTVec.resize(max_concurrency);
+    
+    for(auto& fft : fFFTVec) fft = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(fNTimeSamples);
     
     return;
 }
@@ -291,27 +350,18 @@ void SimWireICARUS::produce(art::Event& evt)
     // digits to be transferred to the art::Event after the put statement below
     std::unique_ptr< std::vector<raw::RawDigit>> digcol(new std::vector<raw::RawDigit>);
     digcol->reserve(maxChannel);
-    //--------------------------------------------------------------------
-    //
-    // Loop over channels a second time and produce the RawDigits by adding together
-    // pedestal, noise, and direct & induced charges
-    //
-    //--------------------------------------------------------------------
-    
-    // vectors for working in the following for loop
-    std::vector<short>  adcvec(fNTimeSamples, 0);
-    icarusutil::TimeVec chargeWork(fNTimeSamples,0.);
-    icarusutil::TimeVec zeroCharge(fNTimeSamples,0.);
-    icarusutil::TimeVec noisetmp(fNTimeSamples,0.);
-    
-    // make sure chargeWork is correct size
-    if (chargeWork.size() < fNTimeSamples) throw std::range_error("SimWireICARUS: chargeWork vector too small");
     
     //detector properties information
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(evt);
     
-    // Let the tools know to update to the next event
-    for(const auto& noiseTool : fNoiseToolVec) noiseTool->nextEvent();
+    // Let the tools know to update to the next event; the copies of the other threads take the new state from the first set
+    for(const auto& noiseTool : fNoiseToolVecs.front()) noiseTool->nextEvent();
+    
+    for(size_t setIdx = 1; setIdx < fNoiseToolVecs.size(); setIdx++)
+    {
+        for(size_t toolIdx = 0; toolIdx < fNoiseToolVecs[setIdx].size(); toolIdx++)
+            fNoiseToolVecs[setIdx][toolIdx]->copyEventState(*fNoiseToolVecs.front()[toolIdx]);
+    }
 
     // The original implementation would allow the option to skip channels for which there was no MC signal
     // present. We want to update this so that if there is an MC signal on any wire in a common group (a
@@ -365,124 +415,203 @@ void SimWireICARUS::produce(art::Event& evt)
         }
     }
     
-    // Ok, now we can simply loop over MB's...
-    for(const auto& mb : mbWithSignalSet)
+    //--------------------------------------------------------------------
+    //
+    // Loop over the motherboards and produce the RawDigits of their channels
+    // by adding together pedestal, noise, and direct & induced charges
+    //
+    //--------------------------------------------------------------------
+    EventInfo eventInfo{pedestalRetrievalAlg, ChannelStatusProvider, clockData, detProp, channels};
+    
+    std::vector<WireChargePair> wireChargeVec;
+
+    if (!fMultiThreaded)
     {
-        raw::ChannelID_t baseChannel = fNumChanPerMB * mb;
+        // Ok, now we can simply loop over MB's...
+        for(const auto& mb : mbWithSignalSet)
+            SimulateBoard(mb, eventInfo, fPedestalEngine, fUncNoiseEngine, fCorNoiseEngine, fNoiseToolVecs.front(), *fFFTVec.front(), *digcol, wireChargeVec);
+    }
+    else
+    {
+        // Each motherboard gets its own random streams, keyed by the event and the board number, and its
+        // own output vectors, so the result does not depend on the number of threads or on the scheduling
+        MBVec mbVec(mbWithSignalSet.begin(), mbWithSignalSet.end());
+        
+        std::vector<std::vector<raw::RawDigit>>  boardDigitVec(mbVec.size());
+        std::vector<std::vector<WireChargePair>> boardWireChargeVec(mbVec.size());
         
-        // And for a given MB we can loop over the channels it contains
-        for(raw::ChannelID_t channel = baseChannel; channel < baseChannel + fNumChanPerMB; channel++)
+        const art::EventID& eventID = evt.id();
+        
+        long pedestalSeed = fPedestalEngine.getSeed();
+        long uncNoiseSeed = fUncNoiseEngine.getSeed();
+        long corNoiseSeed = fCorNoiseEngine.getSeed();
+        
+        tbb::parallel_for(size_t(0), mbVec.size(), [&](size_t mbIdx)
         {
-            //clean up working vectors from previous iteration of loop
-            adcvec.resize(fNTimeSamples, 0);  //compression may have changed the size of this vector
-            noisetmp.resize(fNTimeSamples, 0.);     //just in case
+            size_t threadIdx = tbb::this_task_arena::current_thread_index();
             
-            //use channel number to set some useful numbers
-            std::vector<geo::WireID> widVec  = fGeometry.ChannelToWire(channel);
-            size_t                   plane   = widVec[0].Plane;
-            size_t                   wire    = widVec[0].Wire;
-            size_t                   board   = wire / 32;
+            CLHEP::MixMaxRng pedestalEngine;
+            CLHEP::MixMaxRng uncNoiseEngine;
+            CLHEP::MixMaxRng corNoiseEngine;
             
-            //Get pedestal with random gaussian variation
-            float ped_mean = pedestalRetrievalAlg.PedMean(channel);
+            icarus::ns::util::seedEventStream(pedestalEngine, pedestalSeed, 0, eventID, mbVec[mbIdx]);
+            icarus::ns::util::seedEventStream(uncNoiseEngine, uncNoiseSeed, 1, eventID, mbVec[mbIdx]);
+            icarus::ns::util::seedEventStream(corNoiseEngine, corNoiseSeed, 2, eventID, mbVec[mbIdx]);
             
-            if (fSmearPedestals )
-            {
-                CLHEP::RandGaussQ rGaussPed(fPedestalEngine, 0.0, pedestalRetrievalAlg.PedRms(channel));
-                ped_mean += rGaussPed.fire();
-            }
-            
-            //Generate Noise
-            double noise_factor(0.);
-            auto   tempNoiseVec = fSignalShapingService->GetNoiseFactVec();
-            double shapingTime  = fSignalShapingService->GetShapingTime(plane);
-            double gain         = fSignalShapingService->GetASICGain(channel) * sampling_rate(clockData) * 1.e-3; // Gain returned is electrons/us, this converts to electrons/tick
-            int    timeOffset   = fSignalShapingService->ResponseTOffset(channel);
-            
-            // Recover the response function information for this channel
-            const icarus_tool::IResponse& response = fSignalShapingService->GetResponse(channel);
+            SimulateBoard(mbVec[mbIdx], eventInfo, pedestalEngine, uncNoiseEngine, corNoiseEngine,
+                          fNoiseToolVecs[threadIdx], *fFFTVec[threadIdx], boardDigitVec[mbIdx], boardWireChargeVec[mbIdx]);
+        });
+        
+        // Collect the output in motherboard order
+        for(size_t mbIdx = 0; mbIdx < mbVec.size(); mbIdx++)
+        {
+            std::move(boardDigitVec[mbIdx].begin(), boardDigitVec[mbIdx].end(), std::back_inserter(*digcol));
+            wireChargeVec.insert(wireChargeVec.end(), boardWireChargeVec[mbIdx].begin(), boardWireChargeVec[mbIdx].end());
+        }
+    }
+    
+    if(fMakeHistograms)
+    {
+        for(const auto& wireCharge : wireChargeVec)
+        {
+            fSimCharge->Fill(wireCharge.second);
+            fSimChargeWire->Fill(wireCharge.first,wireCharge.second);
+        }
+    }
+    
+    evt.put(std::move(digcol), fOutInstanceLabel);
+    
+    return;
+}
+//-------------------------------------------------
+void SimWireICARUS::SimulateBoard(raw::ChannelID_t                 mb,
+                                  const EventInfo&                 eventInfo,
+                                  CLHEP::HepRandomEngine&          pedestalEngine,
+                                  CLHEP::HepRandomEngine&          uncNoiseEngine,
+                                  CLHEP::HepRandomEngine&          corNoiseEngine,
+                                  const NoiseToolVec&              noiseToolVec,
+                                  icarus_signal_processing::ICARUSFFT<double>& fft,
+                                  std::vector<raw::RawDigit>&      digitVec,
+                                  std::vector<WireChargePair>&     wireChargeVec) const
+{
+    const detinfo::DetectorClocksData& clockData = eventInfo.clockData;
+    
+    // vectors for working in the following for loop
+    std::vector<short>  adcvec(fNTimeSamples, 0);
+    icarusutil::TimeVec chargeWork(fNTimeSamples,0.);
+    icarusutil::TimeVec zeroCharge(fNTimeSamples,0.);
+    icarusutil::TimeVec noisetmp(fNTimeSamples,0.);
+    
+    // make sure chargeWork is correct size
+    if (chargeWork.size() < fNTimeSamples) throw std::range_error("SimWireICARUS: chargeWork vector too small");
+    
+    raw::ChannelID_t baseChannel = fNumChanPerMB * mb;
+        
+    // And for a given MB we can loop over the channels it contains
+    for(raw::ChannelID_t channel = baseChannel; channel < baseChannel + fNumChanPerMB; channel++)
+    {
+        //clean up working vectors from previous iteration of loop
+        adcvec.resize(fNTimeSamples, 0);  //compression may have changed the size of this vector
+        noisetmp.resize(fNTimeSamples, 0.);     //just in case
+        
+        //use channel number to set some useful numbers
+        std::vector<geo::WireID> widVec  = fGeometry.ChannelToWire(channel);
+        size_t                   plane   = widVec[0].Plane;
+        size_t                   wire    = widVec[0].Wire;
+        size_t                   board   = wire / 32;
+        
+        //Get pedestal with random gaussian variation
+        float ped_mean = eventInfo.pedestals.PedMean(channel);
+        
+        if (fSmearPedestals )
+        {
+            CLHEP::RandGaussQ rGaussPed(pedestalEngine, 0.0, eventInfo.pedestals.PedRms(channel));
+            ped_mean += rGaussPed.fire();
+        }
+        
+        //Generate Noise
+        double noise_factor(0.);
+        auto   tempNoiseVec = fSignalShapingService->GetNoiseFactVec();
+        double shapingTime  = fSignalShapingService->GetShapingTime(plane);
+        double gain         = fSignalShapingService->GetASICGain(channel) * sampling_rate(clockData) * 1.e-3; // Gain returned is electrons/us, this converts to electrons/tick
+        int    timeOffset   = fSignalShapingService->ResponseTOffset(channel);
+        
+        // Recover the response function information for this channel
+        const icarus_tool::IResponse& response = fSignalShapingService->GetResponse(channel);
 
-            if (fShapingTimeOrder.find( shapingTime ) != fShapingTimeOrder.end() )
-                noise_factor = tempNoiseVec[plane].at( fShapingTimeOrder.find( shapingTime )->second );
-            //Throw exception...
-            else
-            {
-                throw cet::exception("SimWireICARUS")
-                << "\033[93m"
-                << "Shaping Time received from signalservices_icarus.fcl is not one of allowed values"
-                << std::endl
-                << "Allowed values: 0.6, 1.0, 1.3, 3.0 usec"
-                << "\033[00m"
-                << std::endl;
-            }
-            
-            // Use the desired noise tool to actually generate the noise on this wire
-            fNoiseToolVec[plane]->generateNoise(fUncNoiseEngine,
-                                                fCorNoiseEngine,
-                                                noisetmp,
-                                                detProp,
-                                                noise_factor,
-                                                widVec[0],
-                                                board);
-            
-            // Recover the SimChannel (if one) for this channel
-            const sim::SimChannel* simChan = channels[channel];
+        if (fShapingTimeOrder.find( shapingTime ) != fShapingTimeOrder.end() )
+            noise_factor = tempNoiseVec[plane].at( fShapingTimeOrder.find( shapingTime )->second );
+        //Throw exception...
+        else
+        {
+            throw cet::exception("SimWireICARUS")
+            << "\033[93m"
+            << "Shaping Time received from signalservices_icarus.fcl is not one of allowed values"
+            << std::endl
+            << "Allowed values: 0.6, 1.0, 1.3, 3.0 usec"
+            << "\033[00m"
+            << std::endl;
+        }
+        
+        // Use the desired noise tool to actually generate the noise on this wire
+        noiseToolVec[plane]->generateNoise(uncNoiseEngine,
+                                           corNoiseEngine,
+                                           noisetmp,
+                                           eventInfo.detProp,
+                                           noise_factor,
+                                           widVec[0],
+                                           board);
+        
+        // Recover the SimChannel (if one) for this channel
+        const sim::SimChannel* simChan = eventInfo.simChannels[channel];
+        
+        // If there is something on this wire, and it is not dead, then add the signal to the wire
+        if(simChan && !(fSimDeadChannels && (eventInfo.channelStatus.IsBad(channel) || !eventInfo.channelStatus.IsPresent(channel))))
+        {
+            std::fill(chargeWork.begin(), chargeWork.end(), 0.);
             
-            // If there is something on this wire, and it is not dead, then add the signal to the wire
-            if(simChan && !(fSimDeadChannels && (ChannelStatusProvider.IsBad(channel) || !ChannelStatusProvider.IsPresent(channel))))
+            // loop over the tdcs and grab the number of electrons for each
+            for(size_t tick = 0; tick < fNTimeSamples; tick++)
             {
-                std::fill(chargeWork.begin(), chargeWork.end(), 0.);
+                int tdc = clockData.TPCTick2TDC(tick);
                 
-                // loop over the tdcs and grab the number of electrons for each
-                for(size_t tick = 0; tick < fNTimeSamples; tick++)
-                {
-                    int tdc = clockData.TPCTick2TDC(tick);
-                    
-                    // continue if tdc < 0
-                    if( tdc < 0 ) continue;
-                    
-                    double charge = simChan->Charge(tdc);  // Charge returned in number of electrons
-                    
-                    chargeWork[tick] += charge/gain;  // # electrons / (# electrons/tick)
-                } // loop over tdcs
-                // now we have the tempWork for the adjacent wire of interest
-                // convolve it with the appropriate response function
-                fFFT->convolute(chargeWork, response.getConvKernel(), timeOffset);
+                // continue if tdc < 0
+                if( tdc < 0 ) continue;
                 
-                // "Make" the ADC vector
-                MakeADCVec(adcvec, noisetmp, chargeWork, ped_mean);
-            }
-            // "Make" an ADC vector with zero charge added
-            else MakeADCVec(adcvec, noisetmp, zeroCharge, ped_mean);
-            
-            // add this digit to the collection;
-            // adcvec is copied, not moved: in case of compression, adcvec will show
-            // less data: e.g. if the uncompressed adcvec has 9600 items, after
-            // compression it will have maybe 5000, but the memory of the other 4600
-            // is still there, although unused; a copy of adcvec will instead have
-            // only 5000 items. All 9600 items of adcvec will be recovered for free
-            // and used on the next loop.
-            raw::RawDigit rd(channel, fNTimeSamples, adcvec, fCompression);
-            
-            if(fMakeHistograms && plane==2)
-            {
-                short area = std::accumulate(adcvec.begin(),adcvec.end(),0,[](const auto& val,const auto& sum){return sum + val - 400;});
+                double charge = simChan->Charge(tdc);  // Charge returned in number of electrons
                 
-                if(area>0)
-                {
-                    fSimCharge->Fill(area);
-                    fSimChargeWire->Fill(widVec[0].Wire,area);
-                }
-            }
+                chargeWork[tick] += charge/gain;  // # electrons / (# electrons/tick)
+            } // loop over tdcs
+            // now we have the tempWork for the adjacent wire of interest
+            // convolve it with the appropriate response function
+            fft.convolute(chargeWork, response.getConvKernel(), timeOffset);
             
-            rd.SetPedestal(ped_mean);
-            digcol->push_back(std::move(rd)); // we do move the raw digit copy, though
-
+            // "Make" the ADC vector
+            MakeADCVec(adcvec, noisetmp, chargeWork, ped_mean);
         }
+        // "Make" an ADC vector with zero charge added
+        else MakeADCVec(adcvec, noisetmp, zeroCharge, ped_mean);
+        
+        // add this digit to the collection;
+        // adcvec is copied, not moved: in case of compression, adcvec will show
+        // less data: e.g. if the uncompressed adcvec has 9600 items, after
+        // compression it will have maybe 5000, but the memory of the other 4600
+        // is still there, although unused; a copy of adcvec will instead have
+        // only 5000 items. All 9600 items of adcvec will be recovered for free
+        // and used on the next loop.
+        raw::RawDigit rd(channel, fNTimeSamples, adcvec, fCompression);
+        
+        if(fMakeHistograms && plane==2)
+        {
+            short area = std::accumulate(adcvec.begin(),adcvec.end(),0,[](const auto& val,const auto& sum){return sum + val - 400;});
+            
+            if(area>0) wireChargeVec.emplace_back(widVec[0].Wire,area);
+        }
+        
+        rd.SetPedestal(ped_mean);
+        digitVec.push_back(std::move(rd)); // we do move the raw digit copy, though
     }
     
-    evt.put(std::move(digcol), fOutInstanceLabel);
-    
     return;
 }
 //-------------------------------------------------
@@ -48,6 +48,8 @@ public:
     
     void nextEvent() override;
 
+    void useExternalSeeds() override {fNeedFirstSeed = false;}
+
     void generateNoise(CLHEP::HepRandomEngine& noise_engine,
                        CLHEP::HepRandomEngine& cornoise_engine,
                        icarusutil::TimeVec& noise,
@@ -37,6 +37,18 @@ namespace icarus_tool
         
         virtual void nextEvent()                                                  = 0;
         
+        // The caller seeds the engines passed to generateNoise (e.g. one stream per
+        // readout board): the tool must not reseed the uncorrelated noise engine
+        virtual void useExternalSeeds() {}
+        
+        // Whether copies of the tool can generate noise concurrently: they must only draw
+        // from the engines passed to generateNoise (not from gRandom or the CLHEP static engine)
+        virtual bool supportsMultiThreading() const {return false;}
+        
+        // In multithreaded mode only the first copy of the tool gets nextEvent(): the other
+        // copies take the event state from it, which is always a tool of their same type
+        virtual void copyEventState(const IGenNoise&) {}
+        
         virtual void generateNoise(CLHEP::HepRandomEngine& noise_engine,
                                    CLHEP::HepRandomEngine& cornoise_engine,
                                    icarusutil::TimeVec&,
@@ -44,6 +44,8 @@ public:
     
     void nextEvent() override  {return;};
 
+    bool supportsMultiThreading() const override {return true;}
+
     void generateNoise(CLHEP::HepRandomEngine&,
                        CLHEP::HepRandomEngine&,
                        icarusutil::TimeVec&,
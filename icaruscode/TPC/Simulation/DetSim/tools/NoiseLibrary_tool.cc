@@ -0,0 +1,484 @@
+////////////////////////////////////////////////////////////////////////
+/// \file   NoiseLibrary.cc
+///
+/// \brief  Noise generation from a library of noise waveforms
+///
+///         Uses the same inputs as the SBNDataNoise tool (coherent and
+///         incoherent power spectra and RMS distributions per cryostat/TPC)
+///         but synthesizes (or loads) a library of waveforms for each
+///         spectrum at configuration time. At event time a waveform is
+///         picked at random, circularly shifted by a random number of ticks,
+///         given a random sign and scaled: no FFT is performed.
+///
+////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include "IGenNoise.h"
+#include "art/Framework/Core/EDProducer.h"
+#include "art/Utilities/ToolMacros.h"
+#include "art/Utilities/make_tool.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "cetlib_except/exception.h"
+#include "cetlib/search_path.h"
+#include "cetlib/cpu_timer.h"
+#include "larcore/CoreUtils/ServiceUtil.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
+#include "lardata/DetectorInfoServices/DetectorClocksService.h"
+#include "art_root_io/TFileService.h"
+
+#include "icaruscode/TPC/Simulation/DetSim/tools/ICoherentNoiseFactor.h"
+#include "icaruscode/TPC/Simulation/DetSim/tools/NoiseRMSDistribution.h"
+
+// CLHEP libraries
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Random/MixMaxRng.h"
+
+#include "TH1D.h"
+#include "TH2F.h"
+#include "TFile.h"
+
+#include <Eigen/Core>
+#include <unsupported/Eigen/FFT>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace icarus_tool
+{
+
+class NoiseLibrary : IGenNoise
+{
+public:
+    explicit NoiseLibrary(const fhicl::ParameterSet& pset);
+
+    ~NoiseLibrary();
+
+    void configure(const fhicl::ParameterSet& pset) override;
+
+    void nextEvent() override;
+
+    void useExternalSeeds() override {fNeedFirstSeed = false;}
+
+    bool supportsMultiThreading() const override {return true;}
+
+    void copyEventState(const IGenNoise& primary) override
+        {fCorrelatedSeed = static_cast<const NoiseLibrary&>(primary).fCorrelatedSeed;}
+
+    void generateNoise(CLHEP::HepRandomEngine& noise_engine,
+                       CLHEP::HepRandomEngine& cornoise_engine,
+                       icarusutil::TimeVec& noise,
+                       detinfo::DetectorPropertiesData const&,
+                       double noise_factor,
+                       const geo::PlaneID&,
+                       unsigned int board) override;
+
+private:
+    // The waveforms for one noise spectrum, stored one after the other
+    struct Library
+    {
+        size_t             nTicks = 0;
+        size_t             size   = 0;
+        std::vector<float> waveforms;
+
+        const float* waveform(size_t idx) const {return waveforms.data() + idx * nTicks;}
+    };
+
+    void   BuildLibrary(CLHEP::HepRandomEngine&, const icarusutil::TimeVec&, Library&);
+    void   LoadLibrary(TFile&, const std::string&, Library&) const;
+    void   StoreLibrary(art::TFileDirectory&, const std::string&, const Library&) const;
+    void   CopyFromLibrary(CLHEP::HepRandomEngine&, const Library&, icarusutil::TimeVec&, float) const;
+    size_t SpectrumIndex(const geo::PlaneID&) const;
+
+    // Member variables from the fhicl file
+    size_t                                      fPlane;
+    float                                       fNoiseRand;
+    long                                        fCorrelatedSeed;
+    long                                        fUncorrelatedSeed;
+    bool                                        fStoreHistograms;
+    std::vector<std::string>                    fInputNoiseHistFileName;
+    std::string                                 fCorrelatedHistogramName;
+    std::string                                 fUncorrelatedHistogramName;
+    std::string                                 fCorrelatedRMSHistoName;
+    std::string                                 fUncorrelatedRMSHistoName;
+    size_t                                      fLibrarySize;        //< Number of waveforms per spectrum
+    long                                        fLibrarySeed;        //< Seed used to synthesize the library
+    std::string                                 fLibraryFileName;    //< If set, load the library from this file
+    std::string                                 fLibraryHistPrefix;  //< Path of the library histograms in that file
+
+    // The libraries, one per spectrum (cryostat/TPC), with the RMS distributions
+    struct LibrarySet
+    {
+        std::vector<Library>                    coherent;
+        std::vector<Library>                    incoherent;
+        std::vector<NoiseRMSDistribution>       uncorrelatedRMSDist;
+        std::vector<std::unique_ptr<TH1D>>      correlatedRMSHist;   //< For the board scale factors
+    };
+
+    std::shared_ptr<const LibrarySet> MakeLibraries(size_t);
+
+    // Built once per configuration and shared by all the tools with it (e.g. the copies for each thread)
+    std::shared_ptr<const LibrarySet>           fLibraries;
+
+    Noise::ICoherentNoiseFactor*                fCoherentNoiseService;   //< Use this to handle the common scale factors per board
+
+    // Keep track of seed initialization for uncorrelated noise
+    bool                                        fNeedFirstSeed=true;
+
+    // Container for doing the work
+    icarusutil::FrequencyVec                    fNoiseFrequencyVec;
+
+    // Keep instance of the eigen FFT (only used to build the library)
+    Eigen::FFT<double>                          fEigenFFT;
+};
+
+//----------------------------------------------------------------------
+// Constructor.
+NoiseLibrary::NoiseLibrary(const fhicl::ParameterSet& pset)
+{
+    // Recover the configuration of the tool from the input fhicl file and set up
+    configure(pset);
+}
+
+NoiseLibrary::~NoiseLibrary()
+{
+}
+
+void NoiseLibrary::configure(const fhicl::ParameterSet& pset)
+{
+    // Recover the histogram used for noise generation
+    fPlane                     = pset.get< size_t                   >("Plane");
+    fNoiseRand                 = pset.get< float                    >("NoiseRand");
+    fCorrelatedSeed            = pset.get< long                     >("CorrelatedSeed",1000);
+    fUncorrelatedSeed          = pset.get< long                     >("UncorrelatedSeed",5000);
+    fStoreHistograms           = pset.get< bool                     >("StoreHistograms");
+    fInputNoiseHistFileName    = pset.get< std::vector<std::string> >("NoiseHistFileName");
+    fCorrelatedHistogramName   = pset.get< std::string              >("CorrelatedHistogramName");
+    fUncorrelatedHistogramName = pset.get< std::string              >("UncorrelatedHistogramName");
+    fCorrelatedRMSHistoName    = pset.get< std::string              >("CorrelatedRMSHistoName");
+    fUncorrelatedRMSHistoName  = pset.get< std::string              >("UncorrelatedRMSHistoName");
+    fLibrarySize               = pset.get< size_t                   >("LibrarySize",               256);
+    fLibrarySeed               = pset.get< long                     >("LibrarySeed",              1357);
+    fLibraryFileName           = pset.get< std::string              >("LibraryFileName",            "");
+    fLibraryHistPrefix         = pset.get< std::string              >("LibraryHistogramPrefix",     "");
+
+    if (fLibrarySize == 0)
+        throw cet::exception("NoiseLibrary::configure") << "The library must contain at least one waveform" << std::endl;
+
+    auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob();
+    auto const detProp   = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob(clockData);
+    size_t     nTicks    = detProp.NumberTimeSamples();
+
+    // The libraries only depend on these parameters (not on StoreHistograms, which the copies for the other threads have off)
+    std::ostringstream libraryKey;
+
+    libraryKey << std::setprecision(9) << nTicks << ';' << fNoiseRand << ';' << fLibrarySize << ';' << fLibrarySeed << ';' << fLibraryFileName << ';' << fLibraryHistPrefix << ';'
+               << fCorrelatedHistogramName << ';' << fUncorrelatedHistogramName << ';' << fCorrelatedRMSHistoName << ';' << fUncorrelatedRMSHistoName;
+
+    for(const auto& fileName : fInputNoiseHistFileName) libraryKey << ';' << fileName;
+
+    // The libraries in use, by configuration: a library is freed with the last tool using it
+    static std::map<std::string, std::weak_ptr<const LibrarySet>> libraryCache;
+    static std::mutex                                             libraryCacheMutex;
+
+    {
+        std::lock_guard<std::mutex> lock(libraryCacheMutex);
+
+        std::weak_ptr<const LibrarySet>& cached = libraryCache[libraryKey.str()];
+
+        fLibraries = cached.lock();
+
+        if (!fLibraries)
+        {
+            fLibraries = MakeLibraries(nTicks);
+            cached     = fLibraries;
+        }
+        else mf::LogDebug("NoiseLibrary") << "Plane " << fPlane << ": sharing the noise libraries of a tool with the same configuration";
+    }
+
+    if (fStoreHistograms)
+    {
+        // Store the libraries, which can then be loaded back with LibraryFileName
+        art::ServiceHandle<art::TFileService> tfs;
+
+        art::TFileDirectory dir = tfs->mkdir(Form("NoiseLibraryPlane%1zu",fPlane));
+
+        for(size_t index = 0; index < fLibraries->coherent.size(); index++)
+        {
+            StoreLibrary(dir, "CoherentLibrary"   + std::to_string(index), fLibraries->coherent[index]);
+            StoreLibrary(dir, "IncoherentLibrary" + std::to_string(index), fLibraries->incoherent[index]);
+        }
+    }
+
+    fCoherentNoiseService = art::ServiceHandle<Noise::ICoherentNoiseFactor>{}.get();
+
+    return;
+}
+
+void NoiseLibrary::nextEvent()
+{
+    // We update the correlated seed because we want to see different noise event-by-event
+    fCorrelatedSeed = (333 * fCorrelatedSeed) % 900000000;
+
+    for(const auto& corrRMSHist : fLibraries->correlatedRMSHist) fCoherentNoiseService->resetCoherentNoiseFactors(corrRMSHist.get());
+
+    return;
+}
+
+void NoiseLibrary::generateNoise(CLHEP::HepRandomEngine& engine_unc,
+                                 CLHEP::HepRandomEngine& engine_corr,
+                                 icarusutil::TimeVec&     noise,
+                                 detinfo::DetectorPropertiesData const&,
+                                 double                  noise_factor,
+                                 const geo::PlaneID&     planeID,
+                                 unsigned int            board)
+{
+    size_t index = SpectrumIndex(planeID);
+
+    // Check for seed initialization
+    if (fNeedFirstSeed)
+    {
+        engine_unc.setSeed(fUncorrelatedSeed,0);
+        fNeedFirstSeed = false;
+    }
+
+    icarusutil::TimeVec noise_corr(noise.size(),0.);
+
+    // The incoherent noise, with a scale drawn from the measured RMS distribution
+    CopyFromLibrary(engine_unc, fLibraries->incoherent[index], noise, noise_factor * fLibraries->uncorrelatedRMSDist[index].sampleRatio(engine_unc));
+
+    // The coherent noise is the same for all the channels of a board
+    engine_corr.setSeed(fCorrelatedSeed+board,0);
+
+    CopyFromLibrary(engine_corr, fLibraries->coherent[index], noise_corr, noise_factor * fCoherentNoiseService->getCoherentNoiseFactor(board,index));
+
+    // Take the noise as the simple sum of the two contributions
+    std::transform(noise.begin(),noise.end(),noise_corr.begin(),noise.begin(),std::plus<icarusutil::SigProcPrecision>());
+
+    return;
+}
+
+std::shared_ptr<const NoiseLibrary::LibrarySet> NoiseLibrary::MakeLibraries(size_t nTicks)
+{
+    auto libraries = std::make_shared<LibrarySet>();
+
+    fNoiseFrequencyVec.resize(nTicks,std::complex<float>(0.,0.));
+
+    cet::search_path searchPath("FW_SEARCH_PATH");
+
+    // Open the library file, if one is given
+    std::unique_ptr<TFile> libraryFile;
+
+    if (!fLibraryFileName.empty())
+    {
+        std::string fullFileName;
+
+        searchPath.find_file(fLibraryFileName, fullFileName);
+
+        libraryFile = std::make_unique<TFile>(fullFileName.c_str(), "READ");
+
+        if (!libraryFile->IsOpen())
+            throw cet::exception("NoiseLibrary::MakeLibraries") << "Unable to open library file: " << fLibraryFileName << std::endl;
+    }
+
+    // The engine used to synthesize the library, so that it is the same in every job
+    CLHEP::MixMaxRng libraryEngine(fLibrarySeed);
+
+    cet::cpu_timer theClock;
+
+    theClock.start();
+
+    for(size_t index = 0; index < fInputNoiseHistFileName.size(); index++)
+    {
+        // Set up to input the histograms with the noise spectra and RMS distributions
+        std::string fullFileName;
+
+        searchPath.find_file(fInputNoiseHistFileName[index], fullFileName);
+
+        TFile inputFile(fullFileName.c_str(), "READ");
+
+        if (!inputFile.IsOpen())
+            throw cet::exception("NoiseLibrary::MakeLibraries") << "Unable to open input file: " << fInputNoiseHistFileName[index] << std::endl;
+
+        auto getHist = [&inputFile](const std::string& name)
+        {
+            TH1D* histPtr = (TH1D*)inputFile.Get(name.c_str());
+
+            if (!histPtr)
+                throw cet::exception("NoiseLibrary::MakeLibraries") << "Unable to recover desired histogram: " << name << std::endl;
+
+            return histPtr;
+        };
+
+        // The RMS distributions are used at event time, so they are copied before closing the file
+        TH1D* uncorrRMSHistPtr = getHist(fUncorrelatedRMSHistoName);
+
+        libraries->uncorrelatedRMSDist.emplace_back(*uncorrRMSHistPtr);
+
+        if (!libraries->uncorrelatedRMSDist.back().isValid())
+            throw cet::exception("NoiseLibrary::MakeLibraries") << "Empty RMS distribution: " << fUncorrelatedRMSHistoName << std::endl;
+
+        TH1D* corrRMSHistPtr = (TH1D*)getHist(fCorrelatedRMSHistoName)->Clone();
+
+        corrRMSHistPtr->SetDirectory(nullptr);
+
+        libraries->correlatedRMSHist.emplace_back(corrRMSHistPtr);
+
+        // Now the libraries, loaded from file or synthesized from the spectra
+        libraries->coherent.emplace_back();
+        libraries->incoherent.emplace_back();
+
+        if (libraryFile)
+        {
+            LoadLibrary(*libraryFile, "CoherentLibrary"   + std::to_string(index), libraries->coherent.back());
+            LoadLibrary(*libraryFile, "IncoherentLibrary" + std::to_string(index), libraries->incoherent.back());
+
+            if (libraries->coherent.back().nTicks != nTicks || libraries->incoherent.back().nTicks != nTicks)
+                throw cet::exception("NoiseLibrary::MakeLibraries") << "Library waveforms do not match the number of time samples: " << nTicks << std::endl;
+        }
+        else
+        {
+            auto getSpectrum = [&getHist](const std::string& name)
+            {
+                TH1D* histPtr = getHist(name);
+
+                icarusutil::TimeVec spectrum(histPtr->GetNbinsX(), 0.);
+
+                for(size_t histIdx = 0; histIdx < spectrum.size(); histIdx++) spectrum[histIdx] = histPtr->GetBinContent(histIdx+1);
+
+                return spectrum;
+            };
+
+            libraries->coherent.back().nTicks   = nTicks;
+            libraries->incoherent.back().nTicks = nTicks;
+
+            BuildLibrary(libraryEngine, getSpectrum(fCorrelatedHistogramName),   libraries->coherent.back());
+            BuildLibrary(libraryEngine, getSpectrum(fUncorrelatedHistogramName), libraries->incoherent.back());
+        }
+
+        // Close the input file
+        inputFile.Close();
+    }
+
+    theClock.stop();
+
+    mf::LogInfo("NoiseLibrary") << "Plane " << fPlane << ": noise libraries of " << fLibrarySize << " waveforms for "
+                                << libraries->coherent.size() << " spectra ready in " << theClock.accumulated_real_time() << " s";
+
+    return libraries;
+}
+
+void NoiseLibrary::BuildLibrary(CLHEP::HepRandomEngine& engine, const icarusutil::TimeVec& freqDist, Library& library)
+{
+    // Same recipe as the on-the-fly tools: random magnitude and phase for each frequency, then inverse FFT
+    CLHEP::RandFlat noiseGen(engine,0,1);
+
+    icarusutil::TimeVec noise(library.nTicks, 0.);
+
+    if (freqDist.size() < noise.size()/2)
+        throw cet::exception("NoiseLibrary::BuildLibrary") << "Noise spectrum has " << freqDist.size() << " bins, " << noise.size()/2 << " needed" << std::endl;
+
+    library.size = fLibrarySize;
+    library.waveforms.resize(library.size * library.nTicks);
+
+    for(size_t waveIdx = 0; waveIdx < library.size; waveIdx++)
+    {
+        double rnd[2] = {0.,0.};
+
+        for(size_t i=0; i< noise.size()/2; ++i)
+        {
+            noiseGen.fireArray(2,rnd);
+
+            float pval  = freqDist[i] * ((1-fNoiseRand) + 2 * fNoiseRand*rnd[0]);
+            float phase = rnd[1] * 2. * M_PI;
+
+            fNoiseFrequencyVec[i] = std::complex<float>(pval*cos(phase),pval*sin(phase));
+        }
+
+        fEigenFFT.inv(noise, fNoiseFrequencyVec);
+
+        std::copy(noise.begin(), noise.end(), library.waveforms.begin() + waveIdx * library.nTicks);
+    }
+
+    return;
+}
+
+void NoiseLibrary::LoadLibrary(TFile& file, const std::string& name, Library& library) const
+{
+    TH2F* libraryHist = (TH2F*)file.Get((fLibraryHistPrefix + name).c_str());
+
+    if (!libraryHist)
+        throw cet::exception("NoiseLibrary::LoadLibrary") << "Unable to recover library histogram: " << fLibraryHistPrefix + name << std::endl;
+
+    // One waveform per bin in x, one tick per bin in y
+    library.size   = libraryHist->GetNbinsX();
+    library.nTicks = libraryHist->GetNbinsY();
+    library.waveforms.resize(library.size * library.nTicks);
+
+    for(size_t waveIdx = 0; waveIdx < library.size; waveIdx++)
+        for(size_t tick = 0; tick < library.nTicks; tick++)
+            library.waveforms[waveIdx * library.nTicks + tick] = libraryHist->GetBinContent(waveIdx+1, tick+1);
+
+    return;
+}
+
+void NoiseLibrary::StoreLibrary(art::TFileDirectory& dir, const std::string& name, const Library& library) const
+{
+    TH2F* libraryHist = dir.make<TH2F>(name.c_str(), ";Waveform;Tick", library.size, 0., library.size, library.nTicks, 0., library.nTicks);
+
+    for(size_t waveIdx = 0; waveIdx < library.size; waveIdx++)
+    {
+        const float* waveform = library.waveform(waveIdx);
+
+        for(size_t tick = 0; tick < library.nTicks; tick++) libraryHist->SetBinContent(waveIdx+1, tick+1, waveform[tick]);
+    }
+
+    return;
+}
+
+void NoiseLibrary::CopyFromLibrary(CLHEP::HepRandomEngine& engine, const Library& library, icarusutil::TimeVec& noise, float scaleFactor) const
+{
+    if (noise.size() != library.nTicks)
+        throw cet::exception("NoiseLibrary::CopyFromLibrary") << "Requested " << noise.size() << " ticks, library waveforms have " << library.nTicks << std::endl;
+
+    CLHEP::RandFlat noiseGen(engine,0,1);
+
+    double rnd[3] = {0.,0.,0.};
+
+    noiseGen.fireArray(3,rnd);
+
+    // The waveforms are periodic (inverse FFT) so a circular shift keeps the spectrum, as does a sign flip
+    size_t       waveIdx = std::min(size_t(rnd[0] * library.size),   library.size - 1);
+    size_t       offset  = std::min(size_t(rnd[1] * library.nTicks), library.nTicks - 1);
+    float        scale   = rnd[2] < 0.5 ? -scaleFactor : scaleFactor;
+    const float* source  = library.waveform(waveIdx);
+
+    auto copyScaled = [scale](const float* first, const float* last, icarusutil::TimeVec::iterator dest)
+    {
+        return std::transform(first, last, dest, [scale](float value){return scale * value;});
+    };
+
+    auto dest = copyScaled(source + offset, source + library.nTicks, noise.begin());
+
+    copyScaled(source, source + offset, dest);
+
+    return;
+}
+
+size_t NoiseLibrary::SpectrumIndex(const geo::PlaneID& planeID) const
+{
+    // Same convention as SBNDataNoise: one spectrum per cryostat and pair of TPCs
+    size_t index = 2 * planeID.Cryostat + (planeID.TPC > 1 ? 1 : 0);
+
+    if (index >= fLibraries->incoherent.size())
+        throw cet::exception("NoiseLibrary::generateNoise") << "No noise spectrum for " << planeID << std::endl;
+
+    return index;
+}
+
+DEFINE_ART_CLASS_TOOL(NoiseLibrary)
+}
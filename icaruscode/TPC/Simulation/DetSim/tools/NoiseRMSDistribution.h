@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   NoiseRMSDistribution.h
+///
+/// \brief  Distribution of the noise RMS from a histogram, sampled from
+///         the random engine it is given (TH1::GetRandom() uses gRandom,
+///         which can't be used from the threads of the simulation)
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef NoiseRMSDistribution_H
+#define NoiseRMSDistribution_H
+
+// CLHEP libraries
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Random/RandomEngine.h"
+
+#include "TH1.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace icarus_tool
+{
+
+class NoiseRMSDistribution
+{
+public:
+    // Copies the cumulative distribution of the histogram (negative bins count as empty)
+    explicit NoiseRMSDistribution(const TH1& hist);
+
+    // The distribution can be sampled only if the histogram has entries and a positive mean
+    bool isValid() const {return fCumulative.back() > 0. && fMean > 0.;}
+
+    // Ratio of a random RMS to the mean RMS: inverse of the cumulative distribution
+    // with linear interpolation in the bin, as TH1::GetRandom() does
+    float sampleRatio(CLHEP::HepRandomEngine& engine) const;
+
+private:
+    std::vector<double> fCumulative;
+    double              fLow;
+    double              fBinWidth;
+    double              fMean;
+};
+
+inline NoiseRMSDistribution::NoiseRMSDistribution(const TH1& hist)
+    : fCumulative(hist.GetNbinsX() + 1, 0.)
+    , fLow(hist.GetXaxis()->GetXmin())
+    , fBinWidth(hist.GetXaxis()->GetBinWidth(1))
+    , fMean(hist.GetMean())
+{
+    for(size_t histIdx = 0; histIdx < size_t(hist.GetNbinsX()); histIdx++)
+        fCumulative[histIdx+1] = fCumulative[histIdx] + std::max(0., hist.GetBinContent(histIdx+1));
+
+    if (fCumulative.back() > 0.)
+    {
+        double total = fCumulative.back();
+
+        for(auto& value : fCumulative) value /= total;
+    }
+}
+
+inline float NoiseRMSDistribution::sampleRatio(CLHEP::HepRandomEngine& engine) const
+{
+    double r1 = CLHEP::RandFlat::shoot(&engine);
+
+    size_t bin = std::upper_bound(fCumulative.begin(), fCumulative.end(), r1) - fCumulative.begin() - 1;
+
+    bin = std::min(bin, fCumulative.size() - 2);
+
+    double rms = fLow + fBinWidth * bin;
+    double dx  = fCumulative[bin+1] - fCumulative[bin];
+
+    if (dx > 0.) rms += fBinWidth * (r1 - fCumulative[bin]) / dx;
+
+    return rms / fMean;
+}
+
+} // end of namespace
+
+#endif
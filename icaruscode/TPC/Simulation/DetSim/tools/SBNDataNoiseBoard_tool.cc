@@ -48,6 +48,8 @@ public:
     void configure(const fhicl::ParameterSet& pset) override;
     
     void nextEvent() override;
+
+    void useExternalSeeds() override {fNeedFirstSeed = false;}
    
     void generateNoise(CLHEP::HepRandomEngine&,
                        CLHEP::HepRandomEngine& ,
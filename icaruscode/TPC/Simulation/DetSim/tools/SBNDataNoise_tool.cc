@@ -22,6 +22,7 @@
 #include "icarus_signal_processing/WaveformTools.h"
 #include "icaruscode/Decode/ChannelMapping/IICARUSChannelMap.h"
 #include "icaruscode/TPC/Simulation/DetSim/tools/ICoherentNoiseFactor.h"
+#include "icaruscode/TPC/Simulation/DetSim/tools/NoiseRMSDistribution.h"
 
 // CLHEP libraries
 #include "CLHEP/Random/RandFlat.h"
@@ -35,7 +36,9 @@
 #include <Eigen/Core>
 #include <unsupported/Eigen/FFT>
 
+#include <algorithm>
 #include <fstream>
+#include <mutex>
 
 namespace icarus_tool
 {
@@ -51,6 +54,12 @@ public:
     
     void nextEvent() override;
 
+    void useExternalSeeds() override {fNeedFirstSeed = false; fExternalSeeds = true;}
+
+    bool supportsMultiThreading() const override {return true;}
+
+    void copyEventState(const IGenNoise& primary) override;
+
     void generateNoise(CLHEP::HepRandomEngine& noise_engine,
                        CLHEP::HepRandomEngine& cornoise_engine,
                        icarusutil::TimeVec& noise,
@@ -106,11 +115,16 @@ private:
     
     // Keep track of seed initialization for uncorrelated noise
     bool                                        fNeedFirstSeed=true;
+    bool                                        fExternalSeeds=false;
+    
+    // Distributions of the uncorrelated noise RMS, to draw from the engines
+    // in multithreaded mode (TH1::GetRandom uses gRandom)
+    std::vector<NoiseRMSDistribution>           fUncorrelatedRMSDistVec;
     
     // Histograms
-    TProfile*                                   fInputNoiseHist;
-    TH1D*                                       fMediaNoiseHist;
-    TProfile*                                   fPeakNoiseHist;
+    TProfile*                                   fInputNoiseHist = nullptr;
+    TH1D*                                       fMediaNoiseHist = nullptr;
+    TProfile*                                   fPeakNoiseHist  = nullptr;
   
     std::vector<TH1D*>                          corrRMSHistPtr;
     std::vector<TH1D*>                          uncorrRMSHistPtr;
@@ -203,6 +217,11 @@ std::cout << "uncorrelated histo name: " << fUncorrelatedHistogramName << std::e
     if (!inputFile.Get(fUncorrelatedRMSHistoName.c_str()))
         throw cet::exception("NoiseFromHist::configure") << "Unable to recover desired histogram: " << fUncorrelatedRMSHistoName << std::endl;
 
+    fUncorrelatedRMSDistVec.emplace_back(*uncorrRMSHistPtr.back());
+
+    if (!fUncorrelatedRMSDistVec.back().isValid())
+        throw cet::exception("NoiseFromHist::configure") << "Empty RMS distribution: " << fUncorrelatedRMSHistoName << std::endl;
+
  totalRMSHistPtr.push_back((TH1D*)inputFile.Get(fTotalRMSHistoName.c_str()));  
     if (!inputFile.Get(fTotalRMSHistoName.c_str()))
         throw cet::exception("NoiseFromHist::configure") << "Unable to recover desired histogram: " << fTotalRMSHistoName << std::endl;
@@ -277,6 +296,19 @@ void SBNDataNoise::nextEvent()
     return;
 }
 
+void SBNDataNoise::copyEventState(const IGenNoise& primary)
+{
+    const SBNDataNoise& primaryTool = static_cast<const SBNDataNoise&>(primary);
+
+    // The coherent noise factors are in the shared service, already reset by the first copy
+    fCorrelatedSeed = primaryTool.fCorrelatedSeed;
+
+    // The other copies do not book histograms: they fill the ones of the first copy
+    fMediaNoiseHist = primaryTool.fMediaNoiseHist;
+
+    return;
+}
+
 void SBNDataNoise::generateNoise(CLHEP::HepRandomEngine& engine_unc,
                                     CLHEP::HepRandomEngine& engine_corr,
                                     icarusutil::TimeVec&     noise,
@@ -353,7 +385,14 @@ float cf = fCoherentNoiseService->getCoherentNoiseFactor(board,index);
 
 mediaNoise/=(noise.size());
 //std::cout << " media noise size " << noise.size() << std::endl;
-fMediaNoiseHist->Fill(mediaNoise);
+if (fMediaNoiseHist)
+{
+    // In multithreaded mode all the copies of the tool fill the same histogram
+    static std::mutex histMutex;
+    std::lock_guard<std::mutex> lock(histMutex);
+
+    fMediaNoiseHist->Fill(mediaNoise);
+}
 //std::cout << " media noise " << mediaNoise << std::endl;
 
     return;
@@ -375,7 +414,8 @@ void SBNDataNoise::GenerateUncorrelatedNoise(CLHEP::HepRandomEngine& engine, ica
     
     std::function<void (double[])> randGenFunc = [&noiseGen](double randArray[]){noiseGen.fireArray(2,randArray);};
 float cf;
-ExtractUncorrelatedRMS(cf,index);
+if (fExternalSeeds) cf = fUncorrelatedRMSDistVec[index].sampleRatio(engine);
+else                ExtractUncorrelatedRMS(cf,index);
     float  scaleFactor = cf*noise_factor;
    //std::cout << " fraction " << fraction <<" unc scale Factor " << scaleFactor << std::endl;
     GenNoise(randGenFunc, fIncoherentNoiseVec[index], noise, scaleFactor);
@@ -48,6 +48,13 @@ public:
     
     void nextEvent() override;
 
+    void useExternalSeeds() override {fNeedFirstSeed = false;}
+
+    bool supportsMultiThreading() const override {return true;}
+
+    void copyEventState(const IGenNoise& primary) override
+        {fCorrelatedSeed = static_cast<const SBNNoise&>(primary).fCorrelatedSeed;}
+
     void generateNoise(CLHEP::HepRandomEngine& noise_engine,
                        CLHEP::HepRandomEngine& cornoise_engine,
                        icarusutil::TimeVec& noise,
@@ -0,0 +1,272 @@
+/**
+ * @file   icaruscode/TPC/Simulation/SpaceCharge/SCEVoxelGrid.h
+ * @brief  Flat, interleaved grid of 3D space charge maps with trilinear
+ *         interpolation.
+ * @see    `icaruscode/TPC/Simulation/SpaceCharge/SpaceChargeICARUS.h`
+ *
+ * This library is header only.
+ */
+
+#ifndef ICARUSCODE_TPC_SIMULATION_SPACECHARGE_SCEVOXELGRID_H
+#define ICARUSCODE_TPC_SIMULATION_SPACECHARGE_SCEVOXELGRID_H
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// ROOT
+#include "TH3.h"
+
+// C/C++ standard libraries
+#include <array>
+#include <cstddef> // std::size_t
+#include <string>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace spacecharge { class SCEVoxelGrid; }
+
+/**
+ * @brief Three-component map sampled on a regular 3D grid.
+ *
+ * The grid is built from three `TH3` with the same binning (one per component
+ * of the map, e.g. the displacement along _x_, _y_ and _z_) and stores all the
+ * components of each voxel next to each other, padded to 16 bytes so that a
+ * voxel never straddles a cache line. The voxels are ordered with _z_ running
+ * fastest, so that the two _z_ neighbours used by the interpolation are
+ * contiguous in memory.
+ *
+ * The interpolation follows exactly the prescription of `TH3::Interpolate()`:
+ * the map is interpolated trilinearly between the centres of the bins, and
+ * points which are not bracketed by bin centres on all three axes (i.e. points
+ * in the outer half of the border bins, or outside the histogram range) get a
+ * value of `0` (without the error message that `TH3` prints).
+ * The three components are interpolated together, with the same weights.
+ *
+ * Only histograms with uniform binning are supported.
+ */
+class spacecharge::SCEVoxelGrid {
+
+    public:
+
+  /// Type of the interpolated value: one entry for each component.
+  using Value_t = std::array<double, 3U>;
+
+  /// Creates an empty grid; `interpolate()` will always return `0`.
+  SCEVoxelGrid() = default;
+
+  /**
+   * @brief Copies the content of the three histograms into the grid.
+   * @param hX histogram with the first component of the map
+   * @param hY histogram with the second component of the map
+   * @param hZ histogram with the third component of the map
+   * @throw cet::exception (category: `"SCEVoxelGrid"`) if the histograms have
+   *        different or non-uniform binning
+   */
+  SCEVoxelGrid(TH3 const& hX, TH3 const& hY, TH3 const& hZ);
+
+  /// Returns whether the grid has no content.
+  bool empty() const { return fVoxels.empty(); }
+
+  /// Returns the number of bytes used by the map.
+  std::size_t memorySize() const { return fVoxels.size() * sizeof(Voxel_t); }
+
+  /// Returns the map interpolated at the point (`x`, `y`, `z`).
+  Value_t interpolate(double x, double y, double z) const;
+
+  /**
+   * @brief Interpolates the map at a list of points.
+   * @param n number of points
+   * @param points coordinates of the points (`x`, `y`, `z` of each point)
+   * @param values (output) interpolated value of each of the points
+   *
+   * Both `points` and `values` must have room for `3 * n` entries.
+   * The result is the same as calling `interpolate()` on each point.
+   */
+  void interpolate(std::size_t n, double const* points, double* values) const;
+
+
+    private:
+
+  /// Number of components stored in each voxel (including the padding one).
+  static constexpr std::size_t NComponents = 4U;
+
+  /// Content of a single voxel.
+  struct alignas(16) Voxel_t { float value[NComponents]; };
+
+  /// Binning of one of the axes, as in a `TAxis` with fixed bins.
+  struct Axis_t {
+    int    nBins = 0;
+    double min   = 0.;
+    double max   = 0.;
+    double width = 0.;
+
+    /// Centre of the (`TAxis`-convention) `bin`, computed as `TAxis` does.
+    double binCenter(int bin) const
+      { return min + (bin - 1) * width + 0.5 * width; }
+
+    /**
+     * @brief Finds the bin centres bracketing `v`.
+     * @param v the coordinate to be bracketed
+     * @param[out] bin index (0-based) of the lower bin
+     * @param[out] frac relative position of `v` between the two centres
+     * @return whether `v` is bracketed by two bin centres
+     */
+    bool bracket(double v, int& bin, double& frac) const;
+  }; // Axis_t
+
+  std::array<Axis_t, 3U> fAxes; ///< Binning on the three axes.
+  std::vector<Voxel_t> fVoxels; ///< Content of the map, _z_ running fastest.
+
+  /// Index of the voxel with the specified (0-based) bin indices.
+  std::size_t voxelIndex(int ix, int iy, int iz) const
+    { return (std::size_t(ix) * fAxes[1].nBins + iy) * fAxes[2].nBins + iz; }
+
+  /// Extracts the binning of `axis`, throwing if it is not uniform.
+  static Axis_t makeAxis(TAxis const& axis, std::string const& histName);
+
+}; // class spacecharge::SCEVoxelGrid
+
+
+// -----------------------------------------------------------------------------
+// ---  Inline implementation
+// -----------------------------------------------------------------------------
+inline bool spacecharge::SCEVoxelGrid::Axis_t::bracket
+  (double v, int& bin, double& frac) const
+{
+  // this is TAxis::FindFixBin(), followed by the choice of TH3::Interpolate()
+  int upper;
+  if (v < min) upper = 0;
+  else if (!(v < max)) upper = nBins + 1;
+  else upper = 1 + int(nBins * (v - min) / (max - min));
+
+  if (v < binCenter(upper)) --upper;
+  if ((upper <= 0) || (upper >= nBins)) return false;
+
+  double const lowCenter = binCenter(upper);
+  frac = (v - lowCenter) / (binCenter(upper + 1) - lowCenter);
+  bin = upper - 1;
+  return true;
+} // spacecharge::SCEVoxelGrid::Axis_t::bracket()
+
+
+// -----------------------------------------------------------------------------
+inline spacecharge::SCEVoxelGrid::SCEVoxelGrid
+  (TH3 const& hX, TH3 const& hY, TH3 const& hZ)
+{
+  fAxes = {
+    makeAxis(*hX.GetXaxis(), hX.GetName()),
+    makeAxis(*hX.GetYaxis(), hX.GetName()),
+    makeAxis(*hX.GetZaxis(), hX.GetName())
+  };
+
+  std::array<TH3 const*, 3U> const hists { &hX, &hY, &hZ };
+  for (TH3 const* hist: hists) {
+    if ((hist->GetNbinsX() == fAxes[0].nBins)
+      && (hist->GetNbinsY() == fAxes[1].nBins)
+      && (hist->GetNbinsZ() == fAxes[2].nBins)
+      && (makeAxis(*hist->GetXaxis(), hist->GetName()).width == fAxes[0].width)
+      && (makeAxis(*hist->GetYaxis(), hist->GetName()).width == fAxes[1].width)
+      && (makeAxis(*hist->GetZaxis(), hist->GetName()).width == fAxes[2].width)
+    ) continue;
+    throw cet::exception("SCEVoxelGrid")
+      << "Histogram '" << hist->GetName()
+      << "' has a binning different from '" << hX.GetName() << "'.\n";
+  } // for
+
+  fVoxels.resize
+    (std::size_t(fAxes[0].nBins) * fAxes[1].nBins * fAxes[2].nBins);
+  for (int ix = 0; ix < fAxes[0].nBins; ++ix) {
+    for (int iy = 0; iy < fAxes[1].nBins; ++iy) {
+      for (int iz = 0; iz < fAxes[2].nBins; ++iz) {
+        Voxel_t& voxel = fVoxels[voxelIndex(ix, iy, iz)];
+        for (std::size_t c = 0; c < hists.size(); ++c) {
+          voxel.value[c]
+            = hists[c]->GetBinContent(ix + 1, iy + 1, iz + 1);
+        }
+        voxel.value[NComponents - 1] = 0.0f;
+      } // for z
+    } // for y
+  } // for x
+
+} // spacecharge::SCEVoxelGrid::SCEVoxelGrid()
+
+
+// -----------------------------------------------------------------------------
+inline auto spacecharge::SCEVoxelGrid::interpolate
+  (double x, double y, double z) const -> Value_t
+{
+  Value_t value;
+  double const point[3] { x, y, z };
+  interpolate(1U, point, value.data());
+  return value;
+} // spacecharge::SCEVoxelGrid::interpolate()
+
+
+// -----------------------------------------------------------------------------
+inline void spacecharge::SCEVoxelGrid::interpolate
+  (std::size_t n, double const* points, double* values) const
+{
+  for (std::size_t iPoint = 0; iPoint < n; ++iPoint, points += 3, values += 3) {
+
+    int ix, iy, iz;
+    double xd, yd, zd;
+    if (empty()
+      || !fAxes[0].bracket(points[0], ix, xd)
+      || !fAxes[1].bracket(points[1], iy, yd)
+      || !fAxes[2].bracket(points[2], iz, zd)
+    ) {
+      values[0] = values[1] = values[2] = 0.0;
+      continue;
+    }
+
+    // the two z neighbours are adjacent; the other corners are strides away
+    std::size_t const strideY = fAxes[2].nBins;
+    std::size_t const strideX = strideY * fAxes[1].nBins;
+    Voxel_t const* v00 = fVoxels.data() + voxelIndex(ix, iy, iz);
+    Voxel_t const* v01 = v00 + strideY;
+    Voxel_t const* v10 = v00 + strideX;
+    Voxel_t const* v11 = v10 + strideY;
+
+    // same sequence of operations as TH3::Interpolate(), on all components
+    // at once (the padding component is computed and discarded)
+    double result[NComponents];
+    for (std::size_t c = 0; c < NComponents; ++c) {
+      double const i1 = v00[0].value[c] * (1 - zd) + v00[1].value[c] * zd;
+      double const i2 = v01[0].value[c] * (1 - zd) + v01[1].value[c] * zd;
+      double const j1 = v10[0].value[c] * (1 - zd) + v10[1].value[c] * zd;
+      double const j2 = v11[0].value[c] * (1 - zd) + v11[1].value[c] * zd;
+      double const w1 = i1 * (1 - yd) + i2 * yd;
+      double const w2 = j1 * (1 - yd) + j2 * yd;
+      result[c] = w1 * (1 - xd) + w2 * xd;
+    } // for components
+
+    values[0] = result[0];
+    values[1] = result[1];
+    values[2] = result[2];
+
+  } // for points
+} // spacecharge::SCEVoxelGrid::interpolate()
+
+
+// -----------------------------------------------------------------------------
+inline auto spacecharge::SCEVoxelGrid::makeAxis
+  (TAxis const& axis, std::string const& histName) -> Axis_t
+{
+  if (axis.IsVariableBinSize()) {
+    throw cet::exception("SCEVoxelGrid")
+      << "Histogram '" << histName
+      << "' has variable size bins, which are not supported.\n";
+  }
+  Axis_t binning;
+  binning.nBins = axis.GetNbins();
+  binning.min   = axis.GetXmin();
+  binning.max   = axis.GetXmax();
+  binning.width = (binning.max - binning.min) / double(binning.nBins);
+  return binning;
+} // spacecharge::SCEVoxelGrid::makeAxis()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_TPC_SIMULATION_SPACECHARGE_SCEVOXELGRID_H
@@ -45,7 +45,11 @@ bool spacecharge::SpaceChargeICARUS::Configure(fhicl::ParameterSet const& pset)
       throw cet::exception("SpaceChargeICARUS") << "Could not find the space charge input file '" << fInputFilename << "'!\n";
     }
 
-    if(fRepresentationType == "Voxelized_TH3"){
+    if(fRepresentationType == "Voxelized_TH3") fRepresentation = Representation_t::VoxelizedTH3;
+    else if(fRepresentationType == "Voxelized_Grid") fRepresentation = Representation_t::VoxelizedGrid;
+    else fRepresentation = Representation_t::None;
+
+    if(fRepresentation != Representation_t::None){
       std::cout << "begin loading voxelized TH3s..." << std::endl;
 
       //Load in histograms
@@ -80,6 +84,20 @@ bool spacecharge::SpaceChargeICARUS::Configure(fhicl::ParameterSet const& pset)
 
 
       std::cout << "...finished loading TH3s" << std::endl;
+
+      if(fRepresentation == Representation_t::VoxelizedGrid){
+        //copy the maps into flat grids, the histograms are not needed anymore
+        fFwdGrid = SCEVoxelGrid(*hTrueFwdX, *hTrueFwdY, *hTrueFwdZ);
+        fBkwdGrid = SCEVoxelGrid(*hTrueBkwdX, *hTrueBkwdY, *hTrueBkwdZ);
+        fEFieldGrid = SCEVoxelGrid(*hTrueEFieldX, *hTrueEFieldY, *hTrueEFieldZ);
+        for(TH3F*& hist: SCEhistograms){
+          delete hist;
+          hist = nullptr;
+        }
+        std::cout << "...converted TH3s into voxel grids ("
+                  << (fFwdGrid.memorySize() + fBkwdGrid.memorySize() + fEFieldGrid.memorySize()) / 1024
+                  << " kB)" << std::endl;
+      }
     }
     infile->Close();
   }
@@ -126,93 +144,48 @@ bool spacecharge::SpaceChargeICARUS::EnableCalEfieldSCE() const
 // Primary working method of service that provides position offsets
 geo::Vector_t spacecharge::SpaceChargeICARUS::GetPosOffsets(geo::Point_t const& point) const
 {
-  std::vector<double> thePosOffsets;
-  double xx=point.X(), yy=point.Y(), zz=point.Z();
-  double cryo_corr=1., tpc_corr=1.;
+  if(fRepresentation == Representation_t::None) return {0., 0., 0.};
 
-  if(fRepresentationType == "Voxelized_TH3"){
-    //handle OOAV by projecting edge cases
-    //also only have map for positive cryostat (assume symmetry)
-    //need to invert coordinates for cryo0 (cryo_corr)
-
-    //in larsim, this is how the offsets are used in DriftElectronstoPlane_module
-    // DriftDistance += -1.0 * thePosOffsets[0]
-    // thus need to apply correction to TPCs "left" of cryostat (tpc_corr)
-    // cathode spans x=210.14 and x=210.29 in pos cryostat
-    if(xx>0){
-      cryo_corr=1.0;
-
-      if(f_2D_drift_sim_hack==true)
-	tpc_corr=-1.0;     
-                 
-      if(xx<210.14){
-	tpc_corr=-1.0;
-      }
-      
-    }else{
-      cryo_corr=-1.0;
-      
-      if(f_2D_drift_sim_hack==true)
-	tpc_corr=-1.0;     
-      
-      if(xx<-210.29){
-	tpc_corr=-1.0;	
-      }
-            
-    }
-    fixCoords(&xx, &yy, &zz); //bring into AV and x = abs(x)
-    double offset_x=0., offset_y=0., offset_z=0.;
-    offset_x = tpc_corr*cryo_corr*SCEhistograms.at(0)->Interpolate(xx,yy,zz);
-    offset_y = SCEhistograms.at(1)->Interpolate(xx,yy,zz);
-    offset_z = SCEhistograms.at(2)->Interpolate(xx,yy,zz);
-    thePosOffsets = {offset_x, offset_y, offset_z};
-  }else{
-    thePosOffsets.resize(3, 0.0);
-  }
+  double xyz[3];
+  double const corr = posMapCoords(point, xyz);
 
-  return { thePosOffsets[0], thePosOffsets[1], thePosOffsets[2] };
+  if(fRepresentation == Representation_t::VoxelizedGrid){
+    auto const offsets = fFwdGrid.interpolate(xyz[0], xyz[1], xyz[2]);
+    return { corr*offsets[0], offsets[1], offsets[2] };
+  }
+  geo::Vector_t const offsets = interpolateTH3(0, xyz);
+  return { corr*offsets.X(), offsets.Y(), offsets.Z() };
 }
 
-// Returns the SCE correction at a specific point in the AV
-  geo::Vector_t spacecharge::SpaceChargeICARUS::GetCalPosOffsets(geo::Point_t const& point, int const& TPCid) const
+void spacecharge::SpaceChargeICARUS::GetPosOffsets(std::vector<geo::Point_t> const& points, std::vector<geo::Vector_t>& offsets) const
 {
-  std::vector<double> theCalPosOffsets;
-  //make copies of const vars to modify
-  double xx=point.X(), yy=point.Y(), zz=point.Z();
-  int tpcid = TPCid;
-
-  if(fRepresentationType == "Voxelized_TH3"){
-    //handle OOAV by projecting edge cases
-    //also only have map for positive cryostat (assume symmetry)
-    //need to invert coordinates for cryo0
-    double corr=1.;
-    if(xx<0){
-      corr=-1.0;
-    }
+  offsets.resize(points.size());
+  if(fRepresentation != Representation_t::VoxelizedGrid){
+    for(std::size_t i = 0; i < points.size(); ++i) offsets[i] = GetPosOffsets(points[i]);
+    return;
+  }
 
-    bool x_is_pos = xx > 0;
+  std::vector<double> xyz(3*points.size()), corr(points.size()), values(3*points.size());
+  for(std::size_t i = 0; i < points.size(); ++i) corr[i] = posMapCoords(points[i], &xyz[3*i]);
+  fFwdGrid.interpolate(points.size(), xyz.data(), values.data());
+  for(std::size_t i = 0; i < points.size(); ++i)
+    offsets[i] = { corr[i]*values[3*i], values[3*i+1], values[3*i+2] };
+}
 
-    fixCoords(&xx, &yy, &zz); //bring into AV and x = abs(x)
-    //handle the depositions that was reconstructed in the wrong TPC   
-    //hard code in the cathode faces (got from dump_icarus_geometry.fcl)
-    //
-    //Gray Putnam: update this check to the split-wire Geometry
-    if (x_is_pos && (tpcid == 0 || tpcid == 1) && xx > 210.14 ) { xx = 210.14; }
-    if (x_is_pos && (tpcid == 2 || tpcid == 3) && xx < 210.29 ) { xx = 210.29; }
+// Returns the SCE correction at a specific point in the AV
+geo::Vector_t spacecharge::SpaceChargeICARUS::GetCalPosOffsets(geo::Point_t const& point, int const& TPCid) const
+{
+  if(fRepresentation == Representation_t::None) return {0., 0., 0.};
 
-    if (!x_is_pos && (tpcid == 2 || tpcid == 3) && xx > 210.14 ) { xx = 210.14; }
-    if (!x_is_pos && (tpcid == 0 || tpcid == 1) && xx < 210.29 ) { xx = 210.29; }
+  double xyz[3];
+  double const corr = calPosMapCoords(point, TPCid, xyz);
 
-    double offset_x=0., offset_y=0., offset_z=0.;
-    offset_x = corr*SCEhistograms.at(3)->Interpolate(xx,yy,zz);
-    offset_y = SCEhistograms.at(4)->Interpolate(xx,yy,zz);
-    offset_z = SCEhistograms.at(5)->Interpolate(xx,yy,zz);
-    theCalPosOffsets = {offset_x, offset_y, offset_z};
-  }else{
-    theCalPosOffsets.resize(3, 0.0);
+  if(fRepresentation == Representation_t::VoxelizedGrid){
+    auto const offsets = fBkwdGrid.interpolate(xyz[0], xyz[1], xyz[2]);
+    return { corr*offsets[0], offsets[1], offsets[2] };
   }
-  
-  return { theCalPosOffsets[0], theCalPosOffsets[1], theCalPosOffsets[2] };
+  geo::Vector_t const offsets = interpolateTH3(3, xyz);
+  return { corr*offsets.X(), offsets.Y(), offsets.Z() };
 }
 
 geo::Vector_t spacecharge::SpaceChargeICARUS::GetCalPosOffsets(geo::Point_t const& point, geo::TPCID const& TPCid ) const
@@ -220,26 +193,132 @@ geo::Vector_t spacecharge::SpaceChargeICARUS::GetCalPosOffsets(geo::Point_t cons
   return GetCalPosOffsets(point, TPCid.TPC);
 }
 
+void spacecharge::SpaceChargeICARUS::GetCalPosOffsets(std::vector<geo::Point_t> const& points, int TPCid, std::vector<geo::Vector_t>& offsets) const
+{
+  offsets.resize(points.size());
+  if(fRepresentation != Representation_t::VoxelizedGrid){
+    for(std::size_t i = 0; i < points.size(); ++i) offsets[i] = GetCalPosOffsets(points[i], TPCid);
+    return;
+  }
+
+  std::vector<double> xyz(3*points.size()), corr(points.size()), values(3*points.size());
+  for(std::size_t i = 0; i < points.size(); ++i) corr[i] = calPosMapCoords(points[i], TPCid, &xyz[3*i]);
+  fBkwdGrid.interpolate(points.size(), xyz.data(), values.data());
+  for(std::size_t i = 0; i < points.size(); ++i)
+    offsets[i] = { corr[i]*values[3*i], values[3*i+1], values[3*i+2] };
+}
+
 // Primary working method of service that provides E field offsets
 geo::Vector_t spacecharge::SpaceChargeICARUS::GetEfieldOffsets(geo::Point_t const& point) const
 {
   //chiefly utilized by larsim, ISCalculationSeparate
   //the magnitude of the Efield is most important
-  std::vector<double> theEfieldOffsets;
+  if(fRepresentation == Representation_t::None) return {0., 0., 0.};
+
+  //handle OOAV by projecting edge cases
+  //also only have map for positive cryostat (assume symmetry)
+  double xyz[3] = { point.X(), point.Y(), point.Z() };
+  fixCoords(&xyz[0], &xyz[1], &xyz[2]);
+
+  if(fRepresentation == Representation_t::VoxelizedGrid){
+    auto const offsets = fEFieldGrid.interpolate(xyz[0], xyz[1], xyz[2]);
+    return { offsets[0], offsets[1], offsets[2] };
+  }
+  return interpolateTH3(6, xyz);
+}
+
+void spacecharge::SpaceChargeICARUS::GetEfieldOffsets(std::vector<geo::Point_t> const& points, std::vector<geo::Vector_t>& offsets) const
+{
+  offsets.resize(points.size());
+  if(fRepresentation != Representation_t::VoxelizedGrid){
+    for(std::size_t i = 0; i < points.size(); ++i) offsets[i] = GetEfieldOffsets(points[i]);
+    return;
+  }
+
+  std::vector<double> xyz(3*points.size()), values(3*points.size());
+  for(std::size_t i = 0; i < points.size(); ++i){
+    xyz[3*i] = points[i].X(); xyz[3*i+1] = points[i].Y(); xyz[3*i+2] = points[i].Z();
+    fixCoords(&xyz[3*i], &xyz[3*i+1], &xyz[3*i+2]);
+  }
+  fEFieldGrid.interpolate(points.size(), xyz.data(), values.data());
+  for(std::size_t i = 0; i < points.size(); ++i)
+    offsets[i] = { values[3*i], values[3*i+1], values[3*i+2] };
+}
+
+double spacecharge::SpaceChargeICARUS::posMapCoords(geo::Point_t const& point, double* xyz) const
+{
   double xx=point.X(), yy=point.Y(), zz=point.Z();
-  double offset_x=0., offset_y=0., offset_z=0.;
+  double cryo_corr=1., tpc_corr=1.;
 
-  if(fRepresentationType == "Voxelized_TH3"){
-    //handle OOAV by projecting edge cases
-    //also only have map for positive cryostat (assume symmetry)
-    fixCoords(&xx, &yy, &zz);
-    offset_x = SCEhistograms.at(6)->Interpolate(xx, yy, zz);
-    offset_y = SCEhistograms.at(7)->Interpolate(xx, yy, zz);
-    offset_z = SCEhistograms.at(8)->Interpolate(xx, yy, zz);
+  //handle OOAV by projecting edge cases
+  //also only have map for positive cryostat (assume symmetry)
+  //need to invert coordinates for cryo0 (cryo_corr)
 
-    theEfieldOffsets = {offset_x, offset_y, offset_z};
+  //in larsim, this is how the offsets are used in DriftElectronstoPlane_module
+  // DriftDistance += -1.0 * thePosOffsets[0]
+  // thus need to apply correction to TPCs "left" of cryostat (tpc_corr)
+  // cathode spans x=210.14 and x=210.29 in pos cryostat
+  if(xx>0){
+    cryo_corr=1.0;
+
+    if(f_2D_drift_sim_hack==true)
+      tpc_corr=-1.0;
+
+    if(xx<210.14){
+      tpc_corr=-1.0;
+    }
+
+  }else{
+    cryo_corr=-1.0;
+
+    if(f_2D_drift_sim_hack==true)
+      tpc_corr=-1.0;
+
+    if(xx<-210.29){
+      tpc_corr=-1.0;
+    }
+
+  }
+  fixCoords(&xx, &yy, &zz); //bring into AV and x = abs(x)
+  xyz[0] = xx; xyz[1] = yy; xyz[2] = zz;
+  return tpc_corr*cryo_corr;
+}
+
+double spacecharge::SpaceChargeICARUS::calPosMapCoords(geo::Point_t const& point, int tpcid, double* xyz) const
+{
+  //make copies of const vars to modify
+  double xx=point.X(), yy=point.Y(), zz=point.Z();
+
+  //handle OOAV by projecting edge cases
+  //also only have map for positive cryostat (assume symmetry)
+  //need to invert coordinates for cryo0
+  double corr=1.;
+  if(xx<0){
+    corr=-1.0;
   }
-  return { theEfieldOffsets[0], theEfieldOffsets[1], theEfieldOffsets[2] };
+
+  bool x_is_pos = xx > 0;
+
+  fixCoords(&xx, &yy, &zz); //bring into AV and x = abs(x)
+  //handle the depositions that was reconstructed in the wrong TPC
+  //hard code in the cathode faces (got from dump_icarus_geometry.fcl)
+  //
+  //Gray Putnam: update this check to the split-wire Geometry
+  if (x_is_pos && (tpcid == 0 || tpcid == 1) && xx > 210.14 ) { xx = 210.14; }
+  if (x_is_pos && (tpcid == 2 || tpcid == 3) && xx < 210.29 ) { xx = 210.29; }
+
+  if (!x_is_pos && (tpcid == 2 || tpcid == 3) && xx > 210.14 ) { xx = 210.14; }
+  if (!x_is_pos && (tpcid == 0 || tpcid == 1) && xx < 210.29 ) { xx = 210.29; }
+
+  xyz[0] = xx; xyz[1] = yy; xyz[2] = zz;
+  return corr;
+}
+
+geo::Vector_t spacecharge::SpaceChargeICARUS::interpolateTH3(std::size_t first, double const* xyz) const
+{
+  return { SCEhistograms[first]->Interpolate(xyz[0], xyz[1], xyz[2]),
+           SCEhistograms[first+1]->Interpolate(xyz[0], xyz[1], xyz[2]),
+           SCEhistograms[first+2]->Interpolate(xyz[0], xyz[1], xyz[2]) };
 }
 
 void spacecharge::SpaceChargeICARUS::fixCoords(double* xx, double* yy, double* zz) const{
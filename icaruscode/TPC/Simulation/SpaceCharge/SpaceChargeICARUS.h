@@ -21,6 +21,8 @@
 #include "canvas/Persistency/Common/PtrVector.h"
 #include "art/Framework/Principal/Event.h"
 
+#include "icaruscode/TPC/Simulation/SpaceCharge/SCEVoxelGrid.h"
+
 // FHiCL libraries
 #include "fhiclcpp/ParameterSet.h"
 // c++
@@ -65,6 +67,12 @@ namespace spacecharge
       geo::Vector_t GetCalPosOffsets(geo::Point_t const& point, geo::TPCID const& TPCid) const;
       geo::Vector_t GetCalEfieldOffsets(geo::Point_t const& point, int const& TPCid = 1) const override { return {0.,0.,0.}; }
 
+      //Batch versions of the methods above: offsets.at(i) is for points.at(i)
+      //("Voxelized_Grid" interpolates all the points in one pass)
+      void GetPosOffsets(std::vector<geo::Point_t> const& points, std::vector<geo::Vector_t>& offsets) const;
+      void GetEfieldOffsets(std::vector<geo::Point_t> const& points, std::vector<geo::Vector_t>& offsets) const;
+      void GetCalPosOffsets(std::vector<geo::Point_t> const& points, int TPCid, std::vector<geo::Vector_t>& offsets) const;
+
     private:
     protected:
 
@@ -73,6 +81,15 @@ namespace spacecharge
       ////////////////////////////
       std::vector<TH3F*> SCEhistograms = std::vector<TH3F*>(9);
 
+      //"Voxelized_Grid": maps copied from the histograms into flat grids
+      SCEVoxelGrid fFwdGrid;    //TrueFwd_Displacement
+      SCEVoxelGrid fBkwdGrid;   //TrueBkwd_Displacement
+      SCEVoxelGrid fEFieldGrid; //True_ElecField
+
+      //representation type, decoded once from fRepresentationType
+      enum class Representation_t { None, VoxelizedTH3, VoxelizedGrid };
+      Representation_t fRepresentation = Representation_t::None;
+
       //////////////////////////////
       // DECLARE FHICL PARAMETERS
       /////////////////////////////
@@ -89,6 +106,11 @@ namespace spacecharge
       // DECLARE SUPPLEMENTAL FUNCTIONS
       ////////////////////////////////
       void fixCoords(double* xx, double* yy, double* zz) const;
+      //bring the point into the map coordinates; return the sign of the x offset
+      double posMapCoords(geo::Point_t const& point, double* xyz) const;
+      double calPosMapCoords(geo::Point_t const& point, int tpcid, double* xyz) const;
+      //interpolate the histograms starting at SCEhistograms[first] (Voxelized_TH3)
+      geo::Vector_t interpolateTH3(std::size_t first, double const* xyz) const;
     }; // class SpaceChargeICARUS
 } //namespace spacecharge
 #endif // SPACECHARGE_SPACECHARGEICARUS_H
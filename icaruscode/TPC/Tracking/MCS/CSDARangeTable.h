@@ -0,0 +1,110 @@
+#ifndef CSDARangeTable_H
+#define CSDARangeTable_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace trkf {
+  /**
+   * @file  icaruscode/TPC/Tracking/MCS/CSDARangeTable.h
+   * @class trkf::CSDARangeTable
+   *
+   * @brief Tabulated continuous slowing down range of a particle as function of its energy.
+   *
+   * The range R(E) of a particle with total energy E is the length it travels before its energy drops to the
+   * stopping energy, integrating a given energy loss per unit length dE/dx(E). The energy after travelling a
+   * length L is then R^-1( R(E) - L ). R(E) is tabulated on a uniform energy grid and interpolated linearly; its
+   * inverse is tabulated on a uniform range grid too, only to find the energy interval to invert, so that each
+   * lookup takes a constant time, independent of the length travelled.
+   *
+   * Energies are in GeV, lengths in cm, energy loss in GeV/cm.
+   */
+  class CSDARangeTable
+  {
+  public:
+    /**
+     * @brief Builds the table.
+     * @param dEdx energy loss per unit length, as function of the total energy (must be positive above `stopE`)
+     * @param stopE energy where the particle is considered stopped
+     * @param maxE highest energy in the table
+     * @param nPoints number of points in each table
+     */
+    template <typename DEdx>
+    CSDARangeTable(DEdx dEdx, double stopE, double maxE, std::size_t nPoints = 4096)
+      : stopE_(stopE), maxE_(maxE)
+    {
+      //
+      // range on the uniform energy grid, with Simpson rule in each interval
+      //
+      dE_ = (maxE_ - stopE_) / double(nPoints - 1);
+      rangeAtE_.resize(nPoints, 0.);
+      double prevInv = 1./dEdx(stopE_);
+      for (std::size_t i = 1; i < nPoints; ++i) {
+        const double e = stopE_ + i*dE_;
+        const double midInv = 1./dEdx(e - 0.5*dE_);
+        const double inv = 1./dEdx(e);
+        rangeAtE_[i] = rangeAtE_[i-1] + dE_*(prevInv + 4.*midInv + inv)/6.;
+        prevInv = inv;
+      }
+      //
+      // inverse, on the uniform range grid
+      //
+      dR_ = rangeAtE_.back() / double(nPoints - 1);
+      energyAtR_.resize(nPoints);
+      std::size_t j = 0;
+      for (std::size_t i = 0; i < nPoints; ++i) {
+        const double r = i*dR_;
+        while (j+2 < nPoints && rangeAtE_[j+1] < r) ++j;
+        const double width = rangeAtE_[j+1] - rangeAtE_[j];
+        const double frac = (width > 0.) ? std::clamp((r - rangeAtE_[j])/width, 0., 1.) : 0.;
+        energyAtR_[i] = stopE_ + (j + frac)*dE_;
+      }
+      energyAtR_.back() = maxE_;
+    }
+    //
+    /// Whether the energy is within the table.
+    bool covers(double e) const { return e >= stopE_ && e <= maxE_; }
+    //
+    /// Range of a particle with energy `e` (within the table).
+    double range(double e) const { return interpolate(rangeAtE_, (e - stopE_)/dE_); }
+    //
+    /// Energy of a particle with the specified range (within the table).
+    double energy(double r) const {
+      if (r <= 0.) return stopE_;
+      if (r >= rangeAtE_.back()) return maxE_;
+      // start from the interval of the coarse inverse, which is at most a few intervals away
+      std::size_t i = std::min(std::size_t((interpolate(energyAtR_, r/dR_) - stopE_)/dE_), rangeAtE_.size()-2);
+      while (i > 0 && rangeAtE_[i] > r) --i;
+      while (i+2 < rangeAtE_.size() && rangeAtE_[i+1] < r) ++i;
+      const double width = rangeAtE_[i+1] - rangeAtE_[i];
+      const double frac = (width > 0.) ? (r - rangeAtE_[i])/width : 0.;
+      return stopE_ + (i + frac)*dE_;
+    }
+    //
+    /// Energy after travelling `length` starting with energy `e` (within the table); `0` if stopped.
+    double energyAfter(double e, double length) const {
+      const double r = range(e) - length;
+      return (r > 0.) ? energy(r) : 0.;
+    }
+    //
+  private:
+    static double interpolate(const std::vector<double>& table, double x) {
+      if (x <= 0.) return table.front();
+      const std::size_t i = std::size_t(x);
+      if (i+1 >= table.size()) return table.back();
+      const double frac = x - double(i);
+      return table[i] + frac*(table[i+1] - table[i]);
+    }
+    //
+    double stopE_;
+    double maxE_;
+    double dE_;
+    double dR_;
+    std::vector<double> rangeAtE_;  ///< range on the uniform energy grid
+    std::vector<double> energyAtR_; ///< energy on the uniform range grid (approximate inverse)
+  };
+}
+
+#endif
@@ -20,6 +20,7 @@
 //#include "larreco/RecoAlg/TrajectoryMCSFitter.h"
 #include "icaruscode/TPC/Tracking/MCS/TrajectoryMCSFitterICARUS.h"
 #include "lardata/RecoBaseProxy/Track.h" //needed only if you do use the proxies
+#include "tbb/parallel_for.h"
 #include <memory>
 
 namespace trkf {
@@ -58,6 +59,11 @@ namespace trkf {
       fhicl::Table<TrajectoryMCSFitterICARUS::Config> fitter {
 	Name("fitter")
       };
+      fhicl::Atom<bool> multiThreaded {
+	Name("multiThreaded"),
+	fhicl::Comment("Fit the tracks in parallel."),
+	false
+      };
     };
     using Parameters = art::EDProducer::Table<Config>;
 
@@ -76,6 +82,7 @@ std::vector<recob::Hit> projectHitsOnPlane(art::Event & e,const recob::Track& tr
   private:
     Parameters p_;
     art::InputTag inputTag;
+    bool multiThreaded;
     TrajectoryMCSFitterICARUS mcsfitter;
   };
 }
@@ -84,6 +91,7 @@ trkf::MCSFitProducerICARUS::MCSFitProducerICARUS(trkf::MCSFitProducerICARUS::Par
   : EDProducer{p}, p_(p), mcsfitter(p_().fitter)
 {
   inputTag = art::InputTag(p_().inputs().inputLabel());
+  multiThreaded = p_().multiThreaded();
   produces<std::vector<recob::MCSFitResult> >();
 }
 
@@ -102,7 +110,27 @@ void trkf::MCSFitProducerICARUS::produce(art::Event & e)
 
 //std::cout << " inputh size " << inputVec.size() << std::endl;
 
-for (const auto& element : inputVec) {
+if (multiThreaded) {
+  // the 2D hit residuals only feed the optimal segment length, which does not enter the fit: compute them first
+  for (const auto& element : inputVec) {
+    std::vector<recob::Hit> hits2d=projectHitsOnPlane(e,element,2);
+    mcsfitter.set2DHits(hits2d);
+    mcsfitter.ComputeD3P();
+  }
+  // fitMcs is const, so the tracks can be fit concurrently; the results are stored in the input order
+  std::vector<recob::MCSFitResult> results(inputVec.size());
+  std::vector<char> fitted(inputVec.size(), false);
+  tbb::parallel_for(size_t(0), inputVec.size(), [&](size_t i) {
+    try{
+    results[i] = mcsfitter.fitMcs(inputVec[i]);
+    fitted[i] = true;
+    } catch(...) {}
+  });
+  for (size_t i = 0; i < inputVec.size(); ++i) {
+    if (fitted[i]) output->emplace_back(std::move(results[i]));
+  }
+}
+else for (const auto& element : inputVec) {
     //fit
     std::vector<recob::Hit> hits2d=projectHitsOnPlane(e,element,2);
     mcsfitter.set2DHits(hits2d);
@@ -149,33 +149,53 @@ void TrajectoryMCSFitterICARUS::breakTrajInSegments(const recob::TrackTrajectory
 }
 
 const TrajectoryMCSFitterICARUS::ScanResult TrajectoryMCSFitterICARUS::doLikelihoodScan(std::vector<float>& dtheta, std::vector<float>& seg_nradlengths, std::vector<float>& cumLen, bool fwdFit, bool momDepConst, int pid) const {
+  //
+  // momentum values of the scan; the likelihood is computed only where needed
+  //
+  std::vector<double> vp;
+  for (double p_test = pMin_; p_test <= pMax_; p_test+=pStep_) vp.push_back(p_test);
+  const int np = vp.size();
+  std::vector<double> vlogL(np, 0.);
+  std::vector<bool> done(np, false);
+  auto logLAt = [&](int idx) {
+    if (!done[idx]) {
+      vlogL[idx] = mcsLikelihood(vp[idx], angResol_, dtheta, seg_nradlengths, cumLen, fwdFit, momDepConst, pid);
+      done[idx] = true;
+    }
+    return vlogL[idx];
+  };
+  //
   int    best_idx  = -1;
   double best_logL = std::numeric_limits<double>::max();
-  double best_p    = -1.0;
-  std::vector<float> vlogL;
- for (double p_test = pMin_; p_test <= pMax_; p_test+=pStep_) {
-    double logL = mcsLikelihood(p_test, angResol_, dtheta, seg_nradlengths, cumLen, fwdFit, momDepConst, pid);
-    if (logL < best_logL) {
-      best_p    = p_test;
-      best_logL = logL;
-      best_idx  = vlogL.size();
+  auto scan = [&](int first, int last, int step) {
+    for (int idx = first; idx <= last; idx+=step) {
+      double logL = logLAt(idx);
+      if (logL < best_logL) {
+        best_logL = logL;
+        best_idx  = idx;
+      }
     }
-// std::cout << " ptest " << p_test << " likeli " << logL << " bestp "<< best_p << std::endl;
-//compute likelihood for MC momentum
-  /*  double logL = mcsLikelihood(2., angResol_, dtheta, seg_nradlengths, cumLen, fwdFit, momDepConst, pid);
-    if (logL < best_logL) {
-      best_p    = 2.;
-      best_logL = logL;
-      best_idx  = vlogL.size();
-    }*/
-    vlogL.push_back(logL);
+  };
+  //
+  // coarse scan (including the last point), then full resolution between the neighbours of its minimum;
+  // the fine pass starts over, so that ties are resolved in favour of the lowest momentum as in a full scan
+  //
+  scan(0, np-1, coarseScanSteps_);
+  if (coarseScanSteps_>1 && np>0) {
+    scan(np-1, np-1, 1);
+    const int coarse_idx = best_idx;
+    best_idx  = -1;
+    best_logL = std::numeric_limits<double>::max();
+    if (coarse_idx>=0) scan(std::max(coarse_idx-coarseScanSteps_+1,0), std::min(coarse_idx+coarseScanSteps_-1,np-1), 1);
+    else               scan(0, np-1, 1);
   }
+  const double best_p = (best_idx>=0 ? vp[best_idx] : -1.0);
   //
-  //uncertainty from left side scan
+  //uncertainty from left side scan (likelihood differences in single precision, as they have always been)
   double lunc = -1.0;
   if (best_idx>0) {
     for (int j=best_idx-1;j>=0;j--) {
-      double dLL = vlogL[j]-vlogL[best_idx];
+      double dLL = float(logLAt(j))-float(vlogL[best_idx]);
       if ( dLL<0.5 ) {
 	lunc = (best_idx-j)*pStep_;
       } else break;
@@ -185,7 +205,7 @@ const TrajectoryMCSFitterICARUS::ScanResult TrajectoryMCSFitterICARUS::doLikelih
   double runc = -1.0;
   if (best_idx<int(vlogL.size()-1)) {  
     for (unsigned int j=best_idx+1;j<vlogL.size();j++) {
-      double dLL = vlogL[j]-vlogL[best_idx];
+      double dLL = float(logLAt(j))-float(vlogL[best_idx]);
       if ( dLL<0.5 ) {
 	runc = (j-best_idx)*pStep_;
       } else break;
@@ -359,6 +379,12 @@ double TrajectoryMCSFitterICARUS::energyLossBetheBloch(const double mass,const d
 }
 //
 double TrajectoryMCSFitterICARUS::GetE(const double initial_E, const double length_travelled, const double m) const {
+  //
+  if (eLossMode_==3) {
+    // Bethe-Bloch, integrated once in the range table
+    const CSDARangeTable* table = rangeTable(m);
+    if (table && table->covers(initial_E)) return table->energyAfter(initial_E, length_travelled);
+  }
   //
   const double step_size = length_travelled / nElossSteps_;
   //
@@ -366,7 +392,7 @@ double TrajectoryMCSFitterICARUS::GetE(const double initial_E, const double leng
   const double m2 = m*m;
   //
   for (auto i = 0; i < nElossSteps_; ++i) {
-    if (eLossMode_==2) {
+    if (eLossMode_==2 || eLossMode_==3) {
       double dedx = energyLossBetheBloch(m,current_E);
       current_E -= (dedx * step_size);
     } else {
@@ -380,6 +406,25 @@ double TrajectoryMCSFitterICARUS::GetE(const double initial_E, const double leng
   }
   return current_E;
 }
+//
+void TrajectoryMCSFitterICARUS::buildRangeTables() {
+  //
+  // tables cover the scan range; the particle stops (GetE returns 0) when its energy drops to its mass
+  //
+  rangeTables_.clear();
+  for (int pid : {13, 211, 321, 2212}) {
+    const double m = mass(pid);
+    const double maxE = sqrt((pMax_+pStep_)*(pMax_+pStep_) + m*m);
+    rangeTables_.emplace_back(m, CSDARangeTable([this,m](double e){ return energyLossBetheBloch(m,e); }, m, maxE));
+  }
+}
+//
+const CSDARangeTable* TrajectoryMCSFitterICARUS::rangeTable(const double m) const {
+  for (const auto& massTable : rangeTables_) {
+    if (massTable.first==m) return &massTable.second;
+  }
+  return nullptr;
+}
 double TrajectoryMCSFitterICARUS::GetOptimalSegLen(const double guess_p, const int n_points, const int plane, const double length_travelled) const {
   //
 // check units of measurment! (energy, length...)
@@ -9,6 +9,7 @@
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardata/RecoObjects/TrackState.h"
+#include "icaruscode/TPC/Tracking/MCS/CSDARangeTable.h"
 
 namespace trkf {
   /**
@@ -66,7 +67,7 @@ namespace trkf {
       };
       fhicl::Atom<int> eLossMode {
         Name("eLossMode"),
-	Comment("Default is MPV Landau. Choose 1 for MIP (constant); 2 for Bethe-Bloch."),
+	Comment("Default is MPV Landau. Choose 1 for MIP (constant); 2 for Bethe-Bloch; 3 for Bethe-Bloch from a precomputed range table."),
 	0
       };
       fhicl::Atom<double> pMin {
@@ -84,6 +85,11 @@ namespace trkf {
 	Comment("Step in momentum value in likelihood scan."),
 	0.01
       };
+      fhicl::Atom<int> coarseScanSteps {
+        Name("coarseScanSteps"),
+	Comment("Likelihood is first scanned every this many pStep, then refined in steps of pStep around the minimum; this may miss a minimum between the coarse steps. 1 (default) is the full scan."),
+	1
+      };
       fhicl::Atom<double> angResol {
         Name("angResol"),
 	Comment("Angular resolution parameter used in modified Highland formula. Unit is mrad."),
@@ -92,7 +98,7 @@ namespace trkf {
     };
     using Parameters = fhicl::Table<Config>;
     //
-    TrajectoryMCSFitterICARUS(int pIdHyp, int minNSegs, double segLen, int minHitsPerSegment, int nElossSteps, int eLossMode, double pMin, double pMax, double pStep, double angResol){
+    TrajectoryMCSFitterICARUS(int pIdHyp, int minNSegs, double segLen, int minHitsPerSegment, int nElossSteps, int eLossMode, double pMin, double pMax, double pStep, double angResol, int coarseScanSteps = 1){
       pIdHyp_ = pIdHyp;
       minNSegs_ = minNSegs;
       segLen_ = segLen;
@@ -103,9 +109,11 @@ namespace trkf {
       pMax_ = pMax;
       pStep_ = pStep;
       angResol_ = angResol;
+      coarseScanSteps_ = std::max(coarseScanSteps,1);
+      if (eLossMode_==3) buildRangeTables();
     }
     explicit TrajectoryMCSFitterICARUS(const Parameters & p)
-      : TrajectoryMCSFitterICARUS(p().pIdHypothesis(),p().minNumSegments(),p().segmentLength(),p().minHitsPerSegment(),p().nElossSteps(),p().eLossMode(),p().pMin(),p().pMax(),p().pStep(),p().angResol()) {}
+      : TrajectoryMCSFitterICARUS(p().pIdHypothesis(),p().minNumSegments(),p().segmentLength(),p().minHitsPerSegment(),p().nElossSteps(),p().eLossMode(),p().pMin(),p().pMax(),p().pStep(),p().angResol(),p().coarseScanSteps()) {}
     //
     recob::MCSFitResult fitMcs(const recob::TrackTrajectory& traj, bool momDepConst = true) const { return fitMcs(traj,pIdHyp_,momDepConst); }
     recob::MCSFitResult fitMcs(const recob::Track& track,          bool momDepConst = true) const { return fitMcs(track,pIdHyp_,momDepConst); }
@@ -154,6 +162,7 @@ void ComputeD3P()   ;
     double energyLossLandau(const double mass2,const double E2, const double x) const;
     //
     double GetE(const double initial_E, const double length_travelled, const double mass) const;
+    const CSDARangeTable* rangeTable(const double mass) const;
     void set2DHits(std::vector<recob::Hit> h) {hits2d=h;}
   //  void projectHitsOnPlane(art::Event & e,const recob::Track& traj,int p) const
     //
@@ -168,6 +177,10 @@ void ComputeD3P()   ;
     double pMax_;
     double pStep_;
     double angResol_;
+    int    coarseScanSteps_;
+
+    void buildRangeTables();
+    std::vector<std::pair<double,CSDARangeTable>> rangeTables_; ///< Bethe-Bloch range tables, by particle mass
 
     std::vector<recob::Hit> hits2d;
     float d3p;
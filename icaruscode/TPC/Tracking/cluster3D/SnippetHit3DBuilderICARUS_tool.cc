@@ -31,13 +31,18 @@
 #include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
 #include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
 #include "larreco/RecoAlg/Cluster3DAlgs/IHit3DBuilder.h"
+#include "icaruscode/TPC/Tracking/cluster3D/WireCrossingIndex.h"
 
 // Eigen
 #include <Eigen/Core>
 
+// TBB
+#include "tbb/parallel_for.h"
+
 // std includes
 #include <string>
 #include <iostream>
+#include <iterator> // std::make_move_iterator
 #include <memory>
 #include <numeric> // std::accumulate
 
@@ -74,6 +79,7 @@ using TPCToPlaneToWireToHitSetMap  = std::map<geo::TPCID, PlaneToWireToHitSetMap
 using HitVectorMap                 = std::map<size_t, HitVector>;
 using SnippetHitMapItrPair         = std::pair<SnippetHitMap::iterator,SnippetHitMap::iterator>;
 using PlaneSnippetHitMapItrPairVec = std::vector<SnippetHitMapItrPair>;
+using HitPairVector                = std::vector<reco::ClusterHit3D>;
 
 /**
  *  @brief  SnippetHit3DBuilderICARUS class definiton
@@ -146,7 +152,7 @@ private:
     /**
      *  @brief Given the ClusterHit2D objects, build the HitPairMap
      */
-    size_t BuildHitPairMapByTPC(PlaneSnippetHitMapItrPairVec& planeSnippetHitMapItrPairVec, reco::HitPairList& hitPairList) const;
+    size_t BuildHitPairMapByTPC(PlaneSnippetHitMapItrPairVec& planeSnippetHitMapItrPairVec, HitPairVector& hitPairList) const;
 
     /**
      *  @brief This builds a list of candidate hit pairs from lists of hits on two planes
@@ -160,13 +166,13 @@ private:
     /**
      *  @brief This algorithm takes lists of hit pairs and finds good triplets
      */
-    void findGoodTriplets(HitMatchTripletVecMap&, HitMatchTripletVecMap&, reco::HitPairList&, bool = false) const;
+    void findGoodTriplets(HitMatchTripletVecMap&, HitMatchTripletVecMap&, HitPairVector&, bool = false) const;
 
     /**
      * @brief This will look at storing pair "orphans" where the 2D hits are otherwise unused
      */
 
-    int saveOrphanPairs(HitMatchTripletVecMap&, reco::HitPairList&) const;
+    int saveOrphanPairs(HitMatchTripletVecMap&, HitPairVector&) const;
 
     /**
      *  @brief Make a HitPair object by checking two hits
@@ -196,9 +202,14 @@ private:
     bool WireIDsIntersect(const geo::WireID&, const geo::WireID&, geo::WireIDIntersection&) const;
 
     /**
-     * @brief function to compute the distance of closest approach and the arc length to the points of closest approach
+     * @brief fills the wire crossing index with the wires of all the TPC planes
      */
-    float closestApproach(const Eigen::Vector3f&, const Eigen::Vector3f&, const Eigen::Vector3f&, const Eigen::Vector3f&, float&, float&) const;
+    void buildWireCrossingIndex();
+
+    /**
+     * @brief returns the index of the TPC of a wire in the wire crossing index
+     */
+    size_t wireIndexTPC(const geo::WireID& wireID) const {return wireID.Cryostat * m_geometry->NTPC() + wireID.TPC;}
 
     /**
      *  @brief A utility routine for finding a 2D hit closest in time to the given pair
@@ -311,6 +322,7 @@ private:
     mutable bool                            m_weHaveAllBeenHereBefore = false;
 
     const geo::Geometry*                    m_geometry;              //< pointer to the Geometry service
+    WireCrossingIndex                       m_wireCrossingIndex;     //< wire positions and crossings, by TPC and plane
     const lariov::ChannelStatusProvider*    m_channelFilter;
 };
 
@@ -362,6 +374,9 @@ void SnippetHit3DBuilderICARUS::configure(fhicl::ParameterSet const &pset)
     m_wirePitch[1] = m_geometry->WirePitch(geo::PlaneID{tpcid, 1});
     m_wirePitch[2] = m_geometry->WirePitch(geo::PlaneID{tpcid, 2});
 
+    // Cache the wire geometry used to match the hits
+    buildWireCrossingIndex();
+
     // Access ART's TFileService, which will handle creating and writing
     // histograms and n-tuples for us.
     if (m_outputHistograms)
@@ -608,6 +623,9 @@ size_t SnippetHit3DBuilderICARUS::BuildHitPairMap(PlaneToSnippetHitMap& planeToS
 
     size_t nTriplets(0);
 
+    // Collect the hits of each TPC with hits on at least two planes
+    std::vector<PlaneSnippetHitMapItrPairVec> tpcHitItrVecs;
+
     // Set up to loop over cryostats and tpcs...
     for(size_t cryoIdx = 0; cryoIdx < m_geometry->Ncryostats(); cryoIdx++)
     {
@@ -635,12 +653,63 @@ size_t SnippetHit3DBuilderICARUS::BuildHitPairMap(PlaneToSnippetHitMap& planeToS
                                                       SnippetHitMapItrPair(snippetHitMap1.begin(),snippetHitMap1.end()),
                                                       SnippetHitMapItrPair(snippetHitMap2.begin(),snippetHitMap2.end())};
 
-            totalNumHits += BuildHitPairMapByTPC(hitItrVec, hitPairList);
+            tpcHitItrVecs.emplace_back(std::move(hitItrVec));
         }
     }
 
+    // Each TPC builds its hit pairs in its own vector, behind any pair already in the list
+    std::vector<HitPairVector> tpcHitPairVecs(tpcHitItrVecs.size() + 1);
+
+    tpcHitPairVecs.front().assign(std::make_move_iterator(hitPairList.begin()),std::make_move_iterator(hitPairList.end()));
+    hitPairList.clear();
+
+    auto buildTPCHitPairs = [&](size_t tpcIdx)
+    {
+        HitPairVector& tpcHitPairVec = tpcHitPairVecs[tpcIdx + 1];
+
+        BuildHitPairMapByTPC(tpcHitItrVecs[tpcIdx], tpcHitPairVec);
+
+        std::stable_sort(tpcHitPairVec.begin(),tpcHitPairVec.end(),SetPairStartTimeOrder);
+    };
+
+    // The TPCs share no 2D hits, but the monitoring vectors are filled in TPC order
+    if (m_outputHistograms)
+    {
+        for(size_t tpcIdx = 0; tpcIdx < tpcHitItrVecs.size(); tpcIdx++) buildTPCHitPairs(tpcIdx);
+    }
+    else tbb::parallel_for(size_t(0), tpcHitItrVecs.size(), buildTPCHitPairs);
+
+    std::stable_sort(tpcHitPairVecs.front().begin(),tpcHitPairVecs.front().end(),SetPairStartTimeOrder);
+
+    // The IDs are the position of the 3D hits in their TPC vector, make them the position in the combined list
+    size_t idOffset(tpcHitPairVecs.front().size());
+
+    for(size_t tpcIdx = 1; tpcIdx < tpcHitPairVecs.size(); tpcIdx++)
+    {
+        for(auto& hit3D : tpcHitPairVecs[tpcIdx]) hit3D.setID(hit3D.getID() + idOffset);
+
+        idOffset     += tpcHitPairVecs[tpcIdx].size();
+        totalNumHits += tpcHitPairVecs[tpcIdx].size();
+    }
+
     // Return the hit pair list but sorted by z and y positions (faster traversal in next steps)
-    hitPairList.sort(SetPairStartTimeOrder);
+    // The sorted vectors are merged taking the earlier TPC first for equal times, as a stable sort of the whole list would
+    std::vector<std::pair<HitPairVector::iterator,HitPairVector::iterator>> mergeItrVec;
+
+    for(auto& tpcHitPairVec : tpcHitPairVecs)
+        if (!tpcHitPairVec.empty()) mergeItrVec.emplace_back(tpcHitPairVec.begin(),tpcHitPairVec.end());
+
+    while(!mergeItrVec.empty())
+    {
+        auto nextItr = mergeItrVec.begin();
+
+        for(auto mergeItr = std::next(nextItr); mergeItr != mergeItrVec.end(); mergeItr++)
+            if (SetPairStartTimeOrder(*mergeItr->first, *nextItr->first)) nextItr = mergeItr;
+
+        hitPairList.emplace_back(std::move(*nextItr->first));
+
+        if (++nextItr->first == nextItr->second) mergeItrVec.erase(nextItr);
+    }
 
     // Where are we?
     mf::LogDebug("SnippetHit3D") << "Total number hits: " << totalNumHits << std::endl;
@@ -650,7 +719,7 @@ size_t SnippetHit3DBuilderICARUS::BuildHitPairMap(PlaneToSnippetHitMap& planeToS
     return hitPairList.size();
 }
 
-size_t SnippetHit3DBuilderICARUS::BuildHitPairMapByTPC(PlaneSnippetHitMapItrPairVec& snippetHitMapItrVec, reco::HitPairList& hitPairList) const
+size_t SnippetHit3DBuilderICARUS::BuildHitPairMapByTPC(PlaneSnippetHitMapItrPairVec& snippetHitMapItrVec, HitPairVector& hitPairList) const
 {
     /**
      *  @brief Given input 2D hits, build out the lists of possible 3D hits
@@ -796,7 +865,7 @@ int SnippetHit3DBuilderICARUS::findGoodHitPairs(SnippetHitMap::iterator& firstSn
     return numPairs;
 }
 
-void SnippetHit3DBuilderICARUS::findGoodTriplets(HitMatchTripletVecMap& pair12Map, HitMatchTripletVecMap& pair13Map, reco::HitPairList& hitPairList, bool tagged) const
+void SnippetHit3DBuilderICARUS::findGoodTriplets(HitMatchTripletVecMap& pair12Map, HitMatchTripletVecMap& pair13Map, HitPairVector& hitPairList, bool tagged) const
 {
     // Build triplets from the two lists of hit pairs
     if (!pair12Map.empty())
@@ -912,7 +981,7 @@ void SnippetHit3DBuilderICARUS::findGoodTriplets(HitMatchTripletVecMap& pair12Ma
     return;
 }
 
-int SnippetHit3DBuilderICARUS::saveOrphanPairs(HitMatchTripletVecMap& pairMap, reco::HitPairList& hitPairList) const
+int SnippetHit3DBuilderICARUS::saveOrphanPairs(HitMatchTripletVecMap& pairMap, HitPairVector& hitPairList) const
 {
     int curTripletCount = hitPairList.size();
 
@@ -1397,81 +1466,55 @@ bool SnippetHit3DBuilderICARUS::makeHitTriplet(reco::ClusterHit3D&       hitTrip
     return result;
 }
 
-bool SnippetHit3DBuilderICARUS::WireIDsIntersect(const geo::WireID& wireID0, const geo::WireID& wireID1, geo::WireIDIntersection& widIntersection) const
+void SnippetHit3DBuilderICARUS::buildWireCrossingIndex()
 {
-    bool success(false);
-
-    // Do quick check that things are in the same logical TPC
-    if (wireID0.Cryostat != wireID1.Cryostat || wireID0.TPC != wireID1.TPC || wireID0.Plane == wireID1.Plane) return success;
-        
-    // Recover wire geometry information for each wire
-    const geo::WireGeo& wireGeo0 = m_geometry->WireIDToWireGeo(wireID0);
-    const geo::WireGeo& wireGeo1 = m_geometry->WireIDToWireGeo(wireID1);
-
-    // Get wire position and direction for first wire
-    auto wirePosArr = wireGeo0.GetCenter();
+    m_wireCrossingIndex.clear();
 
-    Eigen::Vector3f wirePos0(wirePosArr.X(),wirePosArr.Y(),wirePosArr.Z());
-    Eigen::Vector3f wireDir0(wireGeo0.Direction().X(),wireGeo0.Direction().Y(),wireGeo0.Direction().Z());
-
-    //*********************************
-    // Kludge
-//    if (wireID0.Plane > 0) wireDir0[2] = -wireDir0[2];
+    for(size_t cryoIdx = 0; cryoIdx < m_geometry->Ncryostats(); cryoIdx++)
+    {
+        for(size_t tpcIdx = 0; tpcIdx < m_geometry->NTPC(); tpcIdx++)
+        {
+            for(size_t planeIdx = 0; planeIdx < m_geometry->Nplanes(); planeIdx++)
+            {
+                geo::PlaneID planeID(cryoIdx,tpcIdx,planeIdx);
 
-    // And now the second one
-    wirePosArr = wireGeo1.GetCenter();
+                std::vector<WireCrossingIndex::Wire_t> wires;
 
-    Eigen::Vector3f wirePos1(wirePosArr.X(),wirePosArr.Y(),wirePosArr.Z());
-    Eigen::Vector3f wireDir1(wireGeo1.Direction().X(),wireGeo1.Direction().Y(),wireGeo1.Direction().Z());
+                wires.reserve(m_geometry->Nwires(planeID));
 
-    //**********************************
-    // Kludge
-//    if (wireID1.Plane > 0) wireDir1[2] = -wireDir1[2];
+                for(unsigned int wireIdx = 0; wireIdx < m_geometry->Nwires(planeID); wireIdx++)
+                {
+                    const geo::WireGeo& wireGeo = m_geometry->WireIDToWireGeo(geo::WireID(planeID,wireIdx));
 
-    // Get the distance of closest approach
-    float arcLen0;
-    float arcLen1;
+                    auto const wirePosArr = wireGeo.GetCenter();
 
-    if (closestApproach(wirePos0, wireDir0, wirePos1, wireDir1, arcLen0, arcLen1))
-    {
-        // Now check that arc lengths are within range
-        if (std::abs(arcLen0) < wireGeo0.HalfL() && std::abs(arcLen1) < wireGeo1.HalfL())
-        {
-            Eigen::Vector3f poca0 = wirePos0 + arcLen0 * wireDir0;
-
-            widIntersection.y = poca0[1];
-            widIntersection.z = poca0[2];
+                    wires.push_back({Eigen::Vector3f(wirePosArr.X(),wirePosArr.Y(),wirePosArr.Z()),
+                                     Eigen::Vector3f(wireGeo.Direction().X(),wireGeo.Direction().Y(),wireGeo.Direction().Z()),
+                                     wireGeo.HalfL()});
+                }
 
-            success = true;
+                m_wireCrossingIndex.setPlane(wireIndexTPC(geo::WireID(planeID,0)), planeIdx, std::move(wires));
+            }
         }
     }
 
-    return success;
+    m_wireCrossingIndex.buildCrossings();
 }
 
-float SnippetHit3DBuilderICARUS::closestApproach(const Eigen::Vector3f& P0,
-                                           const Eigen::Vector3f& u0,
-                                           const Eigen::Vector3f& P1,
-                                           const Eigen::Vector3f& u1,
-                                           float&                 arcLen0,
-                                           float&                 arcLen1) const
+bool SnippetHit3DBuilderICARUS::WireIDsIntersect(const geo::WireID& wireID0, const geo::WireID& wireID1, geo::WireIDIntersection& widIntersection) const
 {
-    // Technique is to compute the arclength to each point of closest approach
-    Eigen::Vector3f w0 = P0 - P1;
-    float a(1.);
-    float b(u0.dot(u1));
-    float c(1.);
-    float d(u0.dot(w0));
-    float e(u1.dot(w0));
-    float den(a * c - b * b);
-
-    arcLen0 = (b * e - c * d) / den;
-    arcLen1 = (a * e - b * d) / den;
-
-    Eigen::Vector3f poca0 = P0 + arcLen0 * u0;
-    Eigen::Vector3f poca1 = P1 + arcLen1 * u1;
-
-    return (poca0 - poca1).norm();
+    // Do quick check that things are in the same logical TPC
+    if (wireID0.Cryostat != wireID1.Cryostat || wireID0.TPC != wireID1.TPC || wireID0.Plane == wireID1.Plane) return false;
+
+    float y;
+    float z;
+
+    if (!m_wireCrossingIndex.intersect(wireIndexTPC(wireID0), wireID0.Plane, wireID0.Wire, wireID1.Plane, wireID1.Wire, y, z)) return false;
+
+    widIntersection.y = y;
+    widIntersection.z = z;
+
+    return true;
 }
 
 float SnippetHit3DBuilderICARUS::chargeIntegral(float peakMean,
@@ -1642,22 +1685,17 @@ geo::WireID SnippetHit3DBuilderICARUS::NearestWireID(const Eigen::Vector3f& posi
 {
     geo::WireID wireID = wireIDIn;
 
-    // Embed the call to the geometry's services nearest wire id method in a try-catch block
-    try
-    {
-        // Switch from NearestWireID to this method to avoid the roundoff error issues...
-        //double distanceToWire = m_geometry->Plane(wireIDIn).WireCoordinate(geo::vect::toPoint(position.data()));
-
-        //wireID.Wire = int(distanceToWire);
+    // The wire coordinate of each plane is cached, so this is a simple rounding
+    long nearestWire = m_wireCrossingIndex.nearestWire(wireIndexTPC(wireIDIn), wireIDIn.Plane, position[1], position[2]);
 
-        // Not sure the thinking above but is wrong... switch back to NearestWireID...
-        wireID = m_geometry->NearestWireID(geo::vect::toPoint(position.data()),wireIDIn);
+    if (nearestWire >= 0 && nearestWire < long(m_wireCrossingIndex.nWires(wireIndexTPC(wireIDIn), wireIDIn.Plane)))
+    {
+        wireID.Wire = nearestWire;
     }
-    catch(...) // I am not sure what type of exception is thrown by the geometry service so catch all
+    else
     {
         // This can happen, almost always because the coordinates are **just** out of range
-        //mf::LogWarning("Cluster3D") << "Exception caught finding nearest wire, position - " << exc.what() << std::endl;
-        mf::LogWarning("SnippetHit3D") << "Exception caught finding nearest wire, position " << std::endl;
+        mf::LogWarning("SnippetHit3D") << "Nearest wire out of range, position " << std::endl;
 
         // Assume extremum for wire number depending on z coordinate
         if (position[2] < 0.5 * m_geometry->DetLength()) wireID.Wire = 0;
@@ -1669,49 +1707,18 @@ geo::WireID SnippetHit3DBuilderICARUS::NearestWireID(const Eigen::Vector3f& posi
 
 float SnippetHit3DBuilderICARUS::DistanceFromPointToHitWire(const Eigen::Vector3f& position, const geo::WireID& wireIDIn) const
 {
-    float distance = std::numeric_limits<float>::max();
+    // Recover the cached wire geometry information
+    const WireCrossingIndex::Wire_t* wire = m_wireCrossingIndex.wire(wireIndexTPC(wireIDIn), wireIDIn.Plane, wireIDIn.Wire);
 
-    // Embed the call to the geometry's services nearest wire id method in a try-catch block
-    try
-    {
-        // Recover wire geometry information for each wire
-        const geo::WireGeo& wireGeo = m_geometry->WireIDToWireGeo(wireIDIn);
-
-        // Get wire position and direction for first wire
-        auto const wirePosArr = wireGeo.GetCenter();
-
-        Eigen::Vector3f wirePos(wirePosArr.X(),wirePosArr.Y(),wirePosArr.Z());
-        Eigen::Vector3f wireDir(wireGeo.Direction().X(),wireGeo.Direction().Y(),wireGeo.Direction().Z());
-
-        //*********************************
-        // Kludge
-//        if (wireIDIn.Plane > 0) wireDir[2] = -wireDir[2];
-
-
-        // Want the hit position to have same x value as wire coordinates
-        Eigen::Vector3f hitPosition(wirePos[0],position[1],position[2]);
-
-        // Get arc length to doca
-        double arcLen = (hitPosition - wirePos).dot(wireDir);
-
-        // Make sure arclen is in range
-        if (abs(arcLen) < wireGeo.HalfL())
-        {
-            Eigen::Vector3f docaVec = hitPosition - (wirePos + arcLen * wireDir);
-
-            distance = docaVec.norm();
-        }
-    }
-    catch(std::exception& exc)
+    if (!wire)
     {
         // This can happen, almost always because the coordinates are **just** out of range
-        mf::LogWarning("SnippetHit3D") << "Exception caught finding nearest wire, position - " << exc.what() << std::endl;
+        mf::LogWarning("SnippetHit3D") << "Wire not found, wire ID - " << wireIDIn << std::endl;
 
-        // Assume extremum for wire number depending on z coordinate
-        distance = 0.;
+        return 0.;
     }
 
-    return distance;
+    return WireCrossingIndex::distanceToWire(*wire, position);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,351 @@
+/**
+ *  @file   WireCrossingIndex.h
+ *
+ *  @brief  Precomputed wire geometry for matching hits on different planes
+ *
+ *  The 3D hit builders test the crossing of two wires for every candidate
+ *  pair of hits, and the distance of a 3D point from a wire for every
+ *  candidate triplet. This index caches, once per job, the position and
+ *  direction of every wire in the form used by those tests, and for each wire
+ *  the range of wires of each other plane of the same TPC it may cross.
+ *
+ *  It does not depend on the LArSoft geometry: the wires are filled by the
+ *  caller, plane by plane, sorted by wire number.
+ */
+#ifndef ICARUSCODE_TPC_TRACKING_CLUSTER3D_WIRECROSSINGINDEX_H
+#define ICARUSCODE_TPC_TRACKING_CLUSTER3D_WIRECROSSINGINDEX_H
+
+// Eigen
+#include <Eigen/Core>
+
+// std includes
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // std::greater
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace lar_cluster3d {
+
+/**
+ *  @brief  Per-TPC, per-plane-pair wire crossing index
+ *
+ *  Crossings are computed with the same single precision arithmetic as
+ *  `SnippetHit3DBuilderICARUS` always did (closest approach of the two wire
+ *  lines, within the half length of both wires), so the results are the same
+ *  bit by bit; the index only saves the geometry lookups and skips the wire
+ *  pairs which can't cross.
+ *
+ *  A table of all the crossing points, addressed by the two wire numbers,
+ *  would take hundreds of MB with ICARUS planes of 5600 wires: instead, for
+ *  each wire and each other plane the index stores the range of the wires
+ *  whose center is close enough to the line of the first wire to cross it
+ *  within its length. The ranges are found from the projection of the wire
+ *  centers on the direction normal to the wires, which is monotonic with the
+ *  wire number; a plane where this is not true gets no ranges (all the wires
+ *  are tried).
+ *
+ *  The nearest wire to a point is found in constant time from the pitch and
+ *  offset of the wire coordinate of each plane.
+ */
+class WireCrossingIndex
+{
+public:
+    /// Geometry of a wire, in the format of the matching tests.
+    struct Wire_t
+    {
+        Eigen::Vector3f center;     ///< wire center [cm]
+        Eigen::Vector3f direction;  ///< wire direction (unit vector)
+        double          halfLength; ///< half length of the wire [cm]
+    };
+
+    /// Removes all the planes.
+    void clear() { m_tpcs.clear(); }
+
+    /**
+     *  @brief Sets the wires of a plane
+     *
+     *  @param tpc   index of the TPC (any dense index chosen by the caller)
+     *  @param plane index of the plane in the TPC
+     *  @param wires the wires of the plane, sorted by wire number
+     *
+     *  The crossing ranges are computed by `buildCrossings()`.
+     */
+    void setPlane(std::size_t tpc, unsigned int plane, std::vector<Wire_t> wires)
+    {
+        if (m_tpcs.size() <= tpc)            m_tpcs.resize(tpc + 1);
+        if (m_tpcs[tpc].size() <= plane)     m_tpcs[tpc].resize(plane + 1);
+
+        Plane_t& planeInfo = m_tpcs[tpc][plane];
+
+        planeInfo = Plane_t{};
+        planeInfo.wires = std::move(wires);
+
+        if (planeInfo.wires.empty()) return;
+
+        // Coordinate normal to the wires, in the y-z plane
+        Wire_t const& firstWire = planeInfo.wires.front();
+        double        dirY      = firstWire.direction[1];
+        double        dirZ      = firstWire.direction[2];
+        double        dirNorm   = std::hypot(dirY, dirZ);
+
+        planeInfo.normalY = -dirZ / dirNorm;
+        planeInfo.normalZ =  dirY / dirNorm;
+
+        planeInfo.projections.reserve(planeInfo.wires.size());
+
+        for(Wire_t const& wire : planeInfo.wires)
+        {
+            planeInfo.projections.push_back(planeInfo.project(wire.center[1], wire.center[2]));
+
+            // how far from its center a point of this wire may project
+            double sideStep = std::abs(planeInfo.normalY * wire.direction[1] + planeInfo.normalZ * wire.direction[2]) * wire.halfLength;
+
+            planeInfo.maxSideStep = std::max(planeInfo.maxSideStep, sideStep);
+        }
+
+        std::vector<double> const& proj = planeInfo.projections;
+
+        planeInfo.increasing = std::is_sorted(proj.begin(), proj.end());
+        planeInfo.monotonic  = planeInfo.increasing || std::is_sorted(proj.rbegin(), proj.rend());
+
+        if (proj.size() > 1) planeInfo.pitch = (proj.back() - proj.front()) / (proj.size() - 1);
+    }
+
+    /// Computes the crossing ranges for all pairs of planes of each TPC.
+    void buildCrossings()
+    {
+        for(auto& tpc : m_tpcs)
+        {
+            for(std::size_t plane0 = 0; plane0 < tpc.size(); plane0++)
+            {
+                Plane_t& planeInfo0 = tpc[plane0];
+
+                planeInfo0.crossings.assign(tpc.size(), {});
+
+                for(std::size_t plane1 = 0; plane1 < tpc.size(); plane1++)
+                {
+                    Plane_t const& planeInfo1 = tpc[plane1];
+
+                    if (plane1 == plane0 || !planeInfo1.monotonic || planeInfo1.wires.empty()) continue;
+
+                    std::vector<WireRange_t>& ranges = planeInfo0.crossings[plane1];
+
+                    ranges.reserve(planeInfo0.wires.size());
+
+                    for(Wire_t const& wire : planeInfo0.wires)
+                    {
+                        // span of the projections of the points of this wire
+                        double center = planeInfo1.project(wire.center[1], wire.center[2]);
+                        double reach  = std::abs(planeInfo1.normalY * wire.direction[1] + planeInfo1.normalZ * wire.direction[2]) * wire.halfLength
+                                      + planeInfo1.maxSideStep + CrossingTolerance;
+
+                        ranges.push_back(planeInfo1.wiresBetween(center - reach, center + reach));
+                    }
+                }
+            }
+        }
+    }
+
+    /// Returns the number of wires in the specified plane.
+    std::size_t nWires(std::size_t tpc, unsigned int plane) const
+    {
+        Plane_t const* planeInfo = getPlane(tpc, plane);
+
+        return planeInfo ? planeInfo->wires.size() : 0;
+    }
+
+    /// Returns the specified wire, `nullptr` if not in the index.
+    Wire_t const* wire(std::size_t tpc, unsigned int plane, unsigned int wire) const
+    {
+        Plane_t const* planeInfo = getPlane(tpc, plane);
+
+        if (!planeInfo || wire >= planeInfo->wires.size()) return nullptr;
+
+        return &planeInfo->wires[wire];
+    }
+
+    /**
+     *  @brief Returns whether two wires of the same TPC cross
+     *
+     *  @param tpc    index of the TPC
+     *  @param plane0 plane of the first wire
+     *  @param wire0  number of the first wire
+     *  @param plane1 plane of the second wire
+     *  @param wire1  number of the second wire
+     *  @param[out] y coordinate of the crossing point on the first wire [cm]
+     *  @param[out] z coordinate of the crossing point on the first wire [cm]
+     *
+     *  Wires on the same plane never cross; unknown wires don't cross.
+     */
+    bool intersect(std::size_t tpc, unsigned int plane0, unsigned int wire0, unsigned int plane1, unsigned int wire1, float& y, float& z) const
+    {
+        if (plane0 == plane1) return false;
+
+        Plane_t const* planeInfo0 = getPlane(tpc, plane0);
+        Plane_t const* planeInfo1 = getPlane(tpc, plane1);
+
+        if (!planeInfo0 || !planeInfo1) return false;
+        if (wire0 >= planeInfo0->wires.size() || wire1 >= planeInfo1->wires.size()) return false;
+
+        // Quick rejection of the wires which are too far
+        if (plane1 < planeInfo0->crossings.size() && !planeInfo0->crossings[plane1].empty())
+        {
+            WireRange_t const& range = planeInfo0->crossings[plane1][wire0];
+
+            if (wire1 < range.first || wire1 >= range.second) return false;
+        }
+
+        Wire_t const& wireInfo0 = planeInfo0->wires[wire0];
+        Wire_t const& wireInfo1 = planeInfo1->wires[wire1];
+
+        // Get the distance of closest approach
+        float arcLen0;
+        float arcLen1;
+
+        if (closestApproach(wireInfo0.center, wireInfo0.direction, wireInfo1.center, wireInfo1.direction, arcLen0, arcLen1))
+        {
+            // Now check that arc lengths are within range
+            if (std::abs(arcLen0) < wireInfo0.halfLength && std::abs(arcLen1) < wireInfo1.halfLength)
+            {
+                Eigen::Vector3f poca0 = wireInfo0.center + arcLen0 * wireInfo0.direction;
+
+                y = poca0[1];
+                z = poca0[2];
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     *  @brief Returns the number of the wire closest to a point
+     *
+     *  The result is not limited to the range of the existing wires: it is
+     *  negative or not smaller than `nWires(tpc, plane)` for points outside
+     *  the plane. For unknown planes, `-1` is returned.
+     */
+    long nearestWire(std::size_t tpc, unsigned int plane, float y, float z) const
+    {
+        Plane_t const* planeInfo = getPlane(tpc, plane);
+
+        if (!planeInfo || planeInfo->wires.empty()) return -1;
+        if (planeInfo->wires.size() == 1)           return 0;
+
+        return std::lround((planeInfo->project(y, z) - planeInfo->projections.front()) / planeInfo->pitch);
+    }
+
+    /**
+     *  @brief Returns the distance of a point from a wire, at the x of the wire
+     *
+     *  If the point is beyond the end of the wire, the maximum `float` is
+     *  returned.
+     */
+    static float distanceToWire(const Wire_t& wire, const Eigen::Vector3f& position)
+    {
+        float distance = std::numeric_limits<float>::max();
+
+        // Want the hit position to have same x value as wire coordinates
+        Eigen::Vector3f hitPosition(wire.center[0],position[1],position[2]);
+
+        // Get arc length to doca
+        double arcLen = (hitPosition - wire.center).dot(wire.direction);
+
+        // Make sure arclen is in range
+        if (std::abs(arcLen) < wire.halfLength)
+        {
+            Eigen::Vector3f docaVec = hitPosition - (wire.center + arcLen * wire.direction);
+
+            distance = docaVec.norm();
+        }
+
+        return distance;
+    }
+
+    /**
+     *  @brief function to compute the distance of closest approach and the arc length to the points of closest approach
+     */
+    static float closestApproach(const Eigen::Vector3f& P0,
+                                 const Eigen::Vector3f& u0,
+                                 const Eigen::Vector3f& P1,
+                                 const Eigen::Vector3f& u1,
+                                 float&                 arcLen0,
+                                 float&                 arcLen1)
+    {
+        // Technique is to compute the arclength to each point of closest approach
+        Eigen::Vector3f w0 = P0 - P1;
+        float a(1.);
+        float b(u0.dot(u1));
+        float c(1.);
+        float d(u0.dot(w0));
+        float e(u1.dot(w0));
+        float den(a * c - b * b);
+
+        arcLen0 = (b * e - c * d) / den;
+        arcLen1 = (a * e - b * d) / den;
+
+        Eigen::Vector3f poca0 = P0 + arcLen0 * u0;
+        Eigen::Vector3f poca1 = P1 + arcLen1 * u1;
+
+        return (poca0 - poca1).norm();
+    }
+
+private:
+    /// Margin on the crossing ranges, for the rounding of single precision [cm]
+    static constexpr double CrossingTolerance = 0.05;
+
+    /// Range of wire numbers: [ first, second [
+    using WireRange_t = std::pair<std::uint32_t, std::uint32_t>;
+
+    struct Plane_t
+    {
+        std::vector<Wire_t>                   wires;
+        std::vector<double>                   projections;  ///< wire centers on the normal coordinate
+        std::vector<std::vector<WireRange_t>> crossings;    ///< candidate wires, by other plane and by wire
+        double                                normalY     = 0.;
+        double                                normalZ     = 1.;
+        double                                pitch       = 1.;   ///< signed distance between wires
+        double                                maxSideStep = 0.;
+        bool                                  monotonic   = false;
+        bool                                  increasing  = false;
+
+        double project(double y, double z) const { return normalY * y + normalZ * z; }
+
+        /// Returns the range of wires with center projection in [ low, high ].
+        WireRange_t wiresBetween(double low, double high) const
+        {
+            std::size_t first, last;
+
+            if (increasing)
+            {
+                first = std::lower_bound(projections.begin(), projections.end(), low)  - projections.begin();
+                last  = std::upper_bound(projections.begin(), projections.end(), high) - projections.begin();
+            }
+            else
+            {
+                first = std::lower_bound(projections.begin(), projections.end(), high, std::greater<double>()) - projections.begin();
+                last  = std::upper_bound(projections.begin(), projections.end(), low,  std::greater<double>()) - projections.begin();
+            }
+
+            return { std::uint32_t(first), std::uint32_t(std::max(first, last)) };
+        }
+    };
+
+    Plane_t const* getPlane(std::size_t tpc, unsigned int plane) const
+    {
+        if (tpc >= m_tpcs.size() || plane >= m_tpcs[tpc].size()) return nullptr;
+
+        return &m_tpcs[tpc][plane];
+    }
+
+    std::vector<std::vector<Plane_t>> m_tpcs; ///< planes, by TPC and plane
+};
+
+} // namespace lar_cluster3d
+
+#endif // ICARUSCODE_TPC_TRACKING_CLUSTER3D_WIRECROSSINGINDEX_H
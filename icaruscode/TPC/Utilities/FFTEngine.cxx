@@ -0,0 +1,320 @@
+/**
+ * @file   icaruscode/TPC/Utilities/FFTEngine.cxx
+ * @brief  Real-to-complex FFT with plans cached per thread and size.
+ * @see    icaruscode/TPC/Utilities/FFTEngine.h
+ */
+
+// library header
+#include "icaruscode/TPC/Utilities/FFTEngine.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// FFTW
+#include "fftw3.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::copy(), std::rotate(), std::min()
+#include <cmath> // std::abs(), std::round()
+#include <map>
+#include <memory> // std::unique_ptr
+#include <mutex>
+#include <utility> // std::pair
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// FFTW planner is not thread-safe: plan creation and destruction are locked.
+  std::mutex FFTWplannerMutex;
+
+  /// Largest number of waveforms transformed in a single FFTW call.
+  constexpr std::size_t MaxBatchSize = 8;
+
+
+  /// Interface to the FFTW functions of each precision.
+  template <typename T> struct FFTWtraits;
+
+  template <>
+  struct FFTWtraits<double> {
+    using Plan_t = fftw_plan;
+    using Complex_t = fftw_complex;
+
+    static void* allocate(std::size_t bytes) { return fftw_malloc(bytes); }
+    static void release(void* p) { fftw_free(p); }
+
+    static Plan_t planForward
+      (int n, int howMany, double* in, Complex_t* out)
+      {
+        return fftw_plan_many_dft_r2c(1, &n, howMany,
+          in, nullptr, 1, n, out, nullptr, 1, n/2 + 1, FFTW_ESTIMATE);
+      }
+    static Plan_t planInverse
+      (int n, int howMany, Complex_t* in, double* out)
+      {
+        return fftw_plan_many_dft_c2r(1, &n, howMany,
+          in, nullptr, 1, n/2 + 1, out, nullptr, 1, n, FFTW_ESTIMATE);
+      }
+    static void execute(Plan_t plan) { fftw_execute(plan); }
+    static void destroy(Plan_t plan) { fftw_destroy_plan(plan); }
+  }; // FFTWtraits<double>
+
+  template <>
+  struct FFTWtraits<float> {
+    using Plan_t = fftwf_plan;
+    using Complex_t = fftwf_complex;
+
+    static void* allocate(std::size_t bytes) { return fftwf_malloc(bytes); }
+    static void release(void* p) { fftwf_free(p); }
+
+    static Plan_t planForward
+      (int n, int howMany, float* in, Complex_t* out)
+      {
+        return fftwf_plan_many_dft_r2c(1, &n, howMany,
+          in, nullptr, 1, n, out, nullptr, 1, n/2 + 1, FFTW_ESTIMATE);
+      }
+    static Plan_t planInverse
+      (int n, int howMany, Complex_t* in, float* out)
+      {
+        return fftwf_plan_many_dft_c2r(1, &n, howMany,
+          in, nullptr, 1, n/2 + 1, out, nullptr, 1, n, FFTW_ESTIMATE);
+      }
+    static void execute(Plan_t plan) { fftwf_execute(plan); }
+    static void destroy(Plan_t plan) { fftwf_destroy_plan(plan); }
+  }; // FFTWtraits<float>
+
+
+  /// Forward and inverse plans of a given size, with their work buffers.
+  template <typename T>
+  class PlanSet {
+    using Traits_t = FFTWtraits<T>;
+    using FFTWcomplex_t = typename Traits_t::Complex_t;
+
+      public:
+
+    /// Plans `howMany` transforms of size `size`.
+    PlanSet(std::size_t size, std::size_t howMany)
+      : fSize(size), fHowMany(howMany)
+    {
+      std::lock_guard const lock { FFTWplannerMutex };
+      fTime = static_cast<T*>
+        (Traits_t::allocate(sizeof(T) * fSize * fHowMany));
+      fFrequency = static_cast<FFTWcomplex_t*>
+        (Traits_t::allocate(sizeof(FFTWcomplex_t) * nFrequencies() * fHowMany));
+      fForward = Traits_t::planForward
+        (int(fSize), int(fHowMany), fTime, fFrequency);
+      fInverse = Traits_t::planInverse
+        (int(fSize), int(fHowMany), fFrequency, fTime);
+      if (!fTime || !fFrequency || !fForward || !fInverse) {
+        releaseAll();
+        throw cet::exception{ "FFTEngine" } << "Failed to plan " << fHowMany
+          << " FFT of size " << fSize << "\n";
+      }
+    } // PlanSet()
+
+    ~PlanSet()
+      { std::lock_guard const lock { FFTWplannerMutex }; releaseAll(); }
+
+    PlanSet(PlanSet const&) = delete;
+    PlanSet& operator= (PlanSet const&) = delete;
+
+    std::size_t nFrequencies() const { return fSize / 2 + 1; }
+
+    /// Work buffer for the waveforms.
+    T* time() const { return fTime; }
+
+    /// Work buffer for the spectra.
+    std::complex<T>* frequency() const
+      { return reinterpret_cast<std::complex<T>*>(fFrequency); }
+
+    void forward() const { Traits_t::execute(fForward); }
+    void inverse() const { Traits_t::execute(fInverse); }
+
+      private:
+    std::size_t fSize;
+    std::size_t fHowMany;
+    T* fTime = nullptr;
+    FFTWcomplex_t* fFrequency = nullptr;
+    typename Traits_t::Plan_t fForward = nullptr;
+    typename Traits_t::Plan_t fInverse = nullptr;
+
+    void releaseAll() {
+      if (fInverse) Traits_t::destroy(fInverse);
+      if (fForward) Traits_t::destroy(fForward);
+      if (fFrequency) Traits_t::release(fFrequency);
+      if (fTime) Traits_t::release(fTime);
+    }
+
+  }; // PlanSet
+
+
+  /// Returns the plans of this thread for `howMany` transforms of `size`.
+  template <typename T>
+  PlanSet<T> const& plans(std::size_t size, std::size_t howMany = 1) {
+
+    thread_local std::map<std::pair<std::size_t, std::size_t>,
+      std::unique_ptr<PlanSet<T>>> threadPlans;
+
+    auto& planSet = threadPlans[{ size, howMany }];
+    if (!planSet) planSet = std::make_unique<PlanSet<T>>(size, howMany);
+    return *planSet;
+
+  } // plans()
+
+
+  /// Checks that `kernel` matches transforms of `size` samples.
+  template <typename Kernel>
+  void checkKernelSize(Kernel const& kernel, std::size_t size) {
+    if (kernel.size() == size / 2 + 1) return;
+    throw cet::exception{ "FFTEngine" } << "Deconvolution kernel has "
+      << kernel.size() << " coefficients, " << (size / 2 + 1)
+      << " expected for transforms of size " << size << "\n";
+  } // checkKernelSize()
+
+
+  /// Rotates `data` so that its element `i` is the former `i + offset`.
+  template <typename T>
+  void applyTimeOffset(T* data, std::size_t size, int offset) {
+    long const shift = offset % static_cast<long>(size);
+    if (shift == 0) return;
+    std::rotate(data, data + ((shift < 0)? shift + size: shift), data + size);
+  } // applyTimeOffset()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarusutil::FFTEngine<T>::forwardFFT
+  (TimeVec_t const& timeVec, FrequencyVec_t& frequencyVec)
+{
+  std::size_t const size = timeVec.size();
+  if (size == 0) {
+    frequencyVec.clear();
+    return;
+  }
+
+  PlanSet<T> const& planSet = plans<T>(size);
+
+  std::copy(timeVec.begin(), timeVec.end(), planSet.time());
+  planSet.forward();
+  frequencyVec.assign
+    (planSet.frequency(), planSet.frequency() + planSet.nFrequencies());
+
+} // icarusutil::FFTEngine<>::forwardFFT()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarusutil::FFTEngine<T>::inverseFFT
+  (FrequencyVec_t const& frequencyVec, TimeVec_t& timeVec)
+{
+  std::size_t const size = timeVec.size();
+  if (size == 0) return;
+  checkKernelSize(frequencyVec, size);
+
+  PlanSet<T> const& planSet = plans<T>(size);
+
+  std::copy(frequencyVec.begin(), frequencyVec.end(), planSet.frequency());
+  planSet.inverse();
+
+  T const norm = T(1) / T(size);
+  std::transform(planSet.time(), planSet.time() + size, timeVec.begin(),
+    [norm](T value){ return value * norm; });
+
+} // icarusutil::FFTEngine<>::inverseFFT()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarusutil::FFTEngine<T>::deconvolute
+  (TimeVec_t& timeVec, FrequencyVec_t const& kernel, int timeOffset)
+{
+  deconvolute(timeVec.data(), timeVec.size(), 1U, kernel, timeOffset);
+} // icarusutil::FFTEngine<>::deconvolute()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarusutil::FFTEngine<T>::deconvolute(
+  T* data, std::size_t size, std::size_t nWaveforms,
+  FrequencyVec_t const& kernel, int timeOffset
+) {
+  if ((size == 0) || (nWaveforms == 0)) return;
+  checkKernelSize(kernel, size);
+
+  std::size_t const nFrequencies = size / 2 + 1;
+  T const norm = T(1) / T(size);
+
+  for (std::size_t first = 0; first < nWaveforms; first += MaxBatchSize) {
+
+    std::size_t const howMany = std::min(MaxBatchSize, nWaveforms - first);
+    T* const batch = data + first * size;
+
+    PlanSet<T> const& planSet = plans<T>(size, howMany);
+
+    std::copy(batch, batch + size * howMany, planSet.time());
+    planSet.forward();
+
+    // the normalization of the inverse transform is folded in the kernel
+    Complex_t* spectrum = planSet.frequency();
+    for (std::size_t iWaveform = 0; iWaveform < howMany; ++iWaveform) {
+      for (std::size_t iFreq = 0; iFreq < nFrequencies; ++iFreq)
+        *spectrum++ *= kernel[iFreq] * norm;
+    }
+
+    planSet.inverse();
+    std::copy(planSet.time(), planSet.time() + size * howMany, batch);
+
+    for (std::size_t iWaveform = 0; iWaveform < howMany; ++iWaveform)
+      applyTimeOffset(batch + iWaveform * size, size, timeOffset);
+
+  } // for batches
+
+} // icarusutil::FFTEngine<>::deconvolute()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+auto icarusutil::FFTEngine<T>::deconvolutionKernel(
+  std::vector<double> const& response,
+  std::vector<std::complex<double>> const& filter,
+  std::size_t size
+) -> FrequencyVec_t {
+
+  std::size_t const fullSize = response.size();
+  if ((size == 0) || (fullSize == 0) || (filter.size() < fullSize / 2 + 1)) {
+    throw cet::exception{ "FFTEngine" } << "Can't compute a deconvolution"
+      " kernel of size " << size << " from a response of " << fullSize
+      << " samples and a filter of " << filter.size() << " coefficients\n";
+  }
+
+  // the transform is circular: the response is folded into the shorter window
+  std::vector<double> foldedResponse(size, 0.0);
+  for (std::size_t tick = 0; tick < fullSize; ++tick)
+    foldedResponse[tick % size] += response[tick];
+
+  FFTEngine<double>::FrequencyVec_t convKernel;
+  FFTEngine<double>::forwardFFT(foldedResponse, convKernel);
+
+  double const binRatio = double(fullSize) / double(size);
+
+  FrequencyVec_t kernel(convKernel.size());
+  for (std::size_t idx = 0; idx < convKernel.size(); ++idx) {
+    std::size_t const filterIdx
+      = std::min(std::size_t(std::round(idx * binRatio)), fullSize / 2);
+    // same cut as in the response tool
+    if (std::abs(convKernel[idx]) < 0.0001) kernel[idx] = Complex_t(0);
+    else kernel[idx] = Complex_t(filter[filterIdx] / convKernel[idx]);
+  }
+  return kernel;
+
+} // icarusutil::FFTEngine<>::deconvolutionKernel()
+
+
+// -----------------------------------------------------------------------------
+template class icarusutil::FFTEngine<float>;
+template class icarusutil::FFTEngine<double>;
+
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,118 @@
+/**
+ * @file   icaruscode/TPC/Utilities/FFTEngine.h
+ * @brief  Real-to-complex FFT with plans cached per thread and size.
+ * @see    icaruscode/TPC/Utilities/FFTEngine.cxx
+ */
+
+#ifndef ICARUSCODE_TPC_UTILITIES_FFTENGINE_H
+#define ICARUSCODE_TPC_UTILITIES_FFTENGINE_H
+
+// C/C++ standard libraries
+#include <complex>
+#include <vector>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarusutil { template <typename T> class FFTEngine; }
+
+/**
+ * @brief Fast Fourier transforms of real waveforms of any size.
+ * @tparam T precision of the transforms (`float` or `double`)
+ *
+ * All the functions are static and can be called concurrently.
+ * Each thread keeps its own FFTW plans and work buffers, one set for each
+ * transform size (and number of waveforms in a batch) it has encountered,
+ * so that the (serialized) planning happens only the first time a size is
+ * used in a thread. Plans are created with `FFTW_ESTIMATE`, which makes the
+ * results reproducible.
+ *
+ * The frequency representation has the `N/2 + 1` non-redundant coefficients
+ * of the transform of a real waveform of size `N`. The forward transform is
+ * not normalized, the inverse transform is divided by `N`.
+ *
+ * The deconvolution kernels for this engine, in this representation, are
+ * provided and cached by `icarusutil::SignalShapingICARUSService`.
+ */
+template <typename T>
+class icarusutil::FFTEngine {
+
+    public:
+
+  using Value_t = T; ///< Type of the waveform samples.
+  using Complex_t = std::complex<T>; ///< Type of the frequency coefficients.
+  using TimeVec_t = std::vector<T>; ///< A waveform.
+  using FrequencyVec_t = std::vector<Complex_t>; ///< A (half) spectrum.
+
+
+  /// Transforms `timeVec` into its `timeVec.size() / 2 + 1` coefficients.
+  static void forwardFFT(TimeVec_t const& timeVec, FrequencyVec_t& frequencyVec);
+
+  /**
+   * @brief Transforms `frequencyVec` back into `timeVec`.
+   * @param frequencyVec the spectrum, of size `timeVec.size() / 2 + 1`
+   * @param[in,out] timeVec the waveform; its size defines the transform size
+   */
+  static void inverseFFT(FrequencyVec_t const& frequencyVec, TimeVec_t& timeVec);
+
+  /**
+   * @brief Deconvolves `timeVec` in place.
+   * @param[in,out] timeVec the waveform
+   * @param kernel deconvolution kernel, of size `timeVec.size() / 2 + 1`
+   * @param timeOffset offset of the response (`ResponseTOffset()`), in ticks
+   *
+   * The deconvolved waveform is rotated so that sample `i` of the result is
+   * sample `i + timeOffset` (modulo the size) of the plain deconvolution.
+   */
+  static void deconvolute
+    (TimeVec_t& timeVec, FrequencyVec_t const& kernel, int timeOffset);
+
+  /**
+   * @brief Deconvolves in place a batch of waveforms with the same kernel.
+   * @param data `nWaveforms` consecutive waveforms of `size` samples each
+   * @param size number of samples in each waveform
+   * @param nWaveforms number of waveforms in `data`
+   * @param kernel deconvolution kernel, of size `size / 2 + 1`
+   * @param timeOffset offset of the response (`ResponseTOffset()`), in ticks
+   *
+   * The result is the same as calling `deconvolute()` on each waveform,
+   * but all of them are transformed with a single FFTW call.
+   */
+  static void deconvolute(
+    T* data, std::size_t size, std::size_t nWaveforms,
+    FrequencyVec_t const& kernel, int timeOffset
+    );
+
+  /**
+   * @brief Returns the deconvolution kernel for transforms of `size` samples.
+   * @param response the full response, in time (usually the readout window)
+   * @param filter the filter, with `response.size() / 2 + 1` coefficients
+   * @param size the size of the transforms the kernel is for
+   * @return the `size / 2 + 1` coefficients of the kernel
+   * @throw cet::exception (category `"FFTEngine"`) if the sizes don't match
+   *
+   * The kernel is the `filter` divided by the transform of the `response`,
+   * with coefficients set to `0` where the response is smaller than `1e-4`,
+   * as in the response tools.
+   * For a `size` shorter than the response, the transform is circular, so the
+   * response is folded modulo `size`, and the filter is sampled at the
+   * frequencies of the shorter transform (nearest coefficient).
+   */
+  static FrequencyVec_t deconvolutionKernel(
+    std::vector<double> const& response,
+    std::vector<std::complex<double>> const& filter,
+    std::size_t size
+    );
+
+}; // icarusutil::FFTEngine<>
+
+
+// -----------------------------------------------------------------------------
+// the implementation is instantiated for these types in FFTEngine.cxx
+extern template class icarusutil::FFTEngine<float>;
+extern template class icarusutil::FFTEngine<double>;
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_TPC_UTILITIES_FFTENGINE_H
@@ -0,0 +1,259 @@
+/**
+ * @file   icaruscode/TPC/Utilities/RobustWaveformStats.h
+ * @brief  Truncated RMS and baseline of TPC waveforms, without sorting.
+ *
+ * This is a header-only library.
+ */
+
+#ifndef ICARUSCODE_TPC_UTILITIES_ROBUSTWAVEFORMSTATS_H
+#define ICARUSCODE_TPC_UTILITIES_ROBUSTWAVEFORMSTATS_H
+
+// C/C++ standard libraries
+#include <algorithm> // std::nth_element(), std::count_if(), std::max()
+#include <vector>
+#include <cmath> // std::fabs(), std::sqrt()
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarus { template <typename T> class RobustWaveformStats; }
+
+/**
+ * @brief Robust estimation of the baseline and noise of a waveform.
+ * @tparam T type of the waveform samples
+ *
+ * This object computes the same quantities as the truncated RMS helpers in
+ * the TPC signal processing modules, with linear complexity and without
+ * allocating memory once its scratch buffers have grown to the waveform size:
+ * the truncated RMS is computed on the samples with the smallest magnitude,
+ * which are selected with `std::nth_element()` rather than sorting the whole
+ * waveform.
+ *
+ * The results are the same as the sorting algorithms up to the order of
+ * floating point additions.
+ *
+ * The scratch buffers make the object not thread-safe: each thread needs its
+ * own instance.
+ */
+template <typename T>
+class icarus::RobustWaveformStats {
+
+    public:
+
+  using Waveform_t = std::vector<T>; ///< Type of the waveforms being processed.
+
+  /// Default fraction of samples always included in the truncated RMS.
+  static constexpr T DefaultMinFraction = 0.8;
+
+
+  /**
+   * @brief Computes full and truncated RMS of a pedestal-subtracted waveform.
+   * @param waveform the (pedestal subtracted) samples
+   * @param nSig truncation threshold, in units of full RMS
+   * @param[out] fullRMS RMS of the half of the samples with smaller magnitude
+   * @param[out] truncRMS RMS of the samples below the threshold
+   * @param[out] nTrunc number of samples contributing to `truncRMS`
+   * @param minFraction fraction of the samples always contributing to
+   *                    `truncRMS`
+   *
+   * The "full" RMS is the standard deviation of the half of the samples with
+   * the smallest magnitude. The truncated RMS is the root of the average
+   * square of the samples with magnitude below `nSig` times the full RMS, but
+   * at least a `minFraction` of all samples (those with smallest magnitude).
+   */
+  void truncatedRMS(
+    Waveform_t const& waveform, T nSig,
+    T& fullRMS, T& truncRMS, int& nTrunc,
+    T minFraction = DefaultMinFraction
+    );
+
+  /**
+   * @brief Returns the truncated RMS with a fixed threshold.
+   * @param waveform the (pedestal subtracted) samples
+   * @param threshold samples with larger magnitude are excluded...
+   * @param minFraction ... unless needed to reach this fraction of samples
+   * @return the root of the average square of the selected samples
+   */
+  T truncatedRMS(Waveform_t const& waveform, T threshold, T minFraction);
+
+  /// Pedestal and noise of a waveform baseline (see `lowMagnitudeBaseline()`).
+  struct BaselineStats_t {
+    T pedestal = T(0); ///< Average of the selected samples.
+    T RMS = T(0);      ///< Root of the average square of the selected samples.
+    int nSamples = 0;  ///< Number of the selected samples.
+  };
+
+  /**
+   * @brief Returns the baseline from the samples with the smallest magnitude.
+   * @param waveform the samples
+   * @param nSig threshold, in units of the RMS of the smaller half of samples
+   * @param minFraction fraction of the samples always selected
+   * @return the average and the root of the average square of the selection
+   *
+   * Samples are selected as in `truncatedRMS()`, with `nSig` times the full
+   * RMS as threshold.
+   */
+  BaselineStats_t lowMagnitudeBaseline
+    (Waveform_t const& waveform, T nSig, T minFraction);
+
+
+    private:
+
+  std::vector<T> fSelected; ///< Scratch: samples being selected.
+
+
+  /// Copies `waveform` in the scratch buffer.
+  void loadWaveform(Waveform_t const& waveform)
+    { fSelected.assign(waveform.begin(), waveform.end()); }
+
+  /**
+   * @brief Moves the `n` samples with smallest magnitude at the start of the
+   *        buffer.
+   * @param n number of samples to select
+   * @param selected number of samples already selected at the start of buffer
+   */
+  void selectSmallest(std::size_t n, std::size_t selected = 0);
+
+  /// Returns the RMS of the smaller half of the buffer; the half is selected.
+  T smallerHalfRMS();
+
+  /// Returns the number of samples to select by `threshold` and `minFraction`.
+  std::size_t countSelected(T threshold, T minFraction) const;
+
+  /// Returns the sum of the first `n` samples in the buffer.
+  double sum(std::size_t n) const;
+
+  /// Returns the sum of the squares of the first `n` samples in the buffer.
+  double sumSq(std::size_t n, double offset = 0.0) const;
+
+}; // icarus::RobustWaveformStats<>
+
+
+// -----------------------------------------------------------------------------
+// ---  template implementation
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarus::RobustWaveformStats<T>::truncatedRMS(
+  Waveform_t const& waveform, T nSig,
+  T& fullRMS, T& truncRMS, int& nTrunc,
+  T minFraction /* = DefaultMinFraction */
+) {
+  loadWaveform(waveform);
+
+  fullRMS = smallerHalfRMS();
+
+  std::size_t const nSelected = countSelected(nSig * fullRMS, minFraction);
+  selectSmallest(nSelected, fSelected.size() / 2);
+
+  truncRMS = static_cast<T>
+    (std::sqrt(std::max(0.0, sumSq(nSelected) / double(nSelected))));
+  nTrunc = static_cast<int>(nSelected);
+
+} // icarus::RobustWaveformStats<>::truncatedRMS()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+T icarus::RobustWaveformStats<T>::truncatedRMS
+  (Waveform_t const& waveform, T threshold, T minFraction)
+{
+  loadWaveform(waveform);
+
+  std::size_t const nSelected = countSelected(threshold, minFraction);
+  selectSmallest(nSelected);
+
+  return static_cast<T>
+    (std::sqrt(std::max(0.0, sumSq(nSelected) / double(nSelected))));
+
+} // icarus::RobustWaveformStats<>::truncatedRMS()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+auto icarus::RobustWaveformStats<T>::lowMagnitudeBaseline
+  (Waveform_t const& waveform, T nSig, T minFraction) -> BaselineStats_t
+{
+  loadWaveform(waveform);
+
+  T const halfRMS = smallerHalfRMS();
+
+  std::size_t const nSelected = countSelected(nSig * halfRMS, minFraction);
+  selectSmallest(nSelected, fSelected.size() / 2);
+
+  BaselineStats_t stats;
+  stats.nSamples = static_cast<int>(nSelected);
+  stats.pedestal = static_cast<T>(sum(nSelected) / nSelected);
+  stats.RMS = static_cast<T>
+    (std::sqrt(std::max(0.0, sumSq(nSelected) / double(nSelected))));
+  return stats;
+
+} // icarus::RobustWaveformStats<>::lowMagnitudeBaseline()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void icarus::RobustWaveformStats<T>::selectSmallest
+  (std::size_t n, std::size_t selected /* = 0 */)
+{
+  if ((n <= selected) || (n >= fSelected.size())) return;
+  // the samples already selected are all smaller than the rest: skip them
+  std::nth_element
+    (fSelected.begin() + selected, fSelected.begin() + n, fSelected.end(),
+    [](T left, T right){ return std::fabs(left) < std::fabs(right); });
+} // icarus::RobustWaveformStats<>::selectSmallest()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+T icarus::RobustWaveformStats<T>::smallerHalfRMS() {
+
+  std::size_t const nHalf = fSelected.size() / 2;
+  if (nHalf == 0) return T(0);
+
+  selectSmallest(nHalf);
+
+  double const mean = sum(nHalf) / double(nHalf);
+  return static_cast<T>
+    (std::sqrt(std::max(0.0, sumSq(nHalf, mean) / double(nHalf))));
+
+} // icarus::RobustWaveformStats<>::smallerHalfRMS()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+std::size_t icarus::RobustWaveformStats<T>::countSelected
+  (T threshold, T minFraction) const
+{
+  std::size_t const nBelow = std::count_if(fSelected.begin(), fSelected.end(),
+    [threshold](T val){ return !(std::fabs(val) > threshold); });
+  std::size_t const nMin = static_cast<int>(minFraction * fSelected.size());
+  return std::max(nMin, nBelow);
+} // icarus::RobustWaveformStats<>::countSelected()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+double icarus::RobustWaveformStats<T>::sum(std::size_t n) const {
+  double s = 0.0;
+  for (std::size_t i = 0; i < n; ++i) s += fSelected[i];
+  return s;
+} // icarus::RobustWaveformStats<>::sum()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+double icarus::RobustWaveformStats<T>::sumSq
+  (std::size_t n, double offset /* = 0.0 */) const
+{
+  double s = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    double const d = fSelected[i] - offset;
+    s += d * d;
+  }
+  return s;
+} // icarus::RobustWaveformStats<>::sumSq()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_TPC_UTILITIES_ROBUSTWAVEFORMSTATS_H
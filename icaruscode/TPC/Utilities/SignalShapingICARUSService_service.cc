@@ -56,6 +56,11 @@ void SignalShapingICARUSService::reconfigure(const fhicl::ParameterSet& pset)
     // If called again, then we need to clear out the existing tools...
     fPlaneToResponseMap.clear();
     
+    {
+        std::lock_guard<std::mutex> lock(fDeconvKernelMutex);
+        fDeconvKernelCache.clear();
+    }
+    
     // Implement the tools for handling the responses
     const fhicl::ParameterSet& responseTools = pset.get<fhicl::ParameterSet>("ResponseTools");
     
@@ -107,6 +112,30 @@ const icarus_tool::IResponse& SignalShapingICARUSService::GetResponse(size_t cha
     return *fPlaneToResponseMap.at(planeIdx).front();
 }
 
+const SignalShapingICARUSService::FloatFrequencyVec& SignalShapingICARUSService::GetDeconvKernel(size_t channel, size_t fftSize) const
+{
+    const icarus_tool::IResponse& response = GetResponse(channel);
+    
+    KernelKey key(response.getPlane(), fftSize);
+    
+    std::lock_guard<std::mutex> lock(fDeconvKernelMutex);
+    
+    auto kernelItr = fDeconvKernelCache.find(key);
+    
+    // map elements are not moved by insertions, so the reference stays valid
+    if (kernelItr == fDeconvKernelCache.end())
+        kernelItr = fDeconvKernelCache.emplace(key, computeDeconvKernel(response, fftSize)).first;
+    
+    return kernelItr->second;
+}
+
+SignalShapingICARUSService::FloatFrequencyVec SignalShapingICARUSService::computeDeconvKernel(const icarus_tool::IResponse& response, size_t fftSize) const
+{
+    // The response and the filter are both known for the full readout window;
+    // FFTEngine folds the response and samples the filter for shorter transforms
+    return icarusutil::FFTEngine<float>::deconvolutionKernel(response.getResponse(), response.getFilter()->getResponseVec(), fftSize);
+}
+
 
 //----------------------------------------------------------------------
 // Initialization method.
@@ -80,12 +80,15 @@
 
 #include <vector>
 #include <map>
+#include <mutex>
+#include <utility> // std::pair
 #include "fhiclcpp/ParameterSet.h"
 #include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 
 #include "icaruscode/TPC/Utilities/tools/IResponse.h"
+#include "icaruscode/TPC/Utilities/FFTEngine.h"
 #include "TH1D.h"
 
 using DoubleVec  = std::vector<double>;
@@ -120,6 +123,11 @@ public:
     void                          SetDecon(double samplingRate, size_t fftsize, size_t channel);
     double                        GetDeconNorm() {return fDeconNorm;};
     
+    /// Deconvolution kernel of `channel` for `FFTEngine<float>` transforms of
+    /// `fftSize` samples; it is computed on first request and then cached.
+    using FloatFrequencyVec = icarusutil::FFTEngine<float>::FrequencyVec_t;
+    const FloatFrequencyVec&      GetDeconvKernel(size_t channel, size_t fftSize)  const;
+    
     
 private:
     
@@ -145,6 +153,14 @@ private:
     
     // Field response tools
     PlaneToResponseMap fPlaneToResponseMap;
+    
+    // Deconvolution kernels by plane and transform size
+    using KernelKey = std::pair<size_t, size_t>;
+    
+    mutable std::map<KernelKey, FloatFrequencyVec> fDeconvKernelCache;
+    mutable std::mutex                             fDeconvKernelMutex;
+    
+    FloatFrequencyVec  computeDeconvKernel(const icarus_tool::IResponse& response, size_t fftSize) const;
 };
 
 } // end of namespace
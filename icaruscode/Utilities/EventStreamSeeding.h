@@ -0,0 +1,64 @@
+/**
+ * @file   icaruscode/Utilities/EventStreamSeeding.h
+ * @brief  Seeding of random engines on streams specific to event and element.
+ * @date   October 16, 2026
+ *
+ * This library is header-only.
+ */
+
+#ifndef ICARUSCODE_UTILITIES_EVENTSTREAMSEEDING_H
+#define ICARUSCODE_UTILITIES_EVENTSTREAMSEEDING_H
+
+// framework libraries
+#include "canvas/Persistency/Provenance/EventID.h"
+
+// CLHEP libraries
+#include "CLHEP/Random/MixMaxRng.h"
+
+// C/C++ standard libraries
+#include <cstdint>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::ns::util {
+
+  /**
+   * @brief Moves `engine` to a stream specific to the event and `element`.
+   * @param engine the random engine to be moved
+   * @param seed the seed of the (module) engine the stream is derived from
+   * @param streamIdx index distinguishing the engines sharing the same seed
+   * @param eventID the event being simulated
+   * @param element index of the simulated element (e.g. channel or board)
+   *
+   * The seed, `streamIdx`, run and subrun are folded into a 64-bit key by
+   * the splitmix64 finalizer; `CLHEP::MixMaxRng` then jumps to the stream
+   * identified by that key, the event number and `element`.
+   * The resulting sequence depends only on these arguments, so simulating
+   * the elements of an event in any order or on any number of threads gives
+   * the same result.
+   */
+  inline void seedEventStream(
+    CLHEP::MixMaxRng& engine, long seed, unsigned int streamIdx,
+    art::EventID const& eventID, std::uint32_t element
+  ) {
+    auto mix = [](std::uint64_t key)
+      {
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+        return key ^ (key >> 31);
+      };
+
+    std::uint64_t key = mix(std::uint64_t(seed));
+    key = mix(key ^ streamIdx);
+    key = mix(key ^ eventID.run());
+    key = mix(key ^ eventID.subRun());
+
+    engine.seed_uniquestream
+      (std::uint32_t(key >> 32), std::uint32_t(key), eventID.event(), element);
+
+  } // seedEventStream()
+
+} // namespace icarus::ns::util
+
+
+#endif // ICARUSCODE_UTILITIES_EVENTSTREAMSEEDING_H
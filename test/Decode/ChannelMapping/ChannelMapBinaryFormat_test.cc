@@ -0,0 +1,283 @@
+/**
+ * @file   test/Decode/ChannelMapping/ChannelMapBinaryFormat_test.cc
+ * @brief  Unit test for the binary channel mapping format.
+ * @see    `icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.h`
+ *
+ * The mapping of a few run periods is written, read back and compared with
+ * the original; damaged copies of the data are checked to be rejected.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Decode/ChannelMapping/ChannelMapBinaryFormat.h"
+#include "icaruscode/Decode/ChannelMapping/ICARUSChannelMapSnapshot.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ChannelMapBinaryFormat_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <memory> // std::unique_ptr
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint> // std::uint32_t, std::uint64_t
+#include <cstring> // std::memcpy()
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  namespace Format = icarusDB::ChannelMapBinaryFormat;
+
+  /// Returns a mapping with some content, different for each `period`.
+  std::unique_ptr<icarusDB::ICARUSChannelMapSnapshot> makeSnapshot
+    (unsigned int period)
+  {
+    auto snapshot = std::make_unique<icarusDB::ICARUSChannelMapSnapshot>();
+
+    for (unsigned int fragmentID = 0x1000; fragmentID < 0x1010; ++fragmentID) {
+      snapshot->TPCfragmentToReadout[fragmentID + period] = {
+        "EE" + std::to_string(fragmentID % 8) + (period? "-bot": "-top"),
+        { fragmentID * 10, fragmentID * 10 + 1, fragmentID * 10 + 2 + period }
+        };
+    }
+
+    for (unsigned int boardID = 0; boardID < 20; ++boardID) {
+      auto& [ slot, channels ] = snapshot->TPCboardToChannels[boardID * 3];
+      slot = boardID % 9 + period;
+      for (unsigned int ch = 0; ch < 64; ++ch)
+        channels.emplace_back(boardID * 64 + ch, (ch + period) % 3);
+    }
+
+    for (unsigned int DBkey = 0; DBkey < 6; ++DBkey) {
+      auto& channels = snapshot->PMTfragmentToDigitizers[DBkey + 8 * period];
+      for (unsigned int ch = 0; ch < 15 + DBkey; ++ch) {
+        icarusDB::PMTChannelInfo_t info;
+        info.digitizerLabel = "WW-TOP-" + std::string(1, char('A' + DBkey));
+        info.digitizerChannelNo = ch;
+        info.channelID = DBkey * 16 + ch;
+        if (ch % 4 != 3) {
+          info.laserChannelNo = ch / 2 + period;
+          info.LVDSconnector = ch / 8;
+          info.LVDSbit = ch % 8;
+          info.adderConnector = DBkey;
+          info.adderBit = ch % 2;
+        }
+        channels.push_back(info);
+      }
+    }
+
+    for (unsigned int channel = 0; channel < 50; ++channel) {
+      snapshot->sideCRTchannelToMacAddresses[channel + 1]
+        = { 100 + channel / 2, 200 + channel + period };
+    }
+
+    for (unsigned int mac = 0; mac < 30; ++mac)
+      snapshot->topCRTmacAddresses[mac + 1000] = mac + 1 + period;
+
+    for (unsigned int mac5 = 0; mac5 < 4; ++mac5) {
+      for (unsigned int chan = 0; chan < 32; ++chan) {
+        snapshot->sideCRTcalibration[{ mac5, chan }]
+          = { 0.1 * chan + period, 300.0 + 1.0 / (mac5 + 3) };
+      }
+    }
+
+    snapshot->freeze();
+    return snapshot;
+  } // makeSnapshot()
+
+
+  /// Writes the mapping of `periods` into a string.
+  std::string writeToString
+    (std::vector<std::unique_ptr<icarusDB::ICARUSChannelMapSnapshot>> const& periods)
+  {
+    std::vector<icarusDB::ICARUSChannelMapSnapshot const*> pointers;
+    for (auto const& snapshot: periods) pointers.push_back(snapshot.get());
+    std::ostringstream out;
+    Format::write(out, pointers);
+    return out.str();
+  } // writeToString()
+
+
+  /// Offset of the total size in the header of data with `nPeriods` periods.
+  std::size_t totalSizeOffset(std::size_t nPeriods) {
+    return Format::Magic.size() + 4 * sizeof(std::uint32_t)
+      + nPeriods * Format::NTables * sizeof(std::uint64_t);
+  }
+
+
+  template <typename T>
+  void overwrite(std::string& data, std::size_t offset, T value)
+    { std::memcpy(data.data() + offset, &value, sizeof(value)); }
+
+
+  template <typename Map>
+  Map readTable(Format::Reader const& reader, std::size_t period) {
+    Map map;
+    reader.read(period, map);
+    return map;
+  }
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void roundtrip_test() {
+
+  std::vector<std::unique_ptr<icarusDB::ICARUSChannelMapSnapshot>> periods;
+  for (unsigned int period = 0; period < 3; ++period)
+    periods.push_back(makeSnapshot(period));
+
+  std::string const data = writeToString(periods);
+
+  Format::Reader const reader{ data.data(), data.size() };
+  BOOST_TEST(reader.nPeriods() == periods.size());
+
+  for (std::size_t period = 0; period < periods.size(); ++period) {
+    BOOST_TEST_CONTEXT("period #" << period) {
+      icarusDB::ICARUSChannelMapSnapshot const& expected = *periods[period];
+
+      BOOST_TEST((readTable<icarusDB::TPCFragmentIDToReadoutIDMap>(reader, period)
+        == expected.TPCfragmentToReadout));
+      BOOST_TEST((readTable<icarusDB::TPCReadoutBoardToChannelMap>(reader, period)
+        == expected.TPCboardToChannels));
+      BOOST_TEST((readTable<icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap>
+        (reader, period) == expected.sideCRTchannelToMacAddresses));
+      BOOST_TEST((readTable<icarusDB::TopCRTHWtoSimMacAddressPairMap>(reader, period)
+        == expected.topCRTmacAddresses));
+      BOOST_TEST((readTable<icarusDB::SideCRTChannelToCalibrationMap>(reader, period)
+        == expected.sideCRTcalibration));
+
+      auto const PMTmap
+        = readTable<icarusDB::PMTFragmentToDigitizerChannelMap>(reader, period);
+      BOOST_TEST(PMTmap.size() == expected.PMTfragmentToDigitizers.size());
+      for (auto const& [ DBkey, expectedChannels ]: expected.PMTfragmentToDigitizers) {
+        auto const it = PMTmap.find(DBkey);
+        BOOST_TEST_REQUIRE((it != PMTmap.end()));
+        auto const& channels = it->second;
+        BOOST_TEST_REQUIRE(channels.size() == expectedChannels.size());
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+          BOOST_TEST(channels[i].digitizerLabel == expectedChannels[i].digitizerLabel);
+          BOOST_TEST(channels[i].digitizerChannelNo == expectedChannels[i].digitizerChannelNo);
+          BOOST_TEST(channels[i].channelID == expectedChannels[i].channelID);
+          BOOST_TEST(channels[i].laserChannelNo == expectedChannels[i].laserChannelNo);
+          BOOST_TEST(channels[i].LVDSconnector == expectedChannels[i].LVDSconnector);
+          BOOST_TEST(channels[i].LVDSbit == expectedChannels[i].LVDSbit);
+          BOOST_TEST(channels[i].adderConnector == expectedChannels[i].adderConnector);
+          BOOST_TEST(channels[i].adderBit == expectedChannels[i].adderBit);
+        }
+      }
+    } // context
+  } // for periods
+
+  icarusDB::TopCRTHWtoSimMacAddressPairMap map;
+  BOOST_CHECK_THROW(reader.read(periods.size(), map), cet::exception);
+
+  // an empty mapping is still a valid one
+  std::string const empty = writeToString({});
+  Format::Reader const emptyReader{ empty.data(), empty.size() };
+  BOOST_TEST(emptyReader.nPeriods() == 0U);
+
+} // roundtrip_test()
+
+
+void corruption_test() {
+
+  std::vector<std::unique_ptr<icarusDB::ICARUSChannelMapSnapshot>> periods;
+  periods.push_back(makeSnapshot(0));
+  periods.push_back(makeSnapshot(1));
+  std::string const data = writeToString(periods);
+
+  auto const readAll = [](std::string const& data)
+    {
+      Format::Reader const reader{ data.data(), data.size() };
+      for (std::size_t period = 0; period < reader.nPeriods(); ++period) {
+        readTable<icarusDB::TPCFragmentIDToReadoutIDMap>(reader, period);
+        readTable<icarusDB::TPCReadoutBoardToChannelMap>(reader, period);
+        readTable<icarusDB::PMTFragmentToDigitizerChannelMap>(reader, period);
+        readTable<icarusDB::CRTChannelIDToHWtoSimMacAddressPairMap>(reader, period);
+        readTable<icarusDB::TopCRTHWtoSimMacAddressPairMap>(reader, period);
+        readTable<icarusDB::SideCRTChannelToCalibrationMap>(reader, period);
+      }
+    };
+
+  BOOST_CHECK_NO_THROW(readAll(data));
+
+  // not a channel mapping at all
+  {
+    std::string damaged = data;
+    damaged[3] = 'X';
+    BOOST_CHECK_THROW(readAll(damaged), cet::exception);
+    BOOST_CHECK_THROW(readAll(data.substr(0, 5)), cet::exception);
+  }
+
+  // unsupported version
+  {
+    std::string damaged = data;
+    overwrite<std::uint32_t>
+      (damaged, Format::Magic.size(), Format::FormatVersion + 1);
+    BOOST_CHECK_THROW(readAll(damaged), cet::exception);
+  }
+
+  // different byte order
+  {
+    std::string damaged = data;
+    overwrite<std::uint32_t>
+      (damaged, Format::Magic.size() + sizeof(std::uint32_t), 0x04030201);
+    BOOST_CHECK_THROW(readAll(damaged), cet::exception);
+  }
+
+  // different number of tables
+  {
+    std::string damaged = data;
+    overwrite<std::uint32_t>(damaged,
+      Format::Magic.size() + 3 * sizeof(std::uint32_t), Format::NTables + 1);
+    BOOST_CHECK_THROW(readAll(damaged), cet::exception);
+  }
+
+  // truncated file
+  BOOST_CHECK_THROW(readAll(data.substr(0, data.size() - 1)), cet::exception);
+  BOOST_CHECK_THROW(readAll(data.substr(0, 40)), cet::exception);
+
+  // truncated file with a consistent size: the last table is incomplete
+  {
+    std::string damaged = data.substr(0, data.size() - 12);
+    overwrite<std::uint64_t>
+      (damaged, totalSizeOffset(periods.size()), damaged.size());
+    BOOST_CHECK_THROW(readAll(damaged), cet::exception);
+  }
+
+  // table offset past the end of the data
+  {
+    std::string damaged = data;
+    overwrite<std::uint64_t>(damaged,
+      totalSizeOffset(periods.size()) - sizeof(std::uint64_t), data.size());
+    BOOST_CHECK_THROW(readAll(damaged), cet::exception);
+  }
+
+  // a period without mapping can't be written
+  std::ostringstream out;
+  BOOST_CHECK_THROW(
+    Format::write(out, { periods[0].get(), nullptr }), cet::exception
+    );
+
+} // corruption_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ChannelMapBinaryFormat_testcase) {
+
+  roundtrip_test();
+  corruption_test();
+
+} // BOOST_AUTO_TEST_CASE(ChannelMapBinaryFormat_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
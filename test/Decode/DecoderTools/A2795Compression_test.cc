@@ -0,0 +1,336 @@
+/**
+ * @file   test/Decode/DecoderTools/A2795Compression_test.cc
+ * @brief  Unit test and timing for `A2795Compression.h` functions.
+ * @see    `icaruscode/Decode/DecoderTools/details/A2795Compression.h`
+ *
+ * The compressed payload is compared word by word with the one from the
+ * board by board, sample by sample algorithm `ICARUSProduceCompressed` used,
+ * and the decompressed samples with its debug decoder.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Decode/DecoderTools/details/A2795Compression.h"
+#include "icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( A2795Compression_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <arpa/inet.h> // ntohl()
+#include <array>
+#include <chrono>
+#include <cstdlib> // std::abs()
+#include <cstring> // std::memcpy()
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cstdint> // std::uint16_t
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using daq::details::A2795BoardWords;
+  using daq::details::A2795BoardHeaderWords;
+  using daq::details::A2795BoardTrailerWords;
+
+  /**
+   * Returns a payload of `nBoards` boards with random headers and trailers,
+   * and waveforms wandering around a pedestal, with some pulses and a few
+   * samples out of 12 bits.
+   */
+  std::vector<std::uint16_t> makePayload(std::size_t nBoards,
+    std::size_t nChannels, std::size_t nSamples, unsigned int seed)
+  {
+    std::mt19937 engine { seed };
+    std::uniform_int_distribution<unsigned int> word { 0U, 0xFFFFU };
+    std::normal_distribution<double> noise { 0.0, 2.5 };
+    std::uniform_real_distribution<double> uniform { 0.0, 1.0 };
+
+    std::size_t const boardWords = A2795BoardWords(nChannels, nSamples);
+    std::vector<std::uint16_t> data(nBoards * boardWords);
+    for (std::size_t board = 0; board < nBoards; ++board) {
+      std::uint16_t* boardData = data.data() + board * boardWords;
+      for (std::size_t i = 0; i < A2795BoardHeaderWords; ++i)
+        boardData[i] = word(engine);
+      for (std::size_t i = boardWords - A2795BoardTrailerWords; i < boardWords; ++i)
+        boardData[i] = word(engine);
+
+      std::uint16_t* samples = boardData + A2795BoardHeaderWords;
+      for (std::size_t channel = 0; channel < nChannels; ++channel) {
+        double const pedestal = 1800.0 + 400.0 * uniform(engine);
+        for (std::size_t tick = 0; tick < nSamples; ++tick) {
+          double adc = pedestal + noise(engine);
+          if (tick % 512 == channel % 512) adc += 1500.0; // pulse
+          std::uint16_t sample = static_cast<std::uint16_t>(adc);
+          if (uniform(engine) < 0.001) sample = word(engine) & 0x3FFF; // glitch
+          samples[tick * nChannels + channel] = sample;
+        }
+      }
+    } // for boards
+    return data;
+  } // makePayload()
+
+
+  /// 16-bit word `n` of a payload of 64-bit words, as `ICARUSProduceCompressed` read it.
+  std::uint16_t getA2795Word(std::vector<std::uint64_t> const& f, std::size_t nWord)
+    { return (f[nWord / 4] >> (16 * (nWord % 4))) & 0xFFFF; }
+
+  /// Sets the 16-bit word `n` of a payload, as `ICARUSProduceCompressed` did.
+  void setA2795Word(std::vector<std::uint64_t>& f, std::size_t nWord, std::uint16_t value)
+  {
+    std::uint64_t const value64 = value;
+    std::size_t const shift = 16 * (nWord % 4);
+    std::uint64_t const filter = ~(std::uint64_t(0xFFFF) << shift);
+    f[nWord / 4] = (f[nWord / 4] & filter) + ((value64 << shift) & ~filter);
+  }
+
+  /// The reference: `ICARUSProduceCompressed::compressArtdaqFragment()`.
+  std::vector<std::uint16_t> referenceCompress(std::vector<std::uint16_t> const& data,
+    std::size_t nBoards, std::size_t nChannels, std::size_t nSamples, std::uint16_t mask)
+  {
+    std::vector<std::uint64_t> f((data.size() + 3) / 4);
+    std::memcpy(f.data(), data.data(), data.size() * sizeof(std::uint16_t));
+    std::vector<std::uint64_t> out(f);
+
+    auto adc_val = [&](std::size_t b, std::size_t c, std::size_t s) -> std::uint16_t
+      { return data[b * A2795BoardWords(nChannels, nSamples) + A2795BoardHeaderWords + s * nChannels + c] & mask; };
+    auto sampleBytes = [](std::size_t nCompressed)
+      { return 128 - 6 * nCompressed + 2 * (nCompressed % 2); };
+
+    std::size_t compressedDataOffset = 0, uncompressedDataOffset = 0, totalDataTileSize = 0;
+    for (std::size_t board = 0; board < nBoards; ++board) {
+      std::uint32_t boardDataTileSize = 36;
+      for (std::size_t i = 0; i < 18; ++i)
+        setA2795Word(out, compressedDataOffset++, getA2795Word(f, uncompressedDataOffset++));
+      for (std::size_t channel = 0; channel < nChannels; ++channel) {
+        std::uint16_t sampleADC = (adc_val(board, channel, 0) & 0x0FFF);
+        sampleADC += 0x8000;
+        setA2795Word(out, compressedDataOffset++, sampleADC);
+        ++uncompressedDataOffset;
+      }
+      boardDataTileSize += sampleBytes(0);
+      for (std::size_t sample = 1; sample < nSamples; ++sample) {
+        bool oddCompressions = false;
+        std::size_t nCompressed = 0;
+        for (std::size_t channelBlock = 0; channelBlock < nChannels / 4; ++channelBlock) {
+          std::int16_t adcDiff[4];
+          for (std::size_t i = 0; i < 4; ++i)
+            adcDiff[i] = adc_val(board, 4*channelBlock + i, sample) - adc_val(board, 4*channelBlock + i, sample - 1);
+          bool const isComp = (std::abs(adcDiff[0]) < 8) && (std::abs(adcDiff[1]) < 8)
+            && (std::abs(adcDiff[2]) < 8) && (std::abs(adcDiff[3]) < 8);
+          uncompressedDataOffset += 4;
+          if (isComp) {
+            ++nCompressed;
+            oddCompressions = !oddCompressions;
+            std::uint16_t new_word = (adcDiff[3] & 0x000F);
+            new_word <<= 4; new_word += (adcDiff[2] & 0x000F);
+            new_word <<= 4; new_word += (adcDiff[1] & 0x000F);
+            new_word <<= 4; new_word += (adcDiff[0] & 0x000F);
+            setA2795Word(out, compressedDataOffset++, new_word);
+          }
+          else {
+            for (std::size_t i = 0; i < 4; ++i)
+              setA2795Word(out, compressedDataOffset++, (adcDiff[i] & 0x0FFF) + 0x8000);
+          }
+        }
+        if (oddCompressions) setA2795Word(out, compressedDataOffset++, 0);
+        boardDataTileSize += sampleBytes(nCompressed);
+      }
+      boardDataTileSize += 4 * sizeof(std::uint16_t);
+      for (std::size_t i = 0; i < 4; ++i)
+        setA2795Word(out, compressedDataOffset++, getA2795Word(f, uncompressedDataOffset++));
+
+      std::uint32_t const packSize = htonl(boardDataTileSize);
+      std::memcpy(reinterpret_cast<char*>(out.data()) + totalDataTileSize + 24, &packSize, 4);
+      totalDataTileSize += boardDataTileSize;
+    }
+
+    std::vector<std::uint16_t> compressed(totalDataTileSize / sizeof(std::uint16_t));
+    std::memcpy(compressed.data(), out.data(), totalDataTileSize);
+    return compressed;
+  } // referenceCompress()
+
+
+  /// The reference: the debug decoder of `ICARUSProduceCompressed`.
+  std::vector<std::uint16_t> referenceDecompress(std::vector<std::uint16_t> const& data,
+    std::size_t nBoards, std::size_t nChannels, std::size_t nSamples)
+  {
+    std::vector<std::uint16_t> adcValues(nBoards * nChannels * nSamples); // channel-major
+    std::size_t fragWord = 0;
+    for (std::size_t b = 0; b < nBoards; b++) {
+      fragWord += 18;
+      for (std::size_t s = 0; s < nSamples; s++) {
+        std::size_t keyCount = 0;
+        for (std::size_t bit = 0; bit < nChannels/4; bit++) {
+          std::uint16_t const word = data[fragWord];
+          bool const isCompressed = ((word & 0xF000) != 0x8000);
+          for (std::size_t cInSet = 0; cInSet < 4; ++cInSet) {
+            std::size_t const c = 4*bit + cInSet;
+            std::uint16_t const prevSample = (s != 0) ? adcValues[b*nSamples*nChannels + c*nSamples + s - 1] : 0;
+            if (not isCompressed) {
+              std::int16_t const twelveBitDiff = (data[fragWord + cInSet] & 0x0FFF);
+              bool const isNeg = (twelveBitDiff >> 11) && (s != 0);
+              adcValues[b*nSamples*nChannels + c*nSamples + s] = (isNeg*0xF000 + twelveBitDiff + prevSample);
+            } else {
+              std::int16_t const fourBitDiff = (word >> (4*cInSet)) & 0x000F;
+              bool const isNeg = (fourBitDiff >> 3);
+              adcValues[b*nSamples*nChannels + c*nSamples + s] = (isNeg*0xFFF0 + fourBitDiff + prevSample);
+            }
+          }
+          fragWord += (isCompressed) ? 1 : 4;
+          keyCount += isCompressed;
+        }
+        if ((keyCount % 2) == 1) fragWord += 1;
+      }
+      fragWord += 4;
+    }
+    return adcValues;
+  } // referenceDecompress()
+
+
+  void checkSamples(std::vector<std::uint16_t> const& decompressed,
+    std::vector<std::uint16_t> const& expected,
+    std::size_t nBoards, std::size_t nChannels, std::size_t nSamples)
+  {
+    for (std::size_t board = 0; board < nBoards; ++board) {
+      std::uint16_t const* samples = daq::details::A2795BoardSamples
+        (decompressed.data(), board, nChannels, nSamples);
+      std::size_t nMismatches = 0;
+      for (std::size_t channel = 0; channel < nChannels; ++channel) {
+        for (std::size_t tick = 0; tick < nSamples; ++tick) {
+          nMismatches += samples[tick * nChannels + channel]
+            != expected[(board * nChannels + channel) * nSamples + tick];
+        }
+      }
+      BOOST_TEST(nMismatches == 0U, "board " << board);
+    }
+  } // checkSamples()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void roundTrip_test(std::size_t nBoards, std::size_t nSamples) {
+
+  constexpr std::size_t nChannels = 64U;
+  std::uint16_t const mask = daq::details::TPCBoardADCmask(12U);
+  auto const data = makePayload(nBoards, nChannels, nSamples, nBoards * nSamples);
+
+  auto const expected = referenceCompress(data, nBoards, nChannels, nSamples, mask);
+
+  std::vector<std::uint16_t> compressed(data.size());
+  std::size_t const nWords = daq::details::compressA2795Boards
+    (data.data(), nBoards, nChannels, nSamples, mask, compressed.data());
+  compressed.resize(nWords);
+  BOOST_TEST(compressed == expected, boost::test_tools::per_element());
+
+  // the scalar kernel must agree with the vectorized one
+  std::vector<std::uint16_t> scalar(nChannels * nSamples);
+  std::size_t const nScalar = daq::details::compressA2795SamplesScalar(
+    data.data() + A2795BoardHeaderWords, nChannels, nSamples, mask, scalar.data());
+  std::uint32_t packSize;
+  std::memcpy(&packSize, compressed.data() + daq::details::A2795PackSizeWord, 4);
+  BOOST_TEST(nScalar == ntohl(packSize) / 2 - A2795BoardHeaderWords - A2795BoardTrailerWords);
+  BOOST_TEST(std::memcmp(scalar.data(), compressed.data() + A2795BoardHeaderWords,
+    nScalar * sizeof(std::uint16_t)) == 0);
+
+  // decompression
+  auto const expectedSamples = referenceDecompress(compressed, nBoards, nChannels, nSamples);
+  std::vector<std::uint16_t> decompressed(data.size());
+  BOOST_TEST(daq::details::decompressA2795Boards(compressed.data(), compressed.size(),
+    nBoards, nChannels, nSamples, decompressed.data()) == compressed.size());
+  checkSamples(decompressed, expectedSamples, nBoards, nChannels, nSamples);
+
+  std::vector<std::uint16_t> scalarSamples(nChannels * nSamples);
+  BOOST_TEST(daq::details::decompressA2795SamplesScalar(compressed.data() + A2795BoardHeaderWords,
+    compressed.size(), nChannels, nSamples, scalarSamples.data()) == nScalar);
+  BOOST_TEST(std::memcmp(scalarSamples.data(), decompressed.data() + A2795BoardHeaderWords,
+    scalarSamples.size() * sizeof(std::uint16_t)) == 0);
+
+  // headers and trailers are as they were, except for the tile size
+  std::size_t const boardWords = A2795BoardWords(nChannels, nSamples);
+  for (std::size_t board = 0; board < nBoards; ++board) {
+    std::uint16_t const* original = data.data() + board * boardWords;
+    std::uint16_t const* restored = decompressed.data() + board * boardWords;
+    for (std::size_t i = 0; i < A2795BoardHeaderWords; ++i) {
+      if ((i == daq::details::A2795PackSizeWord) || (i == daq::details::A2795PackSizeWord + 1))
+        continue;
+      BOOST_TEST(restored[i] == original[i]);
+    }
+    for (std::size_t i = boardWords - A2795BoardTrailerWords; i < boardWords; ++i)
+      BOOST_TEST(restored[i] == original[i]);
+  }
+
+  // for 12-bit samples with the differences within 12 bits, it is lossless
+  for (std::size_t board = 0; board < nBoards; ++board) {
+    std::uint16_t const* original = daq::details::A2795BoardSamples(data.data(), board, nChannels, nSamples);
+    std::uint16_t const* restored = daq::details::A2795BoardSamples(decompressed.data(), board, nChannels, nSamples);
+    for (std::size_t i = 0; i < nChannels * nSamples; ++i)
+      BOOST_TEST((restored[i] & 0x0FFF) == (original[i] & mask & 0x0FFF));
+  }
+
+  // truncated data is reported
+  BOOST_CHECK_THROW(daq::details::decompressA2795Boards(compressed.data(), compressed.size() - 1,
+    nBoards, nChannels, nSamples, decompressed.data()), cet::exception);
+
+} // roundTrip_test()
+
+
+void timing_test() {
+
+  constexpr std::size_t nBoards = 9U, nChannels = 64U, nSamples = 4096U;
+  std::uint16_t const mask = daq::details::TPCBoardADCmask(12U);
+  auto const data = makePayload(nBoards, nChannels, nSamples, 12345U);
+
+  using Clock_t = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  auto const startReference = Clock_t::now();
+  auto const expected = referenceCompress(data, nBoards, nChannels, nSamples, mask);
+  auto const startCompress = Clock_t::now();
+  std::vector<std::uint16_t> compressed(data.size());
+  compressed.resize(daq::details::compressA2795Boards
+    (data.data(), nBoards, nChannels, nSamples, mask, compressed.data()));
+  auto const startRefDecompress = Clock_t::now();
+  auto const expectedSamples = referenceDecompress(compressed, nBoards, nChannels, nSamples);
+  auto const startDecompress = Clock_t::now();
+  std::vector<std::uint16_t> decompressed(data.size());
+  daq::details::decompressA2795Boards(compressed.data(), compressed.size(),
+    nBoards, nChannels, nSamples, decompressed.data());
+  auto const end = Clock_t::now();
+
+  BOOST_TEST(compressed == expected);
+  checkSamples(decompressed, expectedSamples, nBoards, nChannels, nSamples);
+
+  double const MB = data.size() * sizeof(std::uint16_t) / 1048576.0;
+  std::cout << "Fragment of " << MB << " MB compressed to "
+    << (100.0 * compressed.size() / data.size()) << "%:"
+    << "\n  compression:   " << ms(startCompress - startReference).count() << " ms (reference), "
+    << ms(startRefDecompress - startCompress).count() << " ms"
+    << "\n  decompression: " << ms(startDecompress - startRefDecompress).count() << " ms (reference), "
+    << ms(end - startDecompress).count() << " ms"
+    << std::endl;
+
+} // timing_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(A2795Compression_testcase) {
+
+  roundTrip_test(1U, 1U);
+  roundTrip_test(1U, 2U);
+  roundTrip_test(2U, 100U);
+  roundTrip_test(9U, 4096U);
+
+  timing_test();
+
+} // BOOST_AUTO_TEST_CASE(A2795Compression_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+/**
+ * @file   test/Decode/DecoderTools/TPCBoardUnpacker_test.cc
+ * @brief  Unit test and timing for `TPCBoardUnpacker.h` functions.
+ * @see    `icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h`
+ *
+ */
+
+// ICARUS libraries
+#include "icaruscode/Decode/DecoderTools/details/TPCBoardUnpacker.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( TPCBoardUnpacker_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <chrono>
+#include <cstring> // std::memcmp()
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cstdint> // std::uint16_t
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using Waveforms_t = std::vector<std::vector<float>>;
+
+  /// Returns a board payload with random 12-bit samples and a few stray bits.
+  std::vector<std::uint16_t> makeBoardData
+    (std::size_t nChannels, std::size_t nSamples, unsigned int seed)
+  {
+    std::mt19937 engine { seed };
+    std::uniform_int_distribution<unsigned int> adc { 0U, 0x3FFFU };
+    std::vector<std::uint16_t> data(nChannels * nSamples);
+    for (auto& sample: data) sample = static_cast<std::uint16_t>(adc(engine));
+    return data;
+  } // makeBoardData()
+
+  /// The reference: what the decoders did with `PhysCrateFragment::adc_val()`.
+  Waveforms_t referenceUnpack(std::vector<std::uint16_t> const& data,
+    std::size_t nChannels, std::size_t nSamples, std::uint16_t mask)
+  {
+    Waveforms_t waveforms(nChannels, std::vector<float>(nSamples));
+    for (std::size_t channel = 0; channel < nChannels; ++channel)
+      for (std::size_t tick = 0; tick < nSamples; ++tick)
+        waveforms[channel][tick] = -(data[tick * nChannels + channel] & mask);
+    return waveforms;
+  } // referenceUnpack()
+
+  void checkSameBits(Waveforms_t const& result, Waveforms_t const& expected) {
+    BOOST_TEST_REQUIRE(result.size() == expected.size());
+    for (std::size_t channel = 0; channel < result.size(); ++channel) {
+      BOOST_TEST_CONTEXT("channel " << channel) {
+        BOOST_TEST_REQUIRE(result[channel].size() == expected[channel].size());
+        BOOST_TEST(std::memcmp(result[channel].data(), expected[channel].data(),
+          result[channel].size() * sizeof(float)) == 0);
+      }
+    } // for
+  } // checkSameBits()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void unpackTPCBoard_test(std::size_t nChannels, std::size_t nSamples) {
+
+  std::uint16_t const mask = daq::details::TPCBoardADCmask(12U);
+  auto const data = makeBoardData(nChannels, nSamples, nChannels * nSamples);
+  Waveforms_t const expected = referenceUnpack(data, nChannels, nSamples, mask);
+
+  Waveforms_t result(nChannels, std::vector<float>(nSamples, 1.0f));
+  daq::details::unpackTPCBoardWaveforms
+    (data.data(), nChannels, nSamples, mask, result.begin());
+  checkSameBits(result, expected);
+
+  std::vector<float*> rows;
+  Waveforms_t scalarResult(nChannels, std::vector<float>(nSamples, 1.0f));
+  for (auto& row: scalarResult) rows.push_back(row.data());
+  daq::details::unpackTPCBoardScalar
+    (data.data(), nChannels, nSamples, mask, rows.data());
+  checkSameBits(scalarResult, expected);
+
+} // unpackTPCBoard_test()
+
+
+// -----------------------------------------------------------------------------
+void unpackTPCBoard_timing(unsigned int nRepetitions) {
+  /*
+   * Not a pass/fail test: reports the time spent unpacking a board with the
+   * ICARUS A2795 geometry (64 channels, 4096 samples) with the per-sample path
+   * and with the bulk unpacker.
+   */
+  using clock_t = std::chrono::steady_clock;
+
+  constexpr std::size_t nChannels = 64U;
+  constexpr std::size_t nSamples = 4096U;
+  std::uint16_t const mask = daq::details::TPCBoardADCmask(12U);
+  auto const data = makeBoardData(nChannels, nSamples, 42U);
+
+  Waveforms_t waveforms(nChannels, std::vector<float>(nSamples));
+  std::vector<float*> rows;
+  for (auto& row: waveforms) rows.push_back(row.data());
+
+  auto const startScalar = clock_t::now();
+  for (unsigned int i = 0; i < nRepetitions; ++i) {
+    daq::details::unpackTPCBoardScalar
+      (data.data(), nChannels, nSamples, mask, rows.data());
+  }
+  auto const startBulk = clock_t::now();
+  for (unsigned int i = 0; i < nRepetitions; ++i) {
+    daq::details::unpackTPCBoard
+      (data.data(), nChannels, nSamples, mask, rows.data());
+  }
+  auto const stop = clock_t::now();
+
+  using us = std::chrono::duration<double, std::micro>;
+  std::cout << "Unpacking a " << nChannels << "x" << nSamples << " board: "
+    << (us(startBulk - startScalar).count() / nRepetitions) << " us sample by sample, "
+    << (us(stop - startBulk).count() / nRepetitions) << " us in bulk"
+    << std::endl;
+
+} // unpackTPCBoard_timing()
+
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(unpackTPCBoard_testcase) {
+
+  unpackTPCBoard_test(64U, 4096U); // ICARUS A2795 board
+  unpackTPCBoard_test(64U, 13U);   // leftover samples
+  unpackTPCBoard_test(13U, 64U);   // leftover channels
+  unpackTPCBoard_test(3U, 5U);     // no full tile at all
+
+} // BOOST_AUTO_TEST_CASE(unpackTPCBoard_testcase)
+
+
+BOOST_AUTO_TEST_CASE(unpackTPCBoard_timing_testcase) {
+
+  unpackTPCBoard_timing(200U);
+
+} // BOOST_AUTO_TEST_CASE(unpackTPCBoard_timing_testcase)
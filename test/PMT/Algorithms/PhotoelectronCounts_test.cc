@@ -0,0 +1,243 @@
+/**
+ * @file   test/PMT/Algorithms/PhotoelectronCounts_test.cc
+ * @brief  Unit test for `icarus::opdet::PhotoelectronCounts`.
+ * @date   October 16, 2026
+ * @see    `icaruscode/PMT/Algorithms/PhotoelectronCounts.h`
+ *
+ * The waveforms are compared with the ones from the procedure previously used
+ * in `PMTsimulationAlg` (a hash map of photoelectrons per subsample), which is
+ * reproduced here; the time taken by both on high light channels is also
+ * reported.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Algorithms/PhotoelectronCounts.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( PhotoelectronCounts_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <utility> // std::pair
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using Waveform_t = std::vector<float>;
+  using Pulses_t = std::vector<std::vector<float>>;
+  using PE_t = std::pair<std::size_t, std::size_t>; // tick, subsample
+
+
+  /// Returns an asymmetric gaussian pulse for each of the `nSubsamples`.
+  Pulses_t makePulses(std::size_t nSubsamples) {
+    constexpr std::size_t NSamples = 60; // 120 ns at 500 MHz
+    Pulses_t pulses;
+    for (std::size_t sub = 0; sub < nSubsamples; ++sub) {
+      std::vector<float> pulse(NSamples);
+      for (std::size_t i = 0; i < NSamples; ++i) {
+        double const t = i - 27.5 + double(sub) / nSubsamples; // [ticks]
+        double const sigma = (t < 0.0)? 1.8: 4.5;
+        pulse[i] = -4.0 * std::exp(-0.5 * (t / sigma) * (t / sigma));
+      }
+      pulses.push_back(std::move(pulse));
+    }
+    return pulses;
+  } // makePulses()
+
+
+  /// Photoelectrons from a beam spill with showers on top of cosmic activity.
+  std::vector<PE_t> makeBrightChannel(
+    std::mt19937& engine, std::size_t nPE,
+    std::size_t nTicks, std::size_t nSubsamples
+  ) {
+    std::uniform_real_distribution<double> spill{ 0.0, 800.0 }; // 1.6 us
+    std::uniform_real_distribution<double> anywhere{ 0.0, double(nTicks) };
+    std::exponential_distribution<double> fast{ 1.0 / 3.0 }; // 6 ns
+    std::exponential_distribution<double> slow{ 1.0 / 800.0 }; // 1.6 us
+    std::uniform_real_distribution<double> flat;
+
+    double const beamTick = nTicks / 2.0;
+    std::vector<PE_t> PEs;
+    PEs.reserve(nPE);
+    while (PEs.size() < nPE) {
+      double const u = flat(engine);
+      double const start = (u < 0.05)? anywhere(engine): beamTick + spill(engine);
+      double const tick_d = start + ((u < 0.3)? fast(engine): slow(engine));
+      if (tick_d >= nTicks) continue;
+      double const tick = std::floor(tick_d);
+      PEs.emplace_back(
+        std::size_t(tick), std::size_t((tick_d - tick) * nSubsamples)
+        );
+    } // while
+    return PEs;
+  } // makeBrightChannel()
+
+
+  /// Waveform from the procedure previously used in `PMTsimulationAlg`.
+  Waveform_t refWaveform(
+    std::vector<PE_t> const& PEs, Pulses_t const& pulses, std::size_t nTicks
+  ) {
+    std::vector<std::unordered_map<std::size_t, unsigned int>> peMaps
+      (pulses.size());
+    for (auto const& [ tick, subsample ]: PEs) ++peMaps[subsample][tick];
+
+    Waveform_t waveform(nTicks, 0.0f);
+    for (std::size_t sub = 0; sub < peMaps.size(); ++sub) {
+      auto const& pulse = pulses[sub];
+      for (auto const& [ startTick, nPE ]: peMaps[sub]) {
+        float const n = nPE;
+        std::size_t const max = std::min(startTick + pulse.size(), nTicks);
+        std::transform(
+          waveform.begin() + startTick, waveform.begin() + max,
+          pulse.begin(), waveform.begin() + startTick,
+          [n](float a, float b){ return a + n * b; }
+          );
+      } // for ticks
+    } // for subsamples
+    return waveform;
+  } // refWaveform()
+
+
+  /// Waveform from `PhotoelectronCounts`.
+  Waveform_t newWaveform(
+    icarus::opdet::PhotoelectronCounts& counts,
+    std::vector<PE_t> const& PEs, Pulses_t const& pulses
+  ) {
+    counts.clear();
+    for (auto const& [ tick, subsample ]: PEs) counts.add(tick, subsample);
+
+    Waveform_t waveform(counts.nTicks(), 0.0f);
+    counts.forEach([&](std::size_t tick, std::size_t sub, unsigned int nPE)
+      { icarus::opdet::addScaledPulse(pulses[sub], waveform, tick, float(nPE)); }
+      );
+    return waveform;
+  } // newWaveform()
+
+
+  /// Returns the largest difference between the two waveforms.
+  float maxDifference(Waveform_t const& a, Waveform_t const& b) {
+    float maxDiff = 0.0f;
+    for (std::size_t i = 0; i < a.size(); ++i)
+      maxDiff = std::max(maxDiff, std::abs(a[i] - b[i]));
+    return maxDiff;
+  } // maxDifference()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void counts_test() {
+
+  icarus::opdet::PhotoelectronCounts counts{ 10, 4 };
+  BOOST_TEST(counts.nTicks() == 10U);
+  BOOST_TEST(counts.nSubsamples() == 4U);
+  BOOST_TEST(counts.nFilled() == 0U);
+
+  counts.add(7, 1);
+  counts.add(2, 3, 5U);
+  counts.add(7, 1, 2U);
+  counts.add(2, 0, 0U); // no photoelectron, no cell
+  counts.add(0, 0);
+
+  BOOST_TEST(counts.nFilled() == 3U);
+  BOOST_TEST(counts.count(7, 1) == 3U);
+  BOOST_TEST(counts.count(2, 3) == 5U);
+  BOOST_TEST(counts.count(2, 0) == 0U);
+
+  std::vector<std::tuple<std::size_t, std::size_t, unsigned int>> visited;
+  counts.forEach([&visited](std::size_t tick, std::size_t sub, unsigned int n)
+    { visited.emplace_back(tick, sub, n); });
+  decltype(visited) const expected
+    { { 0U, 0U, 1U }, { 2U, 3U, 5U }, { 7U, 1U, 3U } };
+  BOOST_TEST(visited == expected);
+
+  counts.clear();
+  BOOST_TEST(counts.nFilled() == 0U);
+  BOOST_TEST(counts.count(7, 1) == 0U);
+  BOOST_TEST(counts.count(2, 3) == 0U);
+
+} // counts_test()
+
+
+void addScaledPulse_test() {
+
+  std::vector<float> const pulse { 1.0f, 2.0f, 3.0f };
+  std::vector<float> waveform(5, 1.0f);
+
+  icarus::opdet::addScaledPulse(pulse, waveform, 1, 2.0f);
+  icarus::opdet::addScaledPulse(pulse, waveform, 3, 1.0f); // truncated
+  icarus::opdet::addScaledPulse(pulse, waveform, 5, 1.0f); // out of range
+
+  std::vector<float> const expected { 1.0f, 3.0f, 5.0f, 8.0f, 3.0f };
+  BOOST_TEST(waveform == expected, boost::test_tools::per_element());
+
+} // addScaledPulse_test()
+
+
+void brightChannels_test() {
+
+  constexpr std::size_t NTicks = 1000000; // 2 ms at 500 MHz
+  constexpr std::size_t NSubsamples = 4;
+
+  std::mt19937 engine{ 86420 };
+  Pulses_t const pulses = makePulses(NSubsamples);
+  icarus::opdet::PhotoelectronCounts counts{ NTicks, NSubsamples };
+
+  using Clock_t = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  for (std::size_t nPE: { 10000, 300000, 3000000 }) {
+
+    std::vector<std::vector<PE_t>> channels;
+    for (int i = 0; i < 4; ++i)
+      channels.push_back(makeBrightChannel(engine, nPE, NTicks, NSubsamples));
+
+    ms refTime{ 0 }, newTime{ 0 };
+    for (auto const& PEs: channels) {
+      auto const startRef = Clock_t::now();
+      Waveform_t const ref = refWaveform(PEs, pulses, NTicks);
+      auto const startNew = Clock_t::now();
+      Waveform_t const waveform = newWaveform(counts, PEs, pulses);
+      auto const end = Clock_t::now();
+      refTime += startNew - startRef;
+      newTime += end - startNew;
+
+      // the order of the sums is different
+      float const scale
+        = std::abs(*std::min_element(ref.begin(), ref.end()));
+      BOOST_TEST(maxDifference(waveform, ref) <= 1e-5f * scale);
+    } // for channels
+
+    std::cout << channels.size() << " channels with " << nPE
+      << " photoelectrons each: " << refTime.count() << " ms with hash maps, "
+      << newTime.count() << " ms with dense counts" << std::endl;
+
+  } // for photoelectrons
+
+} // brightChannels_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(PhotoelectronCounts_testcase) {
+
+  counts_test();
+  addScaledPulse_test();
+  brightChannels_test();
+
+} // BOOST_AUTO_TEST_CASE(PhotoelectronCounts_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
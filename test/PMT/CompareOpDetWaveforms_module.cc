@@ -0,0 +1,141 @@
+/**
+ * @file   test/PMT/CompareOpDetWaveforms_module.cc
+ * @brief  Checks that two `raw::OpDetWaveform` collections are identical.
+ * @date   October 16, 2026
+ *
+ * Used to check that the multithreaded `SimPMTIcarus` gives the same
+ * waveforms independently of the number of threads.
+ */
+
+// LArSoft libraries
+#include "lardataobj/RawData/OpDetWaveform.h"
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "canvas/Utilities/InputTag.h"
+#include "canvas/Utilities/Exception.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "fhiclcpp/types/Atom.h"
+
+// C/C++ standard library
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::test { class CompareOpDetWaveforms; }
+
+/**
+ * @brief Throws an exception if two `raw::OpDetWaveform` collections differ.
+ *
+ * The two collections must have the same waveforms in the same order: same
+ * channel, time stamp and samples.
+ *
+ * Configuration parameters
+ * -------------------------
+ *
+ * * `ReferenceWaveforms` (input tag): the reference collection
+ * * `TestWaveforms` (input tag): the collection compared with the reference one
+ */
+class icarus::test::CompareOpDetWaveforms: public art::EDAnalyzer {
+
+    public:
+
+  struct Config {
+    using Name = fhicl::Name;
+    using Comment = fhicl::Comment;
+
+    fhicl::Atom<art::InputTag> ReferenceWaveforms {
+      Name("ReferenceWaveforms"),
+      Comment("the reference optical waveform collection")
+      };
+
+    fhicl::Atom<art::InputTag> TestWaveforms {
+      Name("TestWaveforms"),
+      Comment("the optical waveform collection compared with the reference one")
+      };
+
+  }; // struct Config
+
+  using Parameters = art::EDAnalyzer::Table<Config>;
+
+  explicit CompareOpDetWaveforms(Parameters const& config);
+
+  void analyze(art::Event const& event) override;
+
+    private:
+
+  art::InputTag const fReferenceTag;
+  art::InputTag const fTestTag;
+
+}; // icarus::test::CompareOpDetWaveforms
+
+
+// -----------------------------------------------------------------------------
+icarus::test::CompareOpDetWaveforms::CompareOpDetWaveforms
+  (Parameters const& config)
+  : art::EDAnalyzer(config)
+  , fReferenceTag(config().ReferenceWaveforms())
+  , fTestTag(config().TestWaveforms())
+{
+  consumes<std::vector<raw::OpDetWaveform>>(fReferenceTag);
+  consumes<std::vector<raw::OpDetWaveform>>(fTestTag);
+} // icarus::test::CompareOpDetWaveforms::CompareOpDetWaveforms()
+
+
+// -----------------------------------------------------------------------------
+void icarus::test::CompareOpDetWaveforms::analyze(art::Event const& event) {
+
+  using Samples_t = std::vector<raw::ADC_Count_t>;
+
+  auto const& reference
+    = event.getProduct<std::vector<raw::OpDetWaveform>>(fReferenceTag);
+  auto const& test
+    = event.getProduct<std::vector<raw::OpDetWaveform>>(fTestTag);
+
+  if (reference.size() != test.size()) {
+    throw art::Exception(art::errors::LogicError)
+      << event.id() << ": " << test.size() << " waveforms in '"
+      << fTestTag.encode() << "', " << reference.size() << " in '"
+      << fReferenceTag.encode() << "'\n";
+  }
+
+  unsigned int nDifferent = 0;
+  for (std::size_t iWaveform = 0; iWaveform < reference.size(); ++iWaveform) {
+    raw::OpDetWaveform const& ref = reference[iWaveform];
+    raw::OpDetWaveform const& waveform = test[iWaveform];
+    if ((waveform.ChannelNumber() == ref.ChannelNumber())
+      && (waveform.TimeStamp() == ref.TimeStamp())
+      && (static_cast<Samples_t const&>(waveform)
+        == static_cast<Samples_t const&>(ref))
+    ) {
+      continue;
+    }
+    if (nDifferent++ < 10) {
+      mf::LogError("CompareOpDetWaveforms") << event.id() << ": waveform #"
+        << iWaveform << " (channel " << waveform.ChannelNumber() << ", time "
+        << waveform.TimeStamp() << ") differs from the reference (channel "
+        << ref.ChannelNumber() << ", time " << ref.TimeStamp() << ")";
+    }
+  } // for waveforms
+
+  if (nDifferent > 0) {
+    throw art::Exception(art::errors::LogicError)
+      << event.id() << ": " << nDifferent << "/" << reference.size()
+      << " waveforms in '" << fTestTag.encode() << "' differ from '"
+      << fReferenceTag.encode() << "'\n";
+  }
+
+  mf::LogInfo("CompareOpDetWaveforms") << event.id() << ": all "
+    << reference.size() << " waveforms in '" << fTestTag.encode()
+    << "' match '" << fReferenceTag.encode() << "'";
+
+} // icarus::test::CompareOpDetWaveforms::analyze()
+
+
+// -----------------------------------------------------------------------------
+DEFINE_ART_MODULE(icarus::test::CompareOpDetWaveforms)
+
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,178 @@
+/**
+ * @file   test/PMT/OpReco/SparseFlashAlgo_test.cc
+ * @brief  Unit test for `pmtana::SparseFlashAlgo`.
+ * @date   October 16, 2026
+ * @see    `icaruscode/PMT/OpReco/FlashFinder/SparseFlashAlgo.h`
+ *
+ * The flashes are compared with the ones from `pmtana::SimpleFlashAlgo` with
+ * the same configuration; the time taken by both is also reported.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/OpReco/FlashFinder/SparseFlashAlgo.h"
+#include "icaruscode/PMT/OpReco/FlashFinder/SimpleFlashAlgo.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( SparseFlashAlgo_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  constexpr int NChannels = 180;
+
+  /// Returns a configuration similar to the standard ICARUS one.
+  pmtana::Config_t makeConfig(double timeResolution) {
+    pmtana::Config_t config;
+    config.put("PEThresholdHit", 1.0);
+    config.put("PEThreshold", 50.0);
+    config.put("MinPECoinc", 20.0);
+    config.put("MinMultCoinc", 2.0);
+    config.put("IntegralTime", 1.0);
+    config.put("PreSample", 0.02);
+    config.put("VetoSize", 1.0);
+    config.put("TimeResolution", timeResolution);
+    config.put("HitVetoRangeStart", std::vector<double>{ 1500.0 });
+    config.put("HitVetoRangeEnd", std::vector<double>{ 1510.0 });
+    config.put("OpChannelRange", std::vector<int>{ 0, NChannels - 1 });
+    return config;
+  } // makeConfig()
+
+
+  /// Hits from a beam flash and from cosmic rays in a `span` [us] long window.
+  pmtana::LiteOpHitArray_t makeHits
+    (std::mt19937& engine, double span, unsigned int nCosmics)
+  {
+    std::uniform_int_distribution<std::size_t> channel{ 0, NChannels + 9 };
+    std::uniform_real_distribution<double> flashTime{ -span / 2.0, span / 2.0 };
+    std::exponential_distribution<double> delay{ 1.0 / 0.3 };
+    std::poisson_distribution<int> nHits{ 40 };
+    std::exponential_distribution<double> pe{ 1.0 / 8.0 };
+    std::uniform_real_distribution<double> flat;
+
+    pmtana::LiteOpHitArray_t hits;
+    auto addFlash = [&](double time, int n)
+      {
+        for (int i = 0; i < n; ++i) {
+          pmtana::LiteOpHit_t hit;
+          hit.channel = channel(engine);
+          hit.peak_time = time + delay(engine);
+          // some integral PE values, so that bins may have the same total
+          hit.pe = (flat(engine) < 0.3)? std::ceil(pe(engine)): pe(engine);
+          hits.push_back(hit);
+        }
+      };
+
+    addFlash(0.0, 5 * nHits(engine));
+    for (unsigned int i = 0; i < nCosmics; ++i)
+      addFlash(flashTime(engine), nHits(engine));
+    for (int i = 0; i < 2000; ++i) addFlash(flashTime(engine), 1); // noise
+    return hits;
+  } // makeHits()
+
+
+  /// Checks that the two flash collections are exactly the same.
+  void compareFlashes(
+    pmtana::LiteOpFlashArray_t const& flashes,
+    pmtana::LiteOpFlashArray_t const& expected
+  ) {
+    BOOST_TEST_REQUIRE(flashes.size() == expected.size());
+    for (std::size_t i = 0; i < flashes.size(); ++i) {
+      BOOST_TEST_CONTEXT("flash #" << i) {
+        BOOST_TEST(flashes[i].time == expected[i].time);
+        BOOST_TEST(flashes[i].time_err == expected[i].time_err);
+        BOOST_TEST(flashes[i].channel_pe == expected[i].channel_pe,
+          boost::test_tools::per_element());
+        BOOST_TEST(flashes[i].asshit_idx == expected[i].asshit_idx,
+          boost::test_tools::per_element());
+      }
+    } // for
+  } // compareFlashes()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void parity_test() {
+
+  std::mt19937 engine{ 97531 };
+
+  for (double const timeResolution: { 0.01, 0.02 }) {
+
+    pmtana::Config_t const config = makeConfig(timeResolution);
+    pmtana::SimpleFlashAlgo simpleAlgo{ "SimpleFlashAlgo" };
+    pmtana::SparseFlashAlgo sparseAlgo{ "SparseFlashAlgo" };
+    simpleAlgo.Configure(config);
+    sparseAlgo.Configure(config);
+
+    for (int iEvent = 0; iEvent < 10; ++iEvent) {
+      BOOST_TEST_CONTEXT("resolution " << timeResolution << " event #" << iEvent)
+      {
+        pmtana::LiteOpHitArray_t const hits
+          = makeHits(engine, 200.0, 10 * iEvent);
+        pmtana::LiteOpFlashArray_t const expected = simpleAlgo.RecoFlash(hits);
+        BOOST_TEST(!expected.empty());
+        compareFlashes(sparseAlgo.RecoFlash(hits), expected);
+      }
+    } // for events
+
+    // no hits, no flashes
+    BOOST_TEST(sparseAlgo.RecoFlash({}).empty());
+
+  } // for resolutions
+
+} // parity_test()
+
+
+void timing_test() {
+
+  // hits over 3 ms, as with the out-of-time cosmic rays
+  std::mt19937 engine{ 86420 };
+  pmtana::LiteOpHitArray_t const hits = makeHits(engine, 3000.0, 500);
+
+  pmtana::Config_t const config = makeConfig(0.01);
+  pmtana::SimpleFlashAlgo simpleAlgo{ "SimpleFlashAlgo" };
+  pmtana::SparseFlashAlgo sparseAlgo{ "SparseFlashAlgo" };
+  simpleAlgo.Configure(config);
+  sparseAlgo.Configure(config);
+
+  using Clock_t = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  auto const startSimple = Clock_t::now();
+  pmtana::LiteOpFlashArray_t const expected = simpleAlgo.RecoFlash(hits);
+  auto const startSparse = Clock_t::now();
+  pmtana::LiteOpFlashArray_t const flashes = sparseAlgo.RecoFlash(hits);
+  auto const end = Clock_t::now();
+
+  compareFlashes(flashes, expected);
+
+  std::cout << flashes.size() << " flashes from " << hits.size() << " hits: "
+    << ms(startSparse - startSimple).count() << " ms with SimpleFlashAlgo, "
+    << ms(end - startSparse).count() << " ms with SparseFlashAlgo" << std::endl;
+
+} // timing_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SparseFlashAlgo_testcase) {
+
+  parity_test();
+  timing_test();
+
+} // BOOST_AUTO_TEST_CASE(SparseFlashAlgo_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
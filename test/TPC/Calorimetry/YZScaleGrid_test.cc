@@ -0,0 +1,202 @@
+/**
+ * @file   test/TPC/Calorimetry/YZScaleGrid_test.cc
+ * @brief  Unit test for `icarus::calo::YZScaleGrid`.
+ * @date   October 16, 2026
+ * @see    `icaruscode/TPC/Calorimetry/YZScaleGrid.h`
+ *
+ * The bins found for random points, including points on the bin borders, are
+ * compared with a linear search of the bins, both with bins on a uniform grid
+ * and with bins which are not; the time taken by the grid lookup and by the
+ * binary search is also reported.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Calorimetry/YZScaleGrid.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( YZScaleGrid_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using ScaleBin = icarus::calo::YZScaleGrid::ScaleBin;
+  using Point = icarus::calo::YZScaleGrid::Point;
+
+  /// Bins of 4 TPC on a `ny` x `nz` grid, shuffled, with some holes.
+  std::vector<ScaleBin> makeGridBins
+    (int ny, int nz, double dy, double dz, std::mt19937& engine)
+  {
+    std::uniform_real_distribution<double> scale{ 0.8, 1.2 };
+    std::vector<ScaleBin> bins;
+    for (int itpc = 0; itpc < 4; ++itpc) {
+      for (int iy = 0; iy < ny; ++iy) {
+        for (int iz = 0; iz < nz; ++iz) {
+          if ((itpc == 1) && (iy == 3) && (iz % 7 == 0)) continue; // holes
+          // adjacent bins share their edges exactly
+          double const ylo = -180.0 + iy * dy, yhi = -180.0 + (iy + 1) * dy;
+          double const zlo = -900.0 + iz * dz, zhi = -900.0 + (iz + 1) * dz;
+          bins.push_back({ itpc, ylo, yhi, zlo, zhi, scale(engine) });
+        }
+      }
+    }
+    std::shuffle(bins.begin(), bins.end(), engine);
+    return bins;
+  } // makeGridBins()
+
+
+  /// Bins found by checking all of them.
+  ScaleBin const* linearSearch
+    (std::vector<ScaleBin> const& bins, Point const& point)
+  {
+    for (ScaleBin const& bin: bins) if (bin.contains(point)) return &bin;
+    return nullptr;
+  } // linearSearch()
+
+
+  /// Random points in and around the bins, a few on the bin borders.
+  std::vector<Point> makePoints
+    (std::vector<ScaleBin> const& bins, std::size_t n, std::mt19937& engine)
+  {
+    std::uniform_int_distribution<int> tpc{ -1, 4 };
+    std::uniform_real_distribution<double> y{ -200.0, 200.0 }, z{ -950.0, 950.0 };
+    std::uniform_int_distribution<std::size_t> bin{ 0, bins.size() - 1 };
+    std::vector<Point> points;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (i % 4 == 0) {
+        ScaleBin const& b = bins[bin(engine)];
+        points.push_back({ b.itpc, (i % 8 == 0)? b.ylo: b.yhi, b.zlo });
+      }
+      else points.push_back({ tpc(engine), y(engine), z(engine) });
+    }
+    return points;
+  } // makePoints()
+
+
+  void checkAgainstLinearSearch(std::vector<ScaleBin> const& bins,
+    icarus::calo::YZScaleGrid const& grid, std::vector<Point> const& points)
+  {
+    for (Point const& point: points) {
+      BOOST_TEST_CONTEXT("TPC " << point.itpc << " y=" << point.y << " z=" << point.z) {
+        ScaleBin const* expected = linearSearch(bins, point);
+        ScaleBin const* found = grid.findBin(point);
+        BOOST_TEST((found == nullptr) == (expected == nullptr));
+        if (found && expected) BOOST_TEST(found->scale == expected->scale);
+      }
+    }
+  } // checkAgainstLinearSearch()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void uniform_grid_test() {
+
+  std::mt19937 engine{ 4321 };
+  // bin sizes not exactly representable, as they come from the database
+  std::vector<ScaleBin> const bins = makeGridBins(12, 60, 30.1, 30.3, engine);
+
+  icarus::calo::YZScaleGrid const grid{ bins };
+  for (int itpc = 0; itpc < 4; ++itpc) BOOST_TEST(grid.hasGrid(itpc));
+  BOOST_TEST(!grid.hasGrid(4));
+  BOOST_TEST(grid.bins().size() == bins.size());
+
+  checkAgainstLinearSearch(bins, grid, makePoints(bins, 20000, engine));
+
+} // uniform_grid_test()
+
+
+void irregular_bins_test() {
+
+  std::mt19937 engine{ 8765 };
+  std::vector<ScaleBin> bins = makeGridBins(6, 20, 60.0, 90.0, engine);
+  // make the bins of TPC 2 irregular by splitting some of them
+  std::vector<ScaleBin> split;
+  for (ScaleBin& bin: bins) {
+    if ((bin.itpc != 2) || (bin.zlo > 0.0)) continue;
+    double const zmid = 0.5 * (bin.zlo + bin.zhi);
+    split.push_back({ bin.itpc, bin.ylo, bin.yhi, zmid, bin.zhi, bin.scale * 1.1 });
+    bin.zhi = zmid;
+  }
+  bins.insert(bins.end(), split.begin(), split.end());
+
+  icarus::calo::YZScaleGrid const grid{ bins };
+  BOOST_TEST(grid.hasGrid(0));
+  BOOST_TEST(!grid.hasGrid(2));
+
+  checkAgainstLinearSearch(bins, grid, makePoints(bins, 20000, engine));
+
+  BOOST_TEST(icarus::calo::YZScaleGrid{}.findBin({ 0, 0.0, 0.0 }) == nullptr);
+
+} // irregular_bins_test()
+
+
+void timing_test() {
+
+  std::mt19937 engine{ 1357 };
+  std::vector<ScaleBin> const bins = makeGridBins(30, 180, 10.0, 10.0, engine);
+  icarus::calo::YZScaleGrid const grid{ bins };
+
+  // the binary search of the bins, as it was done before the grid
+  std::vector<ScaleBin> sorted = bins;
+  std::sort(sorted.begin(), sorted.end());
+  icarus::calo::YZScaleGrid const noGrid{ [&sorted]()
+    {
+      // stretching a bin in each TPC prevents the grids
+      std::vector<ScaleBin> bins = sorted;
+      for (ScaleBin& bin: bins) if (bin.ylo == -180.0 && bin.zlo == -900.0) bin.ylo -= 1.0;
+      return bins;
+    }() };
+  BOOST_TEST(!noGrid.hasGrid(0));
+
+  std::uniform_int_distribution<int> tpc{ 0, 3 };
+  std::uniform_real_distribution<double> y{ -179.0, 119.0 }, z{ -899.0, 899.0 };
+  std::vector<Point> points(2000000);
+  for (Point& point: points) point = { tpc(engine), y(engine), z(engine) };
+
+  using Clock_t = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  double gridSum = 0.0, searchSum = 0.0;
+  auto const startGrid = Clock_t::now();
+  for (Point const& point: points) {
+    if (auto bin = grid.findBin(point)) gridSum += bin->scale;
+  }
+  auto const startSearch = Clock_t::now();
+  for (Point const& point: points) {
+    if (auto bin = noGrid.findBin(point)) searchSum += bin->scale;
+  }
+  auto const end = Clock_t::now();
+
+  BOOST_TEST(gridSum == searchSum);
+
+  std::cout << points.size() << " scale lookups: "
+    << ms(startSearch - startGrid).count() << " ms on the grid, "
+    << ms(end - startSearch).count() << " ms with binary search" << std::endl;
+
+} // timing_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(YZScaleGrid_testcase) {
+
+  uniform_grid_test();
+  irregular_bins_test();
+  timing_test();
+
+} // BOOST_AUTO_TEST_CASE(YZScaleGrid_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
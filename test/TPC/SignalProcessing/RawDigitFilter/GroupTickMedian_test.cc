@@ -0,0 +1,211 @@
+/**
+ * @file   test/TPC/SignalProcessing/RawDigitFilter/GroupTickMedian_test.cc
+ * @brief  Unit test for `GroupTickMedian.h` header.
+ * @date   October 16, 2026
+ * @see    `icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/GroupTickMedian.h`
+ *
+ * The medians are compared with the sorting algorithm previously used in
+ * `mtRawDigitFilterICARUS` module, reproduced here; the time taken by both is
+ * also reported.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/GroupTickMedian.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( GroupTickMedian_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+// --- reference implementation (sorting the samples of each tick)
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// A channel of the group: waveform, pedestal and range of good ticks.
+  struct Channel_t {
+    std::vector<short> waveform;
+    float pedestal;
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  std::vector<float> refMedians
+    (std::vector<Channel_t> const& channels, std::size_t nTicks)
+  {
+    std::vector<float> medians(nTicks);
+    for (std::size_t tick = 0; tick < nTicks; ++tick) {
+      std::vector<float> values;
+      for (Channel_t const& channel: channels) {
+        if (tick < channel.begin || tick >= channel.end) continue;
+        values.push_back(float(channel.waveform[tick]) - channel.pedestal);
+      }
+      float median(-10000);
+      if (!values.empty()) {
+        std::sort(values.begin(), values.end());
+        std::size_t const medIdx = values.size() / 2;
+        median = values[medIdx];
+        // (the original code read past the end for two values)
+        if (values.size() > 1 && medIdx % 2 && medIdx + 1 < values.size())
+          median = (median + values[medIdx + 1]) / 2;
+      }
+      medians[tick] = std::max(median, float(-10000));
+    } // for ticks
+    return medians;
+  } // refMedians()
+
+
+  std::vector<float> groupMedians(caldata::GroupTickMedian& finder,
+    std::vector<Channel_t> const& channels, std::size_t nTicks)
+  {
+    finder.reset(channels.size(), nTicks);
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+      Channel_t const& channel = channels[i];
+      finder.setChannel
+        (i, channel.waveform.data(), channel.pedestal, channel.begin, channel.end);
+    }
+    std::vector<float> medians;
+    finder.computeMedians(medians, -10000.f);
+    return medians;
+  } // groupMedians()
+
+
+  /// A group of channels with coherent noise and a few excluded ranges.
+  std::vector<Channel_t> makeGroup
+    (std::mt19937& engine, std::size_t nChannels, std::size_t nTicks)
+  {
+    std::normal_distribution<float> noise{ 0.0f, 3.0f };
+    std::uniform_real_distribution<float> flat{ 0.0f, 1.0f };
+
+    std::vector<float> coherent(nTicks);
+    for (float& value: coherent) value = 2.0f * noise(engine);
+
+    std::vector<Channel_t> channels(nChannels);
+    for (Channel_t& channel: channels) {
+      channel.pedestal = 2000.0f + 0.5f * noise(engine);
+      channel.waveform.resize(nTicks);
+      for (std::size_t tick = 0; tick < nTicks; ++tick) {
+        channel.waveform[tick]
+          = short(std::round(2000.0f + coherent[tick] + noise(engine)));
+      }
+      channel.begin = 0;
+      channel.end = nTicks;
+      if (flat(engine) < 0.1f) channel.begin = std::size_t(flat(engine) * nTicks);
+      if (flat(engine) < 0.1f) channel.end = std::size_t(flat(engine) * nTicks);
+    } // for channels
+    return channels;
+  } // makeGroup()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- tests
+// -----------------------------------------------------------------------------
+void network_test() {
+
+  // the sorting networks do sort
+  auto const check = [](auto const& network, std::size_t nLanes) {
+    std::mt19937 engine{ 1357 };
+    std::uniform_int_distribution<int> values{ -50, 50 };
+    for (int trial = 0; trial < 200; ++trial) {
+      std::vector<int> lanes(nLanes);
+      for (int& value: lanes) value = values(engine);
+      for (auto const& comparator: network) {
+        if (lanes[comparator.high] < lanes[comparator.low])
+          std::swap(lanes[comparator.low], lanes[comparator.high]);
+      }
+      BOOST_TEST(std::is_sorted(lanes.begin(), lanes.end()));
+    }
+  };
+
+  check(caldata::details::makeSortingNetwork<32>(), 32);
+  check(caldata::details::makeSortingNetwork<64>(), 64);
+  BOOST_TEST(caldata::details::makeSortingNetwork<32>().size() == 191U);
+  BOOST_TEST(caldata::details::makeSortingNetwork<64>().size() == 543U);
+
+} // network_test()
+
+
+void median_test() {
+
+  std::mt19937 engine{ 2468 };
+  caldata::GroupTickMedian finder;
+
+  for (std::size_t nChannels: { 2, 3, 7, 31, 32, 48, 64, 65, 96 }) {
+    for (std::size_t nTicks: { 1, 15, 17, 4096 }) {
+      auto const channels = makeGroup(engine, nChannels, nTicks);
+      BOOST_TEST_CONTEXT(nChannels << " channels, " << nTicks << " ticks") {
+        BOOST_TEST(groupMedians(finder, channels, nTicks)
+          == refMedians(channels, nTicks), boost::test_tools::per_element());
+      }
+    }
+  }
+  BOOST_TEST(finder.nLanes() == 96U);
+
+  // no samples at all
+  finder.reset(4, 20);
+  std::vector<float> medians;
+  finder.computeMedians(medians, -10000.f);
+  BOOST_TEST(medians == std::vector<float>(20, -10000.f),
+    boost::test_tools::per_element());
+
+} // median_test()
+
+
+void timing_test() {
+
+  constexpr std::size_t NTicks = 4096;
+  std::mt19937 engine{ 97531 };
+
+  using Clock_t = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+  caldata::GroupTickMedian finder;
+
+  for (std::size_t nChannels: { 32, 64 }) {
+    std::vector<std::vector<Channel_t>> groups;
+    for (int i = 0; i < 20; ++i)
+      groups.push_back(makeGroup(engine, nChannels, NTicks));
+
+    double sumRef = 0.0, sumNew = 0.0;
+
+    auto const startRef = Clock_t::now();
+    for (auto const& group: groups) sumRef += refMedians(group, NTicks)[100];
+    auto const startNew = Clock_t::now();
+    for (auto const& group: groups) sumNew += groupMedians(finder, group, NTicks)[100];
+    auto const end = Clock_t::now();
+
+    BOOST_TEST(sumNew == sumRef);
+
+    std::cout << "Medians of " << groups.size() << " groups of " << nChannels
+      << " channels x " << NTicks << " ticks: "
+      << ms(startNew - startRef).count() << " ms sorting, "
+      << ms(end - startNew).count() << " ms with sorting network" << std::endl;
+  } // for group sizes
+
+} // timing_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(GroupTickMedian_testcase) {
+
+  network_test();
+  median_test();
+  timing_test();
+
+} // BOOST_AUTO_TEST_CASE(GroupTickMedian_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,135 @@
+/**
+ * @file   test/TPC/Simulation/DetSim/CompareRawDigits_module.cc
+ * @brief  Checks that two `raw::RawDigit` collections are identical.
+ * @date   October 16, 2026
+ *
+ * Used to check that the multithreaded `SimWireICARUS` gives the same
+ * waveforms independently of the number of threads.
+ */
+
+// LArSoft libraries
+#include "lardataobj/RawData/RawDigit.h"
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "canvas/Utilities/InputTag.h"
+#include "canvas/Utilities/Exception.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "fhiclcpp/types/Atom.h"
+
+// C/C++ standard library
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::test { class CompareRawDigits; }
+
+/**
+ * @brief Throws an exception if two `raw::RawDigit` collections differ.
+ *
+ * The two collections must have the same digits in the same order: same
+ * channel, pedestal, compression and ADC samples.
+ *
+ * Configuration parameters
+ * -------------------------
+ *
+ * * `ReferenceDigits` (input tag): the reference collection
+ * * `TestDigits` (input tag): the collection compared with the reference one
+ */
+class icarus::test::CompareRawDigits: public art::EDAnalyzer {
+
+    public:
+
+  struct Config {
+    using Name = fhicl::Name;
+    using Comment = fhicl::Comment;
+
+    fhicl::Atom<art::InputTag> ReferenceDigits {
+      Name("ReferenceDigits"),
+      Comment("the reference raw digit collection")
+      };
+
+    fhicl::Atom<art::InputTag> TestDigits {
+      Name("TestDigits"),
+      Comment("the raw digit collection compared with the reference one")
+      };
+
+  }; // struct Config
+
+  using Parameters = art::EDAnalyzer::Table<Config>;
+
+  explicit CompareRawDigits(Parameters const& config);
+
+  void analyze(art::Event const& event) override;
+
+    private:
+
+  art::InputTag const fReferenceTag;
+  art::InputTag const fTestTag;
+
+}; // icarus::test::CompareRawDigits
+
+
+// -----------------------------------------------------------------------------
+icarus::test::CompareRawDigits::CompareRawDigits(Parameters const& config)
+  : art::EDAnalyzer(config)
+  , fReferenceTag(config().ReferenceDigits())
+  , fTestTag(config().TestDigits())
+{
+  consumes<std::vector<raw::RawDigit>>(fReferenceTag);
+  consumes<std::vector<raw::RawDigit>>(fTestTag);
+} // icarus::test::CompareRawDigits::CompareRawDigits()
+
+
+// -----------------------------------------------------------------------------
+void icarus::test::CompareRawDigits::analyze(art::Event const& event) {
+
+  auto const& reference = event.getProduct<std::vector<raw::RawDigit>>(fReferenceTag);
+  auto const& test = event.getProduct<std::vector<raw::RawDigit>>(fTestTag);
+
+  if (reference.size() != test.size()) {
+    throw art::Exception(art::errors::LogicError)
+      << event.id() << ": " << test.size() << " digits in '" << fTestTag.encode()
+      << "', " << reference.size() << " in '" << fReferenceTag.encode() << "'\n";
+  }
+
+  unsigned int nDifferent = 0;
+  for (std::size_t iDigit = 0; iDigit < reference.size(); ++iDigit) {
+    raw::RawDigit const& ref = reference[iDigit];
+    raw::RawDigit const& digit = test[iDigit];
+    if ((digit.Channel() == ref.Channel())
+      && (digit.Samples() == ref.Samples())
+      && (digit.GetPedestal() == ref.GetPedestal())
+      && (digit.Compression() == ref.Compression())
+      && (digit.ADCs() == ref.ADCs())
+    ) {
+      continue;
+    }
+    if (nDifferent++ < 10) {
+      mf::LogError("CompareRawDigits") << event.id() << ": digit #" << iDigit
+        << " (channel " << digit.Channel() << ") differs from the reference (channel "
+        << ref.Channel() << ")";
+    }
+  } // for digits
+
+  if (nDifferent > 0) {
+    throw art::Exception(art::errors::LogicError)
+      << event.id() << ": " << nDifferent << "/" << reference.size()
+      << " digits in '" << fTestTag.encode() << "' differ from '"
+      << fReferenceTag.encode() << "'\n";
+  }
+
+  mf::LogInfo("CompareRawDigits") << event.id() << ": all " << reference.size()
+    << " digits in '" << fTestTag.encode() << "' match '"
+    << fReferenceTag.encode() << "'";
+
+} // icarus::test::CompareRawDigits::analyze()
+
+
+// -----------------------------------------------------------------------------
+DEFINE_ART_MODULE(icarus::test::CompareRawDigits)
+
+
+// -----------------------------------------------------------------------------
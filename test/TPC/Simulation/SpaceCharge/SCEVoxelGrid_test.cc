@@ -0,0 +1,219 @@
+/**
+ * @file   test/TPC/Simulation/SpaceCharge/SCEVoxelGrid_test.cc
+ * @brief  Unit test for `spacecharge::SCEVoxelGrid`.
+ * @date   October 16, 2026
+ * @see    `icaruscode/TPC/Simulation/SpaceCharge/SCEVoxelGrid.h`
+ *
+ * The interpolation is compared with `TH3F::Interpolate()`, which is what the
+ * `Voxelized_TH3` representation of `SpaceChargeICARUS` uses; the time taken
+ * by both is also reported.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Simulation/SpaceCharge/SCEVoxelGrid.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( SCEVoxelGrid_test )
+#include <boost/test/unit_test.hpp>
+
+// ROOT
+#include "TError.h" // gErrorIgnoreLevel
+#include "TH3F.h"
+
+// C/C++ standard library
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using Histograms_t = std::array<std::unique_ptr<TH3F>, 3U>;
+
+  /// Returns three maps with a binning similar to the ICARUS ones.
+  Histograms_t makeMaps(std::mt19937& engine) {
+    std::normal_distribution<double> noise{ 0.0, 0.05 };
+    Histograms_t hists;
+    for (std::size_t c = 0; c < hists.size(); ++c) {
+      std::string const name = "Map" + std::to_string(c);
+      hists[c] = std::make_unique<TH3F>(name.c_str(), name.c_str(),
+        31, 61.0, 359.0, 33, -182.0, 135.0, 181, -895.0, 895.0);
+      hists[c]->SetDirectory(nullptr);
+      TH3F& hist = *hists[c];
+      for (int ix = 1; ix <= hist.GetNbinsX(); ++ix) {
+        double const x = hist.GetXaxis()->GetBinCenter(ix);
+        for (int iy = 1; iy <= hist.GetNbinsY(); ++iy) {
+          double const y = hist.GetYaxis()->GetBinCenter(iy);
+          for (int iz = 1; iz <= hist.GetNbinsZ(); ++iz) {
+            double const z = hist.GetZaxis()->GetBinCenter(iz);
+            hist.SetBinContent(ix, iy, iz,
+              (c + 1) * std::sin(x / 50.0) * std::cos(y / 80.0 + z / 300.0)
+              + noise(engine)
+              );
+          } // for z
+        } // for y
+      } // for x
+    } // for components
+    return hists;
+  } // makeMaps()
+
+
+  /// Returns `n` random points in a box slightly larger than the maps.
+  std::vector<double> makePoints(std::mt19937& engine, std::size_t n) {
+    std::uniform_real_distribution<double> x{ 55.0, 365.0 };
+    std::uniform_real_distribution<double> y{ -190.0, 140.0 };
+    std::uniform_real_distribution<double> z{ -900.0, 900.0 };
+    std::vector<double> points;
+    points.reserve(3 * n);
+    for (std::size_t i = 0; i < n; ++i) {
+      points.push_back(x(engine));
+      points.push_back(y(engine));
+      points.push_back(z(engine));
+    }
+    return points;
+  } // makePoints()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void parity_test() {
+
+  std::mt19937 engine{ 24680 };
+  Histograms_t const hists = makeMaps(engine);
+  spacecharge::SCEVoxelGrid const grid{ *hists[0], *hists[1], *hists[2] };
+
+  BOOST_TEST(!grid.empty());
+
+  // points on the bin centres, on the borders and outside the map
+  std::vector<double> points = makePoints(engine, 20000);
+  TAxis const& xAxis = *hists[0]->GetXaxis();
+  for (int ix: { 0, 1, 2, 30, 31, 32 }) {
+    for (double y: { -182.0, -100.0, 134.9 }) {
+      points.push_back(xAxis.GetBinCenter(ix));
+      points.push_back(y);
+      points.push_back(hists[0]->GetZaxis()->GetBinCenter(90));
+      points.push_back(xAxis.GetBinLowEdge(ix));
+      points.push_back(y);
+      points.push_back(0.0);
+    } // for y
+  } // for x
+
+  std::size_t const nPoints = points.size() / 3;
+  std::vector<double> values(points.size());
+  grid.interpolate(nPoints, points.data(), values.data());
+
+  std::size_t nZero = 0;
+  for (std::size_t i = 0; i < nPoints; ++i) {
+    double const* point = &points[3 * i];
+    double const* value = &values[3 * i];
+    BOOST_TEST_CONTEXT("point #" << i << " ("
+      << point[0] << "; " << point[1] << "; " << point[2] << ")")
+    {
+      auto const single = grid.interpolate(point[0], point[1], point[2]);
+      for (std::size_t c = 0; c < 3; ++c) {
+        double const expected
+          = hists[c]->Interpolate(point[0], point[1], point[2]);
+        BOOST_TEST(std::abs(value[c] - expected) < 1e-9);
+        BOOST_TEST(single[c] == value[c]);
+      } // for components
+      if (value[0] == 0.0) ++nZero;
+    }
+  } // for points
+
+  // some points are out of the domain of the interpolation, most are not
+  BOOST_TEST(nZero > 0U);
+  BOOST_TEST(nZero < nPoints / 2);
+
+} // parity_test()
+
+
+void binning_test() {
+
+  TH3F hA{ "A", "A", 4, 0.0, 4.0, 4, 0.0, 4.0, 4, 0.0, 4.0 };
+  TH3F hB{ "B", "B", 4, 0.0, 4.0, 4, 0.0, 4.0, 5, 0.0, 4.0 };
+  hA.SetDirectory(nullptr);
+  hB.SetDirectory(nullptr);
+
+  BOOST_CHECK_THROW
+    (spacecharge::SCEVoxelGrid(hA, hA, hB), cet::exception);
+
+  spacecharge::SCEVoxelGrid const empty;
+  BOOST_TEST(empty.empty());
+  auto const value = empty.interpolate(1.0, 1.0, 1.0);
+  BOOST_TEST(value[0] == 0.0);
+
+} // binning_test()
+
+
+void timing_test() {
+
+  constexpr std::size_t NPoints = 1000000;
+
+  std::mt19937 engine{ 13579 };
+  Histograms_t const hists = makeMaps(engine);
+  spacecharge::SCEVoxelGrid const grid{ *hists[0], *hists[1], *hists[2] };
+
+  // keep the points inside the domain, as SpaceChargeICARUS mostly does
+  std::uniform_real_distribution<double> x{ 70.0, 350.0 };
+  std::uniform_real_distribution<double> y{ -175.0, 130.0 };
+  std::uniform_real_distribution<double> z{ -890.0, 890.0 };
+  std::vector<double> points;
+  points.reserve(3 * NPoints);
+  for (std::size_t i = 0; i < NPoints; ++i) {
+    points.push_back(x(engine));
+    points.push_back(y(engine));
+    points.push_back(z(engine));
+  }
+
+  using Clock_t = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::vector<double> refValues(points.size()), values(points.size());
+
+  auto const startRef = Clock_t::now();
+  for (std::size_t i = 0; i < points.size(); i += 3) {
+    for (std::size_t c = 0; c < 3; ++c) {
+      refValues[i + c]
+        = hists[c]->Interpolate(points[i], points[i + 1], points[i + 2]);
+    }
+  } // for
+  auto const startNew = Clock_t::now();
+  grid.interpolate(NPoints, points.data(), values.data());
+  auto const end = Clock_t::now();
+
+  for (std::size_t i = 0; i < points.size(); ++i)
+    BOOST_TEST(std::abs(values[i] - refValues[i]) < 1e-9);
+
+  std::cout << "Interpolation of " << NPoints << " points: "
+    << ms(startNew - startRef).count() << " ms with TH3F, "
+    << ms(end - startNew).count() << " ms with voxel grid ("
+    << grid.memorySize() / 1024 << " kB)" << std::endl;
+
+} // timing_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SCEVoxelGrid_testcase) {
+
+  // TH3::Interpolate() complains about the points out of its domain
+  gErrorIgnoreLevel = kFatal;
+
+  parity_test();
+  binning_test();
+  timing_test();
+
+} // BOOST_AUTO_TEST_CASE(SCEVoxelGrid_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
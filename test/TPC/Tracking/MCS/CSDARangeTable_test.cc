@@ -0,0 +1,146 @@
+/**
+ * @file   test/TPC/Tracking/MCS/CSDARangeTable_test.cc
+ * @brief  Unit test for `trkf::CSDARangeTable`.
+ * @date   October 16, 2026
+ * @see    `icaruscode/TPC/Tracking/MCS/CSDARangeTable.h`
+ *
+ * The range and the energy after a given length are compared with analytic
+ * results, and with a fine step integration of a Bethe-Bloch-like energy loss;
+ * the time taken by the table lookup and by the stepping integration used by
+ * `TrajectoryMCSFitterICARUS` is also reported.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Tracking/MCS/CSDARangeTable.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( CSDARangeTable_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  constexpr double MuonMass = 0.1056583755; // GeV
+
+  /// Energy loss in liquid argon with the shape of Bethe-Bloch [GeV/cm].
+  double betheBloch(double e) {
+    double const beta2 = 1.0 - (MuonMass * MuonMass) / (e * e);
+    double const gamma2 = 1.0 / (1.0 - beta2);
+    return 0.307075 * 1.4 * 18.0 / 40.0 / beta2
+      * (std::log(2.0 * 0.511 * beta2 * gamma2 / 188.E-6) - beta2) * 1.E-3;
+  } // betheBloch()
+
+
+  /// Energy after `length`, with `nSteps` steps as in the MCS fitter.
+  double stepEnergy(double e, double length, int nSteps, double stopE) {
+    double const step = length / nSteps;
+    for (int i = 0; i < nSteps; ++i) {
+      e -= betheBloch(e) * step;
+      if (e <= stopE) return 0.0;
+    }
+    return e;
+  } // stepEnergy()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void analytic_test() {
+
+  // constant energy loss: everything is linear
+  trkf::CSDARangeTable const constTable
+    { [](double){ return 0.0021; }, 0.1, 5.1, 1000 };
+  BOOST_TEST(constTable.covers(0.1));
+  BOOST_TEST(!constTable.covers(0.09));
+  BOOST_TEST(!constTable.covers(5.2));
+  BOOST_TEST(constTable.range(0.1) == 0.0);
+  BOOST_TEST(constTable.range(2.1) == 2.0 / 0.0021, boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(constTable.energyAfter(2.1, 100.0) == 2.1 - 0.21, boost::test_tools::tolerance(1e-9));
+  BOOST_TEST(constTable.energyAfter(2.1, 1000.0) == 0.0);
+
+  // energy loss as 1/E: the range is quadratic
+  double const a = 0.002;
+  trkf::CSDARangeTable const invTable{ [a](double e){ return a / e; }, 0.2, 8.0 };
+  for (double const e: { 0.5, 1.0, 2.5, 7.9 }) {
+    BOOST_TEST_CONTEXT("E=" << e) {
+      double const range = (e * e - 0.04) / (2.0 * a);
+      BOOST_TEST(invTable.range(e) == range, boost::test_tools::tolerance(1e-5));
+      double const after = std::sqrt(e * e - 2.0 * a * 0.5 * range);
+      BOOST_TEST(invTable.energyAfter(e, 0.5 * range) == after, boost::test_tools::tolerance(1e-5));
+    }
+  }
+
+} // analytic_test()
+
+
+void bethe_bloch_test() {
+
+  trkf::CSDARangeTable const table{ betheBloch, MuonMass, 8.0 };
+
+  for (double const e: { 0.2, 0.5, 1.0, 3.0, 7.5 }) {
+    for (double const length: { 14.0, 140.0, 400.0 }) {
+      BOOST_TEST_CONTEXT("E=" << e << " length=" << length) {
+        double const expected = stepEnergy(e, length, 100000, MuonMass);
+        double const energy = table.energyAfter(e, length);
+        if (expected == 0.0) BOOST_TEST(energy == 0.0);
+        else BOOST_TEST(energy == expected, boost::test_tools::tolerance(1e-4));
+      }
+    }
+  }
+
+} // bethe_bloch_test()
+
+
+void timing_test() {
+
+  trkf::CSDARangeTable const table{ betheBloch, MuonMass, 8.0 };
+
+  // as in a likelihood scan of a 3 m track in 14 cm segments
+  std::mt19937 engine{ 11235 };
+  std::uniform_real_distribution<double> energy{ 0.3, 7.5 };
+  std::uniform_real_distribution<double> length{ 0.0, 300.0 };
+  std::vector<std::pair<double, double>> points(1000000);
+  for (auto& point: points) point = { energy(engine), length(engine) };
+
+  using Clock_t = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  double stepSum = 0.0, tableSum = 0.0;
+  auto const startStep = Clock_t::now();
+  for (auto const& [ e, l ]: points) stepSum += stepEnergy(e, l, 10, MuonMass);
+  auto const startTable = Clock_t::now();
+  for (auto const& [ e, l ]: points) tableSum += table.energyAfter(e, l);
+  auto const end = Clock_t::now();
+
+  BOOST_TEST(tableSum == stepSum, boost::test_tools::tolerance(1e-3));
+
+  std::cout << points.size() << " energy loss integrations: "
+    << ms(startTable - startStep).count() << " ms with 10 steps, "
+    << ms(end - startTable).count() << " ms with the range table" << std::endl;
+
+} // timing_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CSDARangeTable_testcase) {
+
+  analytic_test();
+  bethe_bloch_test();
+  timing_test();
+
+} // BOOST_AUTO_TEST_CASE(CSDARangeTable_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
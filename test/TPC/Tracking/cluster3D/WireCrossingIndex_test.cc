@@ -0,0 +1,431 @@
+/**
+ * @file   test/TPC/Tracking/cluster3D/WireCrossingIndex_test.cc
+ * @brief  Unit test for `lar_cluster3d::WireCrossingIndex`.
+ * @date   October 16, 2026
+ * @see    `icaruscode/TPC/Tracking/cluster3D/WireCrossingIndex.h`
+ *
+ * The wire crossings are compared with the ones computed wire by wire, as
+ * `SnippetHit3DBuilderICARUS` used to do from the geometry, on a TPC with
+ * three planes of wires at 0 and +/- 60 degrees.
+ *
+ * The rates of the pair and triplet tests are also reported, with and without
+ * the index. Without it, the wires are looked up as `geo::GeometryCore` does
+ * (`WireIDToWireGeo()` through cryostat, TPC and plane, with bound checks, on
+ * wire objects the size of `geo::WireGeo`) and the nearest wire is found as
+ * `geo::PlaneGeo::NearestWireID()` does, from the wire coordinate in double
+ * precision, with an exception when out of range. The unit test can't load
+ * the ICARUS geometry, so this stands in for the geometry service.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Tracking/cluster3D/WireCrossingIndex.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( WireCrossingIndex_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using lar_cluster3d::WireCrossingIndex;
+
+  /// Wire in double precision, as from the geometry.
+  struct RefWire_t {
+    std::array<double, 3> center;
+    std::array<double, 3> direction;
+    double halfLength;
+  };
+
+  using RefPlane_t = std::vector<RefWire_t>;
+
+  constexpr double MinY = -160.0, MaxY = 160.0;
+  constexpr double MinZ = -900.0, MaxZ = 0.0;
+
+  /// Wires with the specified angle from the z axis, clipped to the TPC.
+  RefPlane_t makePlane(double x, double angle, double pitch) {
+
+    double const dirY = std::sin(angle), dirZ = std::cos(angle);
+    double const normY = -dirZ, normZ = dirY;
+
+    // range of the wire coordinate across the TPC
+    double minS = std::numeric_limits<double>::max();
+    double maxS = std::numeric_limits<double>::lowest();
+    for (double const y: { MinY, MaxY }) {
+      for (double const z: { MinZ, MaxZ }) {
+        minS = std::min(minS, normY * y + normZ * z);
+        maxS = std::max(maxS, normY * y + normZ * z);
+      }
+    }
+
+    RefPlane_t wires;
+    for (double s = minS + pitch / 2.0; s < maxS; s += pitch) {
+      // clip the line through ( s * normal ) to the TPC
+      double const y0 = s * normY, z0 = s * normZ;
+      double low = std::numeric_limits<double>::lowest();
+      double high = std::numeric_limits<double>::max();
+      auto clip = [&low, &high](double start, double dir, double min, double max)
+        {
+          if (std::abs(dir) < 1e-9) return;
+          double const t1 = (min - start) / dir, t2 = (max - start) / dir;
+          low = std::max(low, std::min(t1, t2));
+          high = std::min(high, std::max(t1, t2));
+        };
+      clip(y0, dirY, MinY, MaxY);
+      clip(z0, dirZ, MinZ, MaxZ);
+      if (high - low < 0.1) continue;
+      double const mid = (low + high) / 2.0;
+      wires.push_back(RefWire_t{
+        { x, y0 + mid * dirY, z0 + mid * dirZ },
+        { 0.0, dirY, dirZ },
+        (high - low) / 2.0
+      });
+    } // for
+    return wires;
+  } // makePlane()
+
+
+  /// The three planes of a TPC.
+  std::array<RefPlane_t, 3> makeTPC(double pitch) {
+    double const angle = M_PI / 3.0;
+    return {
+      makePlane(-200.0, 0.0, pitch),
+      makePlane(-199.7, angle, pitch),
+      makePlane(-199.4, -angle, pitch)
+    };
+  } // makeTPC()
+
+
+  WireCrossingIndex makeIndex(std::array<RefPlane_t, 3> const& tpc) {
+    WireCrossingIndex index;
+    for (unsigned int plane = 0; plane < tpc.size(); ++plane) {
+      std::vector<WireCrossingIndex::Wire_t> wires;
+      for (RefWire_t const& wire: tpc[plane]) {
+        wires.push_back({
+          Eigen::Vector3f(wire.center[0], wire.center[1], wire.center[2]),
+          Eigen::Vector3f
+            (wire.direction[0], wire.direction[1], wire.direction[2]),
+          wire.halfLength
+        });
+      }
+      index.setPlane(0, plane, std::move(wires));
+    }
+    index.buildCrossings();
+    return index;
+  } // makeIndex()
+
+
+  /// Crossing as computed before the index, from the geometry of each wire.
+  bool refIntersect
+    (RefWire_t const& wire0, RefWire_t const& wire1, float& y, float& z)
+  {
+    Eigen::Vector3f wirePos0(wire0.center[0], wire0.center[1], wire0.center[2]);
+    Eigen::Vector3f wireDir0
+      (wire0.direction[0], wire0.direction[1], wire0.direction[2]);
+    Eigen::Vector3f wirePos1(wire1.center[0], wire1.center[1], wire1.center[2]);
+    Eigen::Vector3f wireDir1
+      (wire1.direction[0], wire1.direction[1], wire1.direction[2]);
+
+    float arcLen0, arcLen1;
+    if (!WireCrossingIndex::closestApproach
+      (wirePos0, wireDir0, wirePos1, wireDir1, arcLen0, arcLen1))
+      return false;
+    if (std::abs(arcLen0) >= wire0.halfLength) return false;
+    if (std::abs(arcLen1) >= wire1.halfLength) return false;
+
+    Eigen::Vector3f const poca0 = wirePos0 + arcLen0 * wireDir0;
+    y = poca0[1];
+    z = poca0[2];
+    return true;
+  } // refIntersect()
+
+
+  /// Wire as the geometry keeps it: with its transformation and node.
+  struct GeoWire_t {
+    RefWire_t wire;
+    std::array<double, 16> transformation; ///< as the local-to-world matrix
+    void const* node = nullptr;            ///< as the ROOT geometry node
+  };
+
+  /// Plane with the wire coordinate as `geo::PlaneGeo` computes it.
+  struct GeoPlane_t {
+    std::vector<GeoWire_t> wires;
+    double normY, normZ, firstCoord, pitch;
+
+    double WireCoordinate(double y, double z) const
+      { return (normY * y + normZ * z - firstCoord) / pitch; }
+
+    unsigned int NearestWire(double y, double z) const
+      {
+        long const wire = std::lround(WireCoordinate(y, z));
+        if (wire < 0 || wire >= long(wires.size()))
+          throw std::out_of_range("NearestWireID(): point out of the plane");
+        return wire;
+      }
+  };
+
+  struct GeoTPC_t { std::vector<GeoPlane_t> planes; };
+  struct GeoCryostat_t { std::vector<GeoTPC_t> TPCs; };
+
+  /// Wire lookup through cryostat, TPC and plane, as `geo::GeometryCore`.
+  struct Geometry_t {
+    std::vector<GeoCryostat_t> cryostats;
+
+    GeoPlane_t const& Plane(unsigned int c, unsigned int t, unsigned int p) const
+      {
+        if (c >= cryostats.size()) throw std::out_of_range("cryostat");
+        GeoCryostat_t const& cryo = cryostats[c];
+        if (t >= cryo.TPCs.size()) throw std::out_of_range("TPC");
+        GeoTPC_t const& tpc = cryo.TPCs[t];
+        if (p >= tpc.planes.size()) throw std::out_of_range("plane");
+        return tpc.planes[p];
+      }
+
+    RefWire_t const& WireIDToWireGeo
+      (unsigned int c, unsigned int t, unsigned int p, unsigned int w) const
+      {
+        GeoPlane_t const& plane = Plane(c, t, p);
+        if (w >= plane.wires.size()) throw std::out_of_range("wire");
+        return plane.wires[w].wire;
+      }
+  };
+
+  constexpr unsigned int NCryostats = 2, NTPCs = 4;
+
+  /// Cryostats with the same TPC everywhere.
+  Geometry_t makeGeometry(std::array<RefPlane_t, 3> const& tpc) {
+    Geometry_t geom;
+    geom.cryostats.resize(NCryostats);
+    for (GeoCryostat_t& cryo: geom.cryostats) {
+      cryo.TPCs.resize(NTPCs);
+      for (GeoTPC_t& geoTPC: cryo.TPCs) {
+        for (RefPlane_t const& wires: tpc) {
+          GeoPlane_t plane;
+          for (RefWire_t const& wire: wires) plane.wires.push_back({ wire, {}, nullptr });
+          plane.normY = -wires.front().direction[2];
+          plane.normZ = wires.front().direction[1];
+          auto project = [&plane](RefWire_t const& wire)
+            { return plane.normY * wire.center[1] + plane.normZ * wire.center[2]; };
+          plane.firstCoord = project(wires.front());
+          plane.pitch = (project(wires.back()) - plane.firstCoord) / (wires.size() - 1);
+          geoTPC.planes.push_back(std::move(plane));
+        }
+      }
+    }
+    return geom;
+  } // makeGeometry()
+
+
+  /// Distance from a wire as computed before the index.
+  float refDistance(RefWire_t const& wire, Eigen::Vector3f const& position) {
+    WireCrossingIndex::Wire_t const wireInfo{
+      Eigen::Vector3f(wire.center[0], wire.center[1], wire.center[2]),
+      Eigen::Vector3f(wire.direction[0], wire.direction[1], wire.direction[2]),
+      wire.halfLength
+    };
+    return WireCrossingIndex::distanceToWire(wireInfo, position);
+  } // refDistance()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void crossing_test() {
+
+  // coarse wires, so that all the pairs can be tried
+  std::array<RefPlane_t, 3> const tpc = makeTPC(1.5);
+  WireCrossingIndex const index = makeIndex(tpc);
+
+  unsigned int nCrossings = 0;
+  for (unsigned int plane0 = 0; plane0 < 3; ++plane0) {
+    BOOST_TEST(index.nWires(0, plane0) == tpc[plane0].size());
+    for (unsigned int plane1 = 0; plane1 < 3; ++plane1) {
+      for (unsigned int wire0 = 0; wire0 < tpc[plane0].size(); ++wire0) {
+        for (unsigned int wire1 = 0; wire1 < tpc[plane1].size(); ++wire1) {
+          float refY = 0.f, refZ = 0.f, y = 0.f, z = 0.f;
+          bool const expected = (plane0 != plane1)
+            && refIntersect(tpc[plane0][wire0], tpc[plane1][wire1], refY, refZ);
+          bool const crossing
+            = index.intersect(0, plane0, wire0, plane1, wire1, y, z);
+          BOOST_TEST_CONTEXT("plane " << plane0 << " wire " << wire0
+            << " with plane " << plane1 << " wire " << wire1)
+          {
+            BOOST_TEST(crossing == expected);
+            if (crossing && expected) {
+              BOOST_TEST(y == refY);
+              BOOST_TEST(z == refZ);
+            }
+          }
+          if (expected) ++nCrossings;
+        } // for wire1
+      } // for wire0
+    } // for plane1
+  } // for plane0
+  BOOST_TEST(nCrossings > 0U);
+
+  // unknown wires, planes and TPC
+  float y, z;
+  BOOST_TEST(!index.intersect(0, 0, tpc[0].size(), 1, 0, y, z));
+  BOOST_TEST(!index.intersect(0, 0, 0, 3, 0, y, z));
+  BOOST_TEST(!index.intersect(1, 0, 0, 1, 0, y, z));
+  BOOST_TEST(index.wire(0, 2, tpc[2].size()) == nullptr);
+  BOOST_TEST(index.nearestWire(1, 0, 0.f, 0.f) == -1);
+
+} // crossing_test()
+
+
+void nearest_wire_test() {
+
+  std::array<RefPlane_t, 3> const tpc = makeTPC(0.3);
+  WireCrossingIndex const index = makeIndex(tpc);
+
+  std::mt19937 engine{ 24680 };
+  std::uniform_real_distribution<float> randomY{ MinY + 1.0, MaxY - 1.0 };
+  std::uniform_real_distribution<float> randomZ{ MinZ + 1.0, MaxZ - 1.0 };
+
+  for (unsigned int plane = 0; plane < 3; ++plane) {
+    RefPlane_t const& wires = tpc[plane];
+    double const normY = -wires.front().direction[2];
+    double const normZ = wires.front().direction[1];
+    for (int i = 0; i < 1000; ++i) {
+      float const y = randomY(engine), z = randomZ(engine);
+      double const s = normY * y + normZ * z;
+
+      // closest wire center projection, skipping the ties
+      long expected = -1;
+      double best = std::numeric_limits<double>::max(), second = best;
+      for (std::size_t wire = 0; wire < wires.size(); ++wire) {
+        double const d = std::abs
+          (normY * wires[wire].center[1] + normZ * wires[wire].center[2] - s);
+        if (d < best) { second = best; best = d; expected = wire; }
+        else if (d < second) second = d;
+      }
+      if (second - best < 1e-3) continue;
+
+      BOOST_TEST_CONTEXT("plane " << plane << " at y=" << y << " z=" << z) {
+        BOOST_TEST(index.nearestWire(0, plane, y, z) == expected);
+      }
+    } // for points
+  } // for planes
+
+} // nearest_wire_test()
+
+
+void timing_test() {
+
+  // ICARUS-like wire pitch, in all the TPC of two cryostats
+  std::array<RefPlane_t, 3> const tpc = makeTPC(0.3);
+  Geometry_t const geom = makeGeometry(tpc);
+
+  WireCrossingIndex index;
+  for (unsigned int tpcIdx = 0; tpcIdx < NCryostats * NTPCs; ++tpcIdx) {
+    WireCrossingIndex const tpcIndex = makeIndex(tpc);
+    for (unsigned int plane = 0; plane < 3; ++plane) {
+      std::vector<WireCrossingIndex::Wire_t> wires;
+      for (unsigned int wire = 0; wire < tpcIndex.nWires(0, plane); ++wire)
+        wires.push_back(*tpcIndex.wire(0, plane, wire));
+      index.setPlane(tpcIdx, plane, std::move(wires));
+    }
+  }
+  index.buildCrossings();
+
+  // candidate pairs of wires on the two planes at +/- 60 degrees, in any TPC
+  struct Pair_t { unsigned int cryo, tpc, wire1, wire2; };
+  std::mt19937 engine{ 13579 };
+  std::uniform_int_distribution<unsigned int> cryo{ 0, NCryostats - 1 };
+  std::uniform_int_distribution<unsigned int> tpcNo{ 0, NTPCs - 1 };
+  std::uniform_int_distribution<unsigned int> wire1{ 0, unsigned(tpc[1].size() - 1) };
+  std::uniform_int_distribution<unsigned int> wire2{ 0, unsigned(tpc[2].size() - 1) };
+  std::vector<Pair_t> pairs(4000000);
+  for (Pair_t& pair: pairs)
+    pair = { cryo(engine), tpcNo(engine), wire1(engine), wire2(engine) };
+
+  using Clock_t = std::chrono::steady_clock;
+  using s = std::chrono::duration<double>;
+
+  // pairs
+  struct Point_t { unsigned int cryo, tpc; Eigen::Vector3f pos; };
+  std::vector<Point_t> refPoints, points;
+  auto const startRefPairs = Clock_t::now();
+  for (Pair_t const& pair: pairs) {
+    float y, z;
+    if (refIntersect(geom.WireIDToWireGeo(pair.cryo, pair.tpc, 1, pair.wire1),
+      geom.WireIDToWireGeo(pair.cryo, pair.tpc, 2, pair.wire2), y, z))
+      refPoints.push_back({ pair.cryo, pair.tpc, { -200.f, y, z } });
+  }
+  auto const startPairs = Clock_t::now();
+  for (Pair_t const& pair: pairs) {
+    float y, z;
+    if (index.intersect(pair.cryo * NTPCs + pair.tpc, 1, pair.wire1, 2, pair.wire2, y, z))
+      points.push_back({ pair.cryo, pair.tpc, { -200.f, y, z } });
+  }
+  auto const endPairs = Clock_t::now();
+
+  BOOST_TEST(points.size() == refPoints.size());
+  bool samePoints = (points.size() == refPoints.size());
+  for (std::size_t i = 0; samePoints && i < points.size(); ++i)
+    samePoints = (points[i].pos == refPoints[i].pos);
+  BOOST_TEST(samePoints);
+
+  // triplets: distance of each pair from the nearest wire of the horizontal plane
+  double refSum = 0.0, sum = 0.0;
+  auto const startRefTriplets = Clock_t::now();
+  for (Point_t const& point: refPoints) {
+    float distance = 0.f;
+    try {
+      unsigned int const wire = geom.Plane(point.cryo, point.tpc, 0)
+        .NearestWire(point.pos[1], point.pos[2]);
+      distance = refDistance
+        (geom.WireIDToWireGeo(point.cryo, point.tpc, 0, wire), point.pos);
+    }
+    catch (std::out_of_range const&) { continue; }
+    if (distance < 1.f) refSum += distance;
+  }
+  auto const startTriplets = Clock_t::now();
+  for (Point_t const& point: points) {
+    std::size_t const tpcIdx = point.cryo * NTPCs + point.tpc;
+    long const wire = index.nearestWire(tpcIdx, 0, point.pos[1], point.pos[2]);
+    if (wire < 0 || wire >= long(index.nWires(tpcIdx, 0))) continue;
+    float const distance
+      = WireCrossingIndex::distanceToWire(*index.wire(tpcIdx, 0, wire), point.pos);
+    if (distance < 1.f) sum += distance;
+  }
+  auto const endTriplets = Clock_t::now();
+
+  BOOST_TEST(sum == refSum);
+
+  std::cout << "Wire pairs: " << pairs.size() / s(startPairs - startRefPairs).count()
+    << "/s from the wire geometry, " << pairs.size() / s(endPairs - startPairs).count()
+    << "/s with the index (" << points.size() << " crossings)" << std::endl;
+  std::cout << "Triplets: " << points.size() / s(startTriplets - startRefTriplets).count()
+    << "/s from the wire geometry, " << points.size() / s(endTriplets - startTriplets).count()
+    << "/s with the index" << std::endl;
+
+} // timing_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(WireCrossingIndex_testcase) {
+
+  crossing_test();
+  nearest_wire_test();
+  timing_test();
+
+} // BOOST_AUTO_TEST_CASE(WireCrossingIndex_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
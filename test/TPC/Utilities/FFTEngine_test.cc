@@ -0,0 +1,131 @@
+/**
+ * @file   test/TPC/Utilities/FFTEngine_test.cc
+ * @brief  Unit test for `icarusutil::FFTEngine`.
+ * @date   October 16, 2026
+ * @see    `icaruscode/TPC/Utilities/FFTEngine.h`
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Utilities/FFTEngine.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( FFTEngine_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Returns the kernel inverting the `response` of the specified `size`.
+  template <typename T>
+  typename icarusutil::FFTEngine<T>::FrequencyVec_t inverseKernel
+    (std::vector<double> const& response)
+  {
+    typename icarusutil::FFTEngine<double>::FrequencyVec_t spectrum;
+    icarusutil::FFTEngine<double>::forwardFFT(response, spectrum);
+    typename icarusutil::FFTEngine<T>::FrequencyVec_t kernel;
+    for (auto const& value: spectrum)
+      kernel.emplace_back(1.0 / value);
+    return kernel;
+  } // inverseKernel()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void roundTrip_test(std::size_t size) {
+
+  using Engine_t = icarusutil::FFTEngine<T>;
+
+  typename Engine_t::TimeVec_t waveform(size);
+  for (std::size_t i = 0; i < size; ++i) waveform[i] = T((i * 7) % 13) - T(6);
+
+  typename Engine_t::FrequencyVec_t spectrum;
+  Engine_t::forwardFFT(waveform, spectrum);
+  BOOST_TEST(spectrum.size() == size / 2 + 1);
+
+  typename Engine_t::TimeVec_t restored(size);
+  Engine_t::inverseFFT(spectrum, restored);
+  for (std::size_t i = 0; i < size; ++i)
+    BOOST_TEST(restored[i] == waveform[i], boost::test_tools::tolerance(T(1e-4)));
+
+} // roundTrip_test()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void deconvolute_test() {
+
+  using Engine_t = icarusutil::FFTEngine<T>;
+  constexpr std::size_t Size = 128;
+  constexpr int ResponsePeak = 5;
+
+  // bipolar response peaking at tick 5
+  std::vector<double> response(Size, 0.0);
+  response[ResponsePeak] = 1.0;
+  response[ResponsePeak + 1] = -0.5;
+  auto const kernel = inverseKernel<T>(response);
+
+  // a unit signal at tick 40 appears at tick 45 in the waveform
+  typename Engine_t::TimeVec_t waveform(Size, T(0));
+  waveform[45] = T(1.0);
+  waveform[46] = T(-0.5);
+
+  // with the response offset the signal is found again at the response peak
+  typename Engine_t::TimeVec_t deconvolved = waveform;
+  Engine_t::deconvolute(deconvolved, kernel, -ResponsePeak);
+  for (std::size_t i = 0; i < Size; ++i) {
+    BOOST_TEST(deconvolved[i] == ((i == 45)? T(1): T(0)),
+      boost::test_tools::tolerance(T(1e-4)));
+  }
+
+  // a batch (larger than a single FFTW call) gives the same result
+  constexpr std::size_t NWaveforms = 11;
+  std::vector<T> batch;
+  for (std::size_t i = 0; i < NWaveforms; ++i)
+    batch.insert(batch.end(), waveform.begin(), waveform.end());
+  Engine_t::deconvolute(batch.data(), Size, NWaveforms, kernel, -ResponsePeak);
+  for (std::size_t i = 0; i < batch.size(); ++i)
+    BOOST_TEST(batch[i] == deconvolved[i % Size]);
+
+  // and so does a different thread, with its own plans
+  typename Engine_t::TimeVec_t threadDeconvolved = waveform;
+  std::thread{ [&](){
+      Engine_t::deconvolute(threadDeconvolved, kernel, -ResponsePeak);
+    } }.join();
+  BOOST_TEST(threadDeconvolved == deconvolved);
+
+  // the kernel must match the transform size
+  BOOST_CHECK_THROW(
+    Engine_t::deconvolute(deconvolved.data(), Size / 2, 1U, kernel, 0),
+    std::exception
+    );
+
+} // deconvolute_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(FFTEngine_testcase) {
+
+  roundTrip_test<float>(512);
+  roundTrip_test<float>(400);
+  roundTrip_test<double>(4096);
+
+  deconvolute_test<float>();
+  deconvolute_test<double>();
+
+} // BOOST_AUTO_TEST_CASE(FFTEngine_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
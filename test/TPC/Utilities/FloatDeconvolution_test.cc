@@ -0,0 +1,243 @@
+/**
+ * @file   test/TPC/Utilities/FloatDeconvolution_test.cc
+ * @brief  Compares the single precision ROI deconvolution with the standard one.
+ * @date   October 16, 2026
+ * @see    `icaruscode/TPC/Utilities/FFTEngine.h`,
+ *         `icaruscode/TPC/SignalProcessing/RecoWire/DeconTools/ROIDeconvolution_tool.cc`
+ *
+ * Waveforms with noise and signals from a collection and an induction
+ * response are deconvolved in windows around their signals, as
+ * `ROIDeconvolution` does:
+ *  * with `icarus_signal_processing::ICARUSFFT<double>` and the kernel of the
+ *    full readout window, as the response tools compute it (`UseFloatFFT`
+ *    disabled);
+ *  * with `icarusutil::FFTEngine<float>` and the kernel for the window size
+ *    from `FFTEngine::deconvolutionKernel()` (`UseFloatFFT` enabled).
+ * The deconvolved ROI from the two must agree within 1% of the ROI peak (3%
+ * for ROI at the border of the window, which happens at the start and end of
+ * the readout), for window sizes from 256 to the full readout window.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Utilities/FFTEngine.h"
+#include "icarus_signal_processing/Filters/ICARUSFFT.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( FloatDeconvolution_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <utility> // std::pair
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  constexpr std::size_t NTicks = 4096; ///< Readout window.
+
+  using TimeVec = std::vector<double>;
+  using FrequencyVec = std::vector<std::complex<double>>;
+
+  /// Response of a plane, in the form the response tools provide it.
+  struct Response_t {
+    TimeVec response;         ///< Full response, `NTicks` long.
+    FrequencyVec filter;      ///< Filter, `NTicks / 2 + 1` coefficients.
+    int timeOffset;           ///< As `SignalShapingICARUSService::ResponseTOffset()`.
+  };
+
+
+  /// Electronics shaping convolved with a collection or induction field response.
+  Response_t makeResponse(bool induction) {
+
+    // field response: unipolar (collection) or bipolar (induction)
+    TimeVec field(40, 0.0);
+    for (std::size_t tick = 0; tick < field.size(); ++tick) {
+      double const x = (double(tick) - 12.0) / 2.5;
+      field[tick] = induction? -x * std::exp(-0.5 * x * x): std::exp(-0.5 * x * x);
+    }
+
+    // electronics: semi-gaussian shaping of about 1.3 us (0.4 us ticks)
+    TimeVec electronics(40, 0.0);
+    for (std::size_t tick = 0; tick < electronics.size(); ++tick) {
+      double const x = double(tick) / 1.6;
+      electronics[tick] = std::pow(x, 4) * std::exp(-x);
+    }
+
+    Response_t response;
+    response.response.assign(NTicks, 0.0);
+    for (std::size_t i = 0; i < field.size(); ++i) {
+      for (std::size_t j = 0; j < electronics.size(); ++j)
+        response.response[i + j] += field[i] * electronics[j];
+    }
+    double const peak = *std::max_element
+      (response.response.begin(), response.response.end());
+    for (double& value: response.response) value /= peak;
+
+    auto const peakTick = std::distance(response.response.begin(), std::max_element
+      (response.response.begin(), response.response.end()));
+    response.timeOffset = -int(peakTick);
+
+    // gaussian filter, with a low frequency cut on induction planes
+    response.filter.resize(NTicks / 2 + 1);
+    for (std::size_t idx = 0; idx < response.filter.size(); ++idx) {
+      double const freq = double(idx) / NTicks; // cycles per tick
+      double value = std::exp(-0.5 * std::pow(freq / 0.05, 2));
+      if (induction) value *= 1.0 - std::exp(-std::pow(freq / 0.004, 2));
+      response.filter[idx] = value;
+    }
+
+    return response;
+  } // makeResponse()
+
+
+  /// Deconvolution kernel for the full readout window, as `Response_tool` has it.
+  FrequencyVec responseToolKernel
+    (Response_t const& response, icarus_signal_processing::ICARUSFFT<double>& fft)
+  {
+    TimeVec responseVec = response.response;
+    FrequencyVec convKernel;
+    fft.forwardFFT(responseVec, convKernel);
+
+    FrequencyVec deconvKernel = response.filter;
+    for (std::size_t idx = 0; idx < deconvKernel.size(); ++idx) {
+      if (std::abs(convKernel[idx]) < 0.0001) deconvKernel[idx] = 0.;
+      else                                    deconvKernel[idx] /= convKernel[idx];
+    }
+    return deconvKernel;
+  } // responseToolKernel()
+
+
+  /// Noisy waveform with a few tracks; returns it with the ROI of the tracks.
+  std::pair<std::vector<float>, std::vector<std::pair<std::size_t, std::size_t>>>
+  makeWaveform(Response_t const& response, std::mt19937& engine) {
+
+    std::normal_distribution<double> noise{ 0.0, 2.5 };
+    std::uniform_real_distribution<double> flat{ 0.0, 1.0 };
+
+    TimeVec charge(NTicks, 0.0);
+    std::vector<std::pair<std::size_t, std::size_t>> rois;
+    for (std::size_t start: { 5U, 600U, 1500U, 2700U, 4000U }) {
+      std::size_t const length = 1 + std::size_t(40 * flat(engine));
+      for (std::size_t tick = start; tick < std::min(start + length, NTicks); ++tick)
+        charge[tick] = 20.0 + 30.0 * flat(engine);
+      std::size_t const first = (start > 10)? start - 10: 0;
+      rois.emplace_back(first, std::min(start + length + 60, NTicks));
+    }
+
+    std::vector<float> waveform(NTicks);
+    for (std::size_t tick = 0; tick < NTicks; ++tick) {
+      double value = noise(engine);
+      for (std::size_t t = 0; t <= std::min(tick, std::size_t(100)); ++t)
+        value += charge[tick - t] * response.response[t];
+      waveform[tick] = std::round(value);
+    }
+    return { std::move(waveform), std::move(rois) };
+  } // makeWaveform()
+
+
+  /// Window of `fftSize` samples containing the ROI, as `ROIDeconvolution::placeROI()`.
+  struct Placement_t { std::size_t first, roiStart; };
+
+  Placement_t placeROI
+    (std::pair<std::size_t, std::size_t> const& roi, std::size_t fftSize)
+  {
+    std::size_t const roiLen = roi.second - roi.first;
+    std::size_t const halfLeftOver = (std::min(fftSize, NTicks) - roiLen) / 2;
+    int roiStart = halfLeftOver;
+    int first = int(roi.first) - int(halfLeftOver);
+    int second = roi.second + halfLeftOver + roiLen % 2;
+    if (first < 0) {
+      roiStart += first;
+      second -= first;
+      first = 0;
+    }
+    else if (std::size_t(second) > NTicks) {
+      std::size_t const overshoot = second - NTicks;
+      roiStart += overshoot;
+      first -= overshoot;
+    }
+    return { std::size_t(first), std::size_t(roiStart) };
+  } // placeROI()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+void compareDeconvolution_test(bool induction, std::size_t fftSize) {
+
+  Response_t const response = makeResponse(induction);
+
+  icarus_signal_processing::ICARUSFFT<double> fft(NTicks);
+  FrequencyVec const fullKernel = responseToolKernel(response, fft);
+  icarusutil::FFTEngine<float>::FrequencyVec_t const floatKernel
+    = icarusutil::FFTEngine<float>::deconvolutionKernel
+      (response.response, response.filter, fftSize);
+
+  std::mt19937 engine{ 2468U + unsigned(fftSize) + (induction? 1U: 0U) };
+  auto const [ waveform, rois ] = makeWaveform(response, engine);
+
+  double maxDiff = 0.0;
+  for (auto const& roi: rois) {
+    std::size_t const roiLen = roi.second - roi.first;
+    Placement_t const placement = placeROI(roi, fftSize);
+
+    // double precision, with the kernel of the full readout window
+    TimeVec deconVec(fftSize);
+    std::copy(waveform.begin() + placement.first,
+      waveform.begin() + placement.first + fftSize, deconVec.begin());
+    fft.deconvolute(deconVec, fullKernel, response.timeOffset);
+
+    // single precision, with the kernel for this size
+    std::vector<float> floatVec
+      (waveform.begin() + placement.first, waveform.begin() + placement.first + fftSize);
+    icarusutil::FFTEngine<float>::deconvolute
+      (floatVec, floatKernel, response.timeOffset);
+
+    double peak = 0.0, diff = 0.0;
+    for (std::size_t i = placement.roiStart; i < placement.roiStart + roiLen; ++i) {
+      peak = std::max(peak, std::abs(deconVec[i]));
+      diff = std::max(diff, std::abs(deconVec[i] - floatVec[i]));
+    }
+    // near the border of the window the circular transform of the shorter
+    // window and the zero padded one treat the noise differently
+    bool const nearBorder = (placement.roiStart < 20)
+      || (placement.roiStart + roiLen + 20 > fftSize);
+    double const tolerance = nearBorder? 0.03: 0.01;
+    BOOST_TEST_CONTEXT((induction? "induction": "collection")
+      << ", size " << fftSize << ", ROI [" << roi.first << "; " << roi.second << "[")
+    {
+      BOOST_TEST(peak > 5.0);
+      BOOST_TEST(diff < tolerance * peak);
+    }
+    maxDiff = std::max(maxDiff, diff / peak);
+  } // for ROI
+
+  std::cout << (induction? "Induction": "Collection") << " response, "
+    << fftSize << " samples: largest difference " << (100.0 * maxDiff)
+    << "% of the ROI peak" << std::endl;
+
+} // compareDeconvolution_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(FloatDeconvolution_testcase) {
+
+  for (bool induction: { false, true }) {
+    for (std::size_t fftSize: { 256U, 512U, 1024U, 4096U })
+      compareDeconvolution_test(induction, fftSize);
+  }
+
+} // BOOST_AUTO_TEST_CASE(FloatDeconvolution_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
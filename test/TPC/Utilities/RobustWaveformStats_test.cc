@@ -0,0 +1,205 @@
+/**
+ * @file   test/TPC/Utilities/RobustWaveformStats_test.cc
+ * @brief  Unit test for `RobustWaveformStats.h` header.
+ * @date   October 16, 2026
+ * @see    `icaruscode/TPC/Utilities/RobustWaveformStats.h`
+ *
+ * The results are compared with the sorting algorithms previously used in
+ * `Decon1DROI` and `RecoWireROIICARUS` modules, reproduced here; the time
+ * taken by both is also reported.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Utilities/RobustWaveformStats.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( RobustWaveformStats_test )
+#include <boost/test/unit_test.hpp>
+
+// C/C++ standard library
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <cmath>
+
+
+// -----------------------------------------------------------------------------
+// --- reference implementations (sorting the whole waveform)
+// -----------------------------------------------------------------------------
+namespace {
+
+  using Waveform_t = std::vector<float>;
+
+  /// Sorts a copy of `waveform` by magnitude.
+  Waveform_t sortedByMagnitude(Waveform_t waveform) {
+    std::sort(waveform.begin(), waveform.end(),
+      [](float left, float right){ return std::fabs(left) < std::fabs(right); });
+    return waveform;
+  }
+
+  /// Number of samples to include, as in the modules.
+  int selectedSamples
+    (Waveform_t const& sorted, float threshold, float minFraction)
+  {
+    auto const threshItr = std::find_if(sorted.begin(), sorted.end(),
+      [threshold](float val){ return std::fabs(val) > threshold; });
+    return std::max(int(minFraction * sorted.size()),
+      int(std::distance(sorted.begin(), threshItr)));
+  }
+
+  /// RMS of the smaller half of the sorted samples.
+  float smallerHalfRMS(Waveform_t const& sorted) {
+    std::size_t const nHalf = sorted.size() / 2;
+    double const mean
+      = std::accumulate(sorted.begin(), sorted.begin() + nHalf, 0.) / nHalf;
+    double sumSq = 0.0;
+    for (std::size_t i = 0; i < nHalf; ++i)
+      sumSq += (sorted[i] - mean) * (sorted[i] - mean);
+    return std::sqrt(std::max(0., sumSq / nHalf));
+  }
+
+  float refTruncatedRMS
+    (Waveform_t const& waveform, float threshold, float minFraction)
+  {
+    Waveform_t const sorted = sortedByMagnitude(waveform);
+    int const n = selectedSamples(sorted, threshold, minFraction);
+    double const sumSq = std::inner_product
+      (sorted.begin(), sorted.begin() + n, sorted.begin(), 0.);
+    return std::sqrt(std::max(0., sumSq / double(n)));
+  }
+
+  void refTruncatedRMS(Waveform_t const& waveform, float nSig,
+    float& fullRMS, float& truncRMS, int& nTrunc)
+  {
+    Waveform_t const sorted = sortedByMagnitude(waveform);
+    fullRMS = smallerHalfRMS(sorted);
+    nTrunc = selectedSamples(sorted, nSig * fullRMS, 0.8f);
+    double const sumSq = std::inner_product
+      (sorted.begin(), sorted.begin() + nTrunc, sorted.begin(), 0.);
+    truncRMS = std::sqrt(std::max(0., sumSq / double(nTrunc)));
+  }
+
+  void refBaseline(Waveform_t const& waveform, float nSig, float minFraction,
+    float& pedestal, float& rms, int& n)
+  {
+    Waveform_t const sorted = sortedByMagnitude(waveform);
+    n = selectedSamples(sorted, nSig * smallerHalfRMS(sorted), minFraction);
+    pedestal = std::accumulate(sorted.begin(), sorted.begin() + n, 0.) / n;
+    double const sumSq = std::inner_product
+      (sorted.begin(), sorted.begin() + n, sorted.begin(), 0.);
+    rms = std::sqrt(std::max(0., sumSq / double(n)));
+  }
+
+
+  /// Returns a noisy waveform with a pedestal and a few large pulses.
+  Waveform_t makeWaveform(std::mt19937& engine, std::size_t nTicks) {
+    std::normal_distribution<float> noise{ 0.0f, 3.5f };
+    std::uniform_real_distribution<float> flat{ 0.0f, 1.0f };
+
+    float const pedestal = 1950.0f + 100.0f * flat(engine);
+    Waveform_t waveform(nTicks);
+    for (float& sample: waveform) sample = std::round(pedestal + noise(engine));
+
+    for (int iPulse = 0; iPulse < 3; ++iPulse) {
+      std::size_t const start = flat(engine) * (nTicks - 50);
+      float const amplitude = 200.0f * (flat(engine) - 0.3f);
+      for (std::size_t tick = 0; tick < 50; ++tick)
+        waveform[start + tick] += std::round(amplitude * std::exp(-0.1f * tick));
+    }
+    return waveform;
+  }
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- tests
+// -----------------------------------------------------------------------------
+void truncatedRMS_test() {
+
+  std::mt19937 engine{ 12345 };
+  icarus::RobustWaveformStats<float> stats;
+
+  for (int i = 0; i < 100; ++i) {
+    Waveform_t waveform = makeWaveform(engine, 4096);
+    float const mean
+      = std::accumulate(waveform.begin(), waveform.end(), 0.) / waveform.size();
+    for (float& sample: waveform) sample -= mean;
+
+    BOOST_TEST(stats.truncatedRMS(waveform, 10.0f, 0.8f)
+      == refTruncatedRMS(waveform, 10.0f, 0.8f),
+      boost::test_tools::tolerance(1e-5f));
+
+    float fullRMS, truncRMS, refFullRMS, refTruncRMS;
+    int nTrunc, refNTrunc;
+    stats.truncatedRMS(waveform, 2.0f, fullRMS, truncRMS, nTrunc);
+    refTruncatedRMS(waveform, 2.0f, refFullRMS, refTruncRMS, refNTrunc);
+    BOOST_TEST(fullRMS == refFullRMS, boost::test_tools::tolerance(1e-5f));
+    BOOST_TEST(truncRMS == refTruncRMS, boost::test_tools::tolerance(1e-5f));
+    BOOST_TEST(nTrunc == refNTrunc);
+
+    auto const baseline = stats.lowMagnitudeBaseline(waveform, 6.0f, 0.8f);
+    float refPedestal, refRMS;
+    int refN;
+    refBaseline(waveform, 6.0f, 0.8f, refPedestal, refRMS, refN);
+    BOOST_TEST(baseline.pedestal == refPedestal,
+      boost::test_tools::tolerance(1e-4f));
+    BOOST_TEST(baseline.RMS == refRMS, boost::test_tools::tolerance(1e-5f));
+    BOOST_TEST(baseline.nSamples == refN);
+  } // for
+
+} // truncatedRMS_test()
+
+
+void timing_test() {
+
+  std::mt19937 engine{ 54321 };
+  std::vector<Waveform_t> waveforms;
+  for (int i = 0; i < 576; ++i) waveforms.push_back(makeWaveform(engine, 4096));
+
+  using Clock_t = std::chrono::steady_clock;
+  icarus::RobustWaveformStats<float> stats;
+
+  double sumRef = 0.0, sumNew = 0.0;
+  float fullRMS, truncRMS;
+  int nTrunc;
+
+  auto const startRef = Clock_t::now();
+  for (Waveform_t const& waveform: waveforms) {
+    refTruncatedRMS(waveform, 2.0f, fullRMS, truncRMS, nTrunc);
+    sumRef += truncRMS;
+  }
+  auto const startNew = Clock_t::now();
+  for (Waveform_t const& waveform: waveforms) {
+    stats.truncatedRMS(waveform, 2.0f, fullRMS, truncRMS, nTrunc);
+    sumNew += truncRMS;
+  }
+  auto const end = Clock_t::now();
+
+  BOOST_TEST(sumNew == sumRef, boost::test_tools::tolerance(1e-5));
+
+  using ms = std::chrono::duration<double, std::milli>;
+  std::cout << "Truncated RMS of " << waveforms.size() << " waveforms: "
+    << ms(startNew - startRef).count() << " ms sorting, "
+    << ms(end - startNew).count() << " ms with selection" << std::endl;
+
+} // timing_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(RobustWaveformStats_testcase) {
+
+  truncatedRMS_test();
+  timing_test();
+
+} // BOOST_AUTO_TEST_CASE(RobustWaveformStats_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------